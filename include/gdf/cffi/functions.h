@@ -125,6 +125,7 @@ const char *gdf_ipc_parser_get_layout_json(gdf_ipc_parser_type *handle) ;
 
 
 /* sorting */
+/* num_items is the plan's capacity: it sorts columns of up to num_items rows */
 gdf_radixsort_plan_type* gdf_radixsort_plan(size_t num_items, int descending,
                                         unsigned begin_bit, unsigned end_bit);
 gdf_error gdf_radixsort_plan_setup(gdf_radixsort_plan_type *hdl,
@@ -153,6 +154,17 @@ gdf_error gdf_radixsort_generic(gdf_radixsort_plan_type *hdl,
                                 gdf_column *keycol,
                                 gdf_column *valcol);
 
+/*
+ * Sorts many independent key (and INT64 value) columns of the plan's dtype,
+ * each of at most the plan's num_items rows, in one call: the columns are
+ * staged back to back and sorted together as the segments of a segmented
+ * sort, reusing the plan's buffers. valcols may be NULL to sort keys only.
+ */
+gdf_error gdf_radixsort_batch(gdf_radixsort_plan_type *hdl,
+                              gdf_column **keycols,
+                              gdf_column **valcols,
+                              size_t num_arrays);
+
 /* segmented sorting */
 gdf_segmented_radixsort_plan_type* gdf_segmented_radixsort_plan(size_t num_items, int descending,
     unsigned begin_bit, unsigned end_bit);
@@ -350,7 +362,34 @@ gdf_error gdf_hash_partition(int num_input_cols,
                              int partition_offsets[],
                              gdf_hash_func hash);
 
-/* prefixsum */
+/* scans */
+/* num_items is the plan's capacity: it scans columns of up to num_items rows
+   of any numeric dtype, reusing its temporary storage */
+gdf_scan_plan_type* gdf_scan_plan(size_t num_items);
+gdf_error gdf_scan_plan_setup(gdf_scan_plan_type *hdl);
+gdf_error gdf_scan_plan_free(gdf_scan_plan_type *hdl);
+
+/*
+ * The plan must be set up (gdf_scan_plan_setup) before scanning with it.
+ * out[i] is the reduction `op` of the valid rows up to i (inclusive) or
+ * before i (exclusive): null rows are skipped, and are null in out when it
+ * has a validity mask. GDF_REDUCE_SUM_SQUARED is for floating point only.
+ */
+gdf_error gdf_scan(gdf_scan_plan_type *hdl, gdf_column *inp, gdf_column *out,
+                   gdf_reduction_op op, int inclusive);
+/* as gdf_scan, restarting at every row whose key differs from the row before */
+gdf_error gdf_scan_by_key(gdf_scan_plan_type *hdl, gdf_column *keys,
+                          gdf_column *inp, gdf_column *out,
+                          gdf_reduction_op op, int inclusive);
+/* as gdf_scan, restarting at the first row of every segment (device offsets,
+   non-decreasing and at most the size of inp) */
+gdf_error gdf_segmented_scan(gdf_scan_plan_type *hdl,
+                             gdf_column *inp, gdf_column *out,
+                             gdf_reduction_op op, int inclusive,
+                             unsigned num_segments,
+                             unsigned *d_begin_offsets);
+
+/* prefixsum: gdf_scan with GDF_REDUCE_SUM, in a plan of its own */
 
 gdf_error gdf_prefixsum_generic(gdf_column *inp, gdf_column *out, int inclusive);
 gdf_error gdf_prefixsum_i8(gdf_column *inp, gdf_column *out, int inclusive);
@@ -619,6 +658,37 @@ gdf_error gdf_bitwise_xor_i8(gdf_column *lhs, gdf_column *rhs, gdf_column *outpu
 gdf_error gdf_bitwise_xor_i32(gdf_column *lhs, gdf_column *rhs, gdf_column *output);
 gdf_error gdf_bitwise_xor_i64(gdf_column *lhs, gdf_column *rhs, gdf_column *output);
 
+/* column and scalar: the scalar is read in place, not broadcast into a
+   column; it takes the type of the column, except that a floating point
+   scalar, or GDF_BINARY_DIV, promotes integers to GDF_FLOAT64, and that an
+   integer scalar out of the range of an integer column promotes both, as by
+   gdf_binary_op; comparisons are done in the promoted type and give
+   GDF_INT8 */
+
+gdf_error gdf_binary_op_column_scalar(gdf_column *lhs, const gdf_scalar *rhs,
+                                      gdf_column *output, gdf_binary_operator op);
+gdf_error gdf_binary_op_scalar_column(const gdf_scalar *lhs, gdf_column *rhs,
+                                      gdf_column *output, gdf_binary_operator op);
+gdf_error gdf_binary_op_column_scalar_async(gdf_column *lhs, const gdf_scalar *rhs,
+                                            gdf_column *output, gdf_binary_operator op,
+                                            gdf_exec_context context);  //in: device context or NULL
+gdf_error gdf_binary_op_scalar_column_async(const gdf_scalar *lhs, gdf_column *rhs,
+                                            gdf_column *output, gdf_binary_operator op,
+                                            gdf_exec_context context);  //in: device context or NULL
+
+/* columns of any two numeric types, promoted in registers: integers to the
+   wider one; floating point to GDF_FLOAT64 if either is, or if GDF_FLOAT32
+   meets a 32 or 64-bit integer, to GDF_FLOAT32 otherwise; GDF_BINARY_DIV
+   promotes integers to GDF_FLOAT64. Dates and timestamps compare with and
+   subtract (into an integer duration) dates of the same type and unit, and
+   add or subtract integer durations in their own unit, giving their type */
+
+gdf_error gdf_binary_op(gdf_column *lhs, gdf_column *rhs, gdf_column *output,
+                        gdf_binary_operator op);
+gdf_error gdf_binary_op_async(gdf_column *lhs, gdf_column *rhs, gdf_column *output,
+                              gdf_binary_operator op,
+                              gdf_exec_context context);                //in: device context or NULL
+
 /* validity */
 
 gdf_error gdf_validity_and(gdf_column *lhs, gdf_column *rhs, gdf_column *output);
@@ -631,6 +701,8 @@ space.  Use gdf_reduce_optimal_output_size() to get its optimal size.
 
 unsigned int gdf_reduce_optimal_output_size();
 
+//floating point sums are compensated (Kahan-Neumaier) and reproducible:
+//the result does not depend on dev_result_size or on the run
 gdf_error gdf_sum_generic(gdf_column *col, void *dev_result, gdf_size_type dev_result_size);
 gdf_error gdf_sum_f64(gdf_column *col, double *dev_result, gdf_size_type dev_result_size);
 gdf_error gdf_sum_f32(gdf_column *col, float *dev_result, gdf_size_type dev_result_size);
@@ -665,6 +737,15 @@ gdf_error gdf_max_i64(gdf_column *col, int64_t *dev_result, gdf_size_type dev_re
 gdf_error gdf_max_i32(gdf_column *col, int32_t *dev_result, gdf_size_type dev_result_size);
 gdf_error gdf_max_i8(gdf_column *col, int8_t *dev_result, gdf_size_type dev_result_size);
 
+/* reduces any number of columns, each with its own reduction, in two launches;
+   results[i] is a host pointer to a value of the type of cols[i] */
+gdf_error gdf_reduce_batch(gdf_column **cols, gdf_reduction_op const *ops,
+                           int num_columns, void **results);
+
+/* count, null count, sum, sum of squares, min, max, mean and variance of the
+   valid values in a single pass; needs no working space */
+gdf_error gdf_column_stats(gdf_column *col, gdf_stats *stats);
+
 
 
 
@@ -680,12 +761,27 @@ gdf_error gpu_comparison_static_i32(gdf_column *lhs, int32_t value, gdf_column *
 gdf_error gpu_comparison_static_i64(gdf_column *lhs, int64_t value, gdf_column *output,gdf_comparison_operator operation);
 gdf_error gpu_comparison_static_f32(gdf_column *lhs, float value, gdf_column *output,gdf_comparison_operator operation);
 gdf_error gpu_comparison_static_f64(gdf_column *lhs, double value, gdf_column *output,gdf_comparison_operator operation);
+//the same queued on a device execution context, with the null count of output as for gpu_comparison_async
+gdf_error gpu_comparison_static_i8_async(gdf_column *lhs, int8_t value, gdf_column *output,gdf_comparison_operator operation, gdf_exec_context context);
+gdf_error gpu_comparison_static_i16_async(gdf_column *lhs, int16_t value, gdf_column *output,gdf_comparison_operator operation, gdf_exec_context context);
+gdf_error gpu_comparison_static_i32_async(gdf_column *lhs, int32_t value, gdf_column *output,gdf_comparison_operator operation, gdf_exec_context context);
+gdf_error gpu_comparison_static_i64_async(gdf_column *lhs, int64_t value, gdf_column *output,gdf_comparison_operator operation, gdf_exec_context context);
+gdf_error gpu_comparison_static_f32_async(gdf_column *lhs, float value, gdf_column *output,gdf_comparison_operator operation, gdf_exec_context context);
+gdf_error gpu_comparison_static_f64_async(gdf_column *lhs, double value, gdf_column *output,gdf_comparison_operator operation, gdf_exec_context context);
 
 //allows you two compare two columns against each other using a comparison operation, retunrs a stencil like functions above
 gdf_error gpu_comparison(gdf_column *lhs, gdf_column *rhs, gdf_column *output,gdf_comparison_operator operation);
+//the same queued on a device execution context; the null count of output is only computed on the host when both inputs have nulls
+gdf_error gpu_comparison_async(gdf_column *lhs, gdf_column *rhs, gdf_column *output,gdf_comparison_operator operation, gdf_exec_context context);
 
 //takes a stencil and uses it to compact a colum e.g. remove all values for which the stencil = 0
 gdf_error gpu_apply_stencil(gdf_column *lhs, gdf_column * stencil, gdf_column * output);
+//the same on the stream of a device execution context; output->size is needed on the host, so it returns once the compaction is done
+gdf_error gpu_apply_stencil_async(gdf_column *lhs, gdf_column * stencil, gdf_column * output, gdf_exec_context context);
+
+//the same with a packed stencil, one bit per row as written by gdf_comparison_mask; lhs may have nulls, output then needs a valid mask
+gdf_error gpu_apply_stencil_mask(gdf_column *lhs, gdf_valid_type const * stencil, gdf_column * output);
+gdf_error gpu_apply_stencil_mask_async(gdf_column *lhs, gdf_valid_type const * stencil, gdf_column * output, gdf_exec_context context);
 
 gdf_error gpu_concat(gdf_column *lhs, gdf_column *rhs, gdf_column *output);
 
@@ -711,10 +807,57 @@ gdf_error get_column_byte_width(gdf_column * col, int * width);
 gdf_error gdf_order_by(size_t nrows,     //in: # rows
 		       gdf_column* cols, //in: host-side array of gdf_columns
 		       size_t ncols,     //in: # cols
-		       void** d_cols,    //out: pre-allocated device-side array to be filled with gdf_column::data for each column; slicing of gdf_column array (host)
-		       int* d_types,     //out: pre-allocated device-side array to be filled with gdf_colum::dtype for each column; slicing of gdf_column array (host)
+		       void** d_cols,    //in: ignored, kept for compatibility; may be NULL
+		       int* d_types,     //in: ignored, kept for compatibility; may be NULL
 		       size_t* d_indx);  //out: device-side array of re-rdered row indices
 
+gdf_error gdf_order_by_asc_desc(size_t nrows,                //in: # rows
+				gdf_column* cols,            //in: host-side array of gdf_columns
+				size_t ncols,                //in: # cols
+				order_by_type* asc_desc,     //in: host-side array of per-column sort direction; NULL for all ascending
+				null_order_type* null_order, //in: host-side array of per-column NULL placement; NULL for all NULLS LAST
+				size_t* d_indx);             //out: device-side array of re-rdered row indices
+
+gdf_error gdf_argsort(size_t nrows,                //in: # rows
+		      gdf_column* cols,            //in: host-side array of gdf_columns
+		      size_t ncols,                //in: # cols
+		      order_by_type* asc_desc,     //in: host-side array of per-column sort direction; NULL for all ascending
+		      null_order_type* null_order, //in: host-side array of per-column NULL placement; NULL for all NULLS LAST
+		      gdf_column* out_indices);    //out: nrows re-ordered row indices; dtype GDF_INT32 (nrows < 2^31) or GDF_INT64
+
+gdf_error gdf_is_sorted(size_t nrows,                //in: # rows
+			gdf_column* cols,            //in: host-side array of gdf_columns
+			size_t ncols,                //in: # cols
+			order_by_type* asc_desc,     //in: host-side array of per-column sort direction; NULL for all ascending
+			null_order_type* null_order, //in: host-side array of per-column NULL placement; NULL for all NULLS LAST
+			int* is_sorted);             //out: host-side 1 if no two adjacent rows are out of order, else 0
+
+gdf_error gdf_top_k(size_t nrows,                //in: # rows
+		    gdf_column* cols,            //in: host-side array of gdf_columns
+		    size_t ncols,                //in: # cols
+		    order_by_type* asc_desc,     //in: host-side array of per-column sort direction; NULL for all ascending
+		    null_order_type* null_order, //in: host-side array of per-column NULL placement; NULL for all NULLS LAST
+		    size_t k,                    //in: # rows to return
+		    size_t* d_indx);             //out: device-side array of the min(k, nrows) first row indices in sorted order
+
+gdf_error gdf_external_order_by(size_t nrows,                //in: # rows
+				gdf_column* cols,            //in: host-side array of gdf_columns with host-side data and valid
+				size_t ncols,                //in: # cols
+				order_by_type* asc_desc,     //in: host-side array of per-column sort direction; NULL for all ascending
+				null_order_type* null_order, //in: host-side array of per-column NULL placement; NULL for all NULLS LAST
+				size_t device_memory_budget, //in: device memory (bytes) available to sort one chunk of rows
+				const char* spill_dir,       //in: directory for the temporary sorted runs
+				size_t* h_indx);             //out: host-side array of re-rdered row indices
+
+gdf_error gdf_merge_sorted(gdf_column** tables,         //in: host-side array of ntables host-side arrays of ncols columns, each table sorted by its first nkeys columns
+			   size_t ntables,              //in: # tables
+			   size_t ncols,                //in: # cols of every table
+			   size_t nkeys,                //in: # key cols
+			   order_by_type* asc_desc,     //in: host-side array of per-key-column sort direction; NULL for all ascending
+			   null_order_type* null_order, //in: host-side array of per-key-column NULL placement; NULL for all NULLS LAST
+			   gdf_column* out_indices,     //out: merged order as row indices into the concatenation of the tables; dtype GDF_INT32 or GDF_INT64; may be NULL
+			   gdf_column** out_cols);      //out: host-side array of ncols pre-allocated columns receiving the merged table; may be NULL
+
 gdf_error gdf_filter(size_t nrows,     //in: # rows
 		     gdf_column* cols, //in: host-side array of gdf_columns
 		     size_t ncols,     //in: # cols
@@ -724,6 +867,11 @@ gdf_error gdf_filter(size_t nrows,     //in: # rows
 		     size_t* d_indx,   //out: device-side array of row indices that remain after filtering
 		     size_t* new_sz);  //out: host-side # rows that remain after filtering
 
+gdf_error gdf_gather_table(gdf_column** in_cols,    //in: host-side array of ncols input columns
+			   gdf_column** out_cols,   //out: host-side array of ncols pre-allocated columns (data and, optionally, valid) of gather_map->size rows
+			   size_t ncols,            //in: # cols
+			   gdf_column* gather_map); //in: row indices into in_cols, e.g. from gdf_argsort or gdf_filter; dtype GDF_INT32 or GDF_INT64
+
 gdf_error gdf_group_by_sum(int ncols,                    // # columns
                            gdf_column** cols,            //input cols
                            gdf_column* col_agg,          //column to aggregate on
@@ -771,7 +919,7 @@ gdf_error gdf_group_by_count(int ncols,                    // # columns
                              gdf_column* out_col_agg,      //aggregation result
                              gdf_context* ctxt);            //struct with additional info: bool is_sorted, flag_sort_or_hash, bool flag_count_distinct
 
-gdf_error gdf_quantile_exact(	gdf_column*         col_in,       //input column;
+gdf_error gdf_quantile_exact(	gdf_column*         col_in,       //input column; null rows are excluded
                                 gdf_quantile_method prec,         //precision: type of quantile method calculation
                                 double              q,            //requested quantile in [0,1]
                                 void*               t_erased_res, //result; for <exact> should probably be double*; it's void* because
@@ -779,7 +927,148 @@ gdf_error gdf_quantile_exact(	gdf_column*         col_in,       //input column;
                                                                   //(2) for possible types bigger than double, in the future;
                                 gdf_context*        ctxt);        //context info
 
-gdf_error gdf_quantile_aprrox(	gdf_column*  col_in,       //input column;
+gdf_error gdf_quantile_aprrox(	gdf_column*  col_in,       //input column; null rows are excluded
                                 double       q,            //requested quantile in [0,1]
                                 void*        t_erased_res, //type-erased result of same type as column;
                                 gdf_context* ctxt);        //context info
+
+gdf_error gdf_quantiles(gdf_column*         col_in,       //input column; null rows are excluded
+                        gdf_quantile_method prec,         //precision: type of quantile method calculation
+                        double const*       qs,           //requested quantiles in [0,1]
+                        size_t              num_qs,       //number of requested quantiles
+                        double*             results,      //out: one result per requested quantile
+                        gdf_context*        ctxt);        //context info
+
+/* t-digest: mergeable quantile sketch, for streaming or partitioned data */
+gdf_tdigest_type* gdf_tdigest_create(double compression);                //compression in (0, 1e7]; NULL if out of range
+gdf_error gdf_tdigest_add(gdf_tdigest_type *hdl, gdf_column *col_in);    //null rows are skipped
+gdf_error gdf_tdigest_merge(gdf_tdigest_type *dst, const gdf_tdigest_type *src);
+gdf_error gdf_tdigest_quantiles(gdf_tdigest_type *hdl, double const *qs, size_t num_qs,
+                                double *results);                        //out: one result per quantile
+gdf_error gdf_tdigest_serialized_size(gdf_tdigest_type *hdl, size_t *bytes);
+gdf_error gdf_tdigest_serialize(gdf_tdigest_type *hdl, void *buffer);    //buffer of serialized_size bytes
+gdf_error gdf_tdigest_deserialize(const void *buffer, size_t bytes,
+                                  gdf_tdigest_type **hdl);               //out: a new digest; GDF_INVALID_API_CALL if the buffer is not a valid one
+gdf_error gdf_tdigest_free(gdf_tdigest_type *hdl);
+
+/* HyperLogLog: mergeable distinct count sketch of rows of one or more columns;
+   rows with a null in any column are skipped; a precision of 0 means 14,
+   for a relative standard error of 1.04 / sqrt(2^precision) */
+gdf_error gdf_approx_count_distinct(int ncols, gdf_column **cols, int precision,
+                                    double *estimate);                   //out: estimated distinct rows
+gdf_hll_type* gdf_hll_create(int precision);                             //precision in [4, 18]; NULL if out of range
+gdf_error gdf_hll_add(gdf_hll_type *hdl, int ncols, gdf_column **cols);
+gdf_error gdf_hll_merge(gdf_hll_type *dst, const gdf_hll_type *src);   //at the smaller of the two precisions
+gdf_error gdf_hll_estimate(gdf_hll_type *hdl, double *estimate);
+gdf_error gdf_hll_serialized_size(gdf_hll_type *hdl, size_t *bytes);
+gdf_error gdf_hll_serialize(gdf_hll_type *hdl, void *buffer);            //buffer of serialized_size bytes
+gdf_error gdf_hll_deserialize(const void *buffer, size_t bytes,
+                              gdf_hll_type **hdl);                       //out: a new sketch
+gdf_error gdf_hll_free(gdf_hll_type *hdl);
+
+/* Histograms and binning of numeric and date columns; null rows are not
+   counted, and the bin of a null row is null */
+gdf_error gdf_histogram(gdf_column *col_in, double lo, double hi,
+                        gdf_column *counts);                             //out: GDF_INT64 counts of counts->size equal-width bins of [lo, hi]
+gdf_error gdf_digitize(gdf_column *col_in, gdf_column *edges, int right,
+                       gdf_column *out);                                 //out: GDF_INT32 index of each value among the sorted edges, as numpy.digitize
+gdf_error gdf_cut(gdf_column *col_in, gdf_column *edges, int right,
+                  gdf_column *out);                                      //out: GDF_INT32 bin between the sorted edges; null (or -1 without a validity mask) outside them
+gdf_error gdf_qcut(gdf_column *col_in, int num_bins, gdf_column *out,
+                   gdf_context *ctxt);                                   //out: GDF_INT32 equi-depth bin, on the quantiles of the valid values
+
+/* Window aggregates: every row gets the aggregate of the valid values of its
+   frame, within its partition, in window order (partition columns, then order
+   columns); rows that are null or whose frame holds fewer than
+   max(min_periods, 1) valid values are null, or NaN without a validity mask,
+   except for counts */
+gdf_error gdf_window_function(gdf_column **window_reduction_columns,      //in: columns to aggregate
+                              window_reduction_type *reductions,         //in: one aggregate per column
+                              int num_window_reduction_columns,
+                              gdf_column **window_partition_columns,     //in: may be NULL
+                              int num_window_partition_columns,
+                              gdf_column **window_order_columns,         //in: may be NULL for rows in table order
+                              order_by_type *order_by_types,             //in: per-order-column direction; NULL for all ascending
+                              int num_window_order_columns,              //in: exactly 1, without nulls, for GDF_WINDOW_RANGE
+                              window_function_type window_type,          //in: GDF_WINDOW_ROW: bounds in rows; GDF_WINDOW_RANGE: in order values
+                              double preceding,                          //in: negative for UNBOUNDED PRECEDING; not NaN
+                              double following,                          //in: negative for UNBOUNDED FOLLOWING; not NaN
+                              gdf_size_type min_periods,
+                              gdf_column **output_columns);              //out: GDF_FLOAT64, or GDF_INT64 for GDF_WINDOW_COUNT
+
+/* Fused elementwise expressions: the nodes, in postfix order, are evaluated
+   over the columns in a single pass, without temporary columns; integer
+   arithmetic stays in int64 unless an operand is floating point, comparisons
+   and logical operations give 0 or 1, and a row is null if any column of
+   the expression is */
+gdf_error gdf_expr_eval(gdf_expr_node const *nodes,                      //in: at most 64 nodes, at most 16 values on the stack
+                        int num_nodes,
+                        gdf_column **cols,                               //in: the columns that GDF_EXPR_COLUMN nodes index
+                        int ncols,
+                        gdf_column *output);                             //out: numeric or date column, the result converted to its type
+gdf_error gdf_expr_eval_async(gdf_expr_node const *nodes,
+                              int num_nodes,
+                              gdf_column **cols,                         //in: host columns for a host context
+                              int ncols,
+                              gdf_column *output,
+                              gdf_exec_context context);
+
+/* Predicates into packed stencils: one bit per row in the format of a
+   validity bitmask, set when both operands are valid and the comparison
+   holds, with the bits past the last row cleared. Mixed types are compared
+   in the type they promote to, as by gdf_binary_op, and so is an integer
+   column with a scalar */
+gdf_error gdf_comparison_mask(gdf_column *lhs,
+                              gdf_column *rhs,
+                              gdf_comparison_operator op,
+                              gdf_valid_type *stencil);                  //out: gdf_get_num_chars_bitmask(lhs->size) bytes, allocated like a valid mask
+gdf_error gdf_comparison_static_mask(gdf_column *lhs,
+                                     const gdf_scalar *value,
+                                     gdf_comparison_operator op,
+                                     gdf_valid_type *stencil);           //out: gdf_get_num_chars_bitmask(lhs->size) bytes, allocated like a valid mask
+gdf_error gdf_comparison_mask_async(gdf_column *lhs, gdf_column *rhs, gdf_comparison_operator op,
+                                    gdf_valid_type *stencil,
+                                    gdf_exec_context context);           //in: host columns and stencil for a host context
+gdf_error gdf_comparison_static_mask_async(gdf_column *lhs, const gdf_scalar *value, gdf_comparison_operator op,
+                                           gdf_valid_type *stencil,
+                                           gdf_exec_context context);
+gdf_error gdf_mask_and(gdf_valid_type const *lhs, gdf_valid_type const *rhs,
+                       gdf_valid_type *output,                           //out: may be lhs or rhs
+                       gdf_size_type size);
+gdf_error gdf_mask_or(gdf_valid_type const *lhs, gdf_valid_type const *rhs,
+                      gdf_valid_type *output,                            //out: may be lhs or rhs
+                      gdf_size_type size);
+gdf_error gdf_mask_not(gdf_valid_type const *input,
+                       gdf_valid_type *output,                           //out: may be input
+                       gdf_size_type size);
+gdf_error gdf_mask_and_async(gdf_valid_type const *lhs, gdf_valid_type const *rhs, gdf_valid_type *output,
+                             gdf_size_type size, gdf_exec_context context);
+gdf_error gdf_mask_or_async(gdf_valid_type const *lhs, gdf_valid_type const *rhs, gdf_valid_type *output,
+                            gdf_size_type size, gdf_exec_context context);
+gdf_error gdf_mask_not_async(gdf_valid_type const *input, gdf_valid_type *output,
+                             gdf_size_type size, gdf_exec_context context);
+
+/* Execution contexts: the _async operations check their arguments, queue
+   their work on the context and return without waiting for it. A context
+   runs its work in order; completion is observed with events, which other
+   contexts can also wait for. The columns, stencils and outputs must stay
+   allocated until the work is done. Operations without a context run on
+   the default stream, also without synchronizing, unless they return
+   values computed on the device (sizes, null counts). Host contexts run
+   gdf_expr_eval_async, the comparison masks and the mask operations; the
+   other _async operations need a device context and return
+   GDF_UNSUPPORTED_METHOD for a host one */
+gdf_error gdf_exec_context_create(gdf_exec_context *context);           //out: on a new non-blocking stream
+gdf_error gdf_exec_context_create_from_stream(gdf_exec_context *context,
+                                              void *stream);             //in: cudaStream_t, not destroyed with the context
+gdf_error gdf_exec_context_create_host(gdf_exec_context *context,        //out: for host columns
+                                       int num_threads);                 //in: 0 for the hardware concurrency
+gdf_error gdf_exec_context_synchronize(gdf_exec_context context);
+gdf_error gdf_exec_context_destroy(gdf_exec_context context);           //in: waits for its work first, unless its stream is not its own (create_from_stream)
+gdf_error gdf_exec_event_record(gdf_exec_context context,
+                                gdf_exec_event *event);                  //out: done once all the work queued on the context so far is done
+gdf_error gdf_exec_event_query(gdf_exec_event event, int *done);         //out: 1 if done, else 0
+gdf_error gdf_exec_event_synchronize(gdf_exec_event event);
+gdf_error gdf_exec_context_wait(gdf_exec_context context,
+                                gdf_exec_event event);                   //in: may be destroyed once this returns; a host context waits for a device event before returning
+gdf_error gdf_exec_event_destroy(gdf_exec_event event);
@@ -128,6 +128,21 @@ typedef enum {
   N_GDF_AGG_OPS,      /**< The total number of aggregation operations. ALL NEW OPERATIONS SHOULD BE ADDED ABOVE THIS LINE*/
 } gdf_agg_op;
 
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  These enums indicate the reduction of a column to a single value
+ * computed by a batched reduction; the result has the type of the column.
+ */
+/* ----------------------------------------------------------------------------*/
+typedef enum {
+  GDF_REDUCE_SUM = 0,     /**< Sum of the valid values */
+  GDF_REDUCE_PRODUCT,     /**< Product of the valid values */
+  GDF_REDUCE_SUM_SQUARED, /**< Sum of the squares of the valid values (floating point columns only) */
+  GDF_REDUCE_MIN,         /**< Smallest valid value */
+  GDF_REDUCE_MAX,         /**< Largest valid value */
+  N_GDF_REDUCTION_OPS,    /**< The total number of reductions. ALL NEW REDUCTIONS SHOULD BE ADDED ABOVE THIS LINE*/
+} gdf_reduction_op;
+
 
 /* --------------------------------------------------------------------------*/
 /** 
@@ -162,8 +177,46 @@ typedef struct gdf_context_{
   int flag_distinct;      /**< for COUNT: DISTINCT = 1, else = 0 */
   int flag_sort_result;   /**< When method is GDF_HASH, 0 = result is not sorted, 1 = result is sorted */
   int flag_sort_inplace;  /**< 0 = No sort in place allowed, 1 = else */
+  int flag_output_sorted; /**< Set by the operation: 1 if its output rows are sorted by its keys, else 0 */
+  int flag_reproducible_sum; /**< 1 = floating point SUM and AVG are compensated and the same from run to run, else 0 */
 } gdf_context;
 
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  An execution context, on which the _async operations are queued
+ * to run asynchronously and in order: a CUDA stream for device columns, or a
+ * pool of host threads for host columns. NULL is the default CUDA stream.
+ */
+/* ----------------------------------------------------------------------------*/
+typedef struct gdf_exec_context_ *gdf_exec_context;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The completion of the operations queued on an execution context
+ * up to some point, to wait for from the caller or from another context.
+ */
+/* ----------------------------------------------------------------------------*/
+typedef struct gdf_exec_event_ *gdf_exec_event;
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Summary statistics of the valid values of a column, computed in
+ * a single pass by gdf_column_stats. Values are accumulated as doubles; the
+ * statistics that need at least one (min, max, mean) or two (variance) valid
+ * values are NaN otherwise.
+ */
+/* ----------------------------------------------------------------------------*/
+typedef struct {
+  gdf_size_type count;      /**< Number of valid rows */
+  gdf_size_type null_count; /**< Number of null rows */
+  double sum;               /**< Sum of the valid values */
+  double sum_squares;       /**< Sum of the squares of the valid values */
+  double min;               /**< Smallest valid value */
+  double max;               /**< Largest valid value */
+  double mean;              /**< Mean of the valid values */
+  double variance;          /**< Sample variance (n - 1 degrees of freedom) of the valid values */
+} gdf_stats;
+
 struct _OpaqueIpcParser;
 typedef struct _OpaqueIpcParser gdf_ipc_parser_type;
 
@@ -176,6 +229,18 @@ struct _OpaqueSegmentedRadixsortPlan;
 typedef struct _OpaqueSegmentedRadixsortPlan gdf_segmented_radixsort_plan_type;
 
 
+struct _OpaqueTDigest;
+typedef struct _OpaqueTDigest gdf_tdigest_type;
+
+
+struct _OpaqueScanPlan;
+typedef struct _OpaqueScanPlan gdf_scan_plan_type;
+
+
+struct _OpaqueHyperLogLog;
+typedef struct _OpaqueHyperLogLog gdf_hll_type;
+
+
 
 
 typedef enum{
@@ -183,6 +248,11 @@ typedef enum{
 	GDF_ORDER_DESC
 } order_by_type;
 
+typedef enum{
+	GDF_NULLS_LAST,
+	GDF_NULLS_FIRST
+} null_order_type;
+
 typedef enum{
 	GDF_EQUALS,
 	GDF_NOT_EQUALS,
@@ -206,3 +276,72 @@ typedef enum{
 	GDF_WINDOW_STDDEV,
 	GDF_WINDOW_VAR //variance
 } window_reduction_type;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Operations of an expression evaluated by gdf_expr_eval. An
+ * expression is an array of nodes in postfix order: the operands of every
+ * operation come before it.
+ */
+/* ----------------------------------------------------------------------------*/
+typedef enum{
+	GDF_EXPR_COLUMN,   /**< Pushes the value of column `column` */
+	GDF_EXPR_INT,      /**< Pushes the integer scalar `ivalue` */
+	GDF_EXPR_FLOAT,    /**< Pushes the floating point scalar `fvalue` */
+	GDF_EXPR_ADD,
+	GDF_EXPR_SUB,
+	GDF_EXPR_MUL,
+	GDF_EXPR_DIV,      /**< True division, always floating point */
+	GDF_EXPR_FLOORDIV, /**< Division rounded towards minus infinity; integer division by 0 gives 0 */
+	GDF_EXPR_NEG,
+	GDF_EXPR_GT,
+	GDF_EXPR_GE,
+	GDF_EXPR_LT,
+	GDF_EXPR_LE,
+	GDF_EXPR_EQ,
+	GDF_EXPR_NE,
+	GDF_EXPR_AND,      /**< Logical and of two values, nonzero being true */
+	GDF_EXPR_OR,
+	GDF_EXPR_NOT,
+	N_GDF_EXPR_OPS     /* additional operations should go BEFORE N_GDF_EXPR_OPS */
+} gdf_expr_op;
+
+typedef struct{
+	gdf_expr_op op;
+	int column;        /**< Column index, for GDF_EXPR_COLUMN */
+	int64_t ivalue;    /**< Scalar, for GDF_EXPR_INT */
+	double fvalue;     /**< Scalar, for GDF_EXPR_FLOAT */
+} gdf_expr_node;
+
+typedef union{
+	int8_t  si08;
+	int16_t si16;
+	int32_t si32;      /**< Also for GDF_DATE32 */
+	int64_t si64;      /**< Also for GDF_DATE64 and GDF_TIMESTAMP */
+	float   fp32;
+	double  fp64;
+} gdf_data;
+
+/* A single value, the operand of a binary operator with a column */
+typedef struct{
+	gdf_data data;
+	gdf_dtype dtype;
+} gdf_scalar;
+
+typedef enum{
+	GDF_BINARY_ADD,
+	GDF_BINARY_SUB,
+	GDF_BINARY_MUL,
+	GDF_BINARY_DIV,          /**< True division, in floating point */
+	GDF_BINARY_FLOORDIV,
+	GDF_BINARY_GT,
+	GDF_BINARY_GE,
+	GDF_BINARY_LT,
+	GDF_BINARY_LE,
+	GDF_BINARY_EQ,
+	GDF_BINARY_NE,
+	GDF_BINARY_BITWISE_AND,
+	GDF_BINARY_BITWISE_OR,
+	GDF_BINARY_BITWISE_XOR,
+	N_GDF_BINARY_OPS         /* additional operators should go BEFORE N_GDF_BINARY_OPS */
+} gdf_binary_operator;
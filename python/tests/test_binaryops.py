@@ -271,3 +271,284 @@ def test_output_dtype_mismatch():
 
 if __name__ == '__main__':
     test_add()
+
+
+# column and scalar
+
+def new_scalar(value, dtype):
+    scalar = ffi.new('gdf_scalar*')
+    field = {
+        np.float64: 'fp64',
+        np.float32: 'fp32',
+        np.int64:   'si64',
+        np.int32:   'si32',
+        np.int16:   'si16',
+        np.int8:    'si08',
+    }[np.dtype(dtype).type]
+    setattr(scalar.data, field, value)
+    scalar.dtype = get_dtype(dtype)
+    return scalar
+
+
+def scalar_op_test(col_dtype, scalar, scalar_dtype, out_dtype, op, expect_fn,
+                   scalar_lhs=False, nelem=128):
+    h_col = gen_rand(col_dtype, nelem)
+    fix_zeros(h_col)
+    d_col = cuda.to_device(h_col)
+    d_result = cuda.device_array(nelem, dtype=out_dtype)
+
+    col = new_column()
+    col_result = new_column()
+    libgdf.gdf_column_view(col, unwrap_devary(d_col), ffi.NULL, nelem,
+                           get_dtype(col_dtype))
+    libgdf.gdf_column_view(col_result, unwrap_devary(d_result), ffi.NULL,
+                           nelem, get_dtype(out_dtype))
+
+    value = new_scalar(scalar, scalar_dtype)
+    if scalar_lhs:
+        libgdf.gdf_binary_op_scalar_column(value, col, col_result, op)
+        expect = expect_fn(np.array(scalar, dtype=scalar_dtype), h_col)
+    else:
+        libgdf.gdf_binary_op_column_scalar(col, value, col_result, op)
+        expect = expect_fn(h_col, np.array(scalar, dtype=scalar_dtype))
+    got = d_result.copy_to_host()
+    print(expect, got)
+    np.testing.assert_array_equal(expect.astype(out_dtype), got)
+
+
+params_scalar_arith = [
+    (np.float64, 1.5, np.float64, np.float64),
+    (np.float32, 2, np.int32, np.float32),
+    (np.int32, 10, np.int64, np.int32),
+    (np.int64, 7, np.int8, np.int64),
+    (np.int32, 1.5, np.float64, np.float64),
+]
+
+@pytest.mark.parametrize('scalar_lhs', [False, True])
+@pytest.mark.parametrize('col_dtype,scalar,scalar_dtype,out_dtype',
+                         params_scalar_arith)
+@pytest.mark.parametrize('op,expect_fn', [
+    (libgdf.GDF_BINARY_ADD, np.add),
+    (libgdf.GDF_BINARY_SUB, np.subtract),
+    (libgdf.GDF_BINARY_MUL, np.multiply),
+    (libgdf.GDF_BINARY_FLOORDIV, np.floor_divide),
+])
+def test_scalar_arith(col_dtype, scalar, scalar_dtype, out_dtype, op,
+                      expect_fn, scalar_lhs):
+    scalar_op_test(col_dtype, scalar, scalar_dtype, out_dtype, op,
+                   lambda x, y: expect_fn(x.astype(out_dtype),
+                                          y.astype(out_dtype)),
+                   scalar_lhs=scalar_lhs)
+
+
+@pytest.mark.parametrize('scalar_lhs', [False, True])
+def test_scalar_div_promotes(scalar_lhs):
+    scalar_op_test(np.int32, 4, np.int32, np.float64, libgdf.GDF_BINARY_DIV,
+                   lambda x, y: np.divide(x.astype(np.float64),
+                                          y.astype(np.float64)),
+                   scalar_lhs=scalar_lhs)
+
+
+@pytest.mark.parametrize('scalar_lhs', [False, True])
+@pytest.mark.parametrize('col_dtype,scalar,scalar_dtype', [
+    (np.float64, 0.25, np.float64),
+    (np.int32, 100, np.int32),
+    (np.int64, 2.5, np.float64),
+])
+@pytest.mark.parametrize('op,expect_fn', [
+    (libgdf.GDF_BINARY_GT, np.greater),
+    (libgdf.GDF_BINARY_GE, np.greater_equal),
+    (libgdf.GDF_BINARY_LT, np.less),
+    (libgdf.GDF_BINARY_LE, np.less_equal),
+    (libgdf.GDF_BINARY_EQ, np.equal),
+    (libgdf.GDF_BINARY_NE, np.not_equal),
+])
+def test_scalar_comparison(col_dtype, scalar, scalar_dtype, op, expect_fn,
+                           scalar_lhs):
+    scalar_op_test(col_dtype, scalar, scalar_dtype, np.int8, op, expect_fn,
+                   scalar_lhs=scalar_lhs)
+
+
+@pytest.mark.parametrize('scalar_lhs', [False, True])
+@pytest.mark.parametrize('col_dtype,scalar,scalar_dtype', [
+    (np.int8, 300, np.int32),
+    (np.int8, -200, np.int16),
+    (np.int16, 100000, np.int64),
+    (np.int32, -(1 << 40), np.int64),
+])
+@pytest.mark.parametrize('op,expect_fn', [
+    (libgdf.GDF_BINARY_GT, np.greater),
+    (libgdf.GDF_BINARY_LT, np.less),
+    (libgdf.GDF_BINARY_EQ, np.equal),
+    (libgdf.GDF_BINARY_NE, np.not_equal),
+])
+def test_scalar_comparison_out_of_range(col_dtype, scalar, scalar_dtype, op,
+                                        expect_fn, scalar_lhs):
+    # Compared in the promoted type, not to the scalar wrapped to the column
+    scalar_op_test(col_dtype, scalar, scalar_dtype, np.int8, op, expect_fn,
+                   scalar_lhs=scalar_lhs)
+
+
+@pytest.mark.parametrize('scalar_lhs', [False, True])
+@pytest.mark.parametrize('col_dtype,scalar,scalar_dtype', [
+    (np.int8, 300, np.int32),
+    (np.int16, 100000, np.int64),
+    (np.int32, 1 << 40, np.int64),
+])
+@pytest.mark.parametrize('op,expect_fn', [
+    (libgdf.GDF_BINARY_ADD, np.add),
+    (libgdf.GDF_BINARY_SUB, np.subtract),
+])
+def test_scalar_arith_out_of_range_promotes(col_dtype, scalar, scalar_dtype,
+                                            op, expect_fn, scalar_lhs):
+    # A scalar out of the range of the column gives the promoted type
+    scalar_op_test(col_dtype, scalar, scalar_dtype, scalar_dtype, op,
+                   lambda x, y: expect_fn(x.astype(scalar_dtype),
+                                          y.astype(scalar_dtype)),
+                   scalar_lhs=scalar_lhs)
+
+
+@pytest.mark.parametrize('scalar_lhs', [False, True])
+@pytest.mark.parametrize('dtype', params_bitwise_types)
+@pytest.mark.parametrize('op,expect_fn', [
+    (libgdf.GDF_BINARY_BITWISE_AND, np.bitwise_and),
+    (libgdf.GDF_BINARY_BITWISE_OR, np.bitwise_or),
+    (libgdf.GDF_BINARY_BITWISE_XOR, np.bitwise_xor),
+])
+def test_scalar_bitwise(dtype, op, expect_fn, scalar_lhs):
+    scalar_op_test(dtype, 0x5a, dtype, dtype, op, expect_fn,
+                   scalar_lhs=scalar_lhs)
+
+
+def test_scalar_bitwise_on_floats_unsupported():
+    col = new_column()
+    col_result = new_column()
+    d_col = cuda.to_device(gen_rand(np.float64, 8))
+    d_result = cuda.device_array(8, dtype=np.float64)
+    libgdf.gdf_column_view(col, unwrap_devary(d_col), ffi.NULL, 8,
+                           libgdf.GDF_FLOAT64)
+    libgdf.gdf_column_view(col_result, unwrap_devary(d_result), ffi.NULL, 8,
+                           libgdf.GDF_FLOAT64)
+    with pytest.raises(GDFError) as raises:
+        libgdf.gdf_binary_op_column_scalar(col, new_scalar(1.0, np.float64),
+                                           col_result,
+                                           libgdf.GDF_BINARY_BITWISE_AND)
+    raises.match("GDF_UNSUPPORTED_DTYPE")
+
+
+# mixed types
+
+def mixed_op_test(lhs_dtype, rhs_dtype, out_dtype, op, expect_fn, nelem=128,
+                  lhs_gdf_dtype=None, rhs_gdf_dtype=None, out_gdf_dtype=None):
+    h_lhs = gen_rand(lhs_dtype, nelem, low=-100, high=100)
+    h_rhs = gen_rand(rhs_dtype, nelem, low=-100, high=100)
+    fix_zeros(h_rhs)
+    d_lhs = cuda.to_device(h_lhs)
+    d_rhs = cuda.to_device(h_rhs)
+    d_result = cuda.device_array(nelem, dtype=out_dtype)
+
+    col_lhs = new_column()
+    col_rhs = new_column()
+    col_result = new_column()
+    libgdf.gdf_column_view(col_lhs, unwrap_devary(d_lhs), ffi.NULL, nelem,
+                           lhs_gdf_dtype or get_dtype(lhs_dtype))
+    libgdf.gdf_column_view(col_rhs, unwrap_devary(d_rhs), ffi.NULL, nelem,
+                           rhs_gdf_dtype or get_dtype(rhs_dtype))
+    libgdf.gdf_column_view(col_result, unwrap_devary(d_result), ffi.NULL,
+                           nelem, out_gdf_dtype or get_dtype(out_dtype))
+
+    libgdf.gdf_binary_op(col_lhs, col_rhs, col_result, op)
+    expect = expect_fn(h_lhs, h_rhs).astype(out_dtype)
+    got = d_result.copy_to_host()
+    print(expect, got)
+    np.testing.assert_array_equal(expect, got)
+
+
+params_promotion = [
+    (np.int8, np.int32, np.int32),
+    (np.int16, np.int64, np.int64),
+    (np.int32, np.int8, np.int32),
+    (np.int8, np.float32, np.float32),
+    (np.int32, np.float32, np.float64),
+    (np.float32, np.int64, np.float64),
+    (np.float32, np.float64, np.float64),
+    (np.int64, np.float64, np.float64),
+]
+
+@pytest.mark.parametrize('lhs_dtype,rhs_dtype,out_dtype', params_promotion)
+@pytest.mark.parametrize('op,expect_fn', [
+    (libgdf.GDF_BINARY_ADD, np.add),
+    (libgdf.GDF_BINARY_SUB, np.subtract),
+    (libgdf.GDF_BINARY_MUL, np.multiply),
+    (libgdf.GDF_BINARY_FLOORDIV, np.floor_divide),
+])
+def test_mixed_arith(lhs_dtype, rhs_dtype, out_dtype, op, expect_fn):
+    assert np.result_type(lhs_dtype, rhs_dtype) == out_dtype
+    mixed_op_test(lhs_dtype, rhs_dtype, out_dtype, op, expect_fn)
+
+
+@pytest.mark.parametrize('lhs_dtype,rhs_dtype', [
+    (np.int32, np.int64),
+    (np.int8, np.int16),
+    (np.float32, np.int32),
+])
+def test_mixed_div(lhs_dtype, rhs_dtype):
+    mixed_op_test(lhs_dtype, rhs_dtype, np.float64, libgdf.GDF_BINARY_DIV,
+                  lambda x, y: np.divide(x.astype(np.float64),
+                                         y.astype(np.float64)))
+
+
+@pytest.mark.parametrize('lhs_dtype,rhs_dtype', [
+    (np.int32, np.float64),
+    (np.int8, np.int64),
+    (np.float32, np.int16),
+])
+@pytest.mark.parametrize('op,expect_fn', [
+    (libgdf.GDF_BINARY_GT, np.greater),
+    (libgdf.GDF_BINARY_LE, np.less_equal),
+    (libgdf.GDF_BINARY_EQ, np.equal),
+])
+def test_mixed_comparison(lhs_dtype, rhs_dtype, op, expect_fn):
+    mixed_op_test(lhs_dtype, rhs_dtype, np.int8, op, expect_fn)
+
+
+def test_mixed_bitwise():
+    mixed_op_test(np.int8, np.int32, np.int32, libgdf.GDF_BINARY_BITWISE_OR,
+                  np.bitwise_or)
+
+
+@pytest.mark.parametrize('date_dtype,gdf_date_dtype,duration_dtype', [
+    (np.int32, libgdf.GDF_DATE32, np.int16),
+    (np.int32, libgdf.GDF_DATE32, np.int64),
+    (np.int64, libgdf.GDF_DATE64, np.int32),
+    (np.int64, libgdf.GDF_TIMESTAMP, np.int64),
+])
+def test_date_plus_duration(date_dtype, gdf_date_dtype, duration_dtype):
+    mixed_op_test(date_dtype, duration_dtype, date_dtype,
+                  libgdf.GDF_BINARY_ADD, np.add,
+                  lhs_gdf_dtype=gdf_date_dtype, out_gdf_dtype=gdf_date_dtype)
+    mixed_op_test(duration_dtype, date_dtype, date_dtype,
+                  libgdf.GDF_BINARY_ADD, np.add,
+                  rhs_gdf_dtype=gdf_date_dtype, out_gdf_dtype=gdf_date_dtype)
+    mixed_op_test(date_dtype, duration_dtype, date_dtype,
+                  libgdf.GDF_BINARY_SUB, np.subtract,
+                  lhs_gdf_dtype=gdf_date_dtype, out_gdf_dtype=gdf_date_dtype)
+
+
+def test_date_minus_date():
+    mixed_op_test(np.int32, np.int32, np.int32, libgdf.GDF_BINARY_SUB,
+                  np.subtract, lhs_gdf_dtype=libgdf.GDF_DATE32,
+                  rhs_gdf_dtype=libgdf.GDF_DATE32)
+
+
+def test_date_operands_unsupported():
+    with pytest.raises(GDFError) as raises:
+        mixed_op_test(np.int32, np.int32, np.int32, libgdf.GDF_BINARY_ADD,
+                      np.add, lhs_gdf_dtype=libgdf.GDF_DATE32,
+                      rhs_gdf_dtype=libgdf.GDF_DATE32)
+    raises.match("GDF_UNSUPPORTED_DTYPE")
+    with pytest.raises(GDFError) as raises:
+        mixed_op_test(np.int32, np.float64, np.int32, libgdf.GDF_BINARY_ADD,
+                      np.add, lhs_gdf_dtype=libgdf.GDF_DATE32,
+                      out_gdf_dtype=libgdf.GDF_DATE32)
+    raises.match("GDF_UNSUPPORTED_DTYPE")
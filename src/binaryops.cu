@@ -1,15 +1,20 @@
 #include <algorithm>
+#include <type_traits>
+
+#include <thrust/iterator/constant_iterator.h>
 
 #include <gdf/gdf.h>
 #include <gdf/utils.h>
 #include <gdf/errorutils.h>
 #include "nvtx_utils.h"
+#include "util/type_promotion.h"
+#include "util/exec_context.h"
 
 
-template<typename T, typename Tout, typename F>
+template<typename LhsIterator, typename RhsIterator, typename Tout, typename F>
 __global__
-void gpu_binary_op(const T *lhs_data, const gdf_valid_type *lhs_valid,
-                   const T *rhs_data, const gdf_valid_type *rhs_valid,
+void gpu_binary_op(LhsIterator lhs_data, const gdf_valid_type *lhs_valid,
+                   RhsIterator rhs_data, const gdf_valid_type *rhs_valid,
                    gdf_size_type size, Tout *results, F functor) {
     int tid = threadIdx.x;
     int blkid = blockIdx.x;
@@ -30,6 +35,42 @@ void gpu_binary_op(const T *lhs_data, const gdf_valid_type *lhs_valid,
     }
 }
 
+// Either operand may be a column or a constant iterator over a scalar. The
+// kernel is only queued on the stream: callers synchronize when they need to
+template<typename Tout, typename F, typename LhsIterator, typename RhsIterator>
+gdf_error launch_binary_op(LhsIterator lhs_data, const gdf_valid_type *lhs_valid,
+                           RhsIterator rhs_data, const gdf_valid_type *rhs_valid,
+                           gdf_size_type size, gdf_column *output,
+                           cudaStream_t stream = 0) {
+    PUSH_RANGE("LIBGDF_BINARY_OP", BINARY_OP_COLOR);
+    // find optimal blocksize
+    int mingridsize, blocksize;
+    CUDA_TRY(
+        cudaOccupancyMaxPotentialBlockSize(&mingridsize, &blocksize,
+                                           gpu_binary_op<LhsIterator, RhsIterator, Tout, F>)
+    );
+    // find needed gridsize
+    int neededgridsize = (size + blocksize - 1) / blocksize;
+    int gridsize = std::min(mingridsize, neededgridsize);
+
+    F functor;
+    gpu_binary_op<<<gridsize, blocksize, 0, stream>>>(
+        // inputs
+        lhs_data, lhs_valid,
+        rhs_data, rhs_valid,
+        size,
+        // output
+        (Tout*)output->data,
+        // action
+        functor
+    );
+
+    POP_RANGE();
+
+    CUDA_CHECK_LAST();
+    return GDF_SUCCESS;
+}
+
 template<typename T, typename Tout, typename F>
 struct BinaryOp {
     static
@@ -44,35 +85,9 @@ struct BinaryOp {
         GDF_REQUIRE(lhs->size == output->size, GDF_COLUMN_SIZE_MISMATCH);
         GDF_REQUIRE(lhs->dtype == rhs->dtype, GDF_UNSUPPORTED_DTYPE);
 
-        PUSH_RANGE("LIBGDF_BINARY_OP", BINARY_OP_COLOR);
-        // find optimal blocksize
-        int mingridsize, blocksize;
-        CUDA_TRY(
-            cudaOccupancyMaxPotentialBlockSize(&mingridsize, &blocksize,
-                                               gpu_binary_op<T, Tout, F>)
-        );
-        // find needed gridsize
-        int neededgridsize = (lhs->size + blocksize - 1) / blocksize;
-        int gridsize = std::min(mingridsize, neededgridsize);
-
-        F functor;
-        gpu_binary_op<<<gridsize, blocksize>>>(
-            // inputs
-            (const T*)lhs->data, lhs->valid,
-            (const T*)rhs->data, rhs->valid,
-            lhs->size,
-            // output
-            (Tout*)output->data,
-            // action
-            functor
-        );
-
-        cudaDeviceSynchronize();
-
-        POP_RANGE();
-
-        CUDA_CHECK_LAST();
-        return GDF_SUCCESS;
+        return launch_binary_op<Tout, F>((const T*)lhs->data, lhs->valid,
+                                         (const T*)rhs->data, rhs->valid,
+                                         lhs->size, output);
     }
 };
 
@@ -505,6 +520,367 @@ DEF_BITWISE_IMPL_GROUP(or, DeviceBitwiseOr)
 DEF_BITWISE_IMPL_GROUP(xor, DeviceBitwiseXor)
 
 
+// operators with a scalar operand
+
+
+namespace {
+
+bool is_integral_dtype(gdf_dtype dtype) {
+    switch ( dtype ) {
+    case GDF_INT8:
+    case GDF_INT16:
+    case GDF_INT32:
+    case GDF_INT64:
+    case GDF_DATE32:
+    case GDF_DATE64:
+    case GDF_TIMESTAMP: return true;
+    default: return false;
+    }
+}
+
+bool is_numeric_dtype(gdf_dtype dtype) {
+    return is_integral_dtype(dtype) || GDF_FLOAT32 == dtype || GDF_FLOAT64 == dtype;
+}
+
+template<typename T> gdf_dtype dtype_of();
+template<> gdf_dtype dtype_of<int8_t>()  { return GDF_INT8; }
+template<> gdf_dtype dtype_of<int16_t>() { return GDF_INT16; }
+template<> gdf_dtype dtype_of<int32_t>() { return GDF_INT32; }
+template<> gdf_dtype dtype_of<int64_t>() { return GDF_INT64; }
+template<> gdf_dtype dtype_of<float>()   { return GDF_FLOAT32; }
+template<> gdf_dtype dtype_of<double>()  { return GDF_FLOAT64; }
+
+template<typename T>
+struct FloorDivOf {
+    typedef typename std::conditional<std::is_floating_point<T>::value,
+                                      DeviceFloorDivReal<T>,
+                                      DeviceFloorDivInt<T> >::type type;
+};
+
+template<typename T, bool integral = std::is_integral<T>::value>
+struct BitwiseOperator {
+    template<typename LhsIterator, typename RhsIterator>
+    static
+    gdf_error launch(gdf_binary_operator op,
+                     LhsIterator lhs, const gdf_valid_type *lhs_valid,
+                     RhsIterator rhs, const gdf_valid_type *rhs_valid,
+                     gdf_size_type size, gdf_column *output, cudaStream_t stream) {
+        switch ( op ) {
+        case GDF_BINARY_BITWISE_AND: return launch_binary_op<T, DeviceBitwiseAnd<T> >(lhs, lhs_valid, rhs, rhs_valid, size, output, stream);
+        case GDF_BINARY_BITWISE_OR:  return launch_binary_op<T, DeviceBitwiseOr<T> >(lhs, lhs_valid, rhs, rhs_valid, size, output, stream);
+        case GDF_BINARY_BITWISE_XOR: return launch_binary_op<T, DeviceBitwiseXor<T> >(lhs, lhs_valid, rhs, rhs_valid, size, output, stream);
+        default: return GDF_INVALID_API_CALL;
+        }
+    }
+};
+
+// No bitwise operators on floating point
+template<typename T>
+struct BitwiseOperator<T, false> {
+    template<typename LhsIterator, typename RhsIterator>
+    static
+    gdf_error launch(gdf_binary_operator, LhsIterator, const gdf_valid_type *,
+                     RhsIterator, const gdf_valid_type *, gdf_size_type, gdf_column *, cudaStream_t) {
+        return GDF_UNSUPPORTED_DTYPE;
+    }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Applies a binary operator to two operands, both converted to T:
+ * arithmetic and bitwise operators give a T of dtype `result_dtype`, and
+ * comparisons a GDF_INT8.
+ */
+/* ----------------------------------------------------------------------------*/
+template<typename T, typename LhsIterator, typename RhsIterator>
+gdf_error apply_binary_operator(gdf_binary_operator op,
+                                LhsIterator lhs, const gdf_valid_type *lhs_valid,
+                                RhsIterator rhs, const gdf_valid_type *rhs_valid,
+                                gdf_size_type size, gdf_dtype result_dtype,
+                                gdf_column *output, cudaStream_t stream) {
+    const bool comparison = op >= GDF_BINARY_GT && op <= GDF_BINARY_NE;
+    GDF_REQUIRE(output->size == size, GDF_COLUMN_SIZE_MISMATCH);
+    GDF_REQUIRE(output->dtype == (comparison ? GDF_INT8 : result_dtype), GDF_UNSUPPORTED_DTYPE);
+
+    switch ( op ) {
+    case GDF_BINARY_ADD:      return launch_binary_op<T, DeviceAdd<T> >(lhs, lhs_valid, rhs, rhs_valid, size, output, stream);
+    case GDF_BINARY_SUB:      return launch_binary_op<T, DeviceSub<T> >(lhs, lhs_valid, rhs, rhs_valid, size, output, stream);
+    case GDF_BINARY_MUL:      return launch_binary_op<T, DeviceMul<T> >(lhs, lhs_valid, rhs, rhs_valid, size, output, stream);
+    case GDF_BINARY_DIV:      return launch_binary_op<T, DeviceDiv<T> >(lhs, lhs_valid, rhs, rhs_valid, size, output, stream);
+    case GDF_BINARY_FLOORDIV: return launch_binary_op<T, typename FloorDivOf<T>::type>(lhs, lhs_valid, rhs, rhs_valid, size, output, stream);
+    case GDF_BINARY_GT:       return launch_binary_op<int8_t, DeviceGt<T> >(lhs, lhs_valid, rhs, rhs_valid, size, output, stream);
+    case GDF_BINARY_GE:       return launch_binary_op<int8_t, DeviceGe<T> >(lhs, lhs_valid, rhs, rhs_valid, size, output, stream);
+    case GDF_BINARY_LT:       return launch_binary_op<int8_t, DeviceLt<T> >(lhs, lhs_valid, rhs, rhs_valid, size, output, stream);
+    case GDF_BINARY_LE:       return launch_binary_op<int8_t, DeviceLe<T> >(lhs, lhs_valid, rhs, rhs_valid, size, output, stream);
+    case GDF_BINARY_EQ:       return launch_binary_op<int8_t, DeviceEq<T> >(lhs, lhs_valid, rhs, rhs_valid, size, output, stream);
+    case GDF_BINARY_NE:       return launch_binary_op<int8_t, DeviceNe<T> >(lhs, lhs_valid, rhs, rhs_valid, size, output, stream);
+    case GDF_BINARY_BITWISE_AND:
+    case GDF_BINARY_BITWISE_OR:
+    case GDF_BINARY_BITWISE_XOR:
+        return BitwiseOperator<T>::launch(op, lhs, lhs_valid, rhs, rhs_valid, size, output, stream);
+    default: return GDF_INVALID_API_CALL;
+    }
+}
+
+// Applies a binary operator to a column of T and a scalar, both in the type C
+template<typename C, typename T>
+gdf_error column_scalar_op_as(gdf_column *col, C scalar, bool scalar_lhs, gdf_dtype result_dtype,
+                              gdf_column *output, gdf_binary_operator op, cudaStream_t stream) {
+    const T *data = static_cast<const T*>(col->data);
+    thrust::constant_iterator<C> value(scalar);
+    if ( scalar_lhs )
+        return apply_binary_operator<C>(op, value, nullptr, data, col->valid,
+                                        col->size, result_dtype, output, stream);
+    return apply_binary_operator<C>(op, data, col->valid, value, nullptr,
+                                    col->size, result_dtype, output, stream);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Applies a binary operator to a column of T and a scalar, read
+ * through a constant iterator rather than from a filled column.
+ *
+ * The scalar takes the type of the column, except that a floating point
+ * scalar, or a true division, promotes an integer column to double; an
+ * integer column is compared with an integer scalar in their promoted type,
+ * and so is it computed with one out of its range, giving a column of the
+ * promoted type: an int8 column is never compared to or added a wrapped
+ * value.
+ */
+/* ----------------------------------------------------------------------------*/
+template<typename T>
+struct column_scalar_op {
+    gdf_column *col;
+    bool scalar_lhs;
+    gdf_column *output;
+    gdf_binary_operator op;
+    cudaStream_t stream;
+
+    template<typename S>
+    gdf_error operator()(S scalar) const {
+        typedef typename gdf::util::PromotedType<T, S>::type Promoted;
+
+        const bool comparison = op >= GDF_BINARY_GT && op <= GDF_BINARY_NE;
+        if ( std::is_integral<T>::value &&
+             (std::is_floating_point<S>::value || GDF_BINARY_DIV == op) )
+            return column_scalar_op_as<double, T>(col, static_cast<double>(scalar), scalar_lhs,
+                                                  GDF_FLOAT64, output, op, stream);
+        if ( std::is_integral<T>::value &&
+             (comparison || !gdf::util::scalar_fits<T>(scalar)) )
+            return column_scalar_op_as<Promoted, T>(col, static_cast<Promoted>(scalar), scalar_lhs,
+                                                    dtype_of<Promoted>(), output, op, stream);
+        return column_scalar_op_as<T, T>(col, static_cast<T>(scalar), scalar_lhs,
+                                         col->dtype, output, op, stream);
+    }
+};
+
+template<typename T>
+gdf_error column_scalar_op_dispatch(gdf_column *col, const gdf_scalar &scalar, bool scalar_lhs,
+                                    gdf_column *output, gdf_binary_operator op,
+                                    cudaStream_t stream) {
+    column_scalar_op<T> f{col, scalar_lhs, output, op, stream};
+    return gdf::util::scalar_dispatch(scalar, f);
+}
+
+gdf_error column_scalar_op_generic(gdf_column *col, const gdf_scalar *scalar, bool scalar_lhs,
+                                   gdf_column *output, gdf_binary_operator op,
+                                   cudaStream_t stream = 0) {
+    GDF_REQUIRE(nullptr != col && nullptr != scalar && nullptr != output, GDF_DATASET_EMPTY);
+    GDF_REQUIRE(is_numeric_dtype(scalar->dtype), GDF_UNSUPPORTED_DTYPE);
+
+    // Return successully right away for empty inputs
+    if ( 0 == col->size ) {
+        return GDF_SUCCESS;
+    }
+
+    switch ( col->dtype ) {
+    case GDF_INT8:      return column_scalar_op_dispatch<int8_t>(col, *scalar, scalar_lhs, output, op, stream);
+    case GDF_INT16:     return column_scalar_op_dispatch<int16_t>(col, *scalar, scalar_lhs, output, op, stream);
+    case GDF_INT32:
+    case GDF_DATE32:    return column_scalar_op_dispatch<int32_t>(col, *scalar, scalar_lhs, output, op, stream);
+    case GDF_INT64:
+    case GDF_DATE64:
+    case GDF_TIMESTAMP: return column_scalar_op_dispatch<int64_t>(col, *scalar, scalar_lhs, output, op, stream);
+    case GDF_FLOAT32:   return column_scalar_op_dispatch<float>(col, *scalar, scalar_lhs, output, op, stream);
+    case GDF_FLOAT64:   return column_scalar_op_dispatch<double>(col, *scalar, scalar_lhs, output, op, stream);
+    default: return GDF_UNSUPPORTED_DTYPE;
+    }
+}
+
+
+// operators on two columns of different types
+
+
+// Date and timestamp plus or minus an integer duration, in the unit of the date
+template<typename L, typename R,
+         bool integral = std::is_integral<L>::value && std::is_integral<R>::value>
+struct DateArithmetic {
+    template<typename Tdate>
+    static
+    gdf_error launch(gdf_binary_operator op, gdf_column *lhs, gdf_column *rhs, gdf_column *output,
+                     cudaStream_t stream) {
+        typedef typename gdf::util::PromotedType<L, R>::type T;
+        const L *lhs_data = static_cast<const L*>(lhs->data);
+        const R *rhs_data = static_cast<const R*>(rhs->data);
+        switch ( op ) {
+        case GDF_BINARY_ADD: return launch_binary_op<Tdate, DeviceAdd<T> >(lhs_data, lhs->valid, rhs_data, rhs->valid, lhs->size, output, stream);
+        case GDF_BINARY_SUB: return launch_binary_op<Tdate, DeviceSub<T> >(lhs_data, lhs->valid, rhs_data, rhs->valid, lhs->size, output, stream);
+        default: return GDF_UNSUPPORTED_DTYPE;
+        }
+    }
+};
+
+template<typename L, typename R>
+struct DateArithmetic<L, R, false> {
+    template<typename Tdate>
+    static
+    gdf_error launch(gdf_binary_operator, gdf_column *, gdf_column *, gdf_column *, cudaStream_t) {
+        return GDF_UNSUPPORTED_DTYPE;
+    }
+};
+
+template<typename L, typename R>
+gdf_error mixed_binary_op(gdf_column *lhs, gdf_column *rhs, gdf_column *output,
+                          gdf_binary_operator op, gdf_dtype date_dtype, cudaStream_t stream) {
+    const L *lhs_data = static_cast<const L*>(lhs->data);
+    const R *rhs_data = static_cast<const R*>(rhs->data);
+
+    if ( GDF_invalid != date_dtype ) {
+        GDF_REQUIRE(output->dtype == date_dtype, GDF_UNSUPPORTED_DTYPE);
+        GDF_REQUIRE(output->size == lhs->size, GDF_COLUMN_SIZE_MISMATCH);
+        if ( GDF_DATE32 == date_dtype )
+            return DateArithmetic<L, R>::template launch<int32_t>(op, lhs, rhs, output, stream);
+        return DateArithmetic<L, R>::template launch<int64_t>(op, lhs, rhs, output, stream);
+    }
+
+    if ( GDF_BINARY_DIV == op ) {
+        typedef typename gdf::util::PromotedType<L, R>::division T;
+        GDF_REQUIRE(output->dtype == dtype_of<T>(), GDF_UNSUPPORTED_DTYPE);
+        GDF_REQUIRE(output->size == lhs->size, GDF_COLUMN_SIZE_MISMATCH);
+        return launch_binary_op<T, DeviceDiv<T> >(lhs_data, lhs->valid, rhs_data, rhs->valid,
+                                                  lhs->size, output, stream);
+    }
+
+    typedef typename gdf::util::PromotedType<L, R>::type T;
+    return apply_binary_operator<T>(op, lhs_data, lhs->valid, rhs_data, rhs->valid,
+                                    lhs->size, dtype_of<T>(), output, stream);
+}
+
+template<typename L>
+gdf_error mixed_binary_op_rhs(gdf_column *lhs, gdf_column *rhs, gdf_column *output,
+                              gdf_binary_operator op, gdf_dtype date_dtype, cudaStream_t stream) {
+    switch ( rhs->dtype ) {
+    case GDF_INT8:      return mixed_binary_op<L, int8_t>(lhs, rhs, output, op, date_dtype, stream);
+    case GDF_INT16:     return mixed_binary_op<L, int16_t>(lhs, rhs, output, op, date_dtype, stream);
+    case GDF_INT32:
+    case GDF_DATE32:    return mixed_binary_op<L, int32_t>(lhs, rhs, output, op, date_dtype, stream);
+    case GDF_INT64:
+    case GDF_DATE64:
+    case GDF_TIMESTAMP: return mixed_binary_op<L, int64_t>(lhs, rhs, output, op, date_dtype, stream);
+    case GDF_FLOAT32:   return mixed_binary_op<L, float>(lhs, rhs, output, op, date_dtype, stream);
+    case GDF_FLOAT64:   return mixed_binary_op<L, double>(lhs, rhs, output, op, date_dtype, stream);
+    default: return GDF_UNSUPPORTED_DTYPE;
+    }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Checks the operands of an operator involving dates and
+ * timestamps, and finds whether it is date arithmetic.
+ *
+ * Dates compare with, and subtract into a duration from, dates of the same
+ * type and unit; an integer duration, in the unit of the date, can be added
+ * to or subtracted from a date, giving a date (`date_dtype`).
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error check_date_operands(gdf_column *lhs, gdf_column *rhs, gdf_binary_operator op,
+                              gdf_dtype *date_dtype) {
+    *date_dtype = GDF_invalid;
+    const bool lhs_date = gdf::util::is_date_dtype(lhs->dtype);
+    const bool rhs_date = gdf::util::is_date_dtype(rhs->dtype);
+    if ( !lhs_date && !rhs_date )
+        return GDF_SUCCESS;
+
+    const bool comparison = op >= GDF_BINARY_GT && op <= GDF_BINARY_NE;
+    if ( lhs_date && rhs_date ) {
+        GDF_REQUIRE(comparison || GDF_BINARY_SUB == op, GDF_UNSUPPORTED_DTYPE);
+        GDF_REQUIRE(lhs->dtype == rhs->dtype, GDF_DTYPE_MISMATCH);
+        GDF_REQUIRE(GDF_TIMESTAMP != lhs->dtype ||
+                    lhs->dtype_info.time_unit == rhs->dtype_info.time_unit, GDF_DTYPE_MISMATCH);
+        return GDF_SUCCESS;
+    }
+
+    // A date and a duration
+    gdf_column *duration = lhs_date ? rhs : lhs;
+    GDF_REQUIRE(is_integral_dtype(duration->dtype), GDF_UNSUPPORTED_DTYPE);
+    GDF_REQUIRE(GDF_BINARY_ADD == op || (GDF_BINARY_SUB == op && lhs_date), GDF_UNSUPPORTED_DTYPE);
+    *date_dtype = lhs_date ? lhs->dtype : rhs->dtype;
+    return GDF_SUCCESS;
+}
+
+} // namespace
+
+gdf_error gdf_binary_op_column_scalar(gdf_column *lhs, const gdf_scalar *rhs,
+                                      gdf_column *output, gdf_binary_operator op) {
+    return column_scalar_op_generic(lhs, rhs, false, output, op);
+}
+
+gdf_error gdf_binary_op_scalar_column(const gdf_scalar *lhs, gdf_column *rhs,
+                                      gdf_column *output, gdf_binary_operator op) {
+    return column_scalar_op_generic(rhs, lhs, true, output, op);
+}
+
+gdf_error gdf_binary_op_column_scalar_async(gdf_column *lhs, const gdf_scalar *rhs,
+                                            gdf_column *output, gdf_binary_operator op,
+                                            gdf_exec_context context) {
+    GDF_REQUIRE(nullptr == gdf::util::exec_host(context), GDF_UNSUPPORTED_METHOD);
+    return column_scalar_op_generic(lhs, rhs, false, output, op, gdf::util::exec_stream(context));
+}
+
+gdf_error gdf_binary_op_scalar_column_async(const gdf_scalar *lhs, gdf_column *rhs,
+                                            gdf_column *output, gdf_binary_operator op,
+                                            gdf_exec_context context) {
+    GDF_REQUIRE(nullptr == gdf::util::exec_host(context), GDF_UNSUPPORTED_METHOD);
+    return column_scalar_op_generic(rhs, lhs, true, output, op, gdf::util::exec_stream(context));
+}
+
+
+gdf_error gdf_binary_op(gdf_column *lhs, gdf_column *rhs, gdf_column *output,
+                        gdf_binary_operator op) {
+    return gdf_binary_op_async(lhs, rhs, output, op, nullptr);
+}
+
+gdf_error gdf_binary_op_async(gdf_column *lhs, gdf_column *rhs, gdf_column *output,
+                              gdf_binary_operator op, gdf_exec_context context) {
+    GDF_REQUIRE(nullptr != lhs && nullptr != rhs && nullptr != output, GDF_DATASET_EMPTY);
+    GDF_REQUIRE(nullptr == gdf::util::exec_host(context), GDF_UNSUPPORTED_METHOD);
+    const cudaStream_t stream = gdf::util::exec_stream(context);
+
+    // Return successully right away for empty inputs
+    if ( (0 == lhs->size) || (0 == rhs->size) ) {
+        return GDF_SUCCESS;
+    }
+    GDF_REQUIRE(lhs->size == rhs->size, GDF_COLUMN_SIZE_MISMATCH);
+
+    gdf_dtype date_dtype;
+    gdf_error status = check_date_operands(lhs, rhs, op, &date_dtype);
+    if ( GDF_SUCCESS != status )
+        return status;
+
+    switch ( lhs->dtype ) {
+    case GDF_INT8:      return mixed_binary_op_rhs<int8_t>(lhs, rhs, output, op, date_dtype, stream);
+    case GDF_INT16:     return mixed_binary_op_rhs<int16_t>(lhs, rhs, output, op, date_dtype, stream);
+    case GDF_INT32:
+    case GDF_DATE32:    return mixed_binary_op_rhs<int32_t>(lhs, rhs, output, op, date_dtype, stream);
+    case GDF_INT64:
+    case GDF_DATE64:
+    case GDF_TIMESTAMP: return mixed_binary_op_rhs<int64_t>(lhs, rhs, output, op, date_dtype, stream);
+    case GDF_FLOAT32:   return mixed_binary_op_rhs<float>(lhs, rhs, output, op, date_dtype, stream);
+    case GDF_FLOAT64:   return mixed_binary_op_rhs<double>(lhs, rhs, output, op, date_dtype, stream);
+    default: return GDF_UNSUPPORTED_DTYPE;
+    }
+}
+
 // validity
 
 gdf_column gdf_validity_column(const gdf_column &col) {
@@ -5,5 +5,7 @@ gdf_error gdf_context_view(gdf_context *context, int flag_sorted, gdf_method fla
     context->flag_sorted   = flag_sorted;
     context->flag_method   = flag_method;
     context->flag_distinct = flag_distinct;
+    context->flag_output_sorted = 0;
+    context->flag_reproducible_sum = 0;
     return GDF_SUCCESS;
 }
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Execution contexts, on which operations run asynchronously, and the events
+//that mark their completion
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+#include <gdf/cffi/functions.h>
+
+#include <chrono>
+
+#include "util/exec_context.h"
+
+gdf_error gdf_exec_context_create(gdf_exec_context *context){
+	GDF_REQUIRE(nullptr != context, GDF_DATASET_EMPTY);
+
+	std::unique_ptr<gdf_exec_context_> created(new gdf_exec_context_);
+	CUDA_TRY( cudaStreamCreateWithFlags(&created->stream, cudaStreamNonBlocking) );
+	created->owns_stream = true;
+	*context = created.release();
+	return GDF_SUCCESS;
+}
+
+gdf_error gdf_exec_context_create_from_stream(gdf_exec_context *context, void *stream){
+	GDF_REQUIRE(nullptr != context, GDF_DATASET_EMPTY);
+
+	gdf_exec_context_ *created = new gdf_exec_context_;
+	created->stream = static_cast<cudaStream_t>(stream);
+	*context = created;
+	return GDF_SUCCESS;
+}
+
+gdf_error gdf_exec_context_create_host(gdf_exec_context *context, int num_threads){
+	GDF_REQUIRE(nullptr != context, GDF_DATASET_EMPTY);
+	GDF_REQUIRE(num_threads >= 0, GDF_INVALID_API_CALL);
+
+	gdf_exec_context_ *created = new gdf_exec_context_;
+	created->host.reset(new gdf::util::host_executor(num_threads));
+	*context = created;
+	return GDF_SUCCESS;
+}
+
+gdf_error gdf_exec_context_synchronize(gdf_exec_context context){
+	if(nullptr != gdf::util::exec_host(context)){
+		context->host->synchronize();
+		return GDF_SUCCESS;
+	}
+	CUDA_TRY( cudaStreamSynchronize(gdf::util::exec_stream(context)) );
+	return GDF_SUCCESS;
+}
+
+gdf_error gdf_exec_context_destroy(gdf_exec_context context){
+	if(nullptr == context)
+		return GDF_SUCCESS;
+
+	//a host executor waits for its operations when destroyed, a stream does not
+	gdf_error status = GDF_SUCCESS;
+	if(context->owns_stream){
+		if(cudaSuccess != cudaStreamSynchronize(context->stream) ||
+		   cudaSuccess != cudaStreamDestroy(context->stream))
+			status = GDF_CUDA_ERROR;
+	}
+	delete context;
+	return status;
+}
+
+gdf_error gdf_exec_event_record(gdf_exec_context context, gdf_exec_event *event){
+	GDF_REQUIRE(nullptr != event, GDF_DATASET_EMPTY);
+
+	std::unique_ptr<gdf_exec_event_> recorded(new gdf_exec_event_);
+	if(nullptr != gdf::util::exec_host(context)){
+		recorded->done = context->host->record();
+	}else{
+		CUDA_TRY( cudaEventCreateWithFlags(&recorded->event, cudaEventDisableTiming) );
+		if(cudaSuccess != cudaEventRecord(recorded->event, gdf::util::exec_stream(context))){
+			cudaEventDestroy(recorded->event);
+			return GDF_CUDA_ERROR;
+		}
+	}
+	*event = recorded.release();
+	return GDF_SUCCESS;
+}
+
+gdf_error gdf_exec_event_query(gdf_exec_event event, int *done){
+	GDF_REQUIRE(nullptr != event && nullptr != done, GDF_DATASET_EMPTY);
+
+	if(nullptr == event->event){
+		*done = std::future_status::ready == event->done.wait_for(std::chrono::seconds(0));
+		return GDF_SUCCESS;
+	}
+	cudaError_t status = cudaEventQuery(event->event);
+	GDF_REQUIRE(cudaSuccess == status || cudaErrorNotReady == status, GDF_CUDA_ERROR);
+	*done = (cudaSuccess == status);
+	return GDF_SUCCESS;
+}
+
+gdf_error gdf_exec_event_synchronize(gdf_exec_event event){
+	GDF_REQUIRE(nullptr != event, GDF_DATASET_EMPTY);
+
+	if(nullptr == event->event){
+		event->done.wait();
+		return GDF_SUCCESS;
+	}
+	CUDA_TRY( cudaEventSynchronize(event->event) );
+	return GDF_SUCCESS;
+}
+
+gdf_error gdf_exec_context_wait(gdf_exec_context context, gdf_exec_event event){
+	GDF_REQUIRE(nullptr != event, GDF_DATASET_EMPTY);
+
+	if(nullptr != gdf::util::exec_host(context)){
+		//a device event is waited for here, as it may be destroyed before the
+		//queue reaches it; the future of a host event is shared by the queue
+		if(nullptr != event->event){
+			CUDA_TRY( cudaEventSynchronize(event->event) );
+			return GDF_SUCCESS;
+		}
+		//the host executor blocks its queue, not the caller, until the event
+		std::shared_future<void> done = event->done;
+		context->host->enqueue([done]() { done.wait(); });
+		return GDF_SUCCESS;
+	}
+
+	if(nullptr != event->event){
+		CUDA_TRY( cudaStreamWaitEvent(gdf::util::exec_stream(context), event->event, 0) );
+		return GDF_SUCCESS;
+	}
+	//a stream cannot wait for host work without blocking its caller
+	event->done.wait();
+	return GDF_SUCCESS;
+}
+
+gdf_error gdf_exec_event_destroy(gdf_exec_event event){
+	if(nullptr == event)
+		return GDF_SUCCESS;
+
+	gdf_error status = GDF_SUCCESS;
+	if(nullptr != event->event && cudaSuccess != cudaEventDestroy(event->event))
+		status = GDF_CUDA_ERROR;
+	delete event;
+	return status;
+}
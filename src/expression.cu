@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Fused evaluation of elementwise expressions over columns
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+#include <gdf/cffi/functions.h>
+
+#include "expression/expression.cuh"
+#include "expression/host_expression.h"
+#include "util/exec_context.h"
+
+//The whole expression is compiled once and evaluated in a single pass over
+//the rows, instead of one kernel, and one temporary column, per operation.
+//
+gdf_error gdf_expr_eval(gdf_expr_node const* nodes, int num_nodes,
+			gdf_column** cols, int ncols, gdf_column* output){
+	return gdf_expr_eval_async(nodes, num_nodes, cols, ncols, output, nullptr);
+}
+
+gdf_error gdf_expr_eval_async(gdf_expr_node const* nodes, int num_nodes,
+			gdf_column** cols, int ncols, gdf_column* output, gdf_exec_context context){
+
+	GDF_REQUIRE(nullptr != output, GDF_DATASET_EMPTY);
+	GDF_REQUIRE(ncols >= 0 && (0 == ncols || nullptr != cols), GDF_DATASET_EMPTY);
+	GDF_REQUIRE(expr_supported_dtype(output->dtype), GDF_UNSUPPORTED_DTYPE);
+
+	for(int i = 0; i < ncols; i++){
+		GDF_REQUIRE(nullptr != cols[i], GDF_DATASET_EMPTY);
+		GDF_REQUIRE(cols[i]->size == output->size, GDF_COLUMN_SIZE_MISMATCH);
+	}
+
+	expr_program program;
+	gdf_error status = expr_compile(nodes, num_nodes, cols, ncols, program);
+	if(status != GDF_SUCCESS)
+		return status;
+
+	//the compiled program holds the pointers of the columns, not the columns
+	gdf::util::host_executor* executor = gdf::util::exec_host(context);
+	if(nullptr != executor){
+		const gdf_size_type size = output->size;
+		void* out = output->data;
+		const gdf_dtype out_dtype = output->dtype;
+		gdf_valid_type* out_valid = output->valid;
+		executor->enqueue([=](){
+			host_expression_evaluate(program, size, out, out_dtype, out_valid, executor);
+		});
+		return GDF_SUCCESS;
+	}
+	return expression_evaluate(program, output->size, output->data, output->dtype, output->valid,
+				gdf::util::exec_stream(context));
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_EXPRESSION_EXPRESSION_CUH
+#define GDF_EXPRESSION_EXPRESSION_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <algorithm>
+
+#include "expression.h"
+
+constexpr int EXPR_BLOCK_SIZE = 256;
+constexpr int EXPR_MAX_BLOCKS = 4096;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Evaluates a compiled expression over every row, in one pass.
+ *
+ * The program is passed by value, with the launch, so that evaluating needs
+ * no allocation nor copy of it to wait for. Every block first copies it into
+ * shared memory, where all its threads read the same instruction at once.
+ * The intermediate values of a row never leave the stack of its thread. A
+ * row is null if any of the columns of the expression is; the validity bits
+ * of a warp's 32 rows are assembled with a ballot and stored as whole bytes.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Unused = void>
+__global__
+void expression_kernel(expr_program const   param_program,
+                       gdf_size_type        size,
+                       void *               out,
+                       gdf_dtype            out_dtype,
+                       gdf_valid_type *     out_valid)
+{
+  __shared__ expr_program program;
+  {
+    int const * from = reinterpret_cast<int const *>(&param_program);
+    int * to = reinterpret_cast<int *>(&program);
+    for(int w = threadIdx.x; w < static_cast<int>(sizeof(expr_program) / sizeof(int)); w += blockDim.x)
+      to[w] = from[w];
+  }
+  __syncthreads();
+
+  const unsigned lane = threadIdx.x % warpSize;
+  for(gdf_size_type tile = static_cast<gdf_size_type>(blockIdx.x) * blockDim.x;
+      tile < size;
+      tile += static_cast<gdf_size_type>(blockDim.x) * gridDim.x)
+  {
+    const gdf_size_type row = tile + threadIdx.x;
+    const bool active = row < size;
+    bool row_valid = false;
+    if( active )
+    {
+      expr_store(out, out_dtype, row, expr_evaluate(program, row), program.result_kind);
+      row_valid = expr_row_valid(program, row);
+    }
+
+    if( nullptr != out_valid )
+    {
+      const unsigned bits = __ballot_sync(0xffffffff, row_valid);
+      if( (0 == lane % GDF_VALID_BITSIZE) && active )
+        out_valid[row / GDF_VALID_BITSIZE] = static_cast<gdf_valid_type>(bits >> lane);
+    }
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Evaluates a compiled expression over device columns into a
+ * device column.
+ *
+ * @Param[in] program The compiled expression, see expr_compile
+ * @Param[in] size The number of rows
+ * @Param[out] out The results, converted to out_dtype
+ * @Param[in] out_dtype The type of the results
+ * @Param[out] out_valid The validity of the results, or nullptr
+ * @Param[in] stream The stream on which to evaluate, asynchronously
+ *
+ * @Returns GDF_SUCCESS upon successful launch
+ */
+/* ----------------------------------------------------------------------------*/
+inline
+gdf_error expression_evaluate(expr_program const & program,
+                              gdf_size_type        size,
+                              void *               out,
+                              gdf_dtype            out_dtype,
+                              gdf_valid_type *     out_valid,
+                              cudaStream_t         stream = 0)
+{
+  // Kernel parameters are limited to 4KB
+  static_assert(sizeof(expr_program) <= 4000, "the program must fit in the kernel parameters");
+  if( size == 0 )
+    return GDF_SUCCESS;
+
+  const int num_blocks = std::min<int>((size + EXPR_BLOCK_SIZE - 1) / EXPR_BLOCK_SIZE,
+                                       EXPR_MAX_BLOCKS);
+  expression_kernel<<<num_blocks, EXPR_BLOCK_SIZE, 0, stream>>>(
+    program, size, out, out_dtype, out_valid);
+  CUDA_CHECK_LAST();
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_EXPRESSION_EXPRESSION_CUH
@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_EXPRESSION_EXPRESSION_H
+#define GDF_EXPRESSION_EXPRESSION_H
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#ifdef __CUDACC__
+#define GDF_EXPR_FUNC __host__ __device__ __forceinline__
+#else
+#define GDF_EXPR_FUNC inline
+#endif
+
+// Most nodes, stack slots and distinct columns of an expression
+constexpr int EXPR_MAX_NODES = 64;
+constexpr int EXPR_MAX_STACK = 16;
+constexpr int EXPR_MAX_COLUMNS = 16;
+
+// Values are evaluated as int64 or as double, whatever their column type
+enum expr_kind : int8_t
+{
+  EXPR_KIND_INT = 0,
+  EXPR_KIND_FLOAT = 1
+};
+
+union expr_value
+{
+  int64_t i;
+  double f;
+};
+
+struct expr_column
+{
+  void const *           data;
+  gdf_valid_type const * valid;
+  gdf_dtype              dtype;
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  One compiled node: its operation, the kinds of its operands and
+ * result, and the stack slot of its result. The operands of an operation are
+ * in that slot and the next, so the interpreter needs no stack pointer.
+ */
+/* ----------------------------------------------------------------------------*/
+struct expr_instruction
+{
+  gdf_expr_op op;
+  int8_t      kind;
+  int8_t      lhs_kind;
+  int8_t      rhs_kind;
+  int8_t      slot;
+  int16_t     column;
+  expr_value  value;
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  A compiled expression: type checked, with the slot of every
+ * node resolved, and small enough to be held in the shared memory of a
+ * block.
+ */
+/* ----------------------------------------------------------------------------*/
+struct expr_program
+{
+  int              num_instructions;
+  int              num_columns;
+  int8_t           result_kind;
+  expr_instruction code[EXPR_MAX_NODES];
+  expr_column      columns[EXPR_MAX_COLUMNS];
+};
+
+inline bool expr_supported_dtype(gdf_dtype dtype)
+{
+  switch( dtype )
+  {
+  case GDF_INT8:
+  case GDF_INT16:
+  case GDF_INT32:
+  case GDF_INT64:
+  case GDF_FLOAT32:
+  case GDF_FLOAT64:
+  case GDF_DATE32:
+  case GDF_DATE64:
+  case GDF_TIMESTAMP: return true;
+  default:            return false;
+  }
+}
+
+inline int8_t expr_dtype_kind(gdf_dtype dtype)
+{
+  return (GDF_FLOAT32 == dtype || GDF_FLOAT64 == dtype) ? EXPR_KIND_FLOAT : EXPR_KIND_INT;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Compiles the nodes of an expression, in postfix order, over a
+ * set of columns: checks that every operation has its operands and that the
+ * expression leaves a single value, and gives every node the kind of its
+ * result. Arithmetic stays in int64 when all of its operands are integers
+ * and is done in double otherwise; true division is always in double, and
+ * comparisons and logical operations give 0 or 1.
+ *
+ * @Returns GDF_SUCCESS upon successful completion, GDF_INVALID_API_CALL for
+ * a malformed expression, GDF_COLUMN_SIZE_TOO_BIG if it is too large, and
+ * GDF_UNSUPPORTED_DTYPE for an unsupported column
+ */
+/* ----------------------------------------------------------------------------*/
+inline
+gdf_error expr_compile(gdf_expr_node const * nodes,
+                       int                   num_nodes,
+                       gdf_column * const *  cols,
+                       int                   ncols,
+                       expr_program &        program)
+{
+  GDF_REQUIRE(nullptr != nodes && num_nodes > 0, GDF_INVALID_API_CALL);
+  GDF_REQUIRE(num_nodes <= EXPR_MAX_NODES, GDF_COLUMN_SIZE_TOO_BIG);
+
+  program = expr_program{};
+  program.num_instructions = num_nodes;
+
+  // Columns are listed once, however often they are referenced
+  std::vector<int> column_slot(ncols, -1);
+
+  int8_t kinds[EXPR_MAX_STACK + 1];
+  int depth = 0;
+  for(int n = 0; n < num_nodes; ++n)
+  {
+    expr_instruction & ins = program.code[n];
+    ins.op = nodes[n].op;
+    switch( ins.op )
+    {
+    case GDF_EXPR_COLUMN:
+    {
+      const int c = nodes[n].column;
+      GDF_REQUIRE(c >= 0 && c < ncols && nullptr != cols[c], GDF_INVALID_API_CALL);
+      GDF_REQUIRE(expr_supported_dtype(cols[c]->dtype), GDF_UNSUPPORTED_DTYPE);
+      if( column_slot[c] < 0 )
+      {
+        GDF_REQUIRE(program.num_columns < EXPR_MAX_COLUMNS, GDF_COLUMN_SIZE_TOO_BIG);
+        column_slot[c] = program.num_columns;
+        program.columns[program.num_columns++] = expr_column{cols[c]->data, cols[c]->valid, cols[c]->dtype};
+      }
+      ins.column = static_cast<int16_t>(column_slot[c]);
+      ins.kind = expr_dtype_kind(cols[c]->dtype);
+      GDF_REQUIRE(depth < EXPR_MAX_STACK, GDF_COLUMN_SIZE_TOO_BIG);
+      ins.slot = static_cast<int8_t>(depth);
+      kinds[depth++] = ins.kind;
+      break;
+    }
+    case GDF_EXPR_INT:
+    case GDF_EXPR_FLOAT:
+      ins.kind = (GDF_EXPR_INT == ins.op) ? EXPR_KIND_INT : EXPR_KIND_FLOAT;
+      if( GDF_EXPR_INT == ins.op )
+        ins.value.i = nodes[n].ivalue;
+      else
+        ins.value.f = nodes[n].fvalue;
+      GDF_REQUIRE(depth < EXPR_MAX_STACK, GDF_COLUMN_SIZE_TOO_BIG);
+      ins.slot = static_cast<int8_t>(depth);
+      kinds[depth++] = ins.kind;
+      break;
+    case GDF_EXPR_NEG:
+    case GDF_EXPR_NOT:
+      GDF_REQUIRE(depth >= 1, GDF_INVALID_API_CALL);
+      ins.slot = static_cast<int8_t>(depth - 1);
+      ins.lhs_kind = kinds[depth - 1];
+      ins.kind = (GDF_EXPR_NEG == ins.op) ? ins.lhs_kind : EXPR_KIND_INT;
+      kinds[depth - 1] = ins.kind;
+      break;
+    case GDF_EXPR_ADD:
+    case GDF_EXPR_SUB:
+    case GDF_EXPR_MUL:
+    case GDF_EXPR_DIV:
+    case GDF_EXPR_FLOORDIV:
+    case GDF_EXPR_GT:
+    case GDF_EXPR_GE:
+    case GDF_EXPR_LT:
+    case GDF_EXPR_LE:
+    case GDF_EXPR_EQ:
+    case GDF_EXPR_NE:
+    case GDF_EXPR_AND:
+    case GDF_EXPR_OR:
+    {
+      GDF_REQUIRE(depth >= 2, GDF_INVALID_API_CALL);
+      --depth;
+      ins.slot = static_cast<int8_t>(depth - 1);
+      ins.lhs_kind = kinds[depth - 1];
+      ins.rhs_kind = kinds[depth];
+      const bool arithmetic = ins.op <= GDF_EXPR_FLOORDIV;
+      const bool any_float = (EXPR_KIND_FLOAT == ins.lhs_kind) || (EXPR_KIND_FLOAT == ins.rhs_kind);
+      if( GDF_EXPR_DIV == ins.op )
+        ins.kind = EXPR_KIND_FLOAT;
+      else
+        ins.kind = (arithmetic && any_float) ? EXPR_KIND_FLOAT : EXPR_KIND_INT;
+      kinds[depth - 1] = ins.kind;
+      break;
+    }
+    default:
+      return GDF_INVALID_API_CALL;
+    }
+  }
+  GDF_REQUIRE(1 == depth, GDF_INVALID_API_CALL);
+  program.result_kind = kinds[0];
+  return GDF_SUCCESS;
+}
+
+// A value of a column, widened to its kind
+GDF_EXPR_FUNC
+expr_value expr_load(expr_column const & col, gdf_size_type row)
+{
+  expr_value v;
+  switch( col.dtype )
+  {
+  case GDF_INT8:      v.i = static_cast<int8_t const *>(col.data)[row]; break;
+  case GDF_INT16:     v.i = static_cast<int16_t const *>(col.data)[row]; break;
+  case GDF_INT32:
+  case GDF_DATE32:    v.i = static_cast<int32_t const *>(col.data)[row]; break;
+  case GDF_FLOAT32:   v.f = static_cast<float const *>(col.data)[row]; break;
+  case GDF_FLOAT64:   v.f = static_cast<double const *>(col.data)[row]; break;
+  default:            v.i = static_cast<int64_t const *>(col.data)[row]; break;
+  }
+  return v;
+}
+
+GDF_EXPR_FUNC
+double expr_as_double(expr_value v, int8_t kind)
+{
+  return EXPR_KIND_FLOAT == kind ? v.f : static_cast<double>(v.i);
+}
+
+GDF_EXPR_FUNC
+bool expr_truth(expr_value v, int8_t kind)
+{
+  return EXPR_KIND_FLOAT == kind ? v.f != 0 : v.i != 0;
+}
+
+GDF_EXPR_FUNC
+int64_t expr_floordiv(int64_t x, int64_t y)
+{
+  if( 0 == y )
+    return 0;
+  const int64_t q = x / y;
+  return ((x % y != 0) && ((x < 0) != (y < 0))) ? q - 1 : q;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Applies the operation of an instruction to its operands, in
+ * the kind it was compiled to.
+ */
+/* ----------------------------------------------------------------------------*/
+GDF_EXPR_FUNC
+expr_value expr_apply(expr_instruction const & ins, expr_value a, expr_value b)
+{
+  expr_value r;
+  const bool in_float = (EXPR_KIND_FLOAT == ins.lhs_kind) || (EXPR_KIND_FLOAT == ins.rhs_kind);
+  const double x = expr_as_double(a, ins.lhs_kind);
+  const double y = expr_as_double(b, ins.rhs_kind);
+  switch( ins.op )
+  {
+  case GDF_EXPR_ADD:
+    if( EXPR_KIND_FLOAT == ins.kind ) r.f = x + y; else r.i = a.i + b.i;
+    break;
+  case GDF_EXPR_SUB:
+    if( EXPR_KIND_FLOAT == ins.kind ) r.f = x - y; else r.i = a.i - b.i;
+    break;
+  case GDF_EXPR_MUL:
+    if( EXPR_KIND_FLOAT == ins.kind ) r.f = x * y; else r.i = a.i * b.i;
+    break;
+  case GDF_EXPR_DIV:
+    r.f = x / y;
+    break;
+  case GDF_EXPR_FLOORDIV:
+    if( EXPR_KIND_FLOAT == ins.kind ) r.f = floor(x / y); else r.i = expr_floordiv(a.i, b.i);
+    break;
+  case GDF_EXPR_NEG:
+    if( EXPR_KIND_FLOAT == ins.kind ) r.f = -a.f; else r.i = -a.i;
+    break;
+  case GDF_EXPR_GT: r.i = in_float ? x > y : a.i > b.i; break;
+  case GDF_EXPR_GE: r.i = in_float ? x >= y : a.i >= b.i; break;
+  case GDF_EXPR_LT: r.i = in_float ? x < y : a.i < b.i; break;
+  case GDF_EXPR_LE: r.i = in_float ? x <= y : a.i <= b.i; break;
+  case GDF_EXPR_EQ: r.i = in_float ? x == y : a.i == b.i; break;
+  case GDF_EXPR_NE: r.i = in_float ? x != y : a.i != b.i; break;
+  case GDF_EXPR_AND: r.i = expr_truth(a, ins.lhs_kind) && expr_truth(b, ins.rhs_kind); break;
+  case GDF_EXPR_OR:  r.i = expr_truth(a, ins.lhs_kind) || expr_truth(b, ins.rhs_kind); break;
+  case GDF_EXPR_NOT: r.i = !expr_truth(a, ins.lhs_kind); break;
+  default:           r.i = 0; break;
+  }
+  return r;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Evaluates a compiled expression for one row: every value stays
+ * in a per-thread stack of EXPR_MAX_STACK slots and only the result leaves
+ * it. The program is the same for all rows, so that the threads of a warp
+ * take the same branch of every instruction.
+ */
+/* ----------------------------------------------------------------------------*/
+GDF_EXPR_FUNC
+expr_value expr_evaluate(expr_program const & program, gdf_size_type row)
+{
+  expr_value stack[EXPR_MAX_STACK + 1];
+  for(int pc = 0; pc < program.num_instructions; ++pc)
+  {
+    expr_instruction const & ins = program.code[pc];
+    switch( ins.op )
+    {
+    case GDF_EXPR_COLUMN:
+      stack[ins.slot] = expr_load(program.columns[ins.column], row);
+      break;
+    case GDF_EXPR_INT:
+    case GDF_EXPR_FLOAT:
+      stack[ins.slot] = ins.value;
+      break;
+    default:
+      stack[ins.slot] = expr_apply(ins, stack[ins.slot], stack[ins.slot + 1]);
+      break;
+    }
+  }
+  return stack[0];
+}
+
+// Whether none of the columns of an expression is null at a row
+GDF_EXPR_FUNC
+bool expr_row_valid(expr_program const & program, gdf_size_type row)
+{
+  bool valid = true;
+  for(int c = 0; c < program.num_columns; ++c)
+    valid = valid && gdf_is_valid(program.columns[c].valid, row);
+  return valid;
+}
+
+// Stores a result, converted to the output type
+GDF_EXPR_FUNC
+void expr_store(void * out, gdf_dtype dtype, gdf_size_type row, expr_value v, int8_t kind)
+{
+  const bool is_float = EXPR_KIND_FLOAT == kind;
+  switch( dtype )
+  {
+  case GDF_INT8:      static_cast<int8_t *>(out)[row] = is_float ? static_cast<int8_t>(v.f) : static_cast<int8_t>(v.i); break;
+  case GDF_INT16:     static_cast<int16_t *>(out)[row] = is_float ? static_cast<int16_t>(v.f) : static_cast<int16_t>(v.i); break;
+  case GDF_INT32:
+  case GDF_DATE32:    static_cast<int32_t *>(out)[row] = is_float ? static_cast<int32_t>(v.f) : static_cast<int32_t>(v.i); break;
+  case GDF_FLOAT32:   static_cast<float *>(out)[row] = static_cast<float>(expr_as_double(v, kind)); break;
+  case GDF_FLOAT64:   static_cast<double *>(out)[row] = expr_as_double(v, kind); break;
+  default:            static_cast<int64_t *>(out)[row] = is_float ? static_cast<int64_t>(v.f) : v.i; break;
+  }
+}
+
+#endif // GDF_EXPRESSION_EXPRESSION_H
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_EXPRESSION_HOST_EXPRESSION_H
+#define GDF_EXPRESSION_HOST_EXPRESSION_H
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "expression.h"
+#include "../util/host_executor.h"
+
+// Rows evaluated together, small enough for the slots of a block to stay in
+// the cache of a core
+constexpr size_t HOST_EXPR_BLOCK = 1024;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of expression_evaluate: evaluates a compiled
+ * expression over host columns into a host column.
+ *
+ * Rows are evaluated a block of HOST_EXPR_BLOCK at a time, one instruction
+ * over the whole block before the next, so that the interpreter dispatches
+ * once per instruction and block instead of once per row, and the inner
+ * loops run over contiguous slots. Blocks are split between host threads.
+ *
+ * @Param[in] program The compiled expression, over host columns
+ * @Param[in] size The number of rows
+ * @Param[out] out The results, converted to out_dtype
+ * @Param[in] out_dtype The type of the results
+ * @Param[out] out_valid The validity of the results, or nullptr
+ * @Param[in] executor The pool of threads to evaluate on, or nullptr
+ */
+/* ----------------------------------------------------------------------------*/
+inline
+void host_expression_evaluate(expr_program const &       program,
+                              size_t                     size,
+                              void *                     out,
+                              gdf_dtype                  out_dtype,
+                              gdf_valid_type *           out_valid,
+                              gdf::util::host_executor * executor = nullptr)
+{
+  // Blocks are whole bytes of the mask, so no two threads share one
+  static_assert(0 == HOST_EXPR_BLOCK % GDF_VALID_BITSIZE, "blocks must cover whole mask bytes");
+  const size_t num_blocks = (size + HOST_EXPR_BLOCK - 1) / HOST_EXPR_BLOCK;
+
+  gdf::util::host_parallel_for(executor, num_blocks, gdf::util::host_num_threads(size),
+    [&](unsigned, size_t first, size_t last) {
+      // One spare slot: unary operations read an operand past their own
+      std::vector<expr_value> slots((EXPR_MAX_STACK + 1) * HOST_EXPR_BLOCK);
+      for(size_t block = first; block < last; ++block)
+      {
+        const size_t begin = block * HOST_EXPR_BLOCK;
+        const size_t rows = std::min(HOST_EXPR_BLOCK, size - begin);
+
+        for(int pc = 0; pc < program.num_instructions; ++pc)
+        {
+          expr_instruction const & ins = program.code[pc];
+          expr_value * result = slots.data() + ins.slot * HOST_EXPR_BLOCK;
+          switch( ins.op )
+          {
+          case GDF_EXPR_COLUMN:
+          {
+            expr_column const & col = program.columns[ins.column];
+            for(size_t r = 0; r < rows; ++r)
+              result[r] = expr_load(col, begin + r);
+            break;
+          }
+          case GDF_EXPR_INT:
+          case GDF_EXPR_FLOAT:
+            std::fill(result, result + rows, ins.value);
+            break;
+          default:
+          {
+            expr_value const * rhs = result + HOST_EXPR_BLOCK;
+            for(size_t r = 0; r < rows; ++r)
+              result[r] = expr_apply(ins, result[r], rhs[r]);
+            break;
+          }
+          }
+        }
+
+        for(size_t r = 0; r < rows; ++r)
+          expr_store(out, out_dtype, begin + r, slots[r], program.result_kind);
+
+        if( nullptr != out_valid )
+          for(size_t r = 0; r < rows; r += GDF_VALID_BITSIZE)
+          {
+            gdf_valid_type bits = 0;
+            for(size_t b = 0; b < GDF_VALID_BITSIZE && r + b < rows; ++b)
+              if( expr_row_valid(program, begin + r + b) )
+                bits |= gdf_valid_type(1) << b;
+            out_valid[(begin + r) / GDF_VALID_BITSIZE] = bits;
+          }
+      }
+    });
+}
+
+#endif // GDF_EXPRESSION_HOST_EXPRESSION_H
@@ -12,6 +12,7 @@
 #include <thrust/iterator/iterator_adaptor.h>
 #include <thrust/device_vector.h>
 #include "bitmaskops.h"
+#include "util/exec_context.h"
 
 
 
@@ -153,21 +154,18 @@ void gpu_filter_op(IteratorTypeLeft begin_left, IteratorTypeRight begin_right, I
 
 	}
 
-	cudaStreamSynchronize(stream);
-
+	//no synchronization: the work is ordered on the stream, and only a null count computed from
+	//two masks needs to wait for it
 }
 
 
 // stencil: plantilla! 
 // 
 template<typename T>
-gdf_error gpu_comparison_static_templated(gdf_column *lhs, T value, gdf_column *output,gdf_comparison_operator operation){
+gdf_error gpu_comparison_static_templated(gdf_column *lhs, T value, gdf_column *output,gdf_comparison_operator operation, cudaStream_t stream = 0){
 	GDF_REQUIRE(lhs->size == output->size, GDF_COLUMN_SIZE_MISMATCH);
 
 	GDF_REQUIRE(output->dtype == GDF_INT8, GDF_COLUMN_SIZE_MISMATCH);
-	
-	cudaStream_t stream;
-	cudaStreamCreate(&stream);
 
 	if(lhs->dtype == GDF_INT8){
 		thrust::device_ptr<int8_t> left_ptr((int8_t *) lhs->data);
@@ -226,39 +224,74 @@ gdf_error gpu_comparison_static_templated(gdf_column *lhs, T value, gdf_column *
 				lhs->null_count,lhs->null_count,output->null_count,stream
 		);
 	}
-	cudaStreamSynchronize(stream);
-	cudaStreamDestroy(stream);
+	CUDA_CHECK_LAST();
 	return GDF_SUCCESS;
 }
 
+//the comparison queued on a device execution context
+template<typename T>
+gdf_error gpu_comparison_static_on(gdf_column *lhs, T value, gdf_column *output,gdf_comparison_operator operation, gdf_exec_context context){
+	GDF_REQUIRE(nullptr == gdf::util::exec_host(context), GDF_UNSUPPORTED_METHOD);
+	return gpu_comparison_static_templated(lhs, value, output, operation, gdf::util::exec_stream(context));
+}
+
 gdf_error gpu_comparison_static_i8(gdf_column *lhs, int8_t value, gdf_column *output,gdf_comparison_operator operation){
-	return gpu_comparison_static_templated(lhs, value, output,operation);
+	return gpu_comparison_static_on(lhs, value, output, operation, nullptr);
+}
+
+gdf_error gpu_comparison_static_i8_async(gdf_column *lhs, int8_t value, gdf_column *output,gdf_comparison_operator operation, gdf_exec_context context){
+	return gpu_comparison_static_on(lhs, value, output, operation, context);
 }
 
 gdf_error gpu_comparison_static_i16(gdf_column *lhs, int16_t value, gdf_column *output,gdf_comparison_operator operation){
-	return gpu_comparison_static_templated(lhs, value, output,operation);
+	return gpu_comparison_static_on(lhs, value, output, operation, nullptr);
+}
+
+gdf_error gpu_comparison_static_i16_async(gdf_column *lhs, int16_t value, gdf_column *output,gdf_comparison_operator operation, gdf_exec_context context){
+	return gpu_comparison_static_on(lhs, value, output, operation, context);
 }
 
 gdf_error gpu_comparison_static_i32(gdf_column *lhs, int32_t value, gdf_column *output,gdf_comparison_operator operation){
-	return gpu_comparison_static_templated(lhs, value, output,operation);
+	return gpu_comparison_static_on(lhs, value, output, operation, nullptr);
+}
+
+gdf_error gpu_comparison_static_i32_async(gdf_column *lhs, int32_t value, gdf_column *output,gdf_comparison_operator operation, gdf_exec_context context){
+	return gpu_comparison_static_on(lhs, value, output, operation, context);
 }
 
 gdf_error gpu_comparison_static_i64(gdf_column *lhs, int64_t value, gdf_column *output,gdf_comparison_operator operation){
-	return gpu_comparison_static_templated(lhs, value, output,operation);
+	return gpu_comparison_static_on(lhs, value, output, operation, nullptr);
+}
+
+gdf_error gpu_comparison_static_i64_async(gdf_column *lhs, int64_t value, gdf_column *output,gdf_comparison_operator operation, gdf_exec_context context){
+	return gpu_comparison_static_on(lhs, value, output, operation, context);
 }
 
 gdf_error gpu_comparison_static_f32(gdf_column *lhs, float value, gdf_column *output,gdf_comparison_operator operation){
-	return gpu_comparison_static_templated(lhs, value, output,operation);
+	return gpu_comparison_static_on(lhs, value, output, operation, nullptr);
+}
+
+gdf_error gpu_comparison_static_f32_async(gdf_column *lhs, float value, gdf_column *output,gdf_comparison_operator operation, gdf_exec_context context){
+	return gpu_comparison_static_on(lhs, value, output, operation, context);
 }
 
 gdf_error gpu_comparison_static_f64(gdf_column *lhs, double value, gdf_column *output,gdf_comparison_operator operation){
-	return gpu_comparison_static_templated(lhs, value, output,operation);
+	return gpu_comparison_static_on(lhs, value, output, operation, nullptr);
+}
+
+gdf_error gpu_comparison_static_f64_async(gdf_column *lhs, double value, gdf_column *output,gdf_comparison_operator operation, gdf_exec_context context){
+	return gpu_comparison_static_on(lhs, value, output, operation, context);
 }
 
 
 
 
 gdf_error gpu_comparison(gdf_column *lhs, gdf_column *rhs, gdf_column *output,gdf_comparison_operator operation){
+	return gpu_comparison_async(lhs, rhs, output, operation, nullptr);
+}
+
+gdf_error gpu_comparison_async(gdf_column *lhs, gdf_column *rhs, gdf_column *output,gdf_comparison_operator operation, gdf_exec_context context){
+	GDF_REQUIRE(nullptr == gdf::util::exec_host(context), GDF_UNSUPPORTED_METHOD);
 	GDF_REQUIRE(lhs->size == rhs->size, GDF_COLUMN_SIZE_MISMATCH);
 	GDF_REQUIRE(lhs->size == output->size, GDF_COLUMN_SIZE_MISMATCH);
 
@@ -275,8 +308,7 @@ gdf_error gpu_comparison(gdf_column *lhs, gdf_column *rhs, gdf_column *output,gd
 	// we could decide to always have be an int8 since the output is a boolean
 
 
-	cudaStream_t stream;
-	cudaStreamCreate(&stream);
+	cudaStream_t stream = gdf::util::exec_stream(context);
 
 
 
@@ -654,8 +686,7 @@ gdf_error gpu_comparison(gdf_column *lhs, gdf_column *rhs, gdf_column *output,gd
 
 
 
-	cudaStreamSynchronize(stream);
-	cudaStreamDestroy(stream);
+	CUDA_CHECK_LAST();
 
 
 
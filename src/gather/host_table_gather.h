@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_GATHER_HOST_TABLE_GATHER_H
+#define GDF_GATHER_HOST_TABLE_GATHER_H
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "../util/host_parallel.h"
+
+// Rows gathered for every column before moving on to the next tile: the
+// indices of a tile stay in cache while all the columns are gathered
+constexpr size_t HOST_TABLE_GATHER_TILE_ROWS = 4096;
+
+template <typename T, typename IndexT>
+void host_gather_tile(void const *   in_data,
+                      void *         out_data,
+                      IndexT const * gather_map,
+                      bool const *   in_range,
+                      size_t         begin,
+                      size_t         end)
+{
+  T const * in = static_cast<T const *>(in_data);
+  T * out = static_cast<T *>(out_data);
+  for(size_t i = begin; i < end; ++i)
+    if( in_range[i - begin] )
+      out[i] = in[gather_map[i]];
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of gather_table: gathers the rows of a set of
+ * host resident columns into another set of columns through one index map,
+ * including the validity bitmasks of the output columns that have one.
+ *
+ * The output rows are split between host threads on validity byte
+ * boundaries, so that no two threads write the same mask byte, and every
+ * thread walks its rows tile by tile, gathering all the columns of a tile
+ * before moving on.
+ *
+ * @Param[in] in_cols The columns to gather from (data resident on the host)
+ * @Param[out] out_cols The columns to gather into, with at least nrows_out
+ * rows allocated
+ * @Param[in] ncols The number of columns
+ * @Param[in] h_gather_map Host array of nrows_out row indices into in_cols
+ * @Param[in] nrows_out The number of rows to gather
+ * @Param[in] range_check If true, rows whose index is outside of in_cols are
+ * set to NULL instead of being read
+ *
+ * @Returns GDF_SUCCESS upon successful completion, GDF_UNSUPPORTED_DTYPE if a
+ * column has no fixed width
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT>
+gdf_error host_gather_table(gdf_column const * const * in_cols,
+                            gdf_column * const *       out_cols,
+                            size_t                     ncols,
+                            IndexT const *             h_gather_map,
+                            size_t                     nrows_out,
+                            bool                       range_check = false)
+{
+  if( 0 == ncols || 0 == nrows_out )
+    return GDF_SUCCESS;
+
+  const size_t nrows_in = in_cols[0]->size;
+  const size_t valid_bytes = gdf_get_num_chars_bitmask(nrows_out);
+
+  std::vector<int> widths(ncols);
+  std::vector<void *> out_data(ncols);
+  std::vector<gdf_valid_type *> out_valid(ncols);
+  // Buffers for the columns gathered onto themselves
+  std::vector<std::vector<char>> scratch_data(ncols);
+  std::vector<std::vector<gdf_valid_type>> scratch_valid(ncols);
+
+  for(size_t c = 0; c < ncols; ++c)
+  {
+    gdf_error status = get_column_byte_width(const_cast<gdf_column *>(in_cols[c]), &widths[c]);
+    if( GDF_SUCCESS != status )
+      return status;
+    if( in_cols[c]->size != nrows_in )
+      return GDF_COLUMN_SIZE_MISMATCH;
+
+    out_data[c] = out_cols[c]->data;
+    out_valid[c] = out_cols[c]->valid;
+    if( in_cols[c]->data == out_cols[c]->data )
+    {
+      scratch_data[c].resize(nrows_out * widths[c]);
+      out_data[c] = scratch_data[c].data();
+    }
+    if( nullptr != out_valid[c] && in_cols[c]->valid == out_valid[c] )
+    {
+      scratch_valid[c].resize(valid_bytes);
+      out_valid[c] = scratch_valid[c].data();
+    }
+  }
+
+  // Signed, so that an unsigned IndexT is not compared with 0
+  using signed_index = typename std::make_signed<IndexT>::type;
+
+  // Threads own whole validity bytes
+  gdf::util::host_parallel_for(valid_bytes, gdf::util::host_num_threads(nrows_out),
+    [&](unsigned, size_t begin_byte, size_t end_byte) {
+      const size_t begin_row = begin_byte * GDF_VALID_BITSIZE;
+      const size_t end_row = std::min(nrows_out, end_byte * GDF_VALID_BITSIZE);
+      std::unique_ptr<bool[]> in_range(new bool[HOST_TABLE_GATHER_TILE_ROWS]);
+
+      for(size_t tile = begin_row; tile < end_row; tile += HOST_TABLE_GATHER_TILE_ROWS)
+      {
+        const size_t tile_end = std::min(end_row, tile + HOST_TABLE_GATHER_TILE_ROWS);
+        for(size_t i = tile; i < tile_end; ++i)
+        {
+          const IndexT index = h_gather_map[i];
+          in_range[i - tile] = !range_check ||
+            ((static_cast<signed_index>(index) >= 0) && (static_cast<size_t>(index) < nrows_in));
+        }
+
+        for(size_t c = 0; c < ncols; ++c)
+        {
+          switch( widths[c] )
+          {
+            case 1: host_gather_tile<int8_t>(in_cols[c]->data, out_data[c], h_gather_map,
+                                             in_range.get(), tile, tile_end); break;
+            case 2: host_gather_tile<int16_t>(in_cols[c]->data, out_data[c], h_gather_map,
+                                              in_range.get(), tile, tile_end); break;
+            case 4: host_gather_tile<int32_t>(in_cols[c]->data, out_data[c], h_gather_map,
+                                              in_range.get(), tile, tile_end); break;
+            case 8: host_gather_tile<int64_t>(in_cols[c]->data, out_data[c], h_gather_map,
+                                              in_range.get(), tile, tile_end); break;
+          }
+
+          if( nullptr == out_valid[c] )
+            continue;
+          gdf_valid_type const * in_valid = in_cols[c]->valid;
+          // Tiles start on byte boundaries
+          for(size_t byte_row = tile; byte_row < tile_end; byte_row += GDF_VALID_BITSIZE)
+          {
+            gdf_valid_type bits = 0;
+            const size_t byte_end = std::min(tile_end, byte_row + GDF_VALID_BITSIZE);
+            for(size_t i = byte_row; i < byte_end; ++i)
+            {
+              const bool valid = in_range[i - tile] &&
+                gdf_is_valid(in_valid, static_cast<gdf_index_type>(h_gather_map[i]));
+              bits |= static_cast<gdf_valid_type>(valid) << (i - byte_row);
+            }
+            out_valid[c][byte_row / GDF_VALID_BITSIZE] = bits;
+          }
+        }
+      }
+    });
+
+  for(size_t c = 0; c < ncols; ++c)
+  {
+    if( !scratch_data[c].empty() )
+      std::memcpy(out_cols[c]->data, scratch_data[c].data(), scratch_data[c].size());
+    if( !scratch_valid[c].empty() )
+      std::memcpy(out_cols[c]->valid, scratch_valid[c].data(), valid_bytes);
+  }
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_GATHER_HOST_TABLE_GATHER_H
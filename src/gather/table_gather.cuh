@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_GATHER_TABLE_GATHER_CUH
+#define GDF_GATHER_TABLE_GATHER_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <thrust/device_vector.h>
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+constexpr int TABLE_GATHER_BLOCK_SIZE = 256;
+constexpr int TABLE_GATHER_MAX_BLOCKS = 4096;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Device side description of one column pair of a table gather
+ */
+/* ----------------------------------------------------------------------------*/
+struct gather_column_desc
+{
+  void const *           in_data;
+  void *                 out_data;
+  gdf_valid_type const * in_valid;   // nullptr: all rows valid
+  gdf_valid_type *       out_valid;  // nullptr: validity is not gathered
+  int                    width;      // bytes per value: 1, 2, 4 or 8
+};
+
+template <typename T>
+__device__ __forceinline__
+void gather_value(gather_column_desc const & col, size_t out_row, size_t in_row)
+{
+  static_cast<T *>(col.out_data)[out_row] = static_cast<T const *>(col.in_data)[in_row];
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Gathers all the columns of a table, and their validity bitmasks,
+ * through one index map.
+ *
+ * Each block works on a tile of consecutive output rows: the map is read once
+ * per row and the index is reused for every column. The output validity bits
+ * of a warp's 32 rows are assembled with a ballot and stored as whole bytes,
+ * so no atomics are needed. Rows whose index is out of range (when
+ * range_check is set, e.g. the unmatched rows of an outer join) are NULL and
+ * their values are left untouched.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT>
+__global__
+void gather_table_kernel(gather_column_desc const * __restrict__ cols,
+                         int                                     ncols,
+                         IndexT const * __restrict__             gather_map,
+                         size_t                                  nrows_out,
+                         size_t                                  nrows_in,
+                         bool                                    range_check)
+{
+  // Signed, so that an unsigned IndexT is not compared with 0
+  using signed_index = typename std::make_signed<IndexT>::type;
+  const unsigned lane = threadIdx.x % warpSize;
+
+  for(size_t tile = static_cast<size_t>(blockIdx.x) * blockDim.x;
+      tile < nrows_out;
+      tile += static_cast<size_t>(blockDim.x) * gridDim.x)
+  {
+    const size_t row = tile + threadIdx.x;
+    const bool active = row < nrows_out;
+    const IndexT index = active ? gather_map[row] : IndexT{0};
+    const bool in_range = active &&
+      (!range_check || ((static_cast<signed_index>(index) >= 0) && (static_cast<size_t>(index) < nrows_in)));
+    const size_t in_row = static_cast<size_t>(index);
+
+    for(int c = 0; c < ncols; ++c)
+    {
+      const gather_column_desc col = cols[c];
+
+      if( in_range )
+      {
+        switch( col.width )
+        {
+          case 1: gather_value<int8_t>(col, row, in_row); break;
+          case 2: gather_value<int16_t>(col, row, in_row); break;
+          case 4: gather_value<int32_t>(col, row, in_row); break;
+          case 8: gather_value<int64_t>(col, row, in_row); break;
+        }
+      }
+
+      if( nullptr != col.out_valid )
+      {
+        const bool valid = in_range && gdf_is_valid(col.in_valid, in_row);
+        const unsigned bits = __ballot_sync(0xffffffff, valid);
+        if( (0 == lane % GDF_VALID_BITSIZE) && active )
+          col.out_valid[row / GDF_VALID_BITSIZE] = static_cast<gdf_valid_type>(bits >> lane);
+      }
+    }
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Gathers the rows of a set of columns into another set of columns
+ * in a single pass over the gather map: out_cols[c][i] = in_cols[c][map[i]]
+ * for every column c, including the validity bitmasks of the output columns
+ * that have one.
+ *
+ * Gathering a column onto itself is supported: such columns are gathered into
+ * a temporary buffer first.
+ *
+ * @Param[in] in_cols The columns to gather from
+ * @Param[out] out_cols The columns to gather into, with at least nrows_out
+ * rows allocated
+ * @Param[in] ncols The number of columns
+ * @Param[in] d_gather_map Device array of nrows_out row indices into in_cols
+ * @Param[in] nrows_out The number of rows to gather
+ * @Param[in] range_check If true, rows whose index is outside of in_cols are
+ * set to NULL instead of being read
+ * @Param[in] stream The stream on which to perform the gather
+ *
+ * @Returns GDF_SUCCESS upon successful completion, GDF_UNSUPPORTED_DTYPE if a
+ * column has no fixed width
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT>
+gdf_error gather_table(gdf_column const * const * in_cols,
+                       gdf_column * const *       out_cols,
+                       size_t                     ncols,
+                       IndexT const *             d_gather_map,
+                       size_t                     nrows_out,
+                       bool                       range_check = false,
+                       cudaStream_t               stream = 0)
+{
+  if( 0 == ncols || 0 == nrows_out )
+    return GDF_SUCCESS;
+
+  const size_t nrows_in = in_cols[0]->size;
+  const size_t valid_bytes = gdf_get_num_chars_bitmask(nrows_out);
+
+  std::vector<gather_column_desc> h_cols(ncols);
+  // Buffers for the columns gathered onto themselves
+  std::vector<thrust::device_vector<char>> scratch_data(ncols);
+  std::vector<thrust::device_vector<gdf_valid_type>> scratch_valid(ncols);
+
+  for(size_t c = 0; c < ncols; ++c)
+  {
+    int width{0};
+    gdf_error status = get_column_byte_width(const_cast<gdf_column *>(in_cols[c]), &width);
+    if( GDF_SUCCESS != status )
+      return status;
+    GDF_REQUIRE(in_cols[c]->size == nrows_in, GDF_COLUMN_SIZE_MISMATCH);
+
+    gather_column_desc & col = h_cols[c];
+    col.in_data = in_cols[c]->data;
+    col.out_data = out_cols[c]->data;
+    col.in_valid = in_cols[c]->valid;
+    col.out_valid = out_cols[c]->valid;
+    col.width = width;
+
+    if( col.in_data == col.out_data )
+    {
+      scratch_data[c].resize(nrows_out * width);
+      col.out_data = scratch_data[c].data().get();
+    }
+    if( nullptr != col.out_valid && col.in_valid == col.out_valid )
+    {
+      scratch_valid[c].resize(valid_bytes);
+      col.out_valid = scratch_valid[c].data().get();
+    }
+  }
+
+  thrust::device_vector<gather_column_desc> d_cols(h_cols);
+
+  const int num_blocks = static_cast<int>(
+    std::min<size_t>((nrows_out + TABLE_GATHER_BLOCK_SIZE - 1) / TABLE_GATHER_BLOCK_SIZE,
+                     TABLE_GATHER_MAX_BLOCKS));
+  gather_table_kernel<<<num_blocks, TABLE_GATHER_BLOCK_SIZE, 0, stream>>>(
+    d_cols.data().get(), static_cast<int>(ncols), d_gather_map, nrows_out, nrows_in, range_check);
+  CUDA_CHECK_LAST();
+
+  for(size_t c = 0; c < ncols; ++c)
+  {
+    if( !scratch_data[c].empty() )
+      CUDA_TRY( cudaMemcpyAsync(out_cols[c]->data, scratch_data[c].data().get(),
+                                scratch_data[c].size(), cudaMemcpyDeviceToDevice, stream) );
+    if( !scratch_valid[c].empty() )
+      CUDA_TRY( cudaMemcpyAsync(out_cols[c]->valid, scratch_valid[c].data().get(),
+                                valid_bytes, cudaMemcpyDeviceToDevice, stream) );
+  }
+  // The scratch buffers and descriptors are released on return
+  CUDA_TRY( cudaStreamSynchronize(stream) );
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_GATHER_TABLE_GATHER_CUH
@@ -25,6 +25,7 @@
 #include "hashmap/hash_functions.cuh"
 #include "hashmap/managed.cuh"
 #include "sqls_rtti_comp.hpp"
+#include "gather/table_gather.cuh"
 
 template <typename size_type>
 struct ValidRange {
@@ -142,84 +143,6 @@ void scatter_valid_mask( gdf_valid_type const * const input_mask,
   }
 }
 
-/* --------------------------------------------------------------------------*/
-/** 
- * @Synopsis  Gathers a validity bitmask.
- * 
- * This kernel is used in order to gather the validity bit mask for a gdf_column.
- * 
- * @Param input_mask The mask that will be gathered.
- * @Param output_mask The output after gathering the input
- * @Param gather_map The map that indicates where elements from the input
-   will be gathered to in the output. output_bit[ gather_map [i] ] = input_bit[i]
- * @Param num_rows The number of bits expected in the output masks
- * @Param input_mask_length The number of bits in the input mask
- */
-/* ----------------------------------------------------------------------------*/
-template <typename index_type>
-__global__ 
-void gather_valid_mask( gdf_valid_type const * const input_mask,
-                        gdf_valid_type * const output_mask,
-                        index_type const * const __restrict__ gather_map,
-                        index_type const num_rows,
-                        index_type const input_mask_length)
-{
-  using mask_type = uint32_t;
-  constexpr uint32_t BITS_PER_MASK = 8 * sizeof(mask_type);
-
-  // Cast the validity type to a type where atomicOr is natively supported
-  const mask_type * __restrict__ input_mask32 = reinterpret_cast<mask_type const *>(input_mask);
-  mask_type * const __restrict__ output_mask32 = reinterpret_cast<mask_type * >(output_mask);
-
-  index_type row_number = threadIdx.x + blockIdx.x * blockDim.x;
-
-  ValidRange<index_type> valid(0, input_mask_length);
-  while(row_number < num_rows)
-  {
-    const index_type gather_location = gather_map[row_number];
-    if (!valid(gather_location)) {
-        row_number += blockDim.x * gridDim.x; continue;
-    }
-
-    // Get the bit corresponding from the gathered row
-    // FIXME Replace with a standard `get_bit` function
-    mask_type input_bit = (static_cast<mask_type>(1) << (gather_location % BITS_PER_MASK));
-    if (nullptr != input_mask) {
-        input_bit = input_bit & input_mask32[gather_location/BITS_PER_MASK];
-    }
-
-    // Only set the output bit if the input is valid
-    if(input_bit > 0)
-    {
-      // FIXME Replace with a standard `set_bit` function
-      // Construct the mask that sets the bit for the output row
-      const mask_type output_bit = static_cast<mask_type>(1) << (row_number % BITS_PER_MASK);
-
-      // Find the mask in the output that will hold the bit for output row
-      const index_type output_location = row_number / BITS_PER_MASK;
-
-      // Bitwise OR to set the gathered row's bit
-      atomicOr(&output_mask32[output_location], output_bit);
-    }
-
-    row_number += blockDim.x * gridDim.x;
-  }
-}
-
-//Wrapper around gather_valid_mask
-template <typename index_type>
-void gather_valid( gdf_valid_type const * const input_mask,
-                   gdf_valid_type * const output_mask,
-                   index_type const * const __restrict__ gather_map,
-                   index_type const num_rows,
-                   index_type const input_mask_length,
-                   cudaStream_t stream = 0) {
-    const index_type BLOCK_SIZE = 256;
-    const index_type gather_grid_size = (num_rows + BLOCK_SIZE - 1)/BLOCK_SIZE;
-    gather_valid_mask<<<gather_grid_size, BLOCK_SIZE, 0, stream>>>(
-            input_mask, output_mask, gather_map, num_rows, input_mask_length);
-}
-
 /* --------------------------------------------------------------------------*/
 /** 
  * @Synopsis A class provides useful functionality for operating on a set of gdf_columns. 
@@ -862,92 +785,9 @@ public:
   gdf_error gather(index_type const * const row_gather_map,
           gdf_table<size_type> & gather_output_table, bool range_check = false)
   {
-    gdf_error gdf_status{GDF_SUCCESS};
-  
-    // Each column can be gathered in parallel, therefore create a 
-    // separate stream for every column
-    std::vector<cudaStream_t> column_streams(num_columns);
-    for(auto & s : column_streams)
-    {
-      cudaStreamCreate(&s);
-    }
-  
-    // Scatter columns one by one
-    for(size_type i = 0; i < num_columns; ++i)
-    {
-      gdf_column * const current_input_column = this->get_column(i);
-      gdf_column * const current_output_column = gather_output_table.get_column(i);
-      int column_width_bytes{0};
-      gdf_status = get_column_byte_width(current_input_column, &column_width_bytes);
-  
-      if(GDF_SUCCESS != gdf_status)
-        return gdf_status;
-  
-      // Scatter each column based on it's byte width
-      switch(column_width_bytes)
-      {
-        case 1:
-          {
-            using column_type = int8_t;
-            gdf_status = gather_column<column_type, index_type>(
-                                                     current_input_column, 
-                                                     row_gather_map, 
-                                                     current_output_column,
-                                                     range_check,
-                                                     column_streams[i]);
-            break;
-          }
-        case 2:
-          {
-            using column_type = int16_t;
-            gdf_status = gather_column<column_type, index_type>(
-                                                     current_input_column, 
-                                                     row_gather_map, 
-                                                     current_output_column,
-                                                     range_check,
-                                                     column_streams[i]);
-            break;
-          }
-        case 4:
-          {
-            using column_type = int32_t;
-            gdf_status = gather_column<column_type, index_type>(
-                                                     current_input_column, 
-                                                     row_gather_map, 
-                                                     current_output_column,
-                                                     range_check,
-                                                     column_streams[i]);
-            break;
-          }
-        case 8:
-          {
-            using column_type = int64_t;
-            gdf_status = gather_column<column_type, index_type>(
-                                                     current_input_column, 
-                                                     row_gather_map, 
-                                                     current_output_column,
-                                                     range_check,
-                                                     column_streams[i]);
-            break;
-          }
-        default:
-          gdf_status = GDF_UNSUPPORTED_DTYPE;
-      }
-  
-      if(GDF_SUCCESS != gdf_status)
-        return gdf_status;
-    }
-  
-    // Synchronize all the streams
-    CUDA_TRY( cudaDeviceSynchronize() );
-  
-    // Destroy all streams
-    for(auto & s : column_streams)
-    {
-      cudaStreamDestroy(s);
-    }
-  
-    return gdf_status;
+    // All the columns are gathered in a single pass over the gather map
+    return gather_table(host_columns, gather_output_table.host_columns, num_columns,
+                        row_gather_map, gather_output_table.column_length, range_check);
   }
 
   template <typename index_type>
@@ -1180,107 +1020,6 @@ gdf_error scatter( gdf_table<size_type> & scattered_output_table,
 
 
 private:
-/* --------------------------------------------------------------------------*/
-  /** 
-   * @brief Gathers the values of a column into a new column based on a map that
-     maps rows in the input column to rows in the output column.
-     input_column[row_gather_map[i]] will be assigned to output_column[i]
-   * 
-   * @Param[in] input_column The input column whose rows will be gathered
-   * @Param[in] num_rows The number of rows in the input and output columns
-   * @Param[in] row_gather_map An array that maps rows in the input column
-     to rows in the output column
-   * @Param[out] output_column The rearrangement of the input column 
-     based on the mapping determined by the row_gather_map array
-   * @Param[in] range_check Flag to check validity of the values in row_gather_map
-   * 
-   * @Returns GDF_SUCCESS upon successful computation
-   */
-  /* ----------------------------------------------------------------------------*/
-  template <typename column_type,
-            typename index_type>
-  gdf_error gather_column(gdf_column * input_column,
-                          index_type const * const row_gather_map,
-                          gdf_column * output_column,
-                          const bool range_check,
-                          cudaStream_t stream = 0) const
-  {
-    column_type * const i_data = static_cast<column_type*>(input_column->data);
-    column_type * const o_data = static_cast<column_type*>(output_column->data);
-    index_type num_rows = output_column->size;
-  
-    gdf_error gdf_status{GDF_SUCCESS};
-
-    // Gathering from one table to another
-    if (i_data != o_data) {
-        if (range_check) {
-            thrust::gather_if(thrust::cuda::par.on(stream),
-                    row_gather_map,
-                    row_gather_map + num_rows,
-                    row_gather_map,
-                    i_data,
-                    o_data,
-                    ValidRange<index_type>(0, input_column->size));
-
-        } else {
-            thrust::gather(thrust::cuda::par.on(stream),
-                    row_gather_map,
-                    row_gather_map + num_rows,
-                    i_data,
-                    o_data);
-        }
-    } 
-    // Gather is in-place
-    else {
-        thrust::device_vector<column_type> remapped_copy(num_rows);
-        if (range_check) {
-            thrust::gather_if(thrust::cuda::par.on(stream),
-                           row_gather_map,
-                           row_gather_map + num_rows,
-                           row_gather_map,
-                           i_data,
-                           remapped_copy.begin(),
-                           ValidRange<index_type>(0, input_column->size));
-        } else {
-            thrust::gather(thrust::cuda::par.on(stream),
-                           row_gather_map,
-                           row_gather_map + num_rows,
-                           i_data,
-                           remapped_copy.begin());
-        }
-        thrust::copy(thrust::cuda::par.on(stream),
-                remapped_copy.begin(),
-                remapped_copy.end(),
-                o_data);
-    }
-    //If gather is in-place
-    if ((input_column->valid == output_column->valid) &&
-            (input_column->valid != nullptr)) {
-        thrust::device_vector<gdf_valid_type> remapped_valid_copy(gdf_get_num_chars_bitmask(num_rows));
-        gather_valid<index_type>(
-                input_column->valid,
-                remapped_valid_copy.data().get(),
-                row_gather_map, 
-                num_rows, input_column->size, stream);
-        thrust::copy(thrust::cuda::par.on(stream),
-                remapped_valid_copy.begin(),
-                remapped_valid_copy.end(), output_column->valid);
-    }
-    //If both input and output columns have a non null valid pointer
-    else if (nullptr != output_column->valid) {
-        gather_valid<index_type>(
-                input_column->valid,
-                output_column->valid,
-                row_gather_map, 
-                num_rows, input_column->size, stream);
-    }
-  
-    CUDA_CHECK_LAST();
-  
-    return gdf_status;
-  }
-
-
 /* --------------------------------------------------------------------------*/
 /** 
  * @brief Scatters the values of a column into a new column based on a map that
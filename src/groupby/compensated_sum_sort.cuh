@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_GROUPBY_COMPENSATED_SUM_SORT_CUH
+#define GDF_GROUPBY_COMPENSATED_SUM_SORT_CUH
+
+#include <gdf/gdf.h>
+
+#include <cub/device/device_segmented_reduce.cuh>
+
+#include <thrust/copy.h>
+#include <thrust/device_vector.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+#include <thrust/transform.h>
+
+#include "sqls_rtti_comp.hpp"
+#include "../reductions/compensated_sum.h"
+
+// Whether the sorted row `i` starts a group
+template<typename IndexT>
+struct group_head_flag
+{
+  LesserRTTI<IndexT> f;
+  const IndexT* indx;
+
+  __device__
+  bool operator()(IndexT i) const
+  {
+    return (0 == i) || !f.equal(indx[i - 1], indx[i]);
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Sort-based group-by SUM of a floating point column, as
+ * multi_col_group_by_sum_sort, with every group summed in a compensated
+ * (Kahan-Neumaier) accumulator.
+ *
+ * The groups are delimited first, and each one is then reduced by a single
+ * block of a segmented reduction, whose order of additions only depends on
+ * the group size. Unlike reduce_by_key, which combines the partial sums of
+ * its tiles in the order they complete, the sums are thus bitwise the same
+ * from run to run.
+ *
+ * @Returns The number of groups
+ */
+/* ----------------------------------------------------------------------------*/
+template<typename ValsT,
+	 typename IndexT>
+size_t multi_col_group_by_compensated_sum_sort(size_t         nrows,
+					       size_t         ncols,
+					       void* const*   d_cols,
+					       int* const     d_gdf_t,
+					       const ValsT*   ptr_d_agg,
+					       IndexT*        ptr_d_indx,
+					       ValsT*         ptr_d_agg_p,
+					       IndexT*        ptr_d_kout,
+					       ValsT*         ptr_d_vout,
+					       bool           sorted = false,
+					       cudaStream_t   stream = NULL)
+{
+  if( !sorted )
+    multi_col_order_by(nrows, ncols, d_cols, d_gdf_t, ptr_d_indx, stream);
+
+  thrust::gather(thrust::cuda::par.on(stream),
+                 ptr_d_indx, ptr_d_indx + nrows,
+                 ptr_d_agg,
+                 ptr_d_agg_p);
+
+  LesserRTTI<IndexT> f(d_cols, d_gdf_t, ncols);
+  auto heads = thrust::make_transform_iterator(thrust::make_counting_iterator<IndexT>(0),
+                                               group_head_flag<IndexT>{f, ptr_d_indx});
+
+  // The first row and the offset of every group
+  thrust::copy_if(thrust::cuda::par.on(stream),
+                  ptr_d_indx, ptr_d_indx + nrows,
+                  heads,
+                  ptr_d_kout,
+                  thrust::identity<bool>());
+  thrust::device_vector<IndexT> d_offsets(nrows + 1);
+  auto offsets_end =
+    thrust::copy_if(thrust::cuda::par.on(stream),
+                    thrust::make_counting_iterator<IndexT>(0),
+                    thrust::make_counting_iterator<IndexT>(nrows),
+                    heads,
+                    d_offsets.begin(),
+                    thrust::identity<bool>());
+  const size_t new_sz = thrust::distance(d_offsets.begin(), offsets_end);
+  d_offsets[new_sz] = static_cast<IndexT>(nrows);
+
+  thrust::device_vector<compensated_sum<ValsT>> d_sums(new_sz);
+  auto d_in = thrust::make_transform_iterator(ptr_d_agg_p, compensated_sum_of<ValsT>{});
+  size_t temp_bytes = 0;
+  cub::DeviceSegmentedReduce::Reduce(nullptr, temp_bytes, d_in, d_sums.data().get(),
+                                     static_cast<int>(new_sz),
+                                     d_offsets.data().get(), d_offsets.data().get() + 1,
+                                     compensated_sum_merge<ValsT>{},
+                                     compensated_sum<ValsT>::identity(), stream);
+  thrust::device_vector<char> d_temp(temp_bytes);
+  cub::DeviceSegmentedReduce::Reduce(d_temp.data().get(), temp_bytes, d_in, d_sums.data().get(),
+                                     static_cast<int>(new_sz),
+                                     d_offsets.data().get(), d_offsets.data().get() + 1,
+                                     compensated_sum_merge<ValsT>{},
+                                     compensated_sum<ValsT>::identity(), stream);
+
+  thrust::transform(thrust::cuda::par.on(stream),
+                    d_sums.begin(), d_sums.end(),
+                    ptr_d_vout,
+                    compensated_sum_value<ValsT>{});
+  return new_sz;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Sort-based group-by AVG of a floating point column, as
+ * multi_col_group_by_avg_sort, over compensated sums.
+ *
+ * @Returns The number of groups
+ */
+/* ----------------------------------------------------------------------------*/
+template<typename ValsT,
+	 typename IndexT>
+size_t multi_col_group_by_compensated_avg_sort(size_t         nrows,
+					       size_t         ncols,
+					       void* const*   d_cols,
+					       int* const     d_gdf_t,
+					       const ValsT*   ptr_d_agg,
+					       IndexT*        ptr_d_indx,
+					       IndexT*        ptr_d_cout,
+					       ValsT*         ptr_d_agg_p,
+					       IndexT*        ptr_d_kout,
+					       ValsT*         ptr_d_vout,
+					       bool           sorted = false,
+					       cudaStream_t   stream = NULL)
+{
+  multi_col_group_by_count_sort(nrows,
+				ncols,
+				d_cols,
+				d_gdf_t,
+				ptr_d_indx,
+				ptr_d_kout,
+				ptr_d_cout,
+				sorted,
+				stream);
+
+  // The rows are ordered by the count above
+  size_t new_sz = multi_col_group_by_compensated_sum_sort(nrows,
+							  ncols,
+							  d_cols,
+							  d_gdf_t,
+							  ptr_d_agg,
+							  ptr_d_indx,
+							  ptr_d_agg_p,
+							  ptr_d_kout,
+							  ptr_d_vout,
+							  true,
+							  stream);
+
+  thrust::transform(thrust::cuda::par.on(stream),
+		    ptr_d_cout, ptr_d_cout + new_sz,
+		    ptr_d_vout,
+		    ptr_d_vout,
+		    []  __device__ (IndexT n, ValsT sum){
+		      return sum/static_cast<ValsT>(n);
+		    });
+
+  return new_sz;
+}
+
+#endif // GDF_GROUPBY_COMPENSATED_SUM_SORT_CUH
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Histograms and binning of numeric and date columns
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <thrust/device_vector.h>
+
+#include <vector>
+
+#include "histogram/histogram.cuh"
+
+namespace {
+
+  template<typename T>
+  gdf_error histogram_generic(gdf_column* col_in, fixed_width_bins bins, gdf_column* counts)
+  {
+    return histogram(static_cast<T const*>(col_in->data), col_in->valid, col_in->size,
+                     bins, static_cast<int64_t*>(counts->data));
+  }
+
+  template<typename T, typename E>
+  gdf_error digitize_generic(gdf_column* col_in, E const* edges, gdf_size_type num_edges,
+                             bool right, bool cut, gdf_column* out)
+  {
+    return digitize(static_cast<T const*>(col_in->data), col_in->valid, col_in->size,
+                    edges, num_edges, right, cut,
+                    static_cast<int32_t*>(out->data), out->valid);
+  }
+
+  template<typename T>
+  gdf_error digitize_same_type(gdf_column* col_in, gdf_column* edges, bool right, bool cut,
+                               gdf_column* out)
+  {
+    return digitize_generic<T>(col_in, static_cast<T const*>(edges->data), edges->size,
+                               right, cut, out);
+  }
+
+  gdf_error check_bin_output(gdf_column* col_in, gdf_column* out)
+  {
+    GDF_REQUIRE(nullptr != col_in && nullptr != out, GDF_DATASET_EMPTY);
+    GDF_REQUIRE(histogram_supported_dtype(col_in->dtype), GDF_UNSUPPORTED_DTYPE);
+    GDF_REQUIRE(GDF_INT32 == out->dtype, GDF_UNSUPPORTED_DTYPE);
+    GDF_REQUIRE(out->size == col_in->size, GDF_COLUMN_SIZE_MISMATCH);
+    return GDF_SUCCESS;
+  }
+
+  //the rows without a bin are the nulls of the output
+  gdf_error set_bin_null_count(gdf_column* out)
+  {
+    out->null_count = 0;
+    if( nullptr == out->valid || 0 == out->size )
+      return GDF_SUCCESS;
+    int valid_count = 0;
+    gdf_error status = gdf_count_nonzero_mask(out->valid, out->size, &valid_count);
+    if( GDF_SUCCESS != status )
+      return status;
+    out->null_count = out->size - valid_count;
+    return GDF_SUCCESS;
+  }
+
+  gdf_error bin_by_edges(gdf_column* col_in, gdf_column* edges, bool right, bool cut,
+                         gdf_column* out)
+  {
+    gdf_error status = check_bin_output(col_in, out);
+    if( GDF_SUCCESS != status )
+      return status;
+    GDF_REQUIRE(nullptr != edges && nullptr != edges->data, GDF_DATASET_EMPTY);
+    GDF_REQUIRE(edges->dtype == col_in->dtype, GDF_DTYPE_MISMATCH);
+    GDF_REQUIRE(nullptr == edges->valid || 0 == edges->null_count, GDF_VALIDITY_UNSUPPORTED);
+    GDF_REQUIRE(!cut || edges->size >= 2, GDF_DATASET_EMPTY);
+
+    switch( col_in->dtype )
+      {
+      case GDF_INT8:      status = digitize_same_type<int8_t>(col_in, edges, right, cut, out); break;
+      case GDF_INT16:     status = digitize_same_type<int16_t>(col_in, edges, right, cut, out); break;
+      case GDF_INT32:
+      case GDF_DATE32:    status = digitize_same_type<int32_t>(col_in, edges, right, cut, out); break;
+      case GDF_INT64:
+      case GDF_DATE64:
+      case GDF_TIMESTAMP: status = digitize_same_type<int64_t>(col_in, edges, right, cut, out); break;
+      case GDF_FLOAT32:   status = digitize_same_type<float>(col_in, edges, right, cut, out); break;
+      case GDF_FLOAT64:   status = digitize_same_type<double>(col_in, edges, right, cut, out); break;
+      default:            return GDF_UNSUPPORTED_DTYPE;
+      }
+    if( GDF_SUCCESS != status )
+      return status;
+    return set_bin_null_count(out);
+  }
+
+}//unknown namespace
+
+gdf_error gdf_histogram(gdf_column* col_in,
+                        double      lo,
+                        double      hi,
+                        gdf_column* counts)
+{
+  GDF_REQUIRE(nullptr != col_in && nullptr != counts, GDF_DATASET_EMPTY);
+  GDF_REQUIRE(histogram_supported_dtype(col_in->dtype), GDF_UNSUPPORTED_DTYPE);
+  GDF_REQUIRE(GDF_INT64 == counts->dtype, GDF_UNSUPPORTED_DTYPE);
+  GDF_REQUIRE(counts->size > 0 && nullptr != counts->data, GDF_DATASET_EMPTY);
+  GDF_REQUIRE(lo < hi, GDF_INVALID_API_CALL);
+
+  const fixed_width_bins bins(lo, hi, static_cast<int>(counts->size));
+  switch( col_in->dtype )
+    {
+    case GDF_INT8:      return histogram_generic<int8_t>(col_in, bins, counts);
+    case GDF_INT16:     return histogram_generic<int16_t>(col_in, bins, counts);
+    case GDF_INT32:
+    case GDF_DATE32:    return histogram_generic<int32_t>(col_in, bins, counts);
+    case GDF_INT64:
+    case GDF_DATE64:
+    case GDF_TIMESTAMP: return histogram_generic<int64_t>(col_in, bins, counts);
+    case GDF_FLOAT32:   return histogram_generic<float>(col_in, bins, counts);
+    case GDF_FLOAT64:   return histogram_generic<double>(col_in, bins, counts);
+    default:            return GDF_UNSUPPORTED_DTYPE;
+    }
+}
+
+gdf_error gdf_digitize(gdf_column* col_in,
+                       gdf_column* edges,
+                       int         right,
+                       gdf_column* out)
+{
+  return bin_by_edges(col_in, edges, 0 != right, false, out);
+}
+
+gdf_error gdf_cut(gdf_column* col_in,
+                  gdf_column* edges,
+                  int         right,
+                  gdf_column* out)
+{
+  return bin_by_edges(col_in, edges, 0 != right, true, out);
+}
+
+gdf_error gdf_qcut(gdf_column*  col_in,
+                   int          num_bins,
+                   gdf_column*  out,
+                   gdf_context* ctxt)
+{
+  gdf_error status = check_bin_output(col_in, out);
+  if( GDF_SUCCESS != status )
+    return status;
+  GDF_REQUIRE(num_bins > 0, GDF_INVALID_API_CALL);
+  GDF_REQUIRE(nullptr != ctxt, GDF_INVALID_API_CALL);
+
+  //the equi-depth edges are the quantiles at 0, 1/num_bins, ..., 1 of the
+  //valid values, as doubles; bins are closed on the right, as pandas.qcut
+  std::vector<double> qs(num_bins + 1);
+  for(int i = 0; i <= num_bins; ++i)
+    qs[i] = static_cast<double>(i) / num_bins;
+  std::vector<double> h_edges(num_bins + 1);
+
+  //date columns are quantiled as the integers they are stored as
+  gdf_column values = *col_in;
+  switch( col_in->dtype )
+    {
+    case GDF_DATE32:    values.dtype = GDF_INT32; break;
+    case GDF_DATE64:
+    case GDF_TIMESTAMP: values.dtype = GDF_INT64; break;
+    default:            break;
+    }
+  //the column is binned after its quantiles: it must not be sorted in place
+  gdf_context quantile_ctxt = *ctxt;
+  quantile_ctxt.flag_sort_inplace = 0;
+  status = gdf_quantiles(&values, GDF_QUANT_LINEAR, qs.data(), qs.size(), h_edges.data(),
+                         &quantile_ctxt);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  thrust::device_vector<double> edges(h_edges);
+  double const* d_edges = edges.data().get();
+  switch( values.dtype )
+    {
+    case GDF_INT8:    status = digitize_generic<int8_t>(col_in, d_edges, edges.size(), true, true, out); break;
+    case GDF_INT16:   status = digitize_generic<int16_t>(col_in, d_edges, edges.size(), true, true, out); break;
+    case GDF_INT32:   status = digitize_generic<int32_t>(col_in, d_edges, edges.size(), true, true, out); break;
+    case GDF_INT64:   status = digitize_generic<int64_t>(col_in, d_edges, edges.size(), true, true, out); break;
+    case GDF_FLOAT32: status = digitize_generic<float>(col_in, d_edges, edges.size(), true, true, out); break;
+    case GDF_FLOAT64: status = digitize_generic<double>(col_in, d_edges, edges.size(), true, true, out); break;
+    default:          return GDF_UNSUPPORTED_DTYPE;
+    }
+  if( GDF_SUCCESS != status )
+    return status;
+  return set_bin_null_count(out);
+}
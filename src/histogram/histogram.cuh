@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_HISTOGRAM_HISTOGRAM_CUH
+#define GDF_HISTOGRAM_HISTOGRAM_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <algorithm>
+
+#include "histogram.h"
+#include "../reductions/valid_words.h"
+
+constexpr int HISTOGRAM_BLOCK_SIZE = 256;
+constexpr int HISTOGRAM_MAX_BLOCKS = 1024;
+// Most bins, and most edges, staged in the shared memory of a block
+constexpr int HISTOGRAM_SHARED_BINS = 4096;
+constexpr gdf_size_type HISTOGRAM_SHARED_EDGES = 2048;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Counts the valid values of a column into fixed-width bins.
+ *
+ * With `privatized` bins, every block counts into bins of its own in shared
+ * memory and adds them to the global counts once at the end, so that the
+ * global atomics do not serialize on the few bins most rows fall into; past
+ * HISTOGRAM_SHARED_BINS bins, rows are spread thinly enough to count into
+ * the global bins directly.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T, bool privatized>
+__global__
+void histogram_kernel(T const *              data,
+                      gdf_valid_type const * valid,
+                      gdf_size_type          size,
+                      fixed_width_bins       bins,
+                      unsigned long long *   counts)
+{
+  extern __shared__ unsigned int block_counts[];
+  if( privatized )
+  {
+    for(int b = threadIdx.x; b < bins.num_bins; b += blockDim.x)
+      block_counts[b] = 0;
+    __syncthreads();
+  }
+
+  // Every warp covers 32 consecutive rows, one word of the mask
+  for(gdf_size_type i = blockIdx.x * blockDim.x + threadIdx.x; i < size; i += blockDim.x * gridDim.x)
+  {
+    if( !row_is_valid_in_word(valid, i, size) )
+      continue;
+    const int b = bins(data[i]);
+    if( b < 0 )
+      continue;
+    if( privatized )
+      atomicAdd(&block_counts[b], 1u);
+    else
+      atomicAdd(&counts[b], 1ull);
+  }
+
+  if( privatized )
+  {
+    __syncthreads();
+    for(int b = threadIdx.x; b < bins.num_bins; b += blockDim.x)
+      if( block_counts[b] != 0 )
+        atomicAdd(&counts[b], static_cast<unsigned long long>(block_counts[b]));
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Counts the valid values of a device column that fall in each
+ * fixed-width bin of [lo, hi]. Values outside of it, and NaN, are not
+ * counted.
+ *
+ * @Param[in] data The values
+ * @Param[in] valid The validity bitmask of the values, or nullptr
+ * @Param[in] size The number of rows
+ * @Param[in] bins The bins
+ * @Param[out] counts Device array of bins.num_bins counts
+ * @Param[in] stream The stream on which to count
+ *
+ * @Returns GDF_SUCCESS upon successful completion
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+gdf_error histogram(T const *              data,
+                    gdf_valid_type const * valid,
+                    gdf_size_type          size,
+                    fixed_width_bins       bins,
+                    int64_t *              counts,
+                    cudaStream_t           stream = 0)
+{
+  unsigned long long * d_counts = reinterpret_cast<unsigned long long *>(counts);
+  CUDA_TRY( cudaMemsetAsync(d_counts, 0, bins.num_bins * sizeof(int64_t), stream) );
+  if( size == 0 )
+    return GDF_SUCCESS;
+
+  const int num_blocks = std::min<int>((size + HISTOGRAM_BLOCK_SIZE - 1) / HISTOGRAM_BLOCK_SIZE,
+                                       HISTOGRAM_MAX_BLOCKS);
+  if( bins.num_bins <= HISTOGRAM_SHARED_BINS )
+    histogram_kernel<T, true><<<num_blocks, HISTOGRAM_BLOCK_SIZE,
+                                bins.num_bins * sizeof(unsigned int), stream>>>(
+      data, valid, size, bins, d_counts);
+  else
+    histogram_kernel<T, false><<<num_blocks, HISTOGRAM_BLOCK_SIZE, 0, stream>>>(
+      data, valid, size, bins, d_counts);
+  CUDA_CHECK_LAST();
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Maps every row of a column onto its bin index among sorted
+ * edges, with digitize_value, or cut_value if `cut`.
+ *
+ * Up to HISTOGRAM_SHARED_EDGES edges are first staged in shared memory, as
+ * every row searches them. The output validity bits of a warp's 32 rows are
+ * assembled with a ballot and stored as whole bytes: a row is valid if its
+ * value is, and, for a cut, if it falls within the edges.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T, typename E, bool right, bool cut>
+__global__
+void digitize_kernel(T const *              data,
+                     gdf_valid_type const * valid,
+                     gdf_size_type          size,
+                     E const *              edges,
+                     gdf_size_type          num_edges,
+                     int32_t *              out,
+                     gdf_valid_type *       out_valid)
+{
+  extern __shared__ unsigned char shared_edges[];
+  E const * search = edges;
+  if( num_edges <= HISTOGRAM_SHARED_EDGES )
+  {
+    E * staged = reinterpret_cast<E *>(shared_edges);
+    for(gdf_size_type e = threadIdx.x; e < num_edges; e += blockDim.x)
+      staged[e] = edges[e];
+    __syncthreads();
+    search = staged;
+  }
+
+  const unsigned lane = threadIdx.x % warpSize;
+  for(gdf_size_type tile = static_cast<gdf_size_type>(blockIdx.x) * blockDim.x;
+      tile < size;
+      tile += static_cast<gdf_size_type>(blockDim.x) * gridDim.x)
+  {
+    const gdf_size_type row = tile + threadIdx.x;
+    const bool active = row < size;
+    bool row_valid = false;
+    if( active )
+    {
+      const int32_t b = cut ? cut_value<right>(search, num_edges, data[row])
+                            : digitize_value<right>(search, num_edges, data[row]);
+      out[row] = b;
+      row_valid = gdf_is_valid(valid, row) && b >= 0;
+    }
+
+    if( nullptr != out_valid )
+    {
+      const unsigned bits = __ballot_sync(0xffffffff, row_valid);
+      if( (0 == lane % GDF_VALID_BITSIZE) && active )
+        out_valid[row / GDF_VALID_BITSIZE] = static_cast<gdf_valid_type>(bits >> lane);
+    }
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Maps the rows of a device column onto int32 bin indices among
+ * device-resident sorted edges, see digitize_value and cut_value.
+ *
+ * @Param[in] data The values
+ * @Param[in] valid The validity bitmask of the values, or nullptr
+ * @Param[in] size The number of rows
+ * @Param[in] edges Device array of sorted edges, at least two for a cut
+ * @Param[in] num_edges The number of edges
+ * @Param[in] right Whether bins are closed on the right rather than the left
+ * @Param[in] cut Whether to cut (bins between edges, -1 outside) rather than
+ * digitize
+ * @Param[out] out The bin indices
+ * @Param[out] out_valid The validity of the bin indices, or nullptr
+ * @Param[in] stream The stream on which to bin
+ *
+ * @Returns GDF_SUCCESS upon successful completion
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T, typename E>
+gdf_error digitize(T const *              data,
+                   gdf_valid_type const * valid,
+                   gdf_size_type          size,
+                   E const *              edges,
+                   gdf_size_type          num_edges,
+                   bool                   right,
+                   bool                   cut,
+                   int32_t *              out,
+                   gdf_valid_type *       out_valid,
+                   cudaStream_t           stream = 0)
+{
+  if( size == 0 )
+    return GDF_SUCCESS;
+
+  const int num_blocks = std::min<int>((size + HISTOGRAM_BLOCK_SIZE - 1) / HISTOGRAM_BLOCK_SIZE,
+                                       HISTOGRAM_MAX_BLOCKS);
+  const size_t shared_bytes = num_edges <= HISTOGRAM_SHARED_EDGES ? num_edges * sizeof(E) : 0;
+  auto kernel = cut ? (right ? digitize_kernel<T, E, true, true> : digitize_kernel<T, E, false, true>)
+                    : (right ? digitize_kernel<T, E, true, false> : digitize_kernel<T, E, false, false>);
+  kernel<<<num_blocks, HISTOGRAM_BLOCK_SIZE, shared_bytes, stream>>>(
+    data, valid, size, edges, num_edges, out, out_valid);
+  CUDA_CHECK_LAST();
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_HISTOGRAM_HISTOGRAM_CUH
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_HISTOGRAM_HISTOGRAM_H
+#define GDF_HISTOGRAM_HISTOGRAM_H
+
+#include <gdf/gdf.h>
+
+#include <cstdint>
+
+#ifdef __CUDACC__
+#define GDF_HIST_FUNC __host__ __device__ __forceinline__
+#else
+#define GDF_HIST_FUNC inline
+#endif
+
+// The numeric and date types that can be binned
+inline bool histogram_supported_dtype(gdf_dtype dtype)
+{
+  switch( dtype )
+  {
+  case GDF_INT8:
+  case GDF_INT16:
+  case GDF_INT32:
+  case GDF_INT64:
+  case GDF_FLOAT32:
+  case GDF_FLOAT64:
+  case GDF_DATE32:
+  case GDF_DATE64:
+  case GDF_TIMESTAMP: return true;
+  default:            return false;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The fixed-width bins of [lo, hi]: bin b holds
+ * [lo + b w, lo + (b + 1) w), with w = (hi - lo) / num_bins, except the last
+ * one which also holds hi, as numpy.histogram does.
+ */
+/* ----------------------------------------------------------------------------*/
+struct fixed_width_bins
+{
+  double lo;
+  double hi;
+  double scale;     // num_bins / (hi - lo)
+  int num_bins;
+
+  fixed_width_bins(double lo, double hi, int num_bins)
+    : lo(lo), hi(hi), scale(num_bins / (hi - lo)), num_bins(num_bins)
+  {}
+
+  // The bin of a value, or -1 if it is outside of [lo, hi] or NaN
+  template <typename T>
+  GDF_HIST_FUNC
+  int operator()(T x) const
+  {
+    const double v = static_cast<double>(x);
+    if( !(v >= lo && v <= hi) )
+      return -1;
+    const int b = static_cast<int>((v - lo) * scale);
+    return b < num_bins ? b : num_bins - 1;
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The number of sorted edges below x: those <= x if `inclusive`,
+ * else those < x. NaN values count as above every edge, as they sort last.
+ *
+ * The search halves the range with a conditional move rather than a branch,
+ * so every lookup takes the same ceil(log2(num_edges)) steps whatever the
+ * value: threads of a warp stay converged, and the host loop does not
+ * mispredict on random values.
+ */
+/* ----------------------------------------------------------------------------*/
+template <bool inclusive, typename E>
+GDF_HIST_FUNC
+gdf_size_type edges_below(E const * edges, gdf_size_type num_edges, E x)
+{
+  if( x != x )
+    return num_edges;
+  if( 0 == num_edges )
+    return 0;
+  E const * base = edges;
+  gdf_size_type n = num_edges;
+  while( n > 1 )
+  {
+    const gdf_size_type half = n / 2;
+    const E e = base[half];
+    base = (inclusive ? e <= x : e < x) ? base + half : base;
+    n -= half;
+  }
+  const E e = *base;
+  return (base - edges) + ((inclusive ? e <= x : e < x) ? 1 : 0);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  gdf_digitize of a value: the index i such that
+ * edges[i - 1] <= x < edges[i] (or edges[i - 1] < x <= edges[i] if `right`),
+ * from 0 below the first edge to num_edges above the last, as numpy.digitize.
+ */
+/* ----------------------------------------------------------------------------*/
+template <bool right, typename E, typename T>
+GDF_HIST_FUNC
+int32_t digitize_value(E const * edges, gdf_size_type num_edges, T x)
+{
+  return static_cast<int32_t>(edges_below<!right>(edges, num_edges, static_cast<E>(x)));
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  gdf_cut of a value: the bin i in [0, num_edges - 2] such that
+ * edges[i] <= x < edges[i + 1] (or edges[i] < x <= edges[i + 1] if `right`),
+ * or -1 if x is outside of [edges[0], edges[num_edges - 1]]. The outermost
+ * edges are inclusive both ways, so that every value of that range has a bin.
+ */
+/* ----------------------------------------------------------------------------*/
+template <bool right, typename E, typename T>
+GDF_HIST_FUNC
+int32_t cut_value(E const * edges, gdf_size_type num_edges, T x)
+{
+  const E v = static_cast<E>(x);
+  if( !(v >= edges[0] && v <= edges[num_edges - 1]) )
+    return -1;
+  const int32_t b = static_cast<int32_t>(edges_below<!right>(edges, num_edges, v)) - 1;
+  const int32_t last = static_cast<int32_t>(num_edges) - 2;
+  return b < 0 ? 0 : (b > last ? last : b);
+}
+
+#endif // GDF_HISTOGRAM_HISTOGRAM_H
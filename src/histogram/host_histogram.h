@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_HISTOGRAM_HOST_HISTOGRAM_H
+#define GDF_HISTOGRAM_HOST_HISTOGRAM_H
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "histogram.h"
+#include "../reductions/valid_words.h"
+#include "../util/host_parallel.h"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of histogram: counts the valid values of a
+ * host column into fixed-width bins.
+ *
+ * Every host thread counts its rows into bins of its own, added up at the
+ * end, and walks the runs of valid rows with host_for_each_valid_run.
+ *
+ * @Param[in] data The values
+ * @Param[in] valid The validity bitmask of the values, or nullptr
+ * @Param[in] size The number of rows
+ * @Param[in] bins The bins
+ * @Param[out] counts Host array of bins.num_bins counts
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+void host_histogram(T const *              data,
+                    gdf_valid_type const * valid,
+                    size_t                 size,
+                    fixed_width_bins       bins,
+                    int64_t *              counts)
+{
+  const unsigned num_threads = gdf::util::host_num_threads(size);
+  std::vector<std::vector<int64_t>> partial(num_threads, std::vector<int64_t>(bins.num_bins, 0));
+  gdf::util::host_parallel_for(size, num_threads,
+    [&](unsigned tid, size_t begin, size_t end) {
+      int64_t * local = partial[tid].data();
+      host_for_each_valid_run(valid, begin, end, [&](size_t first, size_t last) {
+        for(size_t i = first; i < last; ++i)
+        {
+          const int b = bins(data[i]);
+          if( b >= 0 )
+            ++local[b];
+        }
+      });
+    });
+
+  std::fill(counts, counts + bins.num_bins, 0);
+  for(auto const & p : partial)
+    for(int b = 0; b < bins.num_bins; ++b)
+      counts[b] += p[b];
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of digitize: maps the rows of a host column
+ * onto int32 bin indices among sorted edges.
+ *
+ * The `right` and `cut` flags are resolved once, outside of the row loop,
+ * which is then a branch-free search per row.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T, typename E, bool right, bool cut>
+void host_digitize_rows(T const *              data,
+                        gdf_valid_type const * valid,
+                        size_t                 size,
+                        E const *              edges,
+                        gdf_size_type          num_edges,
+                        int32_t *              out,
+                        gdf_valid_type *       out_valid)
+{
+  const unsigned num_threads = gdf::util::host_num_threads(size);
+  // Ranges of whole bytes of the mask, so that threads do not share a byte
+  const size_t num_bytes = gdf_get_num_chars_bitmask(size);
+  gdf::util::host_parallel_for(num_bytes, num_threads,
+    [&](unsigned, size_t first_byte, size_t last_byte) {
+      const size_t begin = first_byte * GDF_VALID_BITSIZE;
+      const size_t end = std::min(size, last_byte * GDF_VALID_BITSIZE);
+      for(size_t i = begin; i < end; ++i)
+        out[i] = cut ? cut_value<right>(edges, num_edges, data[i])
+                     : digitize_value<right>(edges, num_edges, data[i]);
+      if( nullptr == out_valid )
+        return;
+      for(size_t byte = first_byte; byte < last_byte; ++byte)
+      {
+        gdf_valid_type bits = 0;
+        for(size_t i = byte * GDF_VALID_BITSIZE; i < std::min(end, (byte + 1) * GDF_VALID_BITSIZE); ++i)
+          if( gdf_is_valid(valid, i) && out[i] >= 0 )
+            bits |= gdf_valid_type(1) << (i % GDF_VALID_BITSIZE);
+        out_valid[byte] = bits;
+      }
+    });
+}
+
+template <typename T, typename E>
+void host_digitize(T const *              data,
+                   gdf_valid_type const * valid,
+                   size_t                 size,
+                   E const *              edges,
+                   gdf_size_type          num_edges,
+                   bool                   right,
+                   bool                   cut,
+                   int32_t *              out,
+                   gdf_valid_type *       out_valid)
+{
+  auto rows = cut ? (right ? host_digitize_rows<T, E, true, true> : host_digitize_rows<T, E, false, true>)
+                  : (right ? host_digitize_rows<T, E, true, false> : host_digitize_rows<T, E, false, false>);
+  rows(data, valid, size, edges, num_edges, out, out_valid);
+}
+
+#endif // GDF_HISTOGRAM_HOST_HISTOGRAM_H
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Approximate distinct counts (HyperLogLog) of columns and row tuples
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include "hyperloglog/hyperloglog.cuh"
+
+namespace {
+
+  gdf_error check_hll_columns(int ncols, gdf_column** cols)
+  {
+    GDF_REQUIRE(ncols > 0 && nullptr != cols, GDF_DATASET_EMPTY);
+    for(int i = 0; i < ncols; ++i)
+      {
+        GDF_REQUIRE(nullptr != cols[i], GDF_DATASET_EMPTY);
+        GDF_REQUIRE(cols[i]->size == cols[0]->size, GDF_COLUMN_SIZE_MISMATCH);
+        GDF_REQUIRE(hll_supported_dtype(cols[i]->dtype), GDF_UNSUPPORTED_DTYPE);
+        GDF_REQUIRE(0 == cols[i]->size || nullptr != cols[i]->data, GDF_DATASET_EMPTY);
+      }
+    return GDF_SUCCESS;
+  }
+
+}//unknown namespace
+
+gdf_hll_type* cffi_wrap(hyperloglog* obj){
+  return reinterpret_cast<gdf_hll_type*>(obj);
+}
+
+hyperloglog* cffi_unwrap(gdf_hll_type* hdl){
+  return reinterpret_cast<hyperloglog*>(hdl);
+}
+
+gdf_hll_type* gdf_hll_create(int precision)
+{
+  if( 0 == precision )
+    precision = HLL_DEFAULT_PRECISION;
+  if( !hyperloglog::valid_precision(precision) )
+    return nullptr;
+  return cffi_wrap(new hyperloglog(precision));
+}
+
+gdf_error gdf_hll_add(gdf_hll_type* hdl,
+                      int           ncols,
+                      gdf_column**  cols)
+{
+  GDF_REQUIRE(nullptr != hdl, GDF_INVALID_API_CALL);
+  gdf_error status = check_hll_columns(ncols, cols);
+  if( GDF_SUCCESS != status )
+    return status;
+  return device_hll_add(*cffi_unwrap(hdl), ncols, cols);
+}
+
+gdf_error gdf_hll_merge(gdf_hll_type*       dst,
+                        const gdf_hll_type* src)
+{
+  GDF_REQUIRE(nullptr != dst && nullptr != src, GDF_INVALID_API_CALL);
+  cffi_unwrap(dst)->merge(*reinterpret_cast<hyperloglog const*>(src));
+  return GDF_SUCCESS;
+}
+
+gdf_error gdf_hll_estimate(gdf_hll_type* hdl,
+                           double*       estimate)
+{
+  GDF_REQUIRE(nullptr != hdl, GDF_INVALID_API_CALL);
+  *estimate = cffi_unwrap(hdl)->estimate();
+  return GDF_SUCCESS;
+}
+
+gdf_error gdf_hll_serialized_size(gdf_hll_type* hdl,
+                                  size_t*       bytes)
+{
+  GDF_REQUIRE(nullptr != hdl, GDF_INVALID_API_CALL);
+  *bytes = cffi_unwrap(hdl)->serialized_size();
+  return GDF_SUCCESS;
+}
+
+gdf_error gdf_hll_serialize(gdf_hll_type* hdl,
+                            void*         buffer)
+{
+  GDF_REQUIRE(nullptr != hdl, GDF_INVALID_API_CALL);
+  cffi_unwrap(hdl)->serialize(buffer);
+  return GDF_SUCCESS;
+}
+
+gdf_error gdf_hll_deserialize(const void*    buffer,
+                              size_t         bytes,
+                              gdf_hll_type** hdl)
+{
+  hyperloglog* sketch = new hyperloglog(HLL_MIN_PRECISION);
+  if( !sketch->deserialize(buffer, bytes) )
+    {
+      delete sketch;
+      return GDF_INVALID_API_CALL;
+    }
+  *hdl = cffi_wrap(sketch);
+  return GDF_SUCCESS;
+}
+
+gdf_error gdf_hll_free(gdf_hll_type* hdl)
+{
+  delete cffi_unwrap(hdl);
+  return GDF_SUCCESS;
+}
+
+gdf_error gdf_approx_count_distinct(int          ncols,
+                                    gdf_column** cols,
+                                    int          precision,
+                                    double*      estimate)
+{
+  if( 0 == precision )
+    precision = HLL_DEFAULT_PRECISION;
+  GDF_REQUIRE(hyperloglog::valid_precision(precision), GDF_INVALID_API_CALL);
+  gdf_error status = check_hll_columns(ncols, cols);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  hyperloglog sketch(precision);
+  status = device_hll_add(sketch, ncols, cols);
+  if( GDF_SUCCESS != status )
+    return status;
+  *estimate = sketch.estimate();
+  return GDF_SUCCESS;
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_HYPERLOGLOG_HOST_HYPERLOGLOG_H
+#define GDF_HYPERLOGLOG_HOST_HYPERLOGLOG_H
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "hyperloglog.h"
+#include "../hashmap/hash_functions.cuh"
+#include "../util/host_parallel.h"
+
+// Rows hashed at once, column by column
+constexpr size_t HOST_HLL_BLOCK = 1024;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Hashes rows [begin, end) of one column into `hashes`, and
+ * combines the hashes with those of the previous columns the way
+ * gdf_table::hash_row does, so that host and device sketches of the same
+ * rows are equal.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+void host_hll_hash_column(void const * data, size_t begin, size_t end,
+                          bool first, hash_value_type * hashes)
+{
+  MurmurHash3_32<T> hasher;
+  T const * values = static_cast<T const *>(data);
+  for(size_t row = begin; row < end; ++row)
+  {
+    const hash_value_type key_hash = hasher(values[row]);
+    hashes[row - begin] = first ? key_hash
+                                : hasher.hash_combine(hashes[row - begin], key_hash);
+  }
+}
+
+inline
+gdf_error host_hll_hash_column(gdf_column const * col, size_t begin, size_t end,
+                               bool first, hash_value_type * hashes)
+{
+  switch( col->dtype )
+  {
+  case GDF_INT8:      host_hll_hash_column<int8_t>(col->data, begin, end, first, hashes); break;
+  case GDF_INT16:     host_hll_hash_column<int16_t>(col->data, begin, end, first, hashes); break;
+  case GDF_INT32:
+  case GDF_DATE32:    host_hll_hash_column<int32_t>(col->data, begin, end, first, hashes); break;
+  case GDF_INT64:
+  case GDF_DATE64:
+  case GDF_TIMESTAMP: host_hll_hash_column<int64_t>(col->data, begin, end, first, hashes); break;
+  case GDF_FLOAT32:   host_hll_hash_column<float>(col->data, begin, end, first, hashes); break;
+  case GDF_FLOAT64:   host_hll_hash_column<double>(col->data, begin, end, first, hashes); break;
+  default:            return GDF_UNSUPPORTED_DTYPE;
+  }
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of device_hll_add: adds the rows of
+ * host-resident columns without nulls to a sketch.
+ *
+ * The rows are split between host threads, each with registers of its own,
+ * merged at the end. Every thread hashes a block of HOST_HLL_BLOCK rows one
+ * column at a time, so that the type dispatch is paid once per block and
+ * column rather than once per value.
+ *
+ * @Param[in,out] sketch The sketch to add the rows to
+ * @Param[in] num_cols The number of columns
+ * @Param[in] cols The columns, all of the same size, in host memory
+ *
+ * @Returns GDF_SUCCESS upon successful completion
+ */
+/* ----------------------------------------------------------------------------*/
+inline
+gdf_error host_hll_add(hyperloglog & sketch, int num_cols, gdf_column ** cols)
+{
+  const size_t num_rows = cols[0]->size;
+  for(int c = 0; c < num_cols; ++c)
+  {
+    GDF_REQUIRE( cols[c]->size == num_rows, GDF_COLUMN_SIZE_MISMATCH );
+    GDF_REQUIRE( hll_supported_dtype(cols[c]->dtype), GDF_UNSUPPORTED_DTYPE );
+  }
+
+  const unsigned num_threads = gdf::util::host_num_threads(num_rows);
+  std::vector<hyperloglog> partial(num_threads, hyperloglog(sketch.precision));
+  gdf::util::host_parallel_for(num_rows, num_threads,
+    [&](unsigned tid, size_t first, size_t last) {
+      hash_value_type hashes[HOST_HLL_BLOCK];
+      for(size_t begin = first; begin < last; begin += HOST_HLL_BLOCK)
+      {
+        const size_t end = std::min(last, begin + HOST_HLL_BLOCK);
+        for(int c = 0; c < num_cols; ++c)
+          host_hll_hash_column(cols[c], begin, end, 0 == c, hashes);
+
+        for(size_t row = begin; row < end; ++row)
+        {
+          bool valid = true;
+          for(int c = 0; c < num_cols && valid; ++c)
+            valid = gdf_is_valid(cols[c]->valid, row);
+          if( valid )
+            partial[tid].add_hash(hashes[row - begin]);
+        }
+      }
+    });
+
+  for(auto const & p : partial)
+    sketch.merge_registers(p.registers.data());
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_HYPERLOGLOG_HOST_HYPERLOGLOG_H
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_HYPERLOGLOG_HYPERLOGLOG_CUH
+#define GDF_HYPERLOGLOG_HYPERLOGLOG_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <thrust/device_vector.h>
+
+#include <memory>
+#include <vector>
+
+#include "hyperloglog.h"
+#include "../gdf_table.cuh"
+
+constexpr int HLL_BLOCK_SIZE = 256;
+constexpr int HLL_MAX_BLOCKS = 1024;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Adds the hash of every row of a table without nulls to the
+ * registers of a sketch, with an atomic max.
+ *
+ * Once a sketch has seen a few times as many rows as it has registers, almost
+ * no row raises its register: the register is read first, and the atomic is
+ * only issued by the rows that would raise it.
+ */
+/* ----------------------------------------------------------------------------*/
+template <template <typename> class hash_function, typename size_type>
+__global__
+void hll_add_rows(gdf_table<size_type> const & table,
+                  const size_type              num_rows,
+                  const int                    precision,
+                  unsigned int *               registers)
+{
+  for(size_type row = threadIdx.x + blockIdx.x * blockDim.x;
+      row < num_rows;
+      row += blockDim.x * gridDim.x)
+  {
+    if( !table.is_row_valid(row) )
+      continue;
+    const uint32_t h = hll_mix(table.template hash_row<hash_function>(row));
+    const uint32_t reg = hll_register(h, precision);
+    const uint32_t rank = hll_rank(h, precision);
+    if( rank > registers[reg] )
+      atomicMax(&registers[reg], rank);
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Adds the rows of device-resident columns to a sketch. Rows with
+ * a null in any column are skipped, as COUNT(DISTINCT) does.
+ *
+ * The rows are hashed with gdf_table::hash_row, the hash of gdf_hash, into
+ * 32 bit registers on the device; only the registers are copied back and
+ * merged into the host-resident sketch.
+ *
+ * @Param[in,out] sketch The sketch to add the rows to
+ * @Param[in] num_cols The number of columns
+ * @Param[in] cols The columns, all of the same size
+ *
+ * @Returns GDF_SUCCESS upon successful completion
+ */
+/* ----------------------------------------------------------------------------*/
+inline
+gdf_error device_hll_add(hyperloglog & sketch, int num_cols, gdf_column ** cols)
+{
+  using size_type = int64_t;
+
+  const size_type num_rows = cols[0]->size;
+  if( 0 == num_rows )
+    return GDF_SUCCESS;
+
+  std::unique_ptr< gdf_table<size_type> > table{new gdf_table<size_type>(num_cols, cols)};
+
+  thrust::device_vector<unsigned int> d_registers(sketch.num_registers(), 0);
+  const int num_blocks = static_cast<int>(std::min<size_type>(
+      HLL_MAX_BLOCKS, (num_rows + HLL_BLOCK_SIZE - 1) / HLL_BLOCK_SIZE));
+  hll_add_rows<MurmurHash3_32><<<num_blocks, HLL_BLOCK_SIZE>>>(
+      *table, num_rows, sketch.precision, d_registers.data().get());
+  CUDA_CHECK_LAST();
+
+  std::vector<unsigned int> registers(sketch.num_registers());
+  CUDA_TRY( cudaMemcpy(registers.data(), d_registers.data().get(),
+                       registers.size() * sizeof(unsigned int),
+                       cudaMemcpyDeviceToHost) );
+  sketch.merge_registers(registers.data());
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_HYPERLOGLOG_HYPERLOGLOG_CUH
@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_HYPERLOGLOG_HYPERLOGLOG_H
+#define GDF_HYPERLOGLOG_HYPERLOGLOG_H
+
+#include <gdf/gdf.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef __CUDACC__
+#define GDF_HLL_FUNC __host__ __device__ __forceinline__
+#else
+#define GDF_HLL_FUNC inline
+#endif
+
+// Smallest, default and largest precision (log2 of the number of registers)
+constexpr int HLL_MIN_PRECISION = 4;
+constexpr int HLL_DEFAULT_PRECISION = 14;
+constexpr int HLL_MAX_PRECISION = 18;
+
+// Tag of the serialized form of a sketch
+constexpr uint32_t HLL_SERIAL_MAGIC = 0x484c4c01;
+// Bytes ahead of the registers in the serialized form: tag and precision
+constexpr size_t HLL_SERIAL_HEADER = 2 * sizeof(uint32_t);
+
+// The types gdf_table::hash_row can hash
+inline bool hll_supported_dtype(gdf_dtype dtype)
+{
+  switch( dtype )
+  {
+  case GDF_INT8:
+  case GDF_INT16:
+  case GDF_INT32:
+  case GDF_INT64:
+  case GDF_FLOAT32:
+  case GDF_FLOAT64:
+  case GDF_DATE32:
+  case GDF_DATE64:
+  case GDF_TIMESTAMP: return true;
+  default:            return false;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Re-mixes a 32 bit row hash before it is split into a register
+ * index and a rank: the hash_combine of multi-column rows leaves the high
+ * bits poorly mixed. This is the MurmurHash3 finalizer, a bijection.
+ */
+/* ----------------------------------------------------------------------------*/
+GDF_HLL_FUNC
+uint32_t hll_mix(uint32_t h)
+{
+  h ^= h >> 16;
+  h *= 0x85ebca6b;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35;
+  h ^= h >> 16;
+  return h;
+}
+
+// The register of a mixed hash: its top `precision` bits
+GDF_HLL_FUNC
+uint32_t hll_register(uint32_t h, int precision)
+{
+  return h >> (32 - precision);
+}
+
+// The rank of a mixed hash: one plus the number of leading zeros of the
+// bits below the register index, at most 33 - precision
+GDF_HLL_FUNC
+uint32_t hll_rank(uint32_t h, int precision)
+{
+  const uint32_t w = h << precision;
+  if( 0 == w )
+    return 33 - precision;
+#ifdef __CUDA_ARCH__
+  return __clz(w) + 1;
+#else
+  return __builtin_clz(w) + 1;
+#endif
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  A HyperLogLog sketch: an estimate of the number of distinct
+ * hashes added to it, within a relative standard error of about
+ * 1.04 / sqrt(2^precision), in 2^precision bytes whatever that number.
+ *
+ * Every register holds the largest rank of the hashes that map to it. Sketches
+ * are merged with an elementwise max, so that sketches built on different
+ * partitions (on the device or on the host) combine to the sketch of the
+ * union; sketches of different precisions are merged at the smaller one.
+ */
+/* ----------------------------------------------------------------------------*/
+struct hyperloglog
+{
+  int precision;
+  std::vector<uint8_t> registers;
+
+  explicit hyperloglog(int precision = HLL_DEFAULT_PRECISION)
+    : precision(precision),
+      registers(size_t{1} << precision, 0)
+  {}
+
+  static bool valid_precision(int precision)
+  {
+    return precision >= HLL_MIN_PRECISION && precision <= HLL_MAX_PRECISION;
+  }
+
+  size_t num_registers() const { return registers.size(); }
+
+  void add_hash(uint32_t row_hash)
+  {
+    const uint32_t h = hll_mix(row_hash);
+    uint8_t & reg = registers[hll_register(h, precision)];
+    reg = std::max(reg, static_cast<uint8_t>(hll_rank(h, precision)));
+  }
+
+  // Max of the registers with those of a sketch of the same precision
+  template <typename R>
+  void merge_registers(R const * other)
+  {
+    for(size_t i = 0; i < registers.size(); ++i)
+      registers[i] = std::max(registers[i], static_cast<uint8_t>(other[i]));
+  }
+
+  /* ------------------------------------------------------------------------*/
+  /**
+   * Lowers the precision of the sketch to `p`: the register bits dropped from
+   * the index become the leading bits of the rank, so that the result is the
+   * sketch the same hashes would have built at precision p.
+   */
+  /* ------------------------------------------------------------------------*/
+  void fold(int p)
+  {
+    if( p >= precision )
+      return;
+    const int d = precision - p;
+    std::vector<uint8_t> folded(size_t{1} << p, 0);
+    for(size_t i = 0; i < registers.size(); ++i)
+    {
+      if( 0 == registers[i] )
+        continue;
+      const uint32_t low = static_cast<uint32_t>(i) & ((1u << d) - 1);
+      const uint32_t rank = (0 == low) ? d + registers[i]
+                                       : d - (31 - __builtin_clz(low));
+      uint8_t & reg = folded[i >> d];
+      reg = std::max(reg, static_cast<uint8_t>(rank));
+    }
+    precision = p;
+    registers.swap(folded);
+  }
+
+  void merge(hyperloglog const & other)
+  {
+    if( other.precision < precision )
+      fold(other.precision);
+    if( other.precision == precision )
+    {
+      merge_registers(other.registers.data());
+      return;
+    }
+    hyperloglog folded(other);
+    folded.fold(precision);
+    merge_registers(folded.registers.data());
+  }
+
+  /* ------------------------------------------------------------------------*/
+  /**
+   * The raw HyperLogLog estimate, with linear counting while some registers
+   * are still empty and small, and the correction for hash collisions of a
+   * 32 bit hash at the top of its range.
+   */
+  /* ------------------------------------------------------------------------*/
+  double estimate() const
+  {
+    const double m = static_cast<double>(registers.size());
+    double alpha;
+    switch( registers.size() )
+    {
+    case 16: alpha = 0.673; break;
+    case 32: alpha = 0.697; break;
+    case 64: alpha = 0.709; break;
+    default: alpha = 0.7213 / (1.0 + 1.079 / m); break;
+    }
+
+    double sum = 0.0;
+    size_t zeros = 0;
+    for(uint8_t reg : registers)
+    {
+      sum += std::ldexp(1.0, -static_cast<int>(reg));
+      zeros += (0 == reg);
+    }
+    const double raw = alpha * m * m / sum;
+
+    if( raw <= 2.5 * m && zeros > 0 )
+      return m * std::log(m / static_cast<double>(zeros));
+    const double two32 = 4294967296.0;
+    if( raw > two32 / 30.0 )
+      return -two32 * std::log(1.0 - raw / two32);
+    return raw;
+  }
+
+  size_t serialized_size() const
+  {
+    return HLL_SERIAL_HEADER + registers.size();
+  }
+
+  void serialize(void * buffer) const
+  {
+    const uint32_t header[2] = {HLL_SERIAL_MAGIC, static_cast<uint32_t>(precision)};
+    std::memcpy(buffer, header, HLL_SERIAL_HEADER);
+    std::memcpy(static_cast<char *>(buffer) + HLL_SERIAL_HEADER,
+                registers.data(), registers.size());
+  }
+
+  // Returns false if the buffer does not hold a serialized sketch
+  bool deserialize(void const * buffer, size_t bytes)
+  {
+    if( bytes < HLL_SERIAL_HEADER )
+      return false;
+    uint32_t header[2];
+    std::memcpy(header, buffer, HLL_SERIAL_HEADER);
+    const int p = static_cast<int>(header[1]);
+    if( header[0] != HLL_SERIAL_MAGIC || !valid_precision(p) ||
+        bytes != HLL_SERIAL_HEADER + (size_t{1} << p) )
+      return false;
+    precision = p;
+    registers.resize(size_t{1} << p);
+    std::memcpy(registers.data(), static_cast<char const *>(buffer) + HLL_SERIAL_HEADER,
+                registers.size());
+    return true;
+  }
+};
+
+#endif // GDF_HYPERLOGLOG_HYPERLOGLOG_H
@@ -290,6 +290,11 @@ gdf_error join_call( int num_cols, gdf_column **leftcol, gdf_column **rightcol,
 
   using size_type = int64_t;
 
+  // Cleared before any early return, so that a failed call does not report
+  // the order of the previous one
+  if(nullptr != join_context)
+    join_context->flag_output_sorted = 0;
+
   if( (0 == num_cols) || (nullptr == leftcol) || (nullptr == rightcol))
     return GDF_DATASET_EMPTY;
 
@@ -370,6 +375,10 @@ gdf_error join_call( int num_cols, gdf_column **leftcol, gdf_column **rightcol,
       gdf_error_code =  GDF_UNSUPPORTED_METHOD;
   }
 
+  // The sort-based join emits the matches in the order of the sorted left rows
+  if( (GDF_SUCCESS == gdf_error_code) && (GDF_SORT == join_method) )
+    join_context->flag_output_sorted = 1;
+
   POP_RANGE();
 
   return gdf_error_code;
@@ -422,14 +431,12 @@ gdf_error construct_join_output_df(
         int col_width; get_column_byte_width(result_cols[i], &col_width);
         CUDA_TRY( cudaMalloc(&(result_cols[i]->data), col_width * join_size) );
         CUDA_TRY( cudaMalloc(&(result_cols[i]->valid), sizeof(gdf_valid_type)*gdf_get_num_chars_bitmask(join_size)) );
-        CUDA_TRY( cudaMemset(result_cols[i]->valid, 0, sizeof(gdf_valid_type)*gdf_get_num_chars_bitmask(join_size)) );
     }
     for (int i = right_table_begin; i < result_num_cols; ++i) {
         gdf_column_view(result_cols[i], nullptr, nullptr, join_size, rnonjoincol[i - right_table_begin]->dtype);
         int col_width; get_column_byte_width(result_cols[i], &col_width);
         CUDA_TRY( cudaMalloc(&(result_cols[i]->data), col_width * join_size) );
         CUDA_TRY( cudaMalloc(&(result_cols[i]->valid), sizeof(gdf_valid_type)*gdf_get_num_chars_bitmask(join_size)) );
-        CUDA_TRY( cudaMemset(result_cols[i]->valid, 0, sizeof(gdf_valid_type)*gdf_get_num_chars_bitmask(join_size)) );
     }
     //create joined output column data buffers
     for (int join_index = 0; join_index < num_cols_to_join; ++join_index) {
@@ -438,29 +445,20 @@ gdf_error construct_join_output_df(
         int col_width; get_column_byte_width(result_cols[i], &col_width);
         CUDA_TRY( cudaMalloc(&(result_cols[i]->data), col_width * join_size) );
         CUDA_TRY( cudaMalloc(&(result_cols[i]->valid), sizeof(gdf_valid_type)*gdf_get_num_chars_bitmask(join_size)) );
-        CUDA_TRY( cudaMemset(result_cols[i]->valid, 0, sizeof(gdf_valid_type)*gdf_get_num_chars_bitmask(join_size)) );
-    }
-
-    gdf_error err{GDF_SUCCESS};
-    if (0 != lnonjoincol.size()) {
-        gdf_table<size_type> l_i_table(lnonjoincol.size(), lnonjoincol.data());
-        gdf_table<size_type> l_table(num_left_cols - num_cols_to_join, result_cols);
-        err = l_i_table.gather(static_cast<index_type*>(left_indices->data),
-                l_table, join_type != JoinType::INNER_JOIN);
-        if (err != GDF_SUCCESS) { return err; }
-    }
-    if (0 != rnonjoincol.size()) {
-        gdf_table<size_type> r_i_table(rnonjoincol.size(), rnonjoincol.data());
-        gdf_table<size_type> r_table(num_right_cols - num_cols_to_join, result_cols + right_table_begin);
-        err = r_i_table.gather(static_cast<index_type*>(right_indices->data),
-                r_table, join_type != JoinType::INNER_JOIN);
-        if (err != GDF_SUCCESS) { return err; }
     }
 
-    gdf_table<size_type> j_i_table(ljoincol.size(), ljoincol.data());
-    gdf_table<size_type> j_table(num_cols_to_join, result_cols + left_table_end);
-    err = j_i_table.gather(static_cast<index_type*>(left_indices->data),
-            j_table, join_type != JoinType::INNER_JOIN);
+    //gather the left non-join columns and the join columns, which occupy
+    //the first num_left_cols output columns, in one pass over left_indices
+    //(the validity masks are written in full by the gathers)
+    std::vector<gdf_column*> l_i_cols(lnonjoincol);
+    l_i_cols.insert(l_i_cols.end(), ljoincol.begin(), ljoincol.end());
+    const bool range_check = join_type != JoinType::INNER_JOIN;
+    gdf_error err = gather_table(l_i_cols.data(), result_cols, l_i_cols.size(),
+            static_cast<index_type*>(left_indices->data), join_size, range_check);
+    if (err != GDF_SUCCESS) { return err; }
+
+    err = gather_table(rnonjoincol.data(), result_cols + right_table_begin, rnonjoincol.size(),
+            static_cast<index_type*>(right_indices->data), join_size, range_check);
 
 	POP_RANGE();
     return err;
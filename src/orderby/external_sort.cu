@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <thrust/device_vector.h>
+
+#include <algorithm>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "radix_order_by.cuh"
+#include "external_sort.h"
+
+namespace {
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Sorts one chunk of host resident columns on the device and
+ * fetches back its packed key words and row indices in sorted order.
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error device_sort_chunk(std::vector<gdf_column> const & chunk,
+                            order_by_type const *           asc_desc,
+                            null_order_type const *         null_order,
+                            std::vector<key_field> const &  fields,
+                            std::vector<key_word> const &   words,
+                            size_t                          begin,
+                            sorted_run &                    run,
+                            cudaStream_t                    stream)
+{
+  const size_t size = chunk.front().size;
+
+  // Stage the chunk on the device
+  std::vector<thrust::device_vector<char>> d_data(chunk.size());
+  std::vector<thrust::device_vector<gdf_valid_type>> d_valid(chunk.size());
+  std::vector<gdf_column> d_chunk(chunk);
+  for(size_t c = 0; c < chunk.size(); ++c)
+  {
+    const size_t data_bytes = size * (normalized_key_bits(chunk[c].dtype) / 8);
+    d_data[c].resize(data_bytes);
+    CUDA_TRY( cudaMemcpyAsync(d_data[c].data().get(), chunk[c].data, data_bytes,
+                              cudaMemcpyHostToDevice, stream) );
+    d_chunk[c].data = d_data[c].data().get();
+
+    if( chunk[c].valid )
+    {
+      const size_t valid_bytes = gdf_get_num_chars_bitmask(size);
+      d_valid[c].resize(valid_bytes);
+      CUDA_TRY( cudaMemcpyAsync(d_valid[c].data().get(), chunk[c].valid, valid_bytes,
+                                cudaMemcpyHostToDevice, stream) );
+      d_chunk[c].valid = d_valid[c].data().get();
+    }
+  }
+
+  thrust::device_vector<uint64_t> d_indx(size);
+  thrust::sequence(thrust::cuda::par.on(stream), d_indx.begin(), d_indx.end(), 0);
+  gdf_error status = radix_order_rows(d_chunk.data(), asc_desc, null_order, fields, words,
+                                      size, d_indx.data().get(), stream);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  // Key words of the rows in sorted order, so that the runs can be merged
+  // without looking at the columns again
+  thrust::device_vector<uint64_t> d_keys(size);
+  run.keys.resize(words.size());
+  for(size_t w = 0; w < words.size(); ++w)
+  {
+    status = build_key_word(d_chunk.data(), asc_desc, null_order, fields.data(), words[w],
+                            size, d_keys.data().get(), d_indx.data().get(), stream);
+    if( GDF_SUCCESS != status )
+      return status;
+    run.keys[w].resize(size);
+    CUDA_TRY( cudaMemcpyAsync(run.keys[w].data(), d_keys.data().get(), size * sizeof(uint64_t),
+                              cudaMemcpyDeviceToHost, stream) );
+  }
+
+  run.indx.resize(size);
+  CUDA_TRY( cudaMemcpyAsync(run.indx.data(), d_indx.data().get(), size * sizeof(uint64_t),
+                            cudaMemcpyDeviceToHost, stream) );
+  CUDA_TRY( cudaStreamSynchronize(stream) );
+
+  for(auto & i : run.indx)
+    i += begin;
+  return GDF_SUCCESS;
+}
+
+} // namespace
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Orders a table whose columns reside in host memory and do not
+ * fit on the device in one piece.
+ *
+ * The table is cut into chunks that fit `device_memory_budget`; each chunk is
+ * sorted on the device with the radix order-by engine and spilled to
+ * `spill_dir` as a run of packed key words and row indices, while the next
+ * chunk is being sorted. The runs are then k-way merged on the host with a
+ * loser tree, reading every run in large, double-buffered blocks; beyond
+ * EXTERNAL_SORT_MAX_RUNS runs, the merge takes several passes through
+ * intermediate run files. The runs hold the normalized key words rather than
+ * the key columns: only the permutation is returned.
+ *
+ * @Param[in] nrows The number of rows
+ * @Param[in] cols Host array of the key columns (data resident on the host)
+ * @Param[in] ncols The number of key columns
+ * @Param[in] asc_desc Host array of per-column sort direction, or NULL for all
+ * ascending
+ * @Param[in] null_order Host array of per-column NULL placement, or NULL for
+ * all NULLS LAST
+ * @Param[in] device_memory_budget Device memory in bytes available to sort one chunk
+ * @Param[in] spill_dir Directory for the temporary run files
+ * @Param[out] h_indx Host array of nrows row indices, in sorted order
+ *
+ * @Returns GDF_SUCCESS upon successful completion, GDF_UNSUPPORTED_DTYPE if
+ * a column cannot be radix sorted, GDF_FILE_ERROR if spilling failed
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_external_order_by(size_t nrows,
+                                gdf_column* cols,
+                                size_t ncols,
+                                order_by_type* asc_desc,
+                                null_order_type* null_order,
+                                size_t device_memory_budget,
+                                const char* spill_dir,
+                                size_t* h_indx)
+{
+  GDF_REQUIRE(nullptr != cols && nullptr != h_indx && nullptr != spill_dir, GDF_DATASET_EMPTY);
+
+  std::vector<key_field> fields;
+  std::vector<key_word> words;
+  gdf_error status = plan_key_words(cols, ncols, fields, words);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  // The staged columns, plus the indices and the key words of the radix
+  // sort (each double buffered) and the fetched key word
+  size_t bytes_per_row = 2 * sizeof(uint64_t) + 3 * sizeof(uint64_t);
+  for(size_t c = 0; c < ncols; ++c)
+    bytes_per_row += normalized_key_bits(cols[c].dtype) / 8 + (cols[c].valid ? 1 : 0);
+  const size_t chunk_rows = external_sort_chunk_rows(device_memory_budget, bytes_per_row);
+
+  cudaStream_t stream;
+  CUDA_TRY( cudaStreamCreate(&stream) );
+
+  // Fits in one piece: no spilling
+  if( nrows <= chunk_rows )
+  {
+    sorted_run run;
+    if( nrows > 0 )
+      status = device_sort_chunk(slice_key_columns(cols, ncols, 0, nrows), asc_desc, null_order,
+                                 fields, words, 0, run, stream);
+    cudaStreamDestroy(stream);
+    std::copy(run.indx.begin(), run.indx.end(), h_indx);
+    return status;
+  }
+
+  spill_files spilled;
+  std::future<gdf_error> pending_spill;
+  std::vector<sorted_run> runs(2);
+  for(size_t begin = 0, r = 0; begin < nrows && GDF_SUCCESS == status; begin += chunk_rows, r ^= 1)
+  {
+    const size_t size = std::min(chunk_rows, nrows - begin);
+    std::vector<gdf_column> chunk = slice_key_columns(cols, ncols, begin, size);
+
+    // Sort this chunk while the previous one is written out
+    status = device_sort_chunk(chunk, asc_desc, null_order, fields, words, begin, runs[r], stream);
+
+    if( pending_spill.valid() )
+    {
+      const gdf_error spill_status = pending_spill.get();
+      status = (GDF_SUCCESS == status) ? spill_status : status;
+    }
+    if( GDF_SUCCESS == status )
+    {
+      spilled.paths.emplace_back();
+      std::string * path = &spilled.paths.back();
+      sorted_run * run = &runs[r];
+      std::string dir(spill_dir);
+      pending_spill = std::async(std::launch::async, [run, dir, path]() {
+        return spill_sorted_run(*run, dir, *path);
+      });
+    }
+  }
+  if( pending_spill.valid() )
+  {
+    const gdf_error spill_status = pending_spill.get();
+    status = (GDF_SUCCESS == status) ? spill_status : status;
+  }
+  cudaStreamDestroy(stream);
+
+  if( GDF_SUCCESS != status )
+    return status;
+  return merge_spilled_runs(spilled.paths, words.size(), nrows, std::string(spill_dir), h_indx);
+}
@@ -0,0 +1,630 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_ORDERBY_EXTERNAL_SORT_H
+#define GDF_ORDERBY_EXTERNAL_SORT_H
+
+#include <gdf/gdf.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "host_radix_order_by.h"
+
+// Host memory used for the read buffers of all the runs during the merge
+constexpr size_t EXTERNAL_SORT_MERGE_BUFFER_BYTES = size_t{64} << 20;
+constexpr size_t EXTERNAL_SORT_MIN_BLOCK_ROWS = 4096;
+// Merge fan-in limit: every run merged keeps a file open. With more runs, the
+// merge takes several passes, each merging groups of this many runs
+constexpr size_t EXTERNAL_SORT_MAX_RUNS = 512;
+constexpr uint64_t EXTERNAL_SORT_RUN_MAGIC = 0x31304e5552464447ull; // "GDFRUN01"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  One sorted run of an external sort: the packed key words of its
+ * rows (see plan_key_words) and their row indices in the input table, in
+ * sorted order.
+ *
+ * Runs are spilled column by column: a header of three uint64 (magic, number
+ * of rows, number of key words) followed by one uint64 column per key word
+ * and finally the row index column.
+ *
+ * The columns spilled are the normalized key words rather than the key
+ * columns themselves: the sort only returns a permutation, so the values are
+ * never read back, and the merge compares rows with a few unsigned integer
+ * comparisons, whatever the types, directions and null orders of the keys.
+ */
+/* ----------------------------------------------------------------------------*/
+struct sorted_run
+{
+  std::vector<std::vector<uint64_t>> keys;  // keys[w][i]: key word w of the i-th row
+  std::vector<uint64_t> indx;               // indx[i]: row index of the i-th row
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Creates a new, uniquely named run file in `spill_dir` and writes
+ * its header
+ *
+ * @Returns GDF_FILE_ERROR if the file could not be created or written, in
+ * which case it is removed
+ */
+/* ----------------------------------------------------------------------------*/
+inline gdf_error create_run_file(std::string const & spill_dir,
+                                 uint64_t nrows,
+                                 uint64_t nwords,
+                                 std::string & path,
+                                 FILE * & file)
+{
+  std::vector<char> name(spill_dir.begin(), spill_dir.end());
+  const std::string suffix = "/gdf_sort_run_XXXXXX";
+  name.insert(name.end(), suffix.begin(), suffix.end());
+  name.push_back('\0');
+
+  const int fd = mkstemp(name.data());
+  if( fd < 0 )
+    return GDF_FILE_ERROR;
+  path = name.data();
+
+  file = fdopen(fd, "wb");
+  if( nullptr == file )
+  {
+    close(fd);
+    std::remove(path.c_str());
+    return GDF_FILE_ERROR;
+  }
+
+  const uint64_t header[3] = {EXTERNAL_SORT_RUN_MAGIC, nrows, nwords};
+  if( 3 != fwrite(header, sizeof(uint64_t), 3, file) )
+  {
+    fclose(file);
+    std::remove(path.c_str());
+    return GDF_FILE_ERROR;
+  }
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Writes a sorted run to a new, uniquely named file in `spill_dir`
+ *
+ * @Param[in] run The run to spill
+ * @Param[in] spill_dir The directory for the spill files
+ * @Param[out] path The name of the file that was created
+ *
+ * @Returns GDF_FILE_ERROR if the file could not be created or written
+ */
+/* ----------------------------------------------------------------------------*/
+inline gdf_error spill_sorted_run(sorted_run const & run,
+                                  std::string const & spill_dir,
+                                  std::string & path)
+{
+  FILE * file = nullptr;
+  const uint64_t nrows = run.indx.size();
+  gdf_error status = create_run_file(spill_dir, nrows, run.keys.size(), path, file);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  bool ok = true;
+  for(auto const & word_keys : run.keys)
+    ok = ok && (nrows == fwrite(word_keys.data(), sizeof(uint64_t), nrows, file));
+  ok = ok && (nrows == fwrite(run.indx.data(), sizeof(uint64_t), nrows, file));
+  ok = (0 == fclose(file)) && ok;
+
+  if( !ok )
+  {
+    std::remove(path.c_str());
+    return GDF_FILE_ERROR;
+  }
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Streams the rows of a spilled run back in large blocks. While
+ * the merge consumes one block, the next one is read asynchronously into a
+ * second buffer.
+ */
+/* ----------------------------------------------------------------------------*/
+class spilled_run_reader
+{
+public:
+  ~spilled_run_reader()
+  {
+    if( prefetch.valid() )
+      prefetch.wait();
+    if( file )
+      fclose(file);
+  }
+
+  gdf_error open(std::string const & path, size_t rows_per_block)
+  {
+    file = fopen(path.c_str(), "rb");
+    if( nullptr == file )
+      return GDF_FILE_ERROR;
+
+    uint64_t header[3];
+    if( (3 != fread(header, sizeof(uint64_t), 3, file)) || (EXTERNAL_SORT_RUN_MAGIC != header[0]) )
+      return GDF_FILE_ERROR;
+    nrows = header[1];
+    nwords = header[2];
+    block_rows = std::max<size_t>(1, rows_per_block);
+
+    if( !load_block(current, 0) )
+      return GDF_FILE_ERROR;
+    next_row = current.indx.size();
+    start_prefetch();
+    return GDF_SUCCESS;
+  }
+
+  bool done() const { return pos == current.indx.size(); }
+  uint64_t key(size_t w) const { return current.keys[w][pos]; }
+  uint64_t index() const { return current.indx[pos]; }
+  size_t num_words() const { return nwords; }
+  size_t size() const { return nrows; }
+
+  // Moves to the next row; returns false on a read error
+  bool advance()
+  {
+    if( ++pos < current.indx.size() || !prefetch.valid() )
+      return true;
+
+    const bool ok = prefetch.get();
+    std::swap(current, next);
+    pos = 0;
+    next_row += current.indx.size();
+    start_prefetch();
+    return ok;
+  }
+
+private:
+  void start_prefetch()
+  {
+    if( next_row < nrows )
+    {
+      const size_t first_row = next_row;
+      prefetch = std::async(std::launch::async, [this, first_row]() { return load_block(next, first_row); });
+    }
+  }
+
+  // Reads the rows [first_row, first_row + block_rows) of every column
+  bool load_block(sorted_run & block, size_t first_row)
+  {
+    const size_t size = std::min(block_rows, nrows - first_row);
+    block.keys.resize(nwords);
+    for(size_t c = 0; c <= nwords; ++c)
+    {
+      std::vector<uint64_t> & column = (c < nwords) ? block.keys[c] : block.indx;
+      column.resize(size);
+      const off_t offset = static_cast<off_t>((3 + c * nrows + first_row) * sizeof(uint64_t));
+      if( (0 != fseeko(file, offset, SEEK_SET)) ||
+          (size != fread(column.data(), sizeof(uint64_t), size, file)) )
+        return false;
+    }
+    return true;
+  }
+
+  FILE * file{nullptr};
+  size_t nrows{0};
+  size_t nwords{0};
+  size_t block_rows{0};
+  size_t next_row{0};  // first row of the block being prefetched
+  size_t pos{0};
+  sorted_run current;
+  sorted_run next;
+  std::future<bool> prefetch;
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Tournament tree of losers over k sorted runs: the root holds the
+ * run with the smallest current row and every internal node the loser of the
+ * match played there, so that advancing the winner replays a single leaf to
+ * root path (log2(k) comparisons).
+ *
+ * Rows are compared by their key words, then by run number; runs are made of
+ * consecutive slices of the input, so this keeps the merge stable.
+ */
+/* ----------------------------------------------------------------------------*/
+class run_loser_tree
+{
+public:
+  explicit run_loser_tree(std::vector<std::unique_ptr<spilled_run_reader>> & runs)
+    : readers(runs), k(runs.size()), tree(std::max<size_t>(k, 1))
+  {
+    std::vector<size_t> winners(2 * k);
+    for(size_t i = 0; i < k; ++i)
+      winners[k + i] = i;
+    for(size_t n = k - 1; n >= 1; --n)
+    {
+      const size_t a = winners[2 * n];
+      const size_t b = winners[2 * n + 1];
+      const bool b_wins = less(b, a);
+      winners[n] = b_wins ? b : a;
+      tree[n] = b_wins ? a : b;
+    }
+    tree[0] = (k > 1) ? winners[1] : 0;
+  }
+
+  size_t winner() const { return tree[0]; }
+
+  // Replays the matches of the winner's leaf after its run advanced
+  void replay()
+  {
+    size_t winner = tree[0];
+    for(size_t n = (k + tree[0]) / 2; n >= 1; n /= 2)
+    {
+      if( less(tree[n], winner) )
+        std::swap(tree[n], winner);
+    }
+    tree[0] = winner;
+  }
+
+private:
+  bool less(size_t a, size_t b) const
+  {
+    if( readers[a]->done() ) return false;
+    if( readers[b]->done() ) return true;
+    for(size_t w = 0; w < readers[a]->num_words(); ++w)
+    {
+      const uint64_t ka = readers[a]->key(w);
+      const uint64_t kb = readers[b]->key(w);
+      if( ka != kb )
+        return ka < kb;
+    }
+    return a < b;
+  }
+
+  std::vector<std::unique_ptr<spilled_run_reader>> & readers;
+  size_t k;
+  std::vector<size_t> tree;
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Writes the rows of a merged run to its file, a block at a time:
+ * the rows are buffered and every column of the block is then written at
+ * its place in the file.
+ */
+/* ----------------------------------------------------------------------------*/
+class spilled_run_writer
+{
+public:
+  ~spilled_run_writer()
+  {
+    if( file )
+      fclose(file);
+  }
+
+  gdf_error open(std::string const & spill_dir, size_t run_rows, size_t run_words,
+                 size_t rows_per_block, std::string & path)
+  {
+    nrows = run_rows;
+    block_rows = std::max<size_t>(1, rows_per_block);
+    block.keys.resize(run_words);
+    return create_run_file(spill_dir, nrows, run_words, path, file);
+  }
+
+  // Appends the current row of a run; returns false on a write error
+  bool append(spilled_run_reader const & run)
+  {
+    for(size_t w = 0; w < block.keys.size(); ++w)
+      block.keys[w].push_back(run.key(w));
+    block.indx.push_back(run.index());
+    return (block.indx.size() < block_rows) || flush();
+  }
+
+  // Writes the rows still buffered and closes the file
+  bool close()
+  {
+    const bool ok = flush();
+    const bool closed = (0 == fclose(file));
+    file = nullptr;
+    return ok && closed;
+  }
+
+private:
+  bool flush()
+  {
+    const size_t size = block.indx.size();
+    const size_t nwords = block.keys.size();
+    for(size_t c = 0; c <= nwords && size > 0; ++c)
+    {
+      std::vector<uint64_t> & column = (c < nwords) ? block.keys[c] : block.indx;
+      const off_t offset = static_cast<off_t>((3 + c * nrows + first_row) * sizeof(uint64_t));
+      if( (0 != fseeko(file, offset, SEEK_SET)) ||
+          (size != fwrite(column.data(), sizeof(uint64_t), size, file)) )
+        return false;
+      column.clear();
+    }
+    first_row += size;
+    return true;
+  }
+
+  FILE * file{nullptr};
+  size_t nrows{0};
+  size_t block_rows{0};
+  size_t first_row{0};  // first row of the buffered block
+  sorted_run block;
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  K-way merges at most EXTERNAL_SORT_MAX_RUNS spilled sorted runs,
+ * calling `emit(run)` with the run of every row in sorted order.
+ *
+ * @Returns GDF_FILE_ERROR if a run could not be read back or emit failed
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Emit>
+gdf_error merge_runs(std::vector<std::string> const & paths, size_t nwords, Emit emit)
+{
+  // Two buffers per run, each with one uint64 per key word plus the index
+  const size_t bytes_per_row = 2 * paths.size() * (nwords + 1) * sizeof(uint64_t);
+  const size_t rows_per_block = std::max(EXTERNAL_SORT_MIN_BLOCK_ROWS,
+                                         EXTERNAL_SORT_MERGE_BUFFER_BYTES / bytes_per_row);
+
+  std::vector<std::unique_ptr<spilled_run_reader>> readers;
+  size_t nrows = 0;
+  for(auto const & path : paths)
+  {
+    readers.emplace_back(new spilled_run_reader);
+    gdf_error status = readers.back()->open(path, rows_per_block);
+    if( GDF_SUCCESS != status )
+      return status;
+    nrows += readers.back()->size();
+  }
+
+  run_loser_tree tree(readers);
+  for(size_t i = 0; i < nrows; ++i)
+  {
+    spilled_run_reader & run = *readers[tree.winner()];
+    if( run.done() || !emit(run, nrows, rows_per_block) )
+      return GDF_FILE_ERROR;
+    if( !run.advance() )
+      return GDF_FILE_ERROR;
+    tree.replay();
+  }
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Removes the spill files of an external sort when it goes out of
+ * scope, whether the sort succeeded or not.
+ */
+/* ----------------------------------------------------------------------------*/
+struct spill_files
+{
+  ~spill_files()
+  {
+    for(auto const & path : paths)
+      std::remove(path.c_str());
+  }
+
+  std::vector<std::string> paths;
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  K-way merges spilled sorted runs into the final permutation.
+ *
+ * With more than EXTERNAL_SORT_MAX_RUNS runs, groups of consecutive runs are
+ * first merged into longer runs, spilled in turn, until few enough remain:
+ * every pass reads and writes all the rows once more, but the memory used by
+ * the merge stays bounded whatever the number of runs. Merging consecutive
+ * runs keeps the sort stable.
+ *
+ * @Param[in] paths The spill files of the runs, in input order
+ * @Param[in] nwords The number of key words of the runs
+ * @Param[in] nrows The total number of rows of the runs
+ * @Param[in] spill_dir Directory for the intermediate run files
+ * @Param[out] h_indx Host array of nrows row indices, in sorted order
+ *
+ * @Returns GDF_FILE_ERROR if a run could not be written or read back
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT>
+gdf_error merge_spilled_runs(std::vector<std::string> const & paths,
+                             size_t nwords,
+                             size_t nrows,
+                             std::string const & spill_dir,
+                             IndexT * h_indx)
+{
+  if( paths.empty() )
+    return GDF_SUCCESS;
+
+  spill_files merged;  // the runs of the last intermediate pass
+  std::vector<std::string> level(paths);
+  while( level.size() > EXTERNAL_SORT_MAX_RUNS )
+  {
+    spill_files next;
+    for(size_t first = 0; first < level.size(); first += EXTERNAL_SORT_MAX_RUNS)
+    {
+      const size_t last = std::min(level.size(), first + EXTERNAL_SORT_MAX_RUNS);
+      const std::vector<std::string> group(level.begin() + first, level.begin() + last);
+
+      spilled_run_writer writer;
+      next.paths.emplace_back();
+      bool opened = false;
+      gdf_error status = merge_runs(group, nwords,
+        [&](spilled_run_reader const & run, size_t group_rows, size_t rows_per_block) -> bool {
+          if( !opened )
+          {
+            if( GDF_SUCCESS != writer.open(spill_dir, group_rows, nwords, rows_per_block, next.paths.back()) )
+              return false;
+            opened = true;
+          }
+          return writer.append(run);
+        });
+      if( !opened )
+        next.paths.pop_back();
+      if( GDF_SUCCESS == status && opened && !writer.close() )
+        status = GDF_FILE_ERROR;
+      if( GDF_SUCCESS != status )
+        return status;
+    }
+    // The runs of the previous pass are removed with `next`
+    std::swap(merged.paths, next.paths);
+    level = merged.paths;
+  }
+
+  size_t i = 0;
+  return merge_runs(level, nwords, [&](spilled_run_reader const & run, size_t, size_t) -> bool {
+    if( i >= nrows )
+      return false;
+    h_indx[i++] = static_cast<IndexT>(run.index());
+    return true;
+  });
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Returns the number of rows of a chunk that fits a memory budget
+ * of `bytes_per_chunk`, given the number of bytes a row needs while it is
+ * sorted. Chunks hold a multiple of GDF_VALID_BITSIZE rows so that the
+ * validity masks of the chunks can be sliced without shifting: the rounding
+ * is down, so that a chunk never exceeds the budget, but to no less than
+ * GDF_VALID_BITSIZE rows.
+ */
+/* ----------------------------------------------------------------------------*/
+inline size_t external_sort_chunk_rows(size_t bytes_per_chunk, size_t bytes_per_row)
+{
+  const size_t rows = bytes_per_chunk / std::max<size_t>(1, bytes_per_row);
+  return std::max<size_t>(rows - rows % GDF_VALID_BITSIZE, GDF_VALID_BITSIZE);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The columns restricted to the rows [begin, begin + size). `begin`
+ * must be a multiple of GDF_VALID_BITSIZE.
+ */
+/* ----------------------------------------------------------------------------*/
+inline std::vector<gdf_column> slice_key_columns(gdf_column const * cols,
+                                                 size_t ncols,
+                                                 size_t begin,
+                                                 size_t size)
+{
+  std::vector<gdf_column> chunk(cols, cols + ncols);
+  for(auto & col : chunk)
+  {
+    col.data = static_cast<char *>(col.data) + begin * (normalized_key_bits(col.dtype) / 8);
+    if( col.valid )
+      col.valid += begin / GDF_VALID_BITSIZE;
+    col.size = size;
+  }
+  return chunk;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host external sort: orders a table too large to be sorted in
+ * one piece within `memory_budget` bytes. The input is cut into chunks that
+ * fit the budget, each chunk is sorted with host_radix_order_by and spilled
+ * as a run of packed key words and row indices, and the runs are merged with
+ * a loser tree, in several passes when there are many of them.
+ *
+ * @Param[in] nrows The number of rows
+ * @Param[in] cols Host array of the key columns (data resident on the host)
+ * @Param[in] ncols The number of key columns
+ * @Param[in] asc_desc Host array of ncols sort directions, or nullptr for all
+ * ascending
+ * @Param[in] null_order Host array of ncols NULL placements, or nullptr for
+ * all NULLS LAST
+ * @Param[in] memory_budget Memory in bytes available to sort one chunk
+ * @Param[in] spill_dir Directory for the temporary run files
+ * @Param[out] h_indx Host array of nrows row indices, in sorted order
+ *
+ * @Returns GDF_SUCCESS upon successful completion, GDF_UNSUPPORTED_DTYPE if
+ * a column cannot be radix sorted, GDF_FILE_ERROR if spilling failed
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT>
+gdf_error host_external_order_by(size_t                  nrows,
+                                 gdf_column const *      cols,
+                                 size_t                  ncols,
+                                 order_by_type const *   asc_desc,
+                                 null_order_type const * null_order,
+                                 size_t                  memory_budget,
+                                 char const *            spill_dir,
+                                 IndexT *                h_indx)
+{
+  std::vector<key_field> fields;
+  std::vector<key_word> words;
+  gdf_error status = plan_key_words(cols, ncols, fields, words);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  // The sort of a chunk needs its indices and key words, twice each
+  const size_t bytes_per_row = 2 * (sizeof(IndexT) + sizeof(uint64_t)) + words.size() * sizeof(uint64_t);
+  const size_t chunk_rows = external_sort_chunk_rows(memory_budget, bytes_per_row);
+  if( nrows <= chunk_rows )
+    return host_radix_order_by(nrows, cols, ncols, asc_desc, null_order, h_indx);
+
+  spill_files spilled;
+  for(size_t begin = 0; begin < nrows; begin += chunk_rows)
+  {
+    const size_t size = std::min(chunk_rows, nrows - begin);
+    std::vector<gdf_column> chunk = slice_key_columns(cols, ncols, begin, size);
+
+    std::vector<uint64_t> indx(size);
+    status = host_radix_order_by(size, chunk.data(), ncols, asc_desc, null_order, indx.data());
+    if( GDF_SUCCESS != status )
+      return status;
+
+    sorted_run run;
+    run.keys.resize(words.size(), std::vector<uint64_t>(size));
+    for(size_t w = 0; w < words.size(); ++w)
+    {
+      for(size_t f = words[w].first_field; f < words[w].last_field; ++f)
+      {
+        const size_t c = fields[f].col;
+        const bool descending = (nullptr != asc_desc) && (GDF_ORDER_DESC == asc_desc[c]);
+        const bool nulls_last = (nullptr == null_order) || (GDF_NULLS_LAST == null_order[c]);
+        host_key_word_builder<uint64_t> builder{chunk[c], fields[f], descending, nulls_last,
+                                                run.keys[w].data(), indx.data(), size,
+                                                f == words[w].first_field};
+        status = dispatch_key_type(chunk[c].dtype, builder);
+        if( GDF_SUCCESS != status )
+          return status;
+      }
+    }
+    for(auto & i : indx)
+      i += begin;
+    run.indx.swap(indx);
+
+    spilled.paths.emplace_back();
+    status = spill_sorted_run(run, spill_dir, spilled.paths.back());
+    if( GDF_SUCCESS != status )
+    {
+      spilled.paths.pop_back();
+      return status;
+    }
+  }
+
+  return merge_spilled_runs(spilled.paths, words.size(), nrows, std::string(spill_dir), h_indx);
+}
+
+#endif // GDF_ORDERBY_EXTERNAL_SORT_H
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_ORDERBY_HOST_IS_SORTED_H
+#define GDF_ORDERBY_HOST_IS_SORTED_H
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "host_radix_order_by.h"
+#include "../util/host_parallel.h"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of rows_are_sorted: checks whether no adjacent
+ * pair of rows of a set of host-resident columns is out of the order of
+ * host_radix_order_by, comparing one key word at a time, the pairs split
+ * between the host threads.
+ *
+ * @Param[in] nrows The number of rows
+ * @Param[in] cols Host array of the key columns (data resident on the host)
+ * @Param[in] ncols The number of key columns
+ * @Param[in] asc_desc Host array of ncols sort directions, or nullptr for all
+ * ascending
+ * @Param[in] null_order Host array of ncols NULL placements, or nullptr for
+ * all NULLS LAST
+ * @Param[out] is_sorted Whether the rows are sorted
+ *
+ * @Returns GDF_SUCCESS upon successful completion, GDF_UNSUPPORTED_DTYPE if
+ * a column cannot be radix sorted
+ */
+/* ----------------------------------------------------------------------------*/
+inline gdf_error host_rows_are_sorted(size_t                  nrows,
+                                      gdf_column const *      cols,
+                                      size_t                  ncols,
+                                      order_by_type const *   asc_desc,
+                                      null_order_type const * null_order,
+                                      bool &                  is_sorted)
+{
+  std::vector<key_field> fields;
+  std::vector<key_word> words;
+  gdf_error status = plan_key_words(cols, ncols, fields, words);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  is_sorted = true;
+  if( nrows < 2 )
+    return GDF_SUCCESS;
+
+  std::vector<size_t> rows(nrows);
+  std::iota(rows.begin(), rows.end(), size_t{0});
+  std::vector<uint64_t> keys(nrows);
+  std::vector<uint8_t> tied(words.size() > 1 ? nrows - 1 : 0);
+
+  const unsigned num_threads = gdf::util::host_num_threads(nrows - 1);
+  for(size_t w = 0; w < words.size(); ++w)
+  {
+    for(size_t f = words[w].first_field; f < words[w].last_field; ++f)
+    {
+      const size_t c = fields[f].col;
+      const bool descending = (nullptr != asc_desc) && (GDF_ORDER_DESC == asc_desc[c]);
+      const bool nulls_last = (nullptr == null_order) || (GDF_NULLS_LAST == null_order[c]);
+      host_key_word_builder<size_t> builder{cols[c], fields[f], descending, nulls_last,
+                                            keys.data(), rows.data(), nrows,
+                                            f == words[w].first_field};
+      status = dispatch_key_type(cols[c].dtype, builder);
+      if( GDF_SUCCESS != status )
+        return status;
+    }
+
+    const bool first_word = (0 == w);
+    const bool last_word = (w + 1 == words.size());
+    std::atomic<bool> out_of_order{false};
+    std::atomic<bool> any_tied{false};
+    gdf::util::host_parallel_for(nrows - 1, num_threads,
+      [&](unsigned, size_t begin, size_t end) {
+        bool thread_tied = false;
+        for(size_t i = begin; i < end && !out_of_order.load(std::memory_order_relaxed); ++i)
+        {
+          if( !first_word && !tied[i] )
+            continue;
+          if( keys[i] > keys[i + 1] )
+            out_of_order = true;
+          const bool tie = (keys[i] == keys[i + 1]);
+          if( !last_word )
+            tied[i] = tie;
+          thread_tied |= tie;
+        }
+        if( thread_tied )
+          any_tied = true;
+      });
+
+    if( out_of_order )
+    {
+      is_sorted = false;
+      return GDF_SUCCESS;
+    }
+    if( !any_tied )
+      break;
+  }
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_ORDERBY_HOST_IS_SORTED_H
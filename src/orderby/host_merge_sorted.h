@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_ORDERBY_HOST_MERGE_SORTED_H
+#define GDF_ORDERBY_HOST_MERGE_SORTED_H
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "host_radix_order_by.h"
+#include "merge_path.h"
+#include "../util/host_parallel.h"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of merge_sorted: merges tables that are each
+ * sorted by their first `nkeys` columns into the permutation that orders
+ * their concatenation, in O(n log k) for k tables instead of re-sorting.
+ *
+ * The rows are reduced to their packed key words (see plan_key_words), then
+ * the tables are merged two by two in a balanced merge tree. Every round is
+ * split evenly between the host threads with merge path searches.
+ *
+ * The merge is stable: rows with equal keys keep the order of their tables,
+ * then their order within their table.
+ *
+ * @Param[in] tables Host array of ntables host arrays of the columns of the
+ * tables (data resident on the host), all with the same dtypes
+ * @Param[in] ntables The number of tables
+ * @Param[in] nkeys The number of key columns, first in every table
+ * @Param[in] asc_desc Host array of nkeys sort directions, or nullptr for all
+ * ascending
+ * @Param[in] null_order Host array of nkeys NULL placements, or nullptr for
+ * all NULLS LAST
+ * @Param[out] h_indx Host array of the row indices into the concatenation of
+ * the tables, in merged order
+ *
+ * @Returns GDF_SUCCESS upon successful completion, GDF_UNSUPPORTED_DTYPE if
+ * a key column cannot be radix sorted
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT>
+gdf_error host_merge_sorted(gdf_column const * const * tables,
+                            size_t                     ntables,
+                            size_t                     nkeys,
+                            order_by_type const *      asc_desc,
+                            null_order_type const *    null_order,
+                            IndexT *                   h_indx)
+{
+  if( 0 == ntables )
+    return GDF_SUCCESS;
+
+  std::vector<key_field> fields;
+  std::vector<key_word> words;
+  gdf_error status = plan_key_words(merge_key_schema(tables, ntables, nkeys).data(), nkeys,
+                                    fields, words);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  std::vector<size_t> bounds = merge_table_offsets(tables, ntables);
+  const size_t total = bounds.back();
+  if( 0 == total )
+    return GDF_SUCCESS;
+
+  // Key words of every row, in concatenation order
+  std::vector<uint64_t> keys(words.size() * total);
+  std::vector<IndexT> rows;
+  for(size_t t = 0; t < ntables; ++t)
+  {
+    const size_t nrows = tables[t][0].size;
+    rows.resize(nrows);
+    std::iota(rows.begin(), rows.end(), IndexT{0});
+    for(size_t w = 0; w < words.size(); ++w)
+    {
+      for(size_t f = words[w].first_field; f < words[w].last_field; ++f)
+      {
+        const size_t c = fields[f].col;
+        const bool descending = (nullptr != asc_desc) && (GDF_ORDER_DESC == asc_desc[c]);
+        const bool nulls_last = (nullptr == null_order) || (GDF_NULLS_LAST == null_order[c]);
+        host_key_word_builder<IndexT> builder{tables[t][c], fields[f], descending, nulls_last,
+                                              keys.data() + w * total + bounds[t], rows.data(), nrows,
+                                              f == words[w].first_field};
+        status = dispatch_key_type(tables[t][c].dtype, builder);
+        if( GDF_SUCCESS != status )
+          return status;
+      }
+    }
+  }
+
+  const merge_key_less<IndexT> less{keys.data(), words.size(), total};
+  std::vector<IndexT> src(total), dst(total);
+  std::iota(src.begin(), src.end(), IndexT{0});
+
+  const unsigned num_threads = gdf::util::host_num_threads(total);
+  while( bounds.size() > 2 )
+  {
+    gdf::util::host_parallel_for(total, num_threads,
+      [&](unsigned, size_t begin, size_t end) {
+        merge_runs_range(src.data(), dst.data(), bounds.data(), bounds.size() - 1,
+                         begin, end, less);
+      });
+    src.swap(dst);
+    bounds = next_merge_round(bounds);
+  }
+
+  std::copy(src.begin(), src.end(), h_indx);
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_ORDERBY_HOST_MERGE_SORTED_H
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_ORDERBY_HOST_RADIX_ORDER_BY_H
+#define GDF_ORDERBY_HOST_RADIX_ORDER_BY_H
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+
+#include <cstdint>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "normalized_key.h"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Type dispatched functor that writes (or appends) one key field of
+ * a host column, gathered through the current permutation, into a host key
+ * word buffer. See key_field_op for the encoding of the fields.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT>
+struct host_key_word_builder
+{
+  gdf_column const & col;
+  key_field const &  kfield;
+  bool               descending;
+  bool               nulls_last;
+  uint64_t *         keys;
+  IndexT const *     indx;
+  size_t             nrows;
+  bool               first;
+
+  template <typename ColType>
+  gdf_error operator()(ColType)
+  {
+    ColType const * data = static_cast<ColType const *>(col.data);
+    for(size_t i = 0; i < nrows; ++i)
+    {
+      const IndexT row = indx[i];
+      const bool is_valid = gdf_is_valid(col.valid, row);
+      uint64_t field;
+      if( kfield.null_flag )
+        field = (is_valid != nulls_last);
+      else
+        field = is_valid ? encode_ordered(data[row], descending) : 0;
+      keys[i] = first ? field : append_key_field(keys[i], field, kfield.num_bits);
+    }
+    return GDF_SUCCESS;
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Stable LSD radix sort of (keys, indx) pairs with 8 bit digits
+ * over the low `num_bits` bits of the keys.
+ *
+ * The histograms of all digits are computed in a single pass over the keys,
+ * and digits for which every key falls in the same bucket are skipped.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT>
+void host_radix_sort_pairs(std::vector<uint64_t> & keys,
+                           std::vector<IndexT> & indx,
+                           unsigned num_bits)
+{
+  constexpr unsigned RADIX_BITS = 8;
+  constexpr size_t RADIX = size_t{1} << RADIX_BITS;
+  const size_t nrows = keys.size();
+  const unsigned num_digits = (num_bits + RADIX_BITS - 1) / RADIX_BITS;
+
+  std::vector<size_t> histograms(num_digits * RADIX, 0);
+  for(size_t i = 0; i < nrows; ++i)
+  {
+    uint64_t key = keys[i];
+    for(unsigned d = 0; d < num_digits; ++d, key >>= RADIX_BITS)
+      ++histograms[d * RADIX + (key & (RADIX - 1))];
+  }
+
+  std::vector<uint64_t> keys_alt(nrows);
+  std::vector<IndexT> indx_alt(nrows);
+  for(unsigned d = 0; d < num_digits; ++d)
+  {
+    size_t * histogram = &histograms[d * RADIX];
+    const unsigned shift = d * RADIX_BITS;
+
+    // All keys share this digit: the pass would be the identity
+    if( histogram[(keys[0] >> shift) & (RADIX - 1)] == nrows )
+      continue;
+
+    size_t offset = 0;
+    for(size_t b = 0; b < RADIX; ++b)
+    {
+      const size_t count = histogram[b];
+      histogram[b] = offset;
+      offset += count;
+    }
+
+    for(size_t i = 0; i < nrows; ++i)
+    {
+      const size_t pos = histogram[(keys[i] >> shift) & (RADIX - 1)]++;
+      keys_alt[pos] = keys[i];
+      indx_alt[pos] = indx[i];
+    }
+    keys.swap(keys_alt);
+    indx.swap(indx_alt);
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of radix_order_by: computes the permutation that
+ * lexicographically orders the rows of a set of host-resident columns with
+ * LSD radix sorts of packed normalized key words, honoring the per-column
+ * sort direction and NULL placement.
+ *
+ * @Param[in] nrows The number of rows
+ * @Param[in] cols Host array of the key columns (data resident on the host)
+ * @Param[in] ncols The number of key columns
+ * @Param[in] asc_desc Host array of ncols sort directions, or nullptr for all
+ * ascending
+ * @Param[in] null_order Host array of ncols NULL placements, or nullptr for
+ * all NULLS LAST
+ * @Param[out] h_indx Host array of nrows row indices, in sorted order
+ *
+ * @Returns GDF_SUCCESS upon successful completion, GDF_UNSUPPORTED_DTYPE if
+ * a column cannot be radix sorted
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT>
+gdf_error host_radix_order_by(size_t                  nrows,
+                              gdf_column const *      cols,
+                              size_t                  ncols,
+                              order_by_type const *   asc_desc,
+                              null_order_type const * null_order,
+                              IndexT *                h_indx)
+{
+  std::vector<key_field> fields;
+  std::vector<key_word> words;
+  gdf_error status = plan_key_words(cols, ncols, fields, words);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  std::vector<IndexT> indx(nrows);
+  std::iota(indx.begin(), indx.end(), IndexT{0});
+
+  if( nrows > 1 )
+  {
+    std::vector<uint64_t> keys(nrows);
+    for(auto w = words.rbegin(); w != words.rend(); ++w)
+    {
+      for(size_t f = w->first_field; f < w->last_field; ++f)
+      {
+        const size_t c = fields[f].col;
+        const bool descending = (nullptr != asc_desc) && (GDF_ORDER_DESC == asc_desc[c]);
+        const bool nulls_last = (nullptr == null_order) || (GDF_NULLS_LAST == null_order[c]);
+        host_key_word_builder<IndexT> builder{cols[c], fields[f], descending, nulls_last,
+                                              keys.data(), indx.data(), nrows,
+                                              f == w->first_field};
+        status = dispatch_key_type(cols[c].dtype, builder);
+        if( GDF_SUCCESS != status )
+          return status;
+      }
+      host_radix_sort_pairs(keys, indx, w->num_bits);
+    }
+  }
+
+  std::copy(indx.begin(), indx.end(), h_indx);
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_ORDERBY_HOST_RADIX_ORDER_BY_H
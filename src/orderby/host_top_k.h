@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_ORDERBY_HOST_TOP_K_H
+#define GDF_ORDERBY_HOST_TOP_K_H
+
+#include <gdf/gdf.h>
+
+#include <cstdint>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "host_radix_order_by.h"
+#include "../util/host_parallel.h"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of radix_top_k: computes the first k rows of
+ * the ordering that host_radix_order_by would produce.
+ *
+ * The packed key words of every row are computed once; each host thread then
+ * keeps the k best rows of its slice of the table in a bounded max-heap, and
+ * the per-thread heaps are merged and sorted at the end. Ties are broken by
+ * row index, so the result matches the stable full sort.
+ *
+ * @Param[in] nrows The number of rows
+ * @Param[in] cols Host array of the key columns (data resident on the host)
+ * @Param[in] ncols The number of key columns
+ * @Param[in] asc_desc Host array of ncols sort directions, or nullptr for all
+ * ascending
+ * @Param[in] null_order Host array of ncols NULL placements, or nullptr for
+ * all NULLS LAST
+ * @Param[in] k The number of rows to return
+ * @Param[out] h_indx Host array of min(k, nrows) row indices, in sorted order
+ *
+ * @Returns GDF_SUCCESS upon successful completion, GDF_UNSUPPORTED_DTYPE if
+ * a column cannot be radix sorted
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT>
+gdf_error host_top_k(size_t                  nrows,
+                     gdf_column const *      cols,
+                     size_t                  ncols,
+                     order_by_type const *   asc_desc,
+                     null_order_type const * null_order,
+                     size_t                  k,
+                     IndexT *                h_indx)
+{
+  std::vector<key_field> fields;
+  std::vector<key_word> words;
+  gdf_error status = plan_key_words(cols, ncols, fields, words);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  k = std::min(k, nrows);
+  if( 0 == k )
+    return GDF_SUCCESS;
+
+  std::vector<IndexT> rows(nrows);
+  std::iota(rows.begin(), rows.end(), IndexT{0});
+
+  // keys[w][row]: key word w of every row, in row order
+  std::vector<std::vector<uint64_t>> keys(words.size(), std::vector<uint64_t>(nrows));
+  for(size_t w = 0; w < words.size(); ++w)
+  {
+    for(size_t f = words[w].first_field; f < words[w].last_field; ++f)
+    {
+      const size_t c = fields[f].col;
+      const bool descending = (nullptr != asc_desc) && (GDF_ORDER_DESC == asc_desc[c]);
+      const bool nulls_last = (nullptr == null_order) || (GDF_NULLS_LAST == null_order[c]);
+      host_key_word_builder<IndexT> builder{cols[c], fields[f], descending, nulls_last,
+                                            keys[w].data(), rows.data(), nrows,
+                                            f == words[w].first_field};
+      status = dispatch_key_type(cols[c].dtype, builder);
+      if( GDF_SUCCESS != status )
+        return status;
+    }
+  }
+
+  auto less = [&keys](IndexT a, IndexT b) {
+    for(auto const & word_keys : keys)
+    {
+      if( word_keys[a] != word_keys[b] )
+        return word_keys[a] < word_keys[b];
+    }
+    return a < b;
+  };
+
+  const unsigned num_threads = gdf::util::host_num_threads(nrows);
+  std::vector<std::vector<IndexT>> heaps(num_threads);
+  gdf::util::host_parallel_for(nrows, num_threads,
+    [&](unsigned t, size_t begin, size_t end) {
+      std::vector<IndexT> & heap = heaps[t];
+      heap.reserve(k);
+      for(size_t i = begin; i < end; ++i)
+      {
+        const IndexT row = static_cast<IndexT>(i);
+        if( heap.size() < k )
+        {
+          heap.push_back(row);
+          std::push_heap(heap.begin(), heap.end(), less);
+        }
+        else if( less(row, heap.front()) )
+        {
+          std::pop_heap(heap.begin(), heap.end(), less);
+          heap.back() = row;
+          std::push_heap(heap.begin(), heap.end(), less);
+        }
+      }
+    });
+
+  std::vector<IndexT> merged;
+  for(auto const & heap : heaps)
+    merged.insert(merged.end(), heap.begin(), heap.end());
+  std::partial_sort(merged.begin(), merged.begin() + k, merged.end(), less);
+
+  std::copy(merged.begin(), merged.begin() + k, h_indx);
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_ORDERBY_HOST_TOP_K_H
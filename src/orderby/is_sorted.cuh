@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_ORDERBY_IS_SORTED_CUH
+#define GDF_ORDERBY_IS_SORTED_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <thrust/device_vector.h>
+#include <thrust/sequence.h>
+#include <thrust/system/cuda/execution_policy.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "radix_order_by.cuh"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Compares the key word of every pair of adjacent rows that the
+ * more significant words left tied: flags[0] is set if a pair is out of
+ * order, flags[1] if a pair is still tied. The ties of the last word are
+ * not recorded, as no word follows to break them.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename KeyT>
+__global__
+void adjacent_key_check(KeyT const * keys,
+                        uint8_t *    tied,
+                        size_t       npairs,
+                        bool         first_word,
+                        bool         last_word,
+                        int *        flags)
+{
+  bool out_of_order = false;
+  bool any_tied = false;
+  for(size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < npairs;
+      i += blockDim.x * gridDim.x)
+  {
+    if( !first_word && !tied[i] )
+      continue;
+    const KeyT a = keys[i];
+    const KeyT b = keys[i + 1];
+    out_of_order |= (a > b);
+    if( !last_word )
+      tied[i] = (a == b);
+    any_tied |= (a == b);
+  }
+  if( out_of_order )
+    flags[0] = 1;
+  if( any_tied )
+    flags[1] = 1;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Checks whether the rows of a set of columns are already in the
+ * order radix_order_by would put them in, i.e. no adjacent pair of rows is
+ * out of order. Ties are allowed.
+ *
+ * The rows are compared by their packed key words (see plan_key_words), most
+ * significant word first. Only the pairs tied on the previous words are
+ * compared on the next one, and the check stops at the first word that finds
+ * a pair out of order or leaves no ties, so that it usually costs one pass
+ * over the keys.
+ *
+ * @Param[in] nrows The number of rows
+ * @Param[in] cols Host array of the key columns (data resident on the device)
+ * @Param[in] ncols The number of key columns
+ * @Param[in] asc_desc Host array of ncols sort directions, or nullptr for all
+ * ascending
+ * @Param[in] null_order Host array of ncols NULL placements, or nullptr for
+ * all NULLS LAST
+ * @Param[out] is_sorted Whether the rows are sorted
+ * @Param[in] stream The stream on which to perform the check
+ *
+ * @Returns GDF_SUCCESS upon successful completion, GDF_UNSUPPORTED_DTYPE if
+ * a column cannot be radix sorted
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT>
+gdf_error rows_are_sorted(size_t                  nrows,
+                          gdf_column const *      cols,
+                          size_t                  ncols,
+                          order_by_type const *   asc_desc,
+                          null_order_type const * null_order,
+                          bool &                  is_sorted,
+                          cudaStream_t            stream = 0)
+{
+  std::vector<key_field> fields;
+  std::vector<key_word> words;
+  gdf_error status = plan_key_words(cols, ncols, fields, words);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  is_sorted = true;
+  if( nrows < 2 )
+    return GDF_SUCCESS;
+
+  thrust::device_vector<IndexT> d_rows(nrows);
+  thrust::sequence(thrust::cuda::par.on(stream), d_rows.begin(), d_rows.end(), 0);
+  thrust::device_vector<uint64_t> d_keys(nrows);
+  thrust::device_vector<uint8_t> d_tied(words.size() > 1 ? nrows - 1 : 0);
+  thrust::device_vector<int> d_flags(2);
+
+  const int block_size = 256;
+  const int num_blocks = std::min<size_t>((nrows + block_size - 1) / block_size, 1024);
+  for(size_t w = 0; w < words.size(); ++w)
+  {
+    status = build_key_word(cols, asc_desc, null_order, fields.data(), words[w],
+                            nrows, d_keys.data().get(), d_rows.data().get(), stream);
+    if( GDF_SUCCESS != status )
+      return status;
+
+    CUDA_TRY( cudaMemsetAsync(d_flags.data().get(), 0, 2 * sizeof(int), stream) );
+    adjacent_key_check<<<num_blocks, block_size, 0, stream>>>(
+      d_keys.data().get(), d_tied.data().get(), nrows - 1,
+      0 == w, w + 1 == words.size(), d_flags.data().get());
+    CUDA_CHECK_LAST();
+
+    int flags[2];
+    CUDA_TRY( cudaMemcpyAsync(flags, d_flags.data().get(), 2 * sizeof(int),
+                              cudaMemcpyDeviceToHost, stream) );
+    CUDA_TRY( cudaStreamSynchronize(stream) );
+    if( flags[0] )
+    {
+      is_sorted = false;
+      return GDF_SUCCESS;
+    }
+    if( !flags[1] )
+      break;
+  }
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_ORDERBY_IS_SORTED_CUH
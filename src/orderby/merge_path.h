@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_ORDERBY_MERGE_PATH_H
+#define GDF_ORDERBY_MERGE_PATH_H
+
+#include <gdf/gdf.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "normalized_key.h"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Orders two rows of the tables being merged by their key words.
+ * The words are stored word by word for all the rows, in the order of the
+ * concatenation of the tables: word w of row g is words[w * stride + g].
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT>
+struct merge_key_less
+{
+  uint64_t const * words;
+  size_t           num_words;
+  size_t           stride;
+
+  GDF_KEY_FUNC
+  bool operator()(IndexT a, IndexT b) const
+  {
+    for(size_t w = 0; w < num_words; ++w)
+    {
+      const uint64_t ka = words[w * stride + a];
+      const uint64_t kb = words[w * stride + b];
+      if( ka != kb )
+        return ka < kb;
+    }
+    return false;
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Merge path search: the number of items of `a` among the first
+ * `diag` items of the stable merge of the sorted sequences `a` and `b`
+ * (ties are taken from `a` first).
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT, typename Less>
+GDF_KEY_FUNC
+size_t merge_path_search(IndexT const * a, size_t na,
+                         IndexT const * b, size_t nb,
+                         size_t diag, Less const & less)
+{
+  size_t lo = (diag > nb) ? diag - nb : 0;
+  size_t hi = (diag < na) ? diag : na;
+  while( lo < hi )
+  {
+    const size_t mid = (lo + hi) / 2;
+    if( !less(b[diag - 1 - mid], a[mid]) )
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Writes the output items [begin, end) of one round of a merge
+ * tree: the sorted runs of `src` delimited by `bounds` (num_runs + 1
+ * offsets) are merged two by two, run 2p with run 2p + 1, into `dst`. An odd
+ * last run is copied. Every output range is independent of the others, so
+ * that the round can be split evenly between any number of threads.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT, typename Less>
+GDF_KEY_FUNC
+void merge_runs_range(IndexT const * src,
+                      IndexT *       dst,
+                      size_t const * bounds,
+                      size_t         num_runs,
+                      size_t         begin,
+                      size_t         end,
+                      Less const &   less)
+{
+  // The pair of runs holding the output item `begin`
+  size_t lo = 0, hi = (num_runs + 1) / 2;
+  while( hi - lo > 1 )
+  {
+    const size_t mid = (lo + hi) / 2;
+    if( bounds[2 * mid] <= begin )
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  for(size_t p = lo; begin < end; ++p)
+  {
+    const size_t a_begin = bounds[2 * p];
+    const size_t b_begin = bounds[(2 * p + 1 < num_runs) ? 2 * p + 1 : num_runs];
+    const size_t b_end = bounds[(2 * p + 2 < num_runs) ? 2 * p + 2 : num_runs];
+    const size_t last = (end < b_end) ? end : b_end;
+
+    IndexT const * a = src + a_begin;
+    IndexT const * b = src + b_begin;
+    const size_t na = b_begin - a_begin;
+    const size_t nb = b_end - b_begin;
+    const size_t diag = begin - a_begin;
+    size_t i = merge_path_search(a, na, b, nb, diag, less);
+    size_t j = diag - i;
+    for(size_t k = begin; k < last; ++k)
+    {
+      const bool take_a = (j >= nb) || ((i < na) && !less(b[j], a[i]));
+      dst[k] = take_a ? a[i++] : b[j++];
+    }
+    begin = last;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The run bounds of the next round of a merge tree: runs 2p and
+ * 2p + 1 of this round become run p.
+ */
+/* ----------------------------------------------------------------------------*/
+inline std::vector<size_t> next_merge_round(std::vector<size_t> const & bounds)
+{
+  const size_t num_runs = bounds.size() - 1;
+  std::vector<size_t> next;
+  for(size_t r = 0; r < num_runs; r += 2)
+    next.push_back(bounds[r]);
+  next.push_back(bounds[num_runs]);
+  return next;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The key columns whose key words order the rows of every table
+ * to merge: the first `nkeys` columns of the first table, flagged nullable
+ * when the column has a validity mask in any table, so that plan_key_words
+ * lays the words out the same way for all the tables.
+ */
+/* ----------------------------------------------------------------------------*/
+inline std::vector<gdf_column> merge_key_schema(gdf_column const * const * tables,
+                                                size_t                     ntables,
+                                                size_t                     nkeys)
+{
+  std::vector<gdf_column> schema(tables[0], tables[0] + nkeys);
+  for(size_t t = 1; t < ntables; ++t)
+    for(size_t c = 0; c < nkeys; ++c)
+      if( nullptr == schema[c].valid )
+        schema[c].valid = tables[t][c].valid;
+  return schema;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Offsets of the tables in their concatenation: ntables + 1
+ * offsets, the last one being the total number of rows.
+ */
+/* ----------------------------------------------------------------------------*/
+inline std::vector<size_t> merge_table_offsets(gdf_column const * const * tables,
+                                               size_t                     ntables)
+{
+  std::vector<size_t> offsets(1, 0);
+  for(size_t t = 0; t < ntables; ++t)
+    offsets.push_back(offsets.back() + tables[t][0].size);
+  return offsets;
+}
+
+#endif // GDF_ORDERBY_MERGE_PATH_H
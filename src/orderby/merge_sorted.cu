@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+#include <gdf/cffi/functions.h>
+
+#include <thrust/device_vector.h>
+
+#include <vector>
+
+#include "merge_sorted.cuh"
+#include "../gather/table_gather.cuh"
+
+namespace {
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Materializes the merged table: every output column receives the
+ * concatenation of its input columns, which is then permuted in place by the
+ * merged order.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT>
+gdf_error gather_merged(gdf_column **  tables,
+                        size_t         ntables,
+                        size_t         ncols,
+                        IndexT const * d_indx,
+                        size_t         total,
+                        gdf_column **  out_cols)
+{
+  std::vector<gdf_column*> inputs(ntables);
+  for(size_t c = 0; c < ncols; ++c)
+  {
+    for(size_t t = 0; t < ntables; ++t)
+      inputs[t] = &tables[t][c];
+    gdf_error status = gdf_column_concat(out_cols[c], inputs.data(), ntables);
+    if( GDF_SUCCESS != status )
+      return status;
+  }
+  return gather_table(out_cols, out_cols, ncols, d_indx, total);
+}
+
+template <typename IndexT>
+gdf_error merge_and_gather(gdf_column **           tables,
+                           size_t                  ntables,
+                           size_t                  ncols,
+                           size_t                  nkeys,
+                           order_by_type const *   asc_desc,
+                           null_order_type const * null_order,
+                           IndexT *                d_indx,
+                           size_t                  total,
+                           gdf_column **           out_cols)
+{
+  gdf_error status = merge_sorted(tables, ntables, nkeys, asc_desc, null_order, d_indx);
+  if( GDF_SUCCESS != status || nullptr == out_cols )
+    return status;
+  return gather_merged(tables, ntables, ncols, d_indx, total, out_cols);
+}
+
+} // namespace
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Merges tables that are each already sorted by their first
+ * `nkeys` columns, e.g. a large sorted table and the sorted deltas appended
+ * to it, without sorting their concatenation again.
+ *
+ * @Param[in] tables Host array of ntables host arrays of ncols columns, all
+ * with the same dtypes
+ * @Param[in] ntables The number of tables
+ * @Param[in] ncols The number of columns of every table
+ * @Param[in] nkeys The number of key columns, first in every table
+ * @Param[in] asc_desc Host array of nkeys sort directions the tables are
+ * sorted by, or NULL for all ascending
+ * @Param[in] null_order Host array of nkeys NULL placements, or NULL for all
+ * NULLS LAST
+ * @Param[out] out_indices The merged order, as row indices into the
+ * concatenation of the tables (GDF_INT32 or GDF_INT64), or NULL
+ * @Param[out] out_cols Host array of ncols pre-allocated columns receiving
+ * the merged table, or NULL
+ *
+ * @Returns GDF_SUCCESS upon successful completion, GDF_DTYPE_MISMATCH if the
+ * tables do not have the same dtypes, GDF_UNSUPPORTED_DTYPE if a key column
+ * cannot be radix sorted
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_merge_sorted(gdf_column** tables,
+                           size_t ntables,
+                           size_t ncols,
+                           size_t nkeys,
+                           order_by_type* asc_desc,
+                           null_order_type* null_order,
+                           gdf_column* out_indices,
+                           gdf_column** out_cols)
+{
+  GDF_REQUIRE(nullptr != tables && ntables > 0, GDF_DATASET_EMPTY);
+  GDF_REQUIRE(nullptr != out_indices || nullptr != out_cols, GDF_DATASET_EMPTY);
+  GDF_REQUIRE(nkeys > 0 && nkeys <= ncols, GDF_INVALID_API_CALL);
+
+  size_t total = 0;
+  for(size_t t = 0; t < ntables; ++t)
+  {
+    for(size_t c = 0; c < ncols; ++c)
+    {
+      GDF_REQUIRE(tables[t][c].dtype == tables[0][c].dtype, GDF_DTYPE_MISMATCH);
+      GDF_REQUIRE(tables[t][c].size == tables[t][0].size, GDF_COLUMN_SIZE_MISMATCH);
+    }
+    total += tables[t][0].size;
+  }
+  if( nullptr != out_cols )
+  {
+    for(size_t c = 0; c < ncols; ++c)
+    {
+      GDF_REQUIRE(out_cols[c]->dtype == tables[0][c].dtype, GDF_DTYPE_MISMATCH);
+      GDF_REQUIRE(out_cols[c]->size == total, GDF_COLUMN_SIZE_MISMATCH);
+    }
+  }
+
+  if( nullptr == out_indices )
+  {
+    if( use_int32_index(total) )
+    {
+      thrust::device_vector<int32_t> d_indx(total);
+      return merge_and_gather(tables, ntables, ncols, nkeys, asc_desc, null_order,
+                              d_indx.data().get(), total, out_cols);
+    }
+    thrust::device_vector<int64_t> d_indx(total);
+    return merge_and_gather(tables, ntables, ncols, nkeys, asc_desc, null_order,
+                            d_indx.data().get(), total, out_cols);
+  }
+
+  GDF_REQUIRE(out_indices->size == total, GDF_COLUMN_SIZE_MISMATCH);
+  switch( out_indices->dtype )
+    {
+    case GDF_INT32:
+      GDF_REQUIRE(use_int32_index(total), GDF_COLUMN_SIZE_TOO_BIG);
+      return merge_and_gather(tables, ntables, ncols, nkeys, asc_desc, null_order,
+                              static_cast<int32_t*>(out_indices->data), total, out_cols);
+    case GDF_INT64:
+      return merge_and_gather(tables, ntables, ncols, nkeys, asc_desc, null_order,
+                              static_cast<int64_t*>(out_indices->data), total, out_cols);
+    default:
+      return GDF_UNSUPPORTED_DTYPE;
+    }
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_ORDERBY_MERGE_SORTED_CUH
+#define GDF_ORDERBY_MERGE_SORTED_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <thrust/device_vector.h>
+#include <thrust/sequence.h>
+#include <thrust/system/cuda/execution_policy.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "radix_order_by.cuh"
+#include "merge_path.h"
+
+// Output items merged by every thread of a merge round
+constexpr unsigned MERGE_ITEMS_PER_THREAD = 16;
+
+template <typename IndexT>
+__global__
+void merge_round_kernel(IndexT const *         src,
+                        IndexT *               dst,
+                        size_t const *         bounds,
+                        size_t                 num_runs,
+                        size_t                 total,
+                        merge_key_less<IndexT> less)
+{
+  const size_t begin = (static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x)
+                       * MERGE_ITEMS_PER_THREAD;
+  if( begin >= total )
+    return;
+  const size_t end = (begin + MERGE_ITEMS_PER_THREAD < total)
+                     ? begin + MERGE_ITEMS_PER_THREAD : total;
+  merge_runs_range(src, dst, bounds, num_runs, begin, end, less);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Merges tables that are each sorted by their first `nkeys`
+ * columns into the permutation that orders their concatenation, in
+ * O(n log k) for k tables instead of the O(n log n) of a new sort.
+ *
+ * The rows of every table are reduced to their packed key words (see
+ * plan_key_words), then the tables are merged two by two in a balanced merge
+ * tree, one kernel per round. Every thread writes a fixed number of output
+ * rows, found with a merge path search of its first output row.
+ *
+ * The merge is stable: rows with equal keys keep the order of their tables,
+ * then their order within their table.
+ *
+ * @Param[in] tables Host array of ntables host arrays of the columns of the
+ * tables (data resident on the device), all with the same dtypes
+ * @Param[in] ntables The number of tables
+ * @Param[in] nkeys The number of key columns, first in every table
+ * @Param[in] asc_desc Host array of nkeys sort directions, or nullptr for all
+ * ascending
+ * @Param[in] null_order Host array of nkeys NULL placements, or nullptr for
+ * all NULLS LAST
+ * @Param[out] d_indx Device array of the row indices into the concatenation
+ * of the tables, in merged order
+ * @Param[in] stream The stream on which to perform the merge
+ *
+ * @Returns GDF_SUCCESS upon successful completion, GDF_UNSUPPORTED_DTYPE if
+ * a key column cannot be radix sorted
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT>
+gdf_error merge_sorted(gdf_column const * const * tables,
+                       size_t                     ntables,
+                       size_t                     nkeys,
+                       order_by_type const *      asc_desc,
+                       null_order_type const *    null_order,
+                       IndexT *                   d_indx,
+                       cudaStream_t               stream = 0)
+{
+  if( 0 == ntables )
+    return GDF_SUCCESS;
+
+  std::vector<key_field> fields;
+  std::vector<key_word> words;
+  gdf_error status = plan_key_words(merge_key_schema(tables, ntables, nkeys).data(), nkeys,
+                                    fields, words);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  std::vector<size_t> bounds = merge_table_offsets(tables, ntables);
+  const size_t total = bounds.back();
+  if( 0 == total )
+    return GDF_SUCCESS;
+
+  size_t max_rows = 0;
+  for(size_t t = 0; t < ntables; ++t)
+    max_rows = (tables[t][0].size > max_rows) ? tables[t][0].size : max_rows;
+
+  // Key words of every row, in concatenation order
+  thrust::device_vector<uint64_t> d_keys(words.size() * total);
+  thrust::device_vector<IndexT> d_rows(max_rows);
+  thrust::sequence(thrust::cuda::par.on(stream), d_rows.begin(), d_rows.end(), 0);
+  for(size_t t = 0; t < ntables; ++t)
+  {
+    for(size_t w = 0; w < words.size() && tables[t][0].size > 0; ++w)
+    {
+      status = build_key_word(tables[t], asc_desc, null_order, fields.data(), words[w],
+                              tables[t][0].size, d_keys.data().get() + w * total + bounds[t],
+                              d_rows.data().get(), stream);
+      if( GDF_SUCCESS != status )
+        return status;
+    }
+  }
+
+  // The run bounds of all the rounds, uploaded at once
+  std::vector<size_t> round_bounds;
+  std::vector<size_t> round_offsets;
+  for(; bounds.size() > 2; bounds = next_merge_round(bounds))
+  {
+    round_offsets.push_back(round_bounds.size());
+    round_bounds.insert(round_bounds.end(), bounds.begin(), bounds.end());
+  }
+  thrust::device_vector<size_t> d_bounds(round_bounds);
+
+  const merge_key_less<IndexT> less{d_keys.data().get(), words.size(), total};
+  thrust::device_vector<IndexT> d_indx_alt(round_offsets.empty() ? 0 : total);
+  IndexT * src = d_indx;
+  IndexT * dst = d_indx_alt.data().get();
+  thrust::sequence(thrust::cuda::par.on(stream), src, src + total, 0);
+
+  const int block_size = 256;
+  const size_t num_threads = (total + MERGE_ITEMS_PER_THREAD - 1) / MERGE_ITEMS_PER_THREAD;
+  const size_t num_blocks = (num_threads + block_size - 1) / block_size;
+  for(size_t r = 0; r < round_offsets.size(); ++r)
+  {
+    const size_t first = round_offsets[r];
+    const size_t last = (r + 1 < round_offsets.size()) ? round_offsets[r + 1] : round_bounds.size();
+    merge_round_kernel<<<num_blocks, block_size, 0, stream>>>(
+      src, dst, d_bounds.data().get() + first, last - first - 1, total, less);
+    CUDA_CHECK_LAST();
+    std::swap(src, dst);
+  }
+
+  // An odd number of rounds leaves the result in the alternate buffer
+  if( src != d_indx )
+    CUDA_TRY( cudaMemcpyAsync(d_indx, src, total * sizeof(IndexT),
+                              cudaMemcpyDeviceToDevice, stream) );
+  CUDA_TRY( cudaStreamSynchronize(stream) );
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_ORDERBY_MERGE_SORTED_CUH
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_ORDERBY_NORMALIZED_KEY_H
+#define GDF_ORDERBY_NORMALIZED_KEY_H
+
+#include <gdf/gdf.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef __CUDACC__
+#define GDF_KEY_FUNC __host__ __device__ __forceinline__
+#else
+#define GDF_KEY_FUNC inline
+#endif
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Maps a column value onto an unsigned integer whose natural
+ * (unsigned) ordering matches the ordering of the original value, and back.
+ *
+ * Signed integers get their sign bit flipped. Floating point values get every
+ * bit flipped when negative and only the sign bit flipped otherwise. The
+ * resulting keys can be radix sorted directly or concatenated with the keys of
+ * other columns into a single, wider byte-comparable key.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+struct normalized_key;
+
+template <>
+struct normalized_key<int8_t>
+{
+  using key_type = uint8_t;
+  GDF_KEY_FUNC static key_type encode(int8_t v) {
+    return static_cast<key_type>(v) ^ key_type{0x80};
+  }
+  GDF_KEY_FUNC static int8_t decode(key_type k) {
+    return static_cast<int8_t>(k ^ key_type{0x80});
+  }
+};
+
+template <>
+struct normalized_key<int16_t>
+{
+  using key_type = uint16_t;
+  GDF_KEY_FUNC static key_type encode(int16_t v) {
+    return static_cast<key_type>(v) ^ key_type{0x8000};
+  }
+  GDF_KEY_FUNC static int16_t decode(key_type k) {
+    return static_cast<int16_t>(k ^ key_type{0x8000});
+  }
+};
+
+template <>
+struct normalized_key<int32_t>
+{
+  using key_type = uint32_t;
+  GDF_KEY_FUNC static key_type encode(int32_t v) {
+    return static_cast<key_type>(v) ^ key_type{0x80000000u};
+  }
+  GDF_KEY_FUNC static int32_t decode(key_type k) {
+    return static_cast<int32_t>(k ^ key_type{0x80000000u});
+  }
+};
+
+template <>
+struct normalized_key<int64_t>
+{
+  using key_type = uint64_t;
+  GDF_KEY_FUNC static key_type encode(int64_t v) {
+    return static_cast<key_type>(v) ^ key_type{0x8000000000000000ull};
+  }
+  GDF_KEY_FUNC static int64_t decode(key_type k) {
+    return static_cast<int64_t>(k ^ key_type{0x8000000000000000ull});
+  }
+};
+
+template <>
+struct normalized_key<float>
+{
+  using key_type = uint32_t;
+  GDF_KEY_FUNC static key_type encode(float v) {
+    key_type bits;
+    memcpy(&bits, &v, sizeof(bits));
+    const key_type mask = (bits & 0x80000000u) ? 0xFFFFFFFFu : 0x80000000u;
+    return bits ^ mask;
+  }
+  GDF_KEY_FUNC static float decode(key_type k) {
+    const key_type bits = k ^ ((k & 0x80000000u) ? 0x80000000u : 0xFFFFFFFFu);
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+  }
+};
+
+template <>
+struct normalized_key<double>
+{
+  using key_type = uint64_t;
+  GDF_KEY_FUNC static key_type encode(double v) {
+    key_type bits;
+    memcpy(&bits, &v, sizeof(bits));
+    const key_type mask = (bits & 0x8000000000000000ull) ? 0xFFFFFFFFFFFFFFFFull
+                                                         : 0x8000000000000000ull;
+    return bits ^ mask;
+  }
+  GDF_KEY_FUNC static double decode(key_type k) {
+    const key_type bits = k ^ ((k & 0x8000000000000000ull) ? 0x8000000000000000ull
+                                                           : 0xFFFFFFFFFFFFFFFFull);
+    double v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Normalized key of `v` for the requested direction: descending
+ * keys are the complement of the ascending ones.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+GDF_KEY_FUNC typename normalized_key<T>::key_type encode_ordered(T v, bool descending)
+{
+  using key_type = typename normalized_key<T>::key_type;
+  const key_type key = normalized_key<T>::encode(v);
+  return descending ? static_cast<key_type>(~key) : key;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Shifts a partially built key word left by `field_bits` and
+ * appends `field` in the low bits. A field as wide as the word is always the
+ * first field of its word and simply replaces it.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename KeyT>
+GDF_KEY_FUNC KeyT append_key_field(KeyT key, KeyT field, unsigned field_bits)
+{
+  return (field_bits < 8 * sizeof(KeyT)) ? ((key << field_bits) | field) : field;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Returns the width in bits of the normalized key of a gdf_dtype,
+ * or 0 if the dtype cannot be radix sorted.
+ */
+/* ----------------------------------------------------------------------------*/
+inline unsigned normalized_key_bits(gdf_dtype dtype)
+{
+  switch(dtype) {
+    case GDF_INT8:      return 8;
+    case GDF_INT16:     return 16;
+    case GDF_INT32:
+    case GDF_DATE32:
+    case GDF_CATEGORY:
+    case GDF_FLOAT32:   return 32;
+    case GDF_INT64:
+    case GDF_DATE64:
+    case GDF_TIMESTAMP:
+    case GDF_FLOAT64:   return 64;
+    default:            return 0;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Invokes `f` with a dummy value of the C++ type that stores the
+ * values of a radix sortable gdf_dtype (dates, timestamps and categories are
+ * ordered as the integers that encode them).
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Functor>
+gdf_error dispatch_key_type(gdf_dtype dtype, Functor & f)
+{
+  switch(dtype) {
+    case GDF_INT8:      { int8_t  dummy = 0; return f(dummy); }
+    case GDF_INT16:     { int16_t dummy = 0; return f(dummy); }
+    case GDF_INT32:
+    case GDF_DATE32:
+    case GDF_CATEGORY:  { int32_t dummy = 0; return f(dummy); }
+    case GDF_INT64:
+    case GDF_DATE64:
+    case GDF_TIMESTAMP: { int64_t dummy = 0; return f(dummy); }
+    case GDF_FLOAT32:   { float   dummy = 0; return f(dummy); }
+    case GDF_FLOAT64:   { double  dummy = 0; return f(dummy); }
+    default:            return GDF_UNSUPPORTED_DTYPE;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  One field of the composite sort key: either the normalized value
+ * of a key column, or the single bit that places the NULL rows of a nullable
+ * key column before or after its valid rows.
+ */
+/* ----------------------------------------------------------------------------*/
+struct key_field
+{
+  size_t col;         /**< Index of the key column the field belongs to */
+  bool null_flag;     /**< True for the null placement bit of the column */
+  unsigned num_bits;  /**< Width of the field in bits */
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  A run of consecutive key fields whose bits are concatenated into
+ * one unsigned word of at most 64 bits. The first field of the run occupies
+ * the most significant bits.
+ */
+/* ----------------------------------------------------------------------------*/
+struct key_word
+{
+  size_t first_field; /**< Index of the most significant field of the word */
+  size_t last_field;  /**< One past the index of the least significant field */
+  unsigned num_bits;  /**< Total number of key bits in the word */
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Splits the key columns into fields (a null placement bit ahead of
+ * the value of every column that has a validity mask) and greedily packs the
+ * fields, most significant first, into words of at most 64 bits. Sorting the
+ * words least significant first with a stable radix sort orders the rows
+ * lexicographically by the key columns, so e.g. two int32 keys take a single
+ * 64 bit sort instead of two 32 bit sorts.
+ *
+ * @Param[in] cols The host array of key columns
+ * @Param[in] ncols The number of key columns
+ * @Param[out] fields The key fields, most significant first
+ * @Param[out] words The resulting key words, most significant first
+ *
+ * @Returns GDF_UNSUPPORTED_DTYPE if one of the columns cannot be radix sorted
+ */
+/* ----------------------------------------------------------------------------*/
+inline gdf_error plan_key_words(gdf_column const * cols,
+                                size_t ncols,
+                                std::vector<key_field> & fields,
+                                std::vector<key_word> & words)
+{
+  fields.clear();
+  for(size_t i = 0; i < ncols; ++i)
+  {
+    const unsigned bits = normalized_key_bits(cols[i].dtype);
+    if(0 == bits)
+      return GDF_UNSUPPORTED_DTYPE;
+
+    if(nullptr != cols[i].valid)
+      fields.push_back(key_field{i, true, 1});
+    fields.push_back(key_field{i, false, bits});
+  }
+
+  words.clear();
+  for(size_t f = 0; f < fields.size(); ++f)
+  {
+    const unsigned bits = fields[f].num_bits;
+    if(words.empty() || (words.back().num_bits + bits > 64))
+      words.push_back(key_word{f, f + 1, bits});
+    else
+    {
+      words.back().last_field = f + 1;
+      words.back().num_bits += bits;
+    }
+  }
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_ORDERBY_NORMALIZED_KEY_H
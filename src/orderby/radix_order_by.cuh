@@ -0,0 +1,384 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_ORDERBY_RADIX_ORDER_BY_CUH
+#define GDF_ORDERBY_RADIX_ORDER_BY_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <thrust/device_vector.h>
+#include <thrust/execution_policy.h>
+#include <thrust/system/cuda/execution_policy.h>
+#include <thrust/sequence.h>
+#include <thrust/transform.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../sorting.cuh"
+#include "normalized_key.h"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Computes one field of a key word for the row `row`: either the
+ * null placement bit of the column, or its direction adjusted normalized key.
+ * NULL rows get an all-zero value field so that they tie with each other and
+ * keep their relative order.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename ColType, typename KeyT, typename IndexT>
+struct key_field_op
+{
+  ColType const *        col;
+  gdf_valid_type const * valid;
+  unsigned               num_bits;
+  bool                   null_flag;
+  bool                   descending;
+  bool                   nulls_last;
+
+  __device__
+  KeyT field(IndexT row) const
+  {
+    const bool is_valid = gdf_is_valid(valid, row);
+    if( null_flag )
+      return static_cast<KeyT>(is_valid != nulls_last);
+    return is_valid ? static_cast<KeyT>(encode_ordered(col[row], descending)) : KeyT{0};
+  }
+
+  // Most significant field of the word
+  __device__
+  KeyT operator()(IndexT row) const
+  {
+    return field(row);
+  }
+
+  // Following fields: shift the partial word and append
+  __device__
+  KeyT operator()(KeyT key, IndexT row) const
+  {
+    return append_key_field(key, field(row), num_bits);
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Type dispatched functor that writes (or appends) one key field,
+ * gathered through the current permutation, into the key word buffer.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename KeyT, typename IndexT>
+struct key_word_builder
+{
+  gdf_column const & col;
+  key_field const &  kfield;
+  bool               descending;
+  bool               nulls_last;
+  KeyT *             d_keys;
+  IndexT const *     d_indx;
+  size_t             nrows;
+  bool               first;
+  cudaStream_t       stream;
+
+  template <typename ColType>
+  gdf_error operator()(ColType)
+  {
+    key_field_op<ColType, KeyT, IndexT> op{static_cast<ColType const *>(col.data),
+                                           col.valid,
+                                           kfield.num_bits,
+                                           kfield.null_flag,
+                                           descending,
+                                           nulls_last};
+    if( first )
+      thrust::transform(thrust::cuda::par.on(stream),
+                        d_indx, d_indx + nrows,
+                        d_keys,
+                        op);
+    else
+      thrust::transform(thrust::cuda::par.on(stream),
+                        d_keys, d_keys + nrows,
+                        d_indx,
+                        d_keys,
+                        op);
+    CUDA_CHECK_LAST();
+    return GDF_SUCCESS;
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Owns the RadixSortPlans used while ordering a table, one per
+ * key word width, created on first use.
+ */
+/* ----------------------------------------------------------------------------*/
+struct order_by_sort_plans
+{
+  explicit order_by_sort_plans(size_t nrows) : num_items(nrows) {}
+
+  ~order_by_sort_plans()
+  {
+    for(RadixSortPlan * plan : {plan32, plan64})
+    {
+      if( plan )
+      {
+        plan->teardown();
+        delete plan;
+      }
+    }
+  }
+
+  template <typename KeyT>
+  RadixSortPlan * get(size_t sizeof_val)
+  {
+    RadixSortPlan *& plan = (sizeof(KeyT) == sizeof(uint32_t)) ? plan32 : plan64;
+    if( nullptr == plan )
+    {
+      plan = new RadixSortPlan(num_items, 0, 0, 8 * sizeof(KeyT));
+      if( GDF_SUCCESS != plan->setup(sizeof(KeyT), sizeof_val) )
+      {
+        plan->teardown();
+        delete plan;
+        plan = nullptr;
+      }
+    }
+    return plan;
+  }
+
+  size_t num_items;
+  RadixSortPlan * plan32{nullptr};
+  RadixSortPlan * plan64{nullptr};
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Builds one key word for the rows listed in `d_indx`, i.e. the
+ * key of d_indx[i] is written to d_keys[i].
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename KeyT, typename IndexT>
+gdf_error build_key_word(gdf_column const *      cols,
+                         order_by_type const *   asc_desc,
+                         null_order_type const * null_order,
+                         key_field const *       fields,
+                         key_word const &        word,
+                         size_t                  nrows,
+                         KeyT *                  d_keys,
+                         IndexT const *          d_indx,
+                         cudaStream_t            stream)
+{
+  for(size_t f = word.first_field; f < word.last_field; ++f)
+  {
+    const size_t c = fields[f].col;
+    const bool descending = (nullptr != asc_desc) && (GDF_ORDER_DESC == asc_desc[c]);
+    const bool nulls_last = (nullptr == null_order) || (GDF_NULLS_LAST == null_order[c]);
+    key_word_builder<KeyT, IndexT> builder{cols[c], fields[f], descending, nulls_last,
+                                           d_keys, d_indx, nrows,
+                                           f == word.first_field, stream};
+    gdf_error status = dispatch_key_type(cols[c].dtype, builder);
+    if( GDF_SUCCESS != status )
+      return status;
+  }
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Builds one key word for the rows in permutation order and
+ * stably radix sorts the permutation by it.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename KeyT, typename IndexT>
+gdf_error sort_by_key_word(gdf_column const *      cols,
+                           order_by_type const *   asc_desc,
+                           null_order_type const * null_order,
+                           key_field const *       fields,
+                           key_word const &        word,
+                           size_t                  nrows,
+                           void *                  d_key_buffer,
+                           IndexT *                d_indx,
+                           order_by_sort_plans &   plans,
+                           cudaStream_t            stream)
+{
+  KeyT * d_keys = static_cast<KeyT*>(d_key_buffer);
+
+  gdf_error status = build_key_word(cols, asc_desc, null_order, fields, word,
+                                    nrows, d_keys, d_indx, stream);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  RadixSortPlan * plan = plans.get<KeyT>(sizeof(IndexT));
+  GDF_REQUIRE(nullptr != plan, GDF_CUDA_ERROR);
+  plan->stream = stream;
+  plan->end_bit = word.num_bits;
+
+  return RadixSort<KeyT, IndexT>::sort(plan, d_keys, d_indx);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Stably reorders a list of row indices by the planned key words,
+ * one LSD radix sort per word starting with the least significant one.
+ *
+ * `d_indx` may hold any subset of the rows of the columns, so that callers
+ * can order the candidates of a filter without gathering them first.
+ *
+ * @Param[in] cols Host array of the key columns (data resident on the device)
+ * @Param[in] asc_desc Host array of per-column sort directions, or nullptr
+ * @Param[in] null_order Host array of per-column NULL placements, or nullptr
+ * @Param[in] fields The key fields from plan_key_words
+ * @Param[in] words The key words from plan_key_words
+ * @Param[in] nrows The number of row indices in d_indx
+ * @Param[in,out] d_indx Device array of row indices to reorder
+ * @Param[in] stream The stream on which to perform the sort
+ *
+ * @Returns GDF_SUCCESS upon successful completion
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT>
+gdf_error radix_order_rows(gdf_column const *             cols,
+                           order_by_type const *          asc_desc,
+                           null_order_type const *        null_order,
+                           std::vector<key_field> const & fields,
+                           std::vector<key_word> const &  words,
+                           size_t                         nrows,
+                           IndexT *                       d_indx,
+                           cudaStream_t                   stream = 0)
+{
+  if( nrows < 2 )
+    return GDF_SUCCESS;
+
+  unsigned max_bits = 0;
+  for(auto const & word : words)
+    max_bits = (word.num_bits > max_bits) ? word.num_bits : max_bits;
+  const size_t key_bytes = (max_bits > 32) ? sizeof(uint64_t) : sizeof(uint32_t);
+
+  thrust::device_vector<char> d_key_buffer(nrows * key_bytes);
+  order_by_sort_plans plans(nrows);
+
+  for(auto w = words.rbegin(); w != words.rend(); ++w)
+  {
+    gdf_error status;
+    if( w->num_bits > 32 )
+      status = sort_by_key_word<uint64_t>(cols, asc_desc, null_order, fields.data(), *w,
+                                          nrows, d_key_buffer.data().get(),
+                                          d_indx, plans, stream);
+    else
+      status = sort_by_key_word<uint32_t>(cols, asc_desc, null_order, fields.data(), *w,
+                                          nrows, d_key_buffer.data().get(),
+                                          d_indx, plans, stream);
+    if( GDF_SUCCESS != status )
+      return status;
+  }
+
+  return GDF_SUCCESS;
+}
+
+//###########################################################################
+//#                     Multi-column radix ORDER-BY:                        #
+//###########################################################################
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Computes the permutation that lexicographically orders the rows
+ * of a set of columns, using stable LSD radix sorts of normalized keys in
+ * place of a comparison sort.
+ *
+ * The key columns are packed into words of at most 64 bits (see
+ * plan_key_words) and the permutation is radix sorted by one word at a time,
+ * starting with the least significant word. Narrow keys, e.g. up to two int32
+ * columns, therefore need a single key-value radix sort.
+ *
+ * Descending columns are sorted by the complement of their normalized keys.
+ * Columns with a validity mask get an extra one bit field ahead of their
+ * value that sends the NULL rows before or after the valid ones; the value
+ * field of NULL rows is zeroed so that NULLs compare equal.
+ *
+ * @Param[in] nrows The number of rows
+ * @Param[in] cols Host array of the key columns (data resident on the device)
+ * @Param[in] ncols The number of key columns
+ * @Param[in] asc_desc Host array of ncols sort directions, or nullptr to sort
+ * every column in ascending order
+ * @Param[in] null_order Host array of ncols NULL placements, or nullptr to
+ * place the NULLs of every column last
+ * @Param[out] d_indx Device array of nrows row indices, in sorted order
+ * @Param[in] stream The stream on which to perform the sort
+ *
+ * @Returns GDF_SUCCESS upon successful completion, GDF_UNSUPPORTED_DTYPE if
+ * a column cannot be radix sorted
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT>
+gdf_error radix_order_by(size_t                  nrows,
+                         gdf_column const *      cols,
+                         size_t                  ncols,
+                         order_by_type const *   asc_desc,
+                         null_order_type const * null_order,
+                         IndexT *                d_indx,
+                         cudaStream_t            stream = 0)
+{
+  std::vector<key_field> fields;
+  std::vector<key_word> words;
+  gdf_error status = plan_key_words(cols, ncols, fields, words);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  thrust::sequence(thrust::cuda::par.on(stream), d_indx, d_indx + nrows, 0);
+
+  return radix_order_rows(cols, asc_desc, null_order, fields, words, nrows, d_indx, stream);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Returns true if the row indices of a table of `nrows` rows fit in
+ * a 32-bit signed integer, i.e. nrows < 2^31.
+ */
+/* ----------------------------------------------------------------------------*/
+inline bool use_int32_index(size_t nrows)
+{
+  return nrows < (size_t{1} << 31);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Same as radix_order_by, but the permutation is sorted as 32-bit
+ * indices whenever the number of rows allows it and only widened to IndexT
+ * at the end: the radix sort passes then move half the index bytes.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT>
+gdf_error radix_order_by_compact(size_t                  nrows,
+                                 gdf_column const *      cols,
+                                 size_t                  ncols,
+                                 order_by_type const *   asc_desc,
+                                 null_order_type const * null_order,
+                                 IndexT *                d_indx,
+                                 cudaStream_t            stream = 0)
+{
+  if( (sizeof(IndexT) <= sizeof(int32_t)) || !use_int32_index(nrows) )
+    return radix_order_by(nrows, cols, ncols, asc_desc, null_order, d_indx, stream);
+
+  thrust::device_vector<int32_t> d_indx32(nrows);
+  gdf_error status = radix_order_by(nrows, cols, ncols, asc_desc, null_order,
+                                    d_indx32.data().get(), stream);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  thrust::copy(thrust::cuda::par.on(stream), d_indx32.begin(), d_indx32.end(), d_indx);
+  CUDA_CHECK_LAST();
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_ORDERBY_RADIX_ORDER_BY_CUH
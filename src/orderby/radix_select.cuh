@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_ORDERBY_RADIX_SELECT_CUH
+#define GDF_ORDERBY_RADIX_SELECT_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <thrust/device_vector.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "normalized_key.h"
+
+constexpr int RADIX_SELECT_BLOCK_SIZE = 256;
+constexpr int RADIX_SELECT_MAX_BLOCKS = 1024;
+constexpr unsigned RADIX_SELECT_DIGIT_BITS = 8;
+constexpr unsigned RADIX_SELECT_BUCKETS = 1u << RADIX_SELECT_DIGIT_BITS;
+// Histogram counter: a column may have more than 2^32 rows
+using radix_select_count = unsigned long long;
+
+// Keys that are already unsigned radix keys, e.g. packed order-by key words
+template <typename KeyT>
+struct radix_select_identity_key
+{
+  using key_type = KeyT;
+  GDF_KEY_FUNC static key_type encode(KeyT k) { return k; }
+};
+
+// Normalized key of a column value
+template <typename T>
+struct radix_select_value_key
+{
+  using key_type = typename normalized_key<T>::key_type;
+  GDF_KEY_FUNC static key_type encode(T v) { return normalized_key<T>::encode(v); }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Histogram of one 8 bit digit of the keys of the valid rows whose
+ * higher digits match the prefix selected so far. Each block accumulates in
+ * shared memory and flushes its counts to the global histogram once.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Encoder, typename T>
+__global__
+void radix_select_histogram(T const *                  values,
+                            gdf_valid_type const *     valid,
+                            size_t                     nrows,
+                            typename Encoder::key_type prefix,
+                            typename Encoder::key_type prefix_mask,
+                            unsigned                   shift,
+                            radix_select_count *       histogram)
+{
+  __shared__ radix_select_count block_histogram[RADIX_SELECT_BUCKETS];
+
+  for(unsigned b = threadIdx.x; b < RADIX_SELECT_BUCKETS; b += blockDim.x)
+    block_histogram[b] = 0;
+  __syncthreads();
+
+  for(size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < nrows; i += blockDim.x * gridDim.x)
+  {
+    if( !gdf_is_valid(valid, i) )
+      continue;
+    const auto key = Encoder::encode(values[i]);
+    if( (key & prefix_mask) == prefix )
+      atomicAdd(&block_histogram[(key >> shift) & (RADIX_SELECT_BUCKETS - 1)], radix_select_count{1});
+  }
+  __syncthreads();
+
+  for(unsigned b = threadIdx.x; b < RADIX_SELECT_BUCKETS; b += blockDim.x)
+    if( block_histogram[b] )
+      atomicAdd(&histogram[b], block_histogram[b]);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Runs radix_select_histogram over `nrows` values and copies the
+ * RADIX_SELECT_BUCKETS counts to `h_histogram`. `d_histogram` is scratch of
+ * RADIX_SELECT_BUCKETS counters.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Encoder, typename T>
+gdf_error radix_select_digit_histogram(T const *                         values,
+                                       gdf_valid_type const *            valid,
+                                       size_t                            nrows,
+                                       typename Encoder::key_type        prefix,
+                                       typename Encoder::key_type        prefix_mask,
+                                       unsigned                          shift,
+                                       radix_select_count *              d_histogram,
+                                       std::vector<radix_select_count> & h_histogram,
+                                       cudaStream_t                      stream)
+{
+  const int num_blocks = static_cast<int>(
+    std::min<size_t>((nrows + RADIX_SELECT_BLOCK_SIZE - 1) / RADIX_SELECT_BLOCK_SIZE,
+                     RADIX_SELECT_MAX_BLOCKS));
+
+  CUDA_TRY( cudaMemsetAsync(d_histogram, 0, RADIX_SELECT_BUCKETS * sizeof(radix_select_count), stream) );
+  if( num_blocks > 0 )
+  {
+    radix_select_histogram<Encoder><<<num_blocks, RADIX_SELECT_BLOCK_SIZE, 0, stream>>>(
+      values, valid, nrows, prefix, prefix_mask, shift, d_histogram);
+    CUDA_CHECK_LAST();
+  }
+  h_histogram.resize(RADIX_SELECT_BUCKETS);
+  CUDA_TRY( cudaMemcpyAsync(h_histogram.data(), d_histogram,
+                            RADIX_SELECT_BUCKETS * sizeof(radix_select_count),
+                            cudaMemcpyDeviceToHost, stream) );
+  CUDA_TRY( cudaStreamSynchronize(stream) );
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The bucket of a digit histogram holding rank `rank` of the
+ * candidates; `rank` becomes the rank within that bucket.
+ */
+/* ----------------------------------------------------------------------------*/
+inline unsigned radix_select_bucket(std::vector<radix_select_count> const & h_histogram,
+                                    size_t &                                rank)
+{
+  unsigned bucket = 0;
+  while( rank >= h_histogram[bucket] )
+    rank -= h_histogram[bucket++];
+  return bucket;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Finds the key of rank `rank` (0 based) among the keys of the
+ * valid rows of `nrows` values, of which the encoder keeps `num_bits`
+ * significant bits, with an MSD radix select: one histogram pass over the
+ * values per 8 bit digit, without moving any of them.
+ *
+ * @Param[in] values Device array of the values
+ * @Param[in] valid Device validity mask of the values, or nullptr if all are
+ * valid
+ * @Param[in] nrows The number of values
+ * @Param[in] rank The rank to select, less than the number of valid values
+ * @Param[in] num_bits The number of significant low bits of the keys
+ * @Param[out] kth_key The key of rank `rank`
+ * @Param[in] stream The stream on which to perform the selection
+ *
+ * @Returns GDF_SUCCESS upon successful completion
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Encoder, typename T>
+gdf_error radix_select(T const *                    values,
+                       gdf_valid_type const *       valid,
+                       size_t                       nrows,
+                       size_t                       rank,
+                       unsigned                     num_bits,
+                       typename Encoder::key_type & kth_key,
+                       cudaStream_t                 stream)
+{
+  using key_type = typename Encoder::key_type;
+
+  thrust::device_vector<radix_select_count> d_histogram(RADIX_SELECT_BUCKETS);
+  std::vector<radix_select_count> h_histogram(RADIX_SELECT_BUCKETS);
+  const unsigned num_digits = (num_bits + RADIX_SELECT_DIGIT_BITS - 1) / RADIX_SELECT_DIGIT_BITS;
+
+  key_type prefix = 0;
+  key_type prefix_mask = 0;
+  for(unsigned d = num_digits; d-- > 0; )
+  {
+    const unsigned shift = d * RADIX_SELECT_DIGIT_BITS;
+
+    gdf_error status = radix_select_digit_histogram<Encoder>(values, valid, nrows, prefix, prefix_mask,
+                                                             shift, d_histogram.data().get(),
+                                                             h_histogram, stream);
+    if( GDF_SUCCESS != status )
+      return status;
+
+    prefix |= static_cast<key_type>(radix_select_bucket(h_histogram, rank)) << shift;
+    prefix_mask |= static_cast<key_type>(RADIX_SELECT_BUCKETS - 1) << shift;
+  }
+
+  kth_key = prefix;
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_ORDERBY_RADIX_SELECT_CUH
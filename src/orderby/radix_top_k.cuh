@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_ORDERBY_RADIX_TOP_K_CUH
+#define GDF_ORDERBY_RADIX_TOP_K_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/errorutils.h>
+
+#include <thrust/copy.h>
+#include <thrust/device_vector.h>
+#include <thrust/iterator/counting_iterator.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "radix_order_by.cuh"
+#include "radix_select.cuh"
+
+template <typename KeyT>
+struct key_not_greater
+{
+  KeyT threshold;
+
+  __device__
+  bool operator()(KeyT key) const { return key <= threshold; }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Keeps the rows whose most significant key word does not exceed
+ * the k-th smallest one; these are a superset of the top k rows.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename KeyT, typename IndexT>
+gdf_error top_k_candidates(gdf_column const *             cols,
+                           order_by_type const *          asc_desc,
+                           null_order_type const *        null_order,
+                           std::vector<key_field> const & fields,
+                           key_word const &               word,
+                           size_t                         nrows,
+                           size_t                         k,
+                           thrust::device_vector<IndexT> & d_candidates,
+                           cudaStream_t                   stream)
+{
+  thrust::device_vector<KeyT> d_keys(nrows);
+  thrust::counting_iterator<IndexT> rows(0);
+
+  // Keys of all rows, in row order
+  thrust::device_vector<IndexT> d_rows(rows, rows + nrows);
+  gdf_error status = build_key_word(cols, asc_desc, null_order, fields.data(), word,
+                                    nrows, d_keys.data().get(), d_rows.data().get(), stream);
+  if( GDF_SUCCESS != status )
+    return status;
+  d_rows.clear();
+  d_rows.shrink_to_fit();
+
+  KeyT threshold;
+  status = radix_select<radix_select_identity_key<KeyT>>(d_keys.data().get(), nullptr, nrows, k - 1,
+                                                         word.num_bits, threshold, stream);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  d_candidates.resize(nrows);
+  auto end = thrust::copy_if(thrust::cuda::par.on(stream),
+                             rows, rows + nrows,
+                             d_keys.begin(),
+                             d_candidates.begin(),
+                             key_not_greater<KeyT>{threshold});
+  CUDA_CHECK_LAST();
+  d_candidates.resize(end - d_candidates.begin());
+  return GDF_SUCCESS;
+}
+
+//###########################################################################
+//#                        Multi-column radix TOP-K:                        #
+//###########################################################################
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Computes the first k rows of the ordering that radix_order_by
+ * would produce, without sorting the whole table.
+ *
+ * The k-th smallest value of the most significant key word is found with a
+ * radix select (one histogram pass per 8 bit digit), the rows that do not
+ * exceed it are compacted, and only these candidates are radix sorted by all
+ * the key words. Unless the leading key word has massive ties at the
+ * threshold, the cost is a few linear passes plus a sort of about k rows.
+ *
+ * @Param[in] nrows The number of rows
+ * @Param[in] cols Host array of the key columns (data resident on the device)
+ * @Param[in] ncols The number of key columns
+ * @Param[in] asc_desc Host array of ncols sort directions, or nullptr for all
+ * ascending (i.e. the k smallest rows)
+ * @Param[in] null_order Host array of ncols NULL placements, or nullptr for
+ * all NULLS LAST
+ * @Param[in] k The number of rows to return
+ * @Param[out] d_indx Device array of min(k, nrows) row indices, in sorted order
+ * @Param[in] stream The stream on which to perform the selection
+ *
+ * @Returns GDF_SUCCESS upon successful completion, GDF_UNSUPPORTED_DTYPE if
+ * a column cannot be radix sorted
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename IndexT>
+gdf_error radix_top_k(size_t                  nrows,
+                      gdf_column const *      cols,
+                      size_t                  ncols,
+                      order_by_type const *   asc_desc,
+                      null_order_type const * null_order,
+                      size_t                  k,
+                      IndexT *                d_indx,
+                      cudaStream_t            stream = 0)
+{
+  std::vector<key_field> fields;
+  std::vector<key_word> words;
+  gdf_error status = plan_key_words(cols, ncols, fields, words);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  if( 0 == k )
+    return GDF_SUCCESS;
+
+  if( k >= nrows )
+  {
+    thrust::sequence(thrust::cuda::par.on(stream), d_indx, d_indx + nrows, 0);
+    return radix_order_rows(cols, asc_desc, null_order, fields, words, nrows, d_indx, stream);
+  }
+
+  thrust::device_vector<IndexT> d_candidates;
+  if( words.front().num_bits > 32 )
+    status = top_k_candidates<uint64_t>(cols, asc_desc, null_order, fields, words.front(),
+                                        nrows, k, d_candidates, stream);
+  else
+    status = top_k_candidates<uint32_t>(cols, asc_desc, null_order, fields, words.front(),
+                                        nrows, k, d_candidates, stream);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  status = radix_order_rows(cols, asc_desc, null_order, fields, words,
+                            d_candidates.size(), d_candidates.data().get(), stream);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  CUDA_TRY( cudaMemcpyAsync(d_indx, d_candidates.data().get(), k * sizeof(IndexT),
+                            cudaMemcpyDeviceToDevice, stream) );
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_ORDERBY_RADIX_TOP_K_CUH
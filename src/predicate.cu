@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Comparisons into packed, one bit per row, stencils and the operations on them
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+#include <gdf/cffi/functions.h>
+
+#include <type_traits>
+
+#include "predicate/predicate.cuh"
+#include "predicate/host_predicate.h"
+#include "util/type_promotion.h"
+#include "util/exec_context.h"
+
+namespace {
+
+// Queues a comparison on a context: a kernel on its stream, or a task on its
+// host executor, which gets copies of the operands
+template <typename Cmp, typename LhsAt, typename RhsAt>
+gdf_error compare_on(gdf_exec_context context,
+                     LhsAt lhs, gdf_valid_type const *lhs_valid,
+                     RhsAt rhs, gdf_valid_type const *rhs_valid,
+                     gdf_size_type size, gdf_valid_type *stencil) {
+    gdf::util::host_executor *executor = gdf::util::exec_host(context);
+    if ( nullptr != executor ) {
+        executor->enqueue([=]() {
+            host_compare_to_mask<Cmp>(lhs, lhs_valid, rhs, rhs_valid, size, stencil, executor);
+        });
+        return GDF_SUCCESS;
+    }
+    return predicate_launch<Cmp>(lhs, lhs_valid, rhs, rhs_valid, size, stencil,
+                                 gdf::util::exec_stream(context));
+}
+
+// Two columns, compared in the type both are promoted to
+template <typename L, typename R>
+struct compare_columns {
+    gdf_column *lhs, *rhs;
+    gdf_valid_type *stencil;
+    gdf_exec_context context;
+
+    template <typename Cmp>
+    gdf_error run(Cmp) {
+        typedef typename gdf::util::PromotedType<L, R>::type C;
+        return compare_on<Cmp>(context,
+                               column_operand<L, C>{static_cast<L const *>(lhs->data)}, lhs->valid,
+                               column_operand<R, C>{static_cast<R const *>(rhs->data)}, rhs->valid,
+                               lhs->size, stencil);
+    }
+};
+
+template <typename L, typename R>
+gdf_error compare_columns_dispatch(gdf_column *lhs, gdf_column *rhs, gdf_comparison_operator op,
+                                   gdf_valid_type *stencil, gdf_exec_context context) {
+    compare_columns<L, R> f{lhs, rhs, stencil, context};
+    return comparison_dispatch(op, f);
+}
+
+template <typename L>
+gdf_error compare_columns_rhs(gdf_column *lhs, gdf_column *rhs, gdf_comparison_operator op,
+                              gdf_valid_type *stencil, gdf_exec_context context) {
+    switch ( rhs->dtype ) {
+    case GDF_INT8:      return compare_columns_dispatch<L, int8_t>(lhs, rhs, op, stencil, context);
+    case GDF_INT16:     return compare_columns_dispatch<L, int16_t>(lhs, rhs, op, stencil, context);
+    case GDF_INT32:
+    case GDF_DATE32:    return compare_columns_dispatch<L, int32_t>(lhs, rhs, op, stencil, context);
+    case GDF_INT64:
+    case GDF_DATE64:
+    case GDF_TIMESTAMP: return compare_columns_dispatch<L, int64_t>(lhs, rhs, op, stencil, context);
+    case GDF_FLOAT32:   return compare_columns_dispatch<L, float>(lhs, rhs, op, stencil, context);
+    case GDF_FLOAT64:   return compare_columns_dispatch<L, double>(lhs, rhs, op, stencil, context);
+    default:            return GDF_UNSUPPORTED_DTYPE;
+    }
+}
+
+// A column and a scalar, compared in the type C
+template <typename T, typename C>
+struct compare_column_scalar {
+    gdf_column *lhs;
+    C value;
+    gdf_valid_type *stencil;
+    gdf_exec_context context;
+
+    template <typename Cmp>
+    gdf_error run(Cmp) {
+        return compare_on<Cmp>(context,
+                               column_operand<T, C>{static_cast<T const *>(lhs->data)}, lhs->valid,
+                               scalar_operand<C>{value}, nullptr,
+                               lhs->size, stencil);
+    }
+};
+
+// An integer column is compared with the scalar in their promoted type, so
+// that neither x < 2.5 becomes x < 2 nor an int8 x < 300 becomes x < 44;
+// any other column in its own type
+template <typename T>
+struct compare_column_scalar_of {
+    gdf_column *lhs;
+    gdf_comparison_operator op;
+    gdf_valid_type *stencil;
+    gdf_exec_context context;
+
+    template <typename S>
+    gdf_error operator()(S value) const {
+        typedef typename gdf::util::ScalarComparisonType<T, S>::type C;
+        compare_column_scalar<T, C> f{lhs, static_cast<C>(value), stencil, context};
+        return comparison_dispatch(op, f);
+    }
+};
+
+template <typename T>
+gdf_error compare_column_scalar_dispatch(gdf_column *lhs, const gdf_scalar &value,
+                                         gdf_comparison_operator op, gdf_valid_type *stencil,
+                                         gdf_exec_context context) {
+    compare_column_scalar_of<T> f{lhs, op, stencil, context};
+    return gdf::util::scalar_dispatch(value, f);
+}
+
+// Queues an operation on packed masks on a context
+gdf_error mask_on(gdf_exec_context context, mask_operator op, gdf_valid_type const *lhs,
+                  gdf_valid_type const *rhs, gdf_size_type size, gdf_valid_type *output) {
+    gdf::util::host_executor *executor = gdf::util::exec_host(context);
+    if ( nullptr != executor ) {
+        executor->enqueue([=]() { host_mask_apply(op, lhs, rhs, size, output); });
+        return GDF_SUCCESS;
+    }
+    return mask_launch(op, lhs, rhs, size, output, gdf::util::exec_stream(context));
+}
+
+} // namespace
+
+gdf_error gdf_comparison_mask(gdf_column *lhs, gdf_column *rhs, gdf_comparison_operator op,
+                              gdf_valid_type *stencil) {
+    return gdf_comparison_mask_async(lhs, rhs, op, stencil, nullptr);
+}
+
+gdf_error gdf_comparison_mask_async(gdf_column *lhs, gdf_column *rhs, gdf_comparison_operator op,
+                                    gdf_valid_type *stencil, gdf_exec_context context) {
+    GDF_REQUIRE(nullptr != lhs && nullptr != rhs && nullptr != stencil, GDF_DATASET_EMPTY);
+    GDF_REQUIRE(lhs->size == rhs->size, GDF_COLUMN_SIZE_MISMATCH);
+    if ( gdf::util::is_date_dtype(lhs->dtype) || gdf::util::is_date_dtype(rhs->dtype) ) {
+        GDF_REQUIRE(lhs->dtype == rhs->dtype, GDF_DTYPE_MISMATCH);
+        GDF_REQUIRE(GDF_TIMESTAMP != lhs->dtype ||
+                    lhs->dtype_info.time_unit == rhs->dtype_info.time_unit, GDF_DTYPE_MISMATCH);
+    }
+
+    switch ( lhs->dtype ) {
+    case GDF_INT8:      return compare_columns_rhs<int8_t>(lhs, rhs, op, stencil, context);
+    case GDF_INT16:     return compare_columns_rhs<int16_t>(lhs, rhs, op, stencil, context);
+    case GDF_INT32:
+    case GDF_DATE32:    return compare_columns_rhs<int32_t>(lhs, rhs, op, stencil, context);
+    case GDF_INT64:
+    case GDF_DATE64:
+    case GDF_TIMESTAMP: return compare_columns_rhs<int64_t>(lhs, rhs, op, stencil, context);
+    case GDF_FLOAT32:   return compare_columns_rhs<float>(lhs, rhs, op, stencil, context);
+    case GDF_FLOAT64:   return compare_columns_rhs<double>(lhs, rhs, op, stencil, context);
+    default:            return GDF_UNSUPPORTED_DTYPE;
+    }
+}
+
+gdf_error gdf_comparison_static_mask(gdf_column *lhs, const gdf_scalar *value, gdf_comparison_operator op,
+                                     gdf_valid_type *stencil) {
+    return gdf_comparison_static_mask_async(lhs, value, op, stencil, nullptr);
+}
+
+gdf_error gdf_comparison_static_mask_async(gdf_column *lhs, const gdf_scalar *value,
+                                           gdf_comparison_operator op, gdf_valid_type *stencil,
+                                           gdf_exec_context context) {
+    GDF_REQUIRE(nullptr != lhs && nullptr != value && nullptr != stencil, GDF_DATASET_EMPTY);
+    GDF_REQUIRE(gdf::util::is_date_dtype(lhs->dtype) == gdf::util::is_date_dtype(value->dtype),
+                GDF_DTYPE_MISMATCH);
+
+    switch ( lhs->dtype ) {
+    case GDF_INT8:      return compare_column_scalar_dispatch<int8_t>(lhs, *value, op, stencil, context);
+    case GDF_INT16:     return compare_column_scalar_dispatch<int16_t>(lhs, *value, op, stencil, context);
+    case GDF_INT32:
+    case GDF_DATE32:    return compare_column_scalar_dispatch<int32_t>(lhs, *value, op, stencil, context);
+    case GDF_INT64:
+    case GDF_DATE64:
+    case GDF_TIMESTAMP: return compare_column_scalar_dispatch<int64_t>(lhs, *value, op, stencil, context);
+    case GDF_FLOAT32:   return compare_column_scalar_dispatch<float>(lhs, *value, op, stencil, context);
+    case GDF_FLOAT64:   return compare_column_scalar_dispatch<double>(lhs, *value, op, stencil, context);
+    default:            return GDF_UNSUPPORTED_DTYPE;
+    }
+}
+
+gdf_error gdf_mask_and(gdf_valid_type const *lhs, gdf_valid_type const *rhs, gdf_valid_type *output,
+                       gdf_size_type size) {
+    return gdf_mask_and_async(lhs, rhs, output, size, nullptr);
+}
+
+gdf_error gdf_mask_or(gdf_valid_type const *lhs, gdf_valid_type const *rhs, gdf_valid_type *output,
+                      gdf_size_type size) {
+    return gdf_mask_or_async(lhs, rhs, output, size, nullptr);
+}
+
+gdf_error gdf_mask_not(gdf_valid_type const *input, gdf_valid_type *output, gdf_size_type size) {
+    return gdf_mask_not_async(input, output, size, nullptr);
+}
+
+gdf_error gdf_mask_and_async(gdf_valid_type const *lhs, gdf_valid_type const *rhs, gdf_valid_type *output,
+                             gdf_size_type size, gdf_exec_context context) {
+    GDF_REQUIRE(nullptr != lhs && nullptr != rhs && nullptr != output, GDF_DATASET_EMPTY);
+    return mask_on(context, MASK_AND, lhs, rhs, size, output);
+}
+
+gdf_error gdf_mask_or_async(gdf_valid_type const *lhs, gdf_valid_type const *rhs, gdf_valid_type *output,
+                            gdf_size_type size, gdf_exec_context context) {
+    GDF_REQUIRE(nullptr != lhs && nullptr != rhs && nullptr != output, GDF_DATASET_EMPTY);
+    return mask_on(context, MASK_OR, lhs, rhs, size, output);
+}
+
+gdf_error gdf_mask_not_async(gdf_valid_type const *input, gdf_valid_type *output, gdf_size_type size,
+                             gdf_exec_context context) {
+    GDF_REQUIRE(nullptr != input && nullptr != output, GDF_DATASET_EMPTY);
+    return mask_on(context, MASK_NOT, input, nullptr, size, output);
+}
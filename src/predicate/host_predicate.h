@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_PREDICATE_HOST_PREDICATE_H
+#define GDF_PREDICATE_HOST_PREDICATE_H
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "predicate.h"
+#include "../util/host_executor.h"
+
+// Rows packed together: the 16 bytes of an SSE2 register
+constexpr size_t HOST_PREDICATE_GROUP = 16;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Packs 16 bytes of 0 or 1 into 16 bits, the first in the lowest
+ */
+/* ----------------------------------------------------------------------------*/
+inline
+uint16_t host_pack_flags(uint8_t const * flags)
+{
+#ifdef __SSE2__
+  // Move the flag into the sign bit of every byte, and gather the sign bits
+  const __m128i bytes = _mm_loadu_si128(reinterpret_cast<__m128i const *>(flags));
+  return static_cast<uint16_t>(_mm_movemask_epi8(_mm_slli_epi16(bytes, 7)));
+#else
+  uint16_t bits = 0;
+  for(size_t k = 0; k < HOST_PREDICATE_GROUP; ++k)
+    bits |= static_cast<uint16_t>(flags[k]) << k;
+  return bits;
+#endif
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of predicate_launch: compares two operands row
+ * by row into a packed stencil.
+ *
+ * Rows are compared 16 at a time into bytes, a dense loop without branches
+ * that the compiler can vectorize, and the bytes are packed into bits with a
+ * movemask; the bits are then ANDed with two bytes of each validity mask.
+ * Groups of rows are split between host threads, which never share a byte.
+ *
+ * @Param[in] lhs, rhs The operands, see column_operand and scalar_operand
+ * @Param[in] lhs_valid, rhs_valid The validity of the operands, or nullptr
+ * @Param[in] size The number of rows
+ * @Param[out] out The stencil, a validity bitmask of size rows
+ * @Param[in] executor The pool of threads to compare on, or nullptr
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Cmp, typename LhsAt, typename RhsAt>
+void host_compare_to_mask(LhsAt                       lhs,
+                          gdf_valid_type const *      lhs_valid,
+                          RhsAt                       rhs,
+                          gdf_valid_type const *      rhs_valid,
+                          size_t                      size,
+                          gdf_valid_type *            out,
+                          gdf::util::host_executor *  executor = nullptr)
+{
+  static_assert(2 * GDF_VALID_BITSIZE == HOST_PREDICATE_GROUP, "a group is two mask bytes");
+  const Cmp cmp{};
+  const size_t num_groups = (size + HOST_PREDICATE_GROUP - 1) / HOST_PREDICATE_GROUP;
+  const size_t num_bytes = gdf_get_num_chars_bitmask(size);
+
+  gdf::util::host_parallel_for(executor, num_groups, gdf::util::host_num_threads(size),
+    [&](unsigned, size_t first, size_t last) {
+      for(size_t g = first; g < last; ++g)
+      {
+        const size_t begin = g * HOST_PREDICATE_GROUP;
+        uint16_t bits = 0;
+        if( begin + HOST_PREDICATE_GROUP <= size )
+        {
+          uint8_t flags[HOST_PREDICATE_GROUP];
+          for(size_t k = 0; k < HOST_PREDICATE_GROUP; ++k)
+            flags[k] = cmp(lhs(begin + k), rhs(begin + k));
+          bits = host_pack_flags(flags);
+        }
+        else
+        {
+          for(size_t k = 0; begin + k < size; ++k)
+            if( cmp(lhs(begin + k), rhs(begin + k)) )
+              bits |= uint16_t(1) << k;
+        }
+
+        const size_t byte = begin / GDF_VALID_BITSIZE;
+        for(size_t b = 0; b < 2 && byte + b < num_bytes; ++b)
+        {
+          gdf_valid_type v = static_cast<gdf_valid_type>(bits >> (b * GDF_VALID_BITSIZE));
+          if( nullptr != lhs_valid )
+            v &= lhs_valid[byte + b];
+          if( nullptr != rhs_valid )
+            v &= rhs_valid[byte + b];
+          out[byte + b] = v;
+        }
+      }
+    });
+
+  // The bits of the rows past the end are cleared
+  if( 0 != size % GDF_VALID_BITSIZE )
+    out[num_bytes - 1] &= static_cast<gdf_valid_type>((1u << (size % GDF_VALID_BITSIZE)) - 1);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of mask_launch: combines one or two packed
+ * masks of size rows into out, a byte at a time in a loop the compiler
+ * vectorizes.
+ */
+/* ----------------------------------------------------------------------------*/
+inline
+void host_mask_apply(mask_operator          op,
+                     gdf_valid_type const * a,
+                     gdf_valid_type const * b,
+                     size_t                 size,
+                     gdf_valid_type *       out)
+{
+  const size_t num_bytes = gdf_get_num_chars_bitmask(size);
+  switch( op )
+  {
+  case MASK_AND:
+    for(size_t i = 0; i < num_bytes; ++i)
+      out[i] = a[i] & b[i];
+    break;
+  case MASK_OR:
+    for(size_t i = 0; i < num_bytes; ++i)
+      out[i] = a[i] | b[i];
+    break;
+  default:
+    for(size_t i = 0; i < num_bytes; ++i)
+      out[i] = ~a[i];
+    break;
+  }
+
+  if( 0 != size % GDF_VALID_BITSIZE )
+    out[num_bytes - 1] &= static_cast<gdf_valid_type>((1u << (size % GDF_VALID_BITSIZE)) - 1);
+}
+
+#endif // GDF_PREDICATE_HOST_PREDICATE_H
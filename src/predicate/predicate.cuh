@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_PREDICATE_PREDICATE_CUH
+#define GDF_PREDICATE_PREDICATE_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <algorithm>
+
+#include "predicate.h"
+#include "../reductions/valid_words.h"
+
+constexpr int PREDICATE_BLOCK_SIZE = 256;
+constexpr int PREDICATE_MAX_BLOCKS = 4096;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Compares every row and writes the results as a bitmask.
+ *
+ * The comparisons of a warp's 32 rows are assembled with a ballot; the
+ * first lane ANDs them with the validity words of both operands, read at
+ * once, and stores the 32 bits as a single word.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Cmp, typename LhsAt, typename RhsAt>
+__global__
+void predicate_kernel(LhsAt                  lhs,
+                      gdf_valid_type const * lhs_valid,
+                      RhsAt                  rhs,
+                      gdf_valid_type const * rhs_valid,
+                      gdf_size_type          size,
+                      gdf_valid_type *       out)
+{
+  static_assert(0 == PREDICATE_BLOCK_SIZE % VALID_WORD_BITS, "warps must cover whole mask words");
+  const Cmp cmp{};
+  const unsigned lane = threadIdx.x % warpSize;
+
+  for(gdf_size_type tile = static_cast<gdf_size_type>(blockIdx.x) * blockDim.x;
+      tile < size;
+      tile += static_cast<gdf_size_type>(blockDim.x) * gridDim.x)
+  {
+    const gdf_size_type row = tile + threadIdx.x;
+    const bool result = (row < size) && cmp(lhs(row), rhs(row));
+
+    const valid_word_t bits = __ballot_sync(0xffffffff, result);
+    if( 0 == lane )
+    {
+      const gdf_size_type w = row / VALID_WORD_BITS;
+      store_valid_word(out, w,
+                       bits & load_valid_word(lhs_valid, w, size) & load_valid_word(rhs_valid, w, size),
+                       size);
+    }
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Combines packed masks a word of 32 rows per thread. The bits of
+ * rows past the end are cleared, also by a NOT.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Unused = void>
+__global__
+void mask_kernel(mask_operator          op,
+                 gdf_valid_type const * a,
+                 gdf_valid_type const * b,
+                 gdf_size_type          size,
+                 gdf_valid_type *       out)
+{
+  const gdf_size_type num_words = (size + VALID_WORD_BITS - 1) / VALID_WORD_BITS;
+  for(gdf_size_type w = static_cast<gdf_size_type>(blockIdx.x) * blockDim.x + threadIdx.x;
+      w < num_words;
+      w += static_cast<gdf_size_type>(blockDim.x) * gridDim.x)
+  {
+    const valid_word_t x = load_valid_word(a, w, size);
+    const valid_word_t y = (MASK_NOT == op) ? 0 : load_valid_word(b, w, size);
+    store_valid_word(out, w, mask_apply(op, x, y) & load_valid_word(nullptr, w, size), size);
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Compares two operands row by row into a packed stencil.
+ *
+ * @Param[in] lhs, rhs The operands, see column_operand and scalar_operand
+ * @Param[in] lhs_valid, rhs_valid The validity of the operands, or nullptr
+ * @Param[in] size The number of rows
+ * @Param[out] out The stencil, a validity bitmask of size rows
+ * @Param[in] stream The stream on which to compare
+ *
+ * @Returns GDF_SUCCESS upon successful launch
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Cmp, typename LhsAt, typename RhsAt>
+gdf_error predicate_launch(LhsAt                  lhs,
+                           gdf_valid_type const * lhs_valid,
+                           RhsAt                  rhs,
+                           gdf_valid_type const * rhs_valid,
+                           gdf_size_type          size,
+                           gdf_valid_type *       out,
+                           cudaStream_t           stream = 0)
+{
+  if( size == 0 )
+    return GDF_SUCCESS;
+
+  const int num_blocks = std::min<int>((size + PREDICATE_BLOCK_SIZE - 1) / PREDICATE_BLOCK_SIZE,
+                                       PREDICATE_MAX_BLOCKS);
+  predicate_kernel<Cmp><<<num_blocks, PREDICATE_BLOCK_SIZE, 0, stream>>>(
+    lhs, lhs_valid, rhs, rhs_valid, size, out);
+  CUDA_CHECK_LAST();
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Combines one or two packed masks of size rows into out, which
+ * may be one of them.
+ *
+ * @Returns GDF_SUCCESS upon successful launch
+ */
+/* ----------------------------------------------------------------------------*/
+inline
+gdf_error mask_launch(mask_operator          op,
+                      gdf_valid_type const * a,
+                      gdf_valid_type const * b,
+                      gdf_size_type          size,
+                      gdf_valid_type *       out,
+                      cudaStream_t           stream = 0)
+{
+  if( size == 0 )
+    return GDF_SUCCESS;
+
+  const gdf_size_type num_words = (size + VALID_WORD_BITS - 1) / VALID_WORD_BITS;
+  const int num_blocks = std::min<int>((num_words + PREDICATE_BLOCK_SIZE - 1) / PREDICATE_BLOCK_SIZE,
+                                       PREDICATE_MAX_BLOCKS);
+  mask_kernel<<<num_blocks, PREDICATE_BLOCK_SIZE, 0, stream>>>(op, a, b, size, out);
+  CUDA_CHECK_LAST();
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_PREDICATE_PREDICATE_CUH
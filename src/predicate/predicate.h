@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_PREDICATE_PREDICATE_H
+#define GDF_PREDICATE_PREDICATE_H
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#ifdef __CUDACC__
+#define GDF_PREDICATE_FUNC __host__ __device__ __forceinline__
+#else
+#define GDF_PREDICATE_FUNC inline
+#endif
+
+/*
+ * Predicates write one bit per row, in the format of a validity bitmask,
+ * instead of one int8_t: a row's bit is set if both of its operands are
+ * valid and the comparison holds. Such a stencil is an eighth of the size of
+ * an int8_t one, combines with others a word of rows at a time, and can be
+ * used as the validity of a column as is.
+ */
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The comparisons, one type each so that the kernels and host
+ * loops are instantiated per comparison, with no switch in their loops.
+ */
+/* ----------------------------------------------------------------------------*/
+template <gdf_comparison_operator Op>
+struct comparison_op;
+
+template <>
+struct comparison_op<GDF_EQUALS> {
+  template <typename T> GDF_PREDICATE_FUNC bool operator()(T x, T y) const { return x == y; }
+};
+
+template <>
+struct comparison_op<GDF_NOT_EQUALS> {
+  template <typename T> GDF_PREDICATE_FUNC bool operator()(T x, T y) const { return x != y; }
+};
+
+template <>
+struct comparison_op<GDF_LESS_THAN> {
+  template <typename T> GDF_PREDICATE_FUNC bool operator()(T x, T y) const { return x < y; }
+};
+
+template <>
+struct comparison_op<GDF_LESS_THAN_OR_EQUALS> {
+  template <typename T> GDF_PREDICATE_FUNC bool operator()(T x, T y) const { return x <= y; }
+};
+
+template <>
+struct comparison_op<GDF_GREATER_THAN> {
+  template <typename T> GDF_PREDICATE_FUNC bool operator()(T x, T y) const { return x > y; }
+};
+
+template <>
+struct comparison_op<GDF_GREATER_THAN_OR_EQUALS> {
+  template <typename T> GDF_PREDICATE_FUNC bool operator()(T x, T y) const { return x >= y; }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Calls `f.run(comparison_op<op>{})` for the comparison chosen
+ * at runtime.
+ *
+ * @Returns The result of f, GDF_INVALID_API_CALL for an unknown comparison
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename F>
+gdf_error comparison_dispatch(gdf_comparison_operator op, F & f)
+{
+  switch( op )
+  {
+  case GDF_EQUALS:                 return f.run(comparison_op<GDF_EQUALS>{});
+  case GDF_NOT_EQUALS:             return f.run(comparison_op<GDF_NOT_EQUALS>{});
+  case GDF_LESS_THAN:              return f.run(comparison_op<GDF_LESS_THAN>{});
+  case GDF_LESS_THAN_OR_EQUALS:    return f.run(comparison_op<GDF_LESS_THAN_OR_EQUALS>{});
+  case GDF_GREATER_THAN:           return f.run(comparison_op<GDF_GREATER_THAN>{});
+  case GDF_GREATER_THAN_OR_EQUALS: return f.run(comparison_op<GDF_GREATER_THAN_OR_EQUALS>{});
+  default:                         return GDF_INVALID_API_CALL;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Operand accessors: the values of a column, or a single value
+ * for every row, converted to the type C they are compared in.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T, typename C>
+struct column_operand {
+  T const * data;
+  GDF_PREDICATE_FUNC C operator()(gdf_size_type row) const { return static_cast<C>(data[row]); }
+};
+
+template <typename C>
+struct scalar_operand {
+  C value;
+  GDF_PREDICATE_FUNC C operator()(gdf_size_type) const { return value; }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The operations on packed masks
+ */
+/* ----------------------------------------------------------------------------*/
+enum mask_operator {
+  MASK_AND,
+  MASK_OR,
+  MASK_NOT,   // of the first mask only
+};
+
+template <typename W>
+GDF_PREDICATE_FUNC
+W mask_apply(mask_operator op, W a, W b)
+{
+  switch( op )
+  {
+  case MASK_AND: return a & b;
+  case MASK_OR:  return a | b;
+  default:       return ~a;
+  }
+}
+
+#endif // GDF_PREDICATE_PREDICATE_H
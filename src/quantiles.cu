@@ -1,270 +1,458 @@
-/*
- * Copyright (c) 2018, NVIDIA CORPORATION.
- *
- * Licensed under the Apache License, Version 2.0 (the "License");
- * you may not use this file except in compliance with the License.
- * You may obtain a copy of the License at
- *
- *     http://www.apache.org/licenses/LICENSE-2.0
- *
- * Unless required by applicable law or agreed to in writing, software
- * distributed under the License is distributed on an "AS IS" BASIS,
- * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
- * See the License for the specific language governing permissions and
- * limitations under the License.
- */
-
-//Quantile (percentile) functionality
-
-#include <gdf/gdf.h>
-#include <gdf/utils.h>
-#include <gdf/errorutils.h>
-
-#include <thrust/device_vector.h>
-#include <thrust/copy.h>
-
-#include "quantiles.hpp"
-
-
-namespace{ //unknown
-  template<typename VType,
-           typename RetT = double>
-    void f_quantile_tester(thrust::device_vector<VType>& d_in)
-  {
-    using FctrType = std::function<RetT(VType, VType, double)>;
-
-    FctrType lin_interp{[](VType y0, VType y1, double x){
-        return static_cast<RetT>(static_cast<double>(y0) + x*static_cast<double>(y1-y0));//(f(x) - y0) / (x - 0) = m = (y1 - y0)/(1 - 0)
-      }};
-
-    FctrType midpoint{[](VType y0, VType y1, double x){
-        return static_cast<RetT>(static_cast<double>(y0 + y1)/2.0);
-      }};
-
-    FctrType nearest{[](VType y0, VType y1, double x){
-        return static_cast<RetT>(x < 0.5 ? y0 : y1);
-      }};
-
-    FctrType lowest{[](VType y0, VType y1, double x){
-        return static_cast<RetT>(y0);
-      }};
-
-    FctrType highest{[](VType y0, VType y1, double x){
-        return static_cast<RetT>(y1);
-      }};
-  
-  
-    std::vector<std::string> methods{"lin_interp", "midpoint", "nearest", "lowest", "highest"};
-    size_t n_methods = methods.size();
-    std::vector<FctrType> vf{lin_interp, midpoint, nearest, lowest, highest};
-  
-    std::vector<double> qvals{0.0, 0.25, 0.33, 0.5, 1.0};
-
-  
-    assert( n_methods == methods.size() );
-  
-    for(auto q: qvals)
-      {
-        VType res = quantile_approx(d_in.data().get(), d_in.size(), q);
-        std::cout<<"q: "<<q<<"; exact res: "<<res<<"\n";
-        for(auto i = 0;i<n_methods;++i)
-          {
-            RetT rt = quantile_exact(d_in.data().get(), d_in.size(), q, vf[i]);
-            std::cout<<"q: "<<q<<"; method: "<<methods[i]<<"; rt: "<<rt<<"\n";
-          }
-      }
-  }
-
-  template<typename ColType,
-           typename RetT = double> // just in case double won't be enough to hold result, in the future
-  gdf_error trampoline_exact(gdf_column*  col_in,
-                             gdf_quantile_method prec,
-                             double q,
-                             void* t_erased_res,
-                             gdf_context* ctxt)
-  {
-    RetT* ptr_res = static_cast<RetT*>(t_erased_res);
-    size_t n = col_in->size;
-    ColType* p_dv = static_cast<ColType*>(col_in->data);
-    if( ctxt->flag_sort_inplace || ctxt->flag_sorted)
-      {
-        return select_quantile(p_dv,
-                               n,
-                               q, 
-                               prec,
-                               *ptr_res,
-                               ctxt->flag_sorted);
-      }
-    else
-      {
-        thrust::device_vector<ColType> dv(n);
-        thrust::copy_n(thrust::device, /*TODO: stream*/p_dv, n, dv.begin());
-        cudaDeviceSynchronize();
-        p_dv = dv.data().get();
-
-        return select_quantile(p_dv,
-                               n,
-                               q, 
-                               prec,
-                               *ptr_res,
-                               ctxt->flag_sorted);
-      }
-  }
-
-  template<typename ColType>
-  void trampoline_approx(gdf_column*  col_in,
-                         double q,
-                         void* t_erased_res,
-                         gdf_context* ctxt)
-  {
-    ColType* ptr_res = static_cast<ColType*>(t_erased_res);
-    size_t n = col_in->size;
-    ColType* p_dv = static_cast<ColType*>(col_in->data);
-    if( ctxt->flag_sort_inplace || ctxt->flag_sorted )
-      {
-        *ptr_res = quantile_approx(p_dv, n, q, NULL, ctxt->flag_sorted);
-      }
-    else
-      {
-        thrust::device_vector<ColType> dv(n);
-        thrust::copy_n(thrust::device, /*TODO: stream*/p_dv, n, dv.begin());
-        cudaDeviceSynchronize();
-        p_dv = dv.data().get();
-
-        *ptr_res = quantile_approx(p_dv, n, q, NULL, ctxt->flag_sorted);
-      }
-  }
-    
-}//unknown namespace
-
-gdf_error gdf_quantile_exact(	gdf_column*         col_in,       //input column;
-                                gdf_quantile_method prec,         //precision: type of quantile method calculation
-                                double              q,            //requested quantile in [0,1]
-                                void*               t_erased_res, //result; for <exact> should probably be double*; it's void* because
-                                                                  //(1) for uniformity of interface with <approx>;
-                                                                  //(2) for possible types bigger than double, in the future;
-                                gdf_context*        ctxt)         //context info
-{
-  GDF_REQUIRE(!col_in->valid, GDF_VALIDITY_UNSUPPORTED);
-  gdf_error ret = GDF_SUCCESS;
-  assert( col_in->size > 0 );
-  
-  switch( col_in->dtype )
-    {
-    case GDF_INT8:
-      {
-        using ColType = int8_t;//char;
-        ret = trampoline_exact<ColType>(col_in, prec, q, t_erased_res, ctxt);
-        
-        break;
-      }
-    case GDF_INT16:
-      {
-        using ColType = int16_t;//short;
-        ret = trampoline_exact<ColType>(col_in, prec, q, t_erased_res, ctxt);
-	  
-        break;
-        
-      }
-    case GDF_INT32:
-      {
-        using ColType = int32_t;//int;
-        ret = trampoline_exact<ColType>(col_in, prec, q, t_erased_res, ctxt);
-	  
-        break;
-        
-      }
-    case GDF_INT64:
-      {
-        using ColType = int64_t;//long;
-        ret = trampoline_exact<ColType>(col_in, prec, q, t_erased_res, ctxt);
-	  
-        break;
-        
-      }
-    case GDF_FLOAT32:
-      {
-        using ColType = float;
-        ret = trampoline_exact<ColType>(col_in, prec, q, t_erased_res, ctxt);
-	  
-        break;
-      }
-    case GDF_FLOAT64:
-      {
-        using ColType = double;
-        ret = trampoline_exact<ColType>(col_in, prec, q, t_erased_res, ctxt);
-	  
-        break;
-      }
-
-    default:
-      assert( false );//type not handled, yet
-    }
-
-  return ret;
-}
-
-gdf_error gdf_quantile_aprrox(	gdf_column*  col_in,       //input column;
-                                double       q,            //requested quantile in [0,1]
-                                void*        t_erased_res, //type-erased result of same type as column;
-                                gdf_context* ctxt)         //context info
-{
-  GDF_REQUIRE(!col_in->valid, GDF_VALIDITY_UNSUPPORTED);
-  gdf_error ret = GDF_SUCCESS;
-  assert( col_in->size > 0 );
-  
-  switch( col_in->dtype )
-    {
-    case GDF_INT8:
-      {
-        using ColType = int8_t;//char;
-        trampoline_approx<ColType>(col_in, q, t_erased_res, ctxt);
-	  
-        break;
-      }
-    case GDF_INT16:
-      {
-        using ColType = int16_t;//short;
-        trampoline_approx<ColType>(col_in, q, t_erased_res, ctxt);
-	  
-        break;
-        
-      }
-    case GDF_INT32:
-      {
-        using ColType = int32_t;//int;
-        trampoline_approx<ColType>(col_in, q, t_erased_res, ctxt);
-	  
-        break;
-        
-      }
-    case GDF_INT64:
-      {
-        using ColType = int64_t;//long;
-        trampoline_approx<ColType>(col_in, q, t_erased_res, ctxt);
-	  
-        break;
-        
-      }
-    case GDF_FLOAT32:
-      {
-        using ColType = float;
-        trampoline_approx<ColType>(col_in, q, t_erased_res, ctxt);
-	  
-        break;
-      }
-    case GDF_FLOAT64:
-      {
-        using ColType = double;
-        trampoline_approx<ColType>(col_in, q, t_erased_res, ctxt);
-	  
-        break;
-      }
-
-    default:
-      assert( false );//type not handled, yet
-    }
-
-  return ret;
-}
-
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Quantile (percentile) functionality
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <thrust/device_vector.h>
+#include <thrust/copy.h>
+
+#include "quantiles.hpp"
+#include "quantiles/radix_select.cuh"
+#include "quantiles/tdigest.cuh"
+
+
+namespace{ //unknown
+  template<typename VType,
+           typename RetT = double>
+    void f_quantile_tester(thrust::device_vector<VType>& d_in)
+  {
+    using FctrType = std::function<RetT(VType, VType, double)>;
+
+    FctrType lin_interp{[](VType y0, VType y1, double x){
+        return static_cast<RetT>(static_cast<double>(y0) + x*static_cast<double>(y1-y0));//(f(x) - y0) / (x - 0) = m = (y1 - y0)/(1 - 0)
+      }};
+
+    FctrType midpoint{[](VType y0, VType y1, double x){
+        return static_cast<RetT>(static_cast<double>(y0 + y1)/2.0);
+      }};
+
+    FctrType nearest{[](VType y0, VType y1, double x){
+        return static_cast<RetT>(x < 0.5 ? y0 : y1);
+      }};
+
+    FctrType lowest{[](VType y0, VType y1, double x){
+        return static_cast<RetT>(y0);
+      }};
+
+    FctrType highest{[](VType y0, VType y1, double x){
+        return static_cast<RetT>(y1);
+      }};
+  
+  
+    std::vector<std::string> methods{"lin_interp", "midpoint", "nearest", "lowest", "highest"};
+    size_t n_methods = methods.size();
+    std::vector<FctrType> vf{lin_interp, midpoint, nearest, lowest, highest};
+  
+    std::vector<double> qvals{0.0, 0.25, 0.33, 0.5, 1.0};
+
+  
+    assert( n_methods == methods.size() );
+  
+    for(auto q: qvals)
+      {
+        VType res = quantile_approx(d_in.data().get(), d_in.size(), q);
+        std::cout<<"q: "<<q<<"; exact res: "<<res<<"\n";
+        for(auto i = 0;i<n_methods;++i)
+          {
+            RetT rt = quantile_exact(d_in.data().get(), d_in.size(), q, vf[i]);
+            std::cout<<"q: "<<q<<"; method: "<<methods[i]<<"; rt: "<<rt<<"\n";
+          }
+      }
+  }
+
+  //values around quantile q of the valid values, by radix
+  //selection: neither sorts nor copies the column
+  //
+  template<typename ColType>
+  gdf_error radix_select_quantile(gdf_column* col_in,
+                                  double q,
+                                  bool with_next,
+                                  ColType& lower,
+                                  ColType& upper,
+                                  double& fract_pos)
+  {
+    radix_selector<ColType> selector(static_cast<ColType const*>(col_in->data),
+                                     col_in->valid,
+                                     col_in->size);
+    size_t n = 0;
+    gdf_error status = selector.count(n);
+    if( status != GDF_SUCCESS )
+      return status;
+    GDF_REQUIRE(n > 0, GDF_DATASET_EMPTY);
+
+    size_t k = 0;
+    fract_pos = 0;
+    if( q >= 1.0 )
+      k = n-1;//max
+    else if( n >= 2 )
+      k = quantile_position(n, q, fract_pos);
+
+    status = selector.select(k, with_next, lower, upper);
+    if( !with_next )
+      upper = lower;
+    return status;
+  }
+
+  template<typename ColType,
+           typename RetT = double> // just in case double won't be enough to hold result, in the future
+  gdf_error trampoline_exact(gdf_column*  col_in,
+                             gdf_quantile_method prec,
+                             double q,
+                             void* t_erased_res,
+                             gdf_context* ctxt)
+  {
+    RetT* ptr_res = static_cast<RetT*>(t_erased_res);
+    if( ctxt->flag_sorted && !col_in->valid )
+      {
+        return select_quantile(static_cast<ColType*>(col_in->data),
+                               col_in->size,
+                               q, 
+                               prec,
+                               *ptr_res,
+                               true);
+      }
+
+    std::function<RetT(ColType, ColType, double)> fctr;
+    gdf_error status = quantile_interpolator(prec, fctr);
+    if( status != GDF_SUCCESS )
+      return status;
+
+    ColType lower, upper;
+    double fract_pos = 0;
+    status = radix_select_quantile(col_in, q, prec != GDF_QUANT_LOWER, lower, upper, fract_pos);
+    if( status != GDF_SUCCESS )
+      return status;
+    *ptr_res = fctr(lower, upper, fract_pos);
+    return GDF_SUCCESS;
+  }
+
+  template<typename ColType>
+  gdf_error trampoline_approx(gdf_column*  col_in,
+                              double q,
+                              void* t_erased_res,
+                              gdf_context* ctxt)
+  {
+    ColType* ptr_res = static_cast<ColType*>(t_erased_res);
+    if( ctxt->flag_sorted && !col_in->valid )
+      {
+        *ptr_res = quantile_approx(static_cast<ColType*>(col_in->data), col_in->size, q, NULL, true);
+        return GDF_SUCCESS;
+      }
+
+    ColType upper;
+    double fract_pos = 0;
+    return radix_select_quantile(col_in, q, false, *ptr_res, upper, fract_pos);
+  }
+
+  template<typename ColType,
+           typename RetT = double>
+  gdf_error trampoline_quantiles(gdf_column*  col_in,
+                                 gdf_quantile_method prec,
+                                 double const* qs,
+                                 size_t num_qs,
+                                 RetT* results,
+                                 gdf_context* ctxt)
+  {
+    size_t n = col_in->size;
+    ColType* p_dv = static_cast<ColType*>(col_in->data);
+    if( col_in->valid )
+      {
+        //compact the valid values (no digit selected yet: every
+        //valid row is a candidate), keeping their order
+        thrust::device_vector<ColType> dv(n);
+        auto end = thrust::copy_if(thrust::device, p_dv, p_dv + n,
+                                   thrust::make_counting_iterator<size_t>(0),
+                                   dv.begin(),
+                                   radix_select_is_candidate<ColType>{p_dv, col_in->valid, 0, 0});
+        n = end - dv.begin();
+        GDF_REQUIRE(n > 0, GDF_DATASET_EMPTY);
+        return select_quantiles(dv.data().get(), n, qs, num_qs, prec, results, ctxt->flag_sorted);
+      }
+    if( ctxt->flag_sort_inplace || ctxt->flag_sorted)
+      {
+        return select_quantiles(p_dv, n, qs, num_qs, prec, results, ctxt->flag_sorted);
+      }
+    else
+      {
+        thrust::device_vector<ColType> dv(n);
+        thrust::copy_n(thrust::device, p_dv, n, dv.begin());
+
+        return select_quantiles(dv.data().get(), n, qs, num_qs, prec, results, ctxt->flag_sorted);
+      }
+  }
+
+  template<typename ColType>
+  gdf_error trampoline_tdigest(tdigest& digest,
+                               gdf_column* col_in)
+  {
+    return device_tdigest_add(digest,
+                              static_cast<ColType const*>(col_in->data),
+                              col_in->valid,
+                              col_in->size);
+  }
+    
+}//unknown namespace
+
+gdf_error gdf_quantile_exact(	gdf_column*         col_in,       //input column;
+                                gdf_quantile_method prec,         //precision: type of quantile method calculation
+                                double              q,            //requested quantile in [0,1]
+                                void*               t_erased_res, //result; for <exact> should probably be double*; it's void* because
+                                                                  //(1) for uniformity of interface with <approx>;
+                                                                  //(2) for possible types bigger than double, in the future;
+                                gdf_context*        ctxt)         //context info
+{
+  GDF_REQUIRE(col_in->size > 0, GDF_DATASET_EMPTY);
+  gdf_error ret = GDF_SUCCESS;
+  
+  switch( col_in->dtype )
+    {
+    case GDF_INT8:
+      {
+        using ColType = int8_t;//char;
+        ret = trampoline_exact<ColType>(col_in, prec, q, t_erased_res, ctxt);
+        
+        break;
+      }
+    case GDF_INT16:
+      {
+        using ColType = int16_t;//short;
+        ret = trampoline_exact<ColType>(col_in, prec, q, t_erased_res, ctxt);
+	  
+        break;
+        
+      }
+    case GDF_INT32:
+      {
+        using ColType = int32_t;//int;
+        ret = trampoline_exact<ColType>(col_in, prec, q, t_erased_res, ctxt);
+	  
+        break;
+        
+      }
+    case GDF_INT64:
+      {
+        using ColType = int64_t;//long;
+        ret = trampoline_exact<ColType>(col_in, prec, q, t_erased_res, ctxt);
+	  
+        break;
+        
+      }
+    case GDF_FLOAT32:
+      {
+        using ColType = float;
+        ret = trampoline_exact<ColType>(col_in, prec, q, t_erased_res, ctxt);
+	  
+        break;
+      }
+    case GDF_FLOAT64:
+      {
+        using ColType = double;
+        ret = trampoline_exact<ColType>(col_in, prec, q, t_erased_res, ctxt);
+	  
+        break;
+      }
+
+    default:
+      assert( false );//type not handled, yet
+    }
+
+  return ret;
+}
+
+gdf_error gdf_quantile_aprrox(	gdf_column*  col_in,       //input column;
+                                double       q,            //requested quantile in [0,1]
+                                void*        t_erased_res, //type-erased result of same type as column;
+                                gdf_context* ctxt)         //context info
+{
+  GDF_REQUIRE(col_in->size > 0, GDF_DATASET_EMPTY);
+  gdf_error ret = GDF_SUCCESS;
+  
+  switch( col_in->dtype )
+    {
+    case GDF_INT8:
+      {
+        using ColType = int8_t;//char;
+        ret = trampoline_approx<ColType>(col_in, q, t_erased_res, ctxt);
+	  
+        break;
+      }
+    case GDF_INT16:
+      {
+        using ColType = int16_t;//short;
+        ret = trampoline_approx<ColType>(col_in, q, t_erased_res, ctxt);
+	  
+        break;
+        
+      }
+    case GDF_INT32:
+      {
+        using ColType = int32_t;//int;
+        ret = trampoline_approx<ColType>(col_in, q, t_erased_res, ctxt);
+	  
+        break;
+        
+      }
+    case GDF_INT64:
+      {
+        using ColType = int64_t;//long;
+        ret = trampoline_approx<ColType>(col_in, q, t_erased_res, ctxt);
+	  
+        break;
+        
+      }
+    case GDF_FLOAT32:
+      {
+        using ColType = float;
+        ret = trampoline_approx<ColType>(col_in, q, t_erased_res, ctxt);
+	  
+        break;
+      }
+    case GDF_FLOAT64:
+      {
+        using ColType = double;
+        ret = trampoline_approx<ColType>(col_in, q, t_erased_res, ctxt);
+	  
+        break;
+      }
+
+    default:
+      assert( false );//type not handled, yet
+    }
+
+  return ret;
+}
+
+gdf_error gdf_quantiles(gdf_column*         col_in,       //input column;
+                        gdf_quantile_method prec,         //precision: type of quantile method calculation
+                        double const*       qs,           //requested quantiles in [0,1]
+                        size_t              num_qs,       //number of requested quantiles
+                        double*             results,      //one result per requested quantile
+                        gdf_context*        ctxt)         //context info
+{
+  GDF_REQUIRE(col_in->size > 0, GDF_DATASET_EMPTY);
+  if( num_qs == 0 )
+    return GDF_SUCCESS;
+
+  switch( col_in->dtype )
+    {
+    case GDF_INT8:    return trampoline_quantiles<int8_t>(col_in, prec, qs, num_qs, results, ctxt);
+    case GDF_INT16:   return trampoline_quantiles<int16_t>(col_in, prec, qs, num_qs, results, ctxt);
+    case GDF_INT32:   return trampoline_quantiles<int32_t>(col_in, prec, qs, num_qs, results, ctxt);
+    case GDF_INT64:   return trampoline_quantiles<int64_t>(col_in, prec, qs, num_qs, results, ctxt);
+    case GDF_FLOAT32: return trampoline_quantiles<float>(col_in, prec, qs, num_qs, results, ctxt);
+    case GDF_FLOAT64: return trampoline_quantiles<double>(col_in, prec, qs, num_qs, results, ctxt);
+    default:          return GDF_UNSUPPORTED_DTYPE;
+    }
+}
+
+//t-digest quantile sketch
+//
+gdf_tdigest_type* cffi_wrap(tdigest* obj){
+  return reinterpret_cast<gdf_tdigest_type*>(obj);
+}
+
+tdigest* cffi_unwrap(gdf_tdigest_type* hdl){
+  return reinterpret_cast<tdigest*>(hdl);
+}
+
+gdf_tdigest_type* gdf_tdigest_create(double compression)
+{
+  if( !tdigest::valid_compression(compression) )
+    return nullptr;
+  return cffi_wrap(new tdigest(compression));
+}
+
+gdf_error gdf_tdigest_add(gdf_tdigest_type* hdl,
+                          gdf_column*       col_in)
+{
+  GDF_REQUIRE(nullptr != hdl, GDF_INVALID_API_CALL);
+  if( col_in->size == 0 )
+    return GDF_SUCCESS;
+
+  tdigest& digest = *cffi_unwrap(hdl);
+  switch( col_in->dtype )
+    {
+    case GDF_INT8:    return trampoline_tdigest<int8_t>(digest, col_in);
+    case GDF_INT16:   return trampoline_tdigest<int16_t>(digest, col_in);
+    case GDF_INT32:   return trampoline_tdigest<int32_t>(digest, col_in);
+    case GDF_INT64:   return trampoline_tdigest<int64_t>(digest, col_in);
+    case GDF_FLOAT32: return trampoline_tdigest<float>(digest, col_in);
+    case GDF_FLOAT64: return trampoline_tdigest<double>(digest, col_in);
+    default:          return GDF_UNSUPPORTED_DTYPE;
+    }
+}
+
+gdf_error gdf_tdigest_merge(gdf_tdigest_type*       dst,
+                            const gdf_tdigest_type* src)
+{
+  GDF_REQUIRE(nullptr != dst && nullptr != src, GDF_INVALID_API_CALL);
+  cffi_unwrap(dst)->merge(*reinterpret_cast<tdigest const*>(src));
+  return GDF_SUCCESS;
+}
+
+gdf_error gdf_tdigest_quantiles(gdf_tdigest_type* hdl,
+                                double const*     qs,
+                                size_t            num_qs,
+                                double*           results)
+{
+  GDF_REQUIRE(nullptr != hdl, GDF_INVALID_API_CALL);
+  tdigest const& digest = *cffi_unwrap(hdl);
+  GDF_REQUIRE(digest.size() > 0, GDF_DATASET_EMPTY);
+  for(size_t i = 0; i < num_qs; ++i)
+    results[i] = digest.quantile(qs[i]);
+  return GDF_SUCCESS;
+}
+
+gdf_error gdf_tdigest_serialized_size(gdf_tdigest_type* hdl,
+                                      size_t*           bytes)
+{
+  GDF_REQUIRE(nullptr != hdl, GDF_INVALID_API_CALL);
+  *bytes = cffi_unwrap(hdl)->serialized_size();
+  return GDF_SUCCESS;
+}
+
+gdf_error gdf_tdigest_serialize(gdf_tdigest_type* hdl,
+                                void*             buffer)
+{
+  GDF_REQUIRE(nullptr != hdl, GDF_INVALID_API_CALL);
+  cffi_unwrap(hdl)->serialize(buffer);
+  return GDF_SUCCESS;
+}
+
+gdf_error gdf_tdigest_deserialize(const void*        buffer,
+                                  size_t             bytes,
+                                  gdf_tdigest_type** hdl)
+{
+  GDF_REQUIRE(nullptr != buffer && nullptr != hdl, GDF_INVALID_API_CALL);
+  tdigest* digest = new tdigest();
+  if( !digest->deserialize(buffer, bytes) )
+    {
+      delete digest;
+      return GDF_INVALID_API_CALL;
+    }
+  *hdl = cffi_wrap(digest);
+  return GDF_SUCCESS;
+}
+
+gdf_error gdf_tdigest_free(gdf_tdigest_type* hdl)
+{
+  delete cffi_unwrap(hdl);
+  return GDF_SUCCESS;
+}
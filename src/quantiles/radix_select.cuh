@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_QUANTILES_RADIX_SELECT_CUH
+#define GDF_QUANTILES_RADIX_SELECT_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <thrust/copy.h>
+#include <thrust/device_vector.h>
+#include <thrust/functional.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+#include <thrust/transform_reduce.h>
+#include <thrust/system/cuda/execution_policy.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "../orderby/radix_select.cuh"
+
+// The candidates are compacted once they are at most this fraction of the rows
+constexpr size_t RADIX_SELECT_COMPACT_RATIO = 16;
+
+template <typename T>
+struct radix_select_is_candidate
+{
+  using key_type = typename normalized_key<T>::key_type;
+  T const * values;
+  gdf_valid_type const * valid;
+  key_type prefix;
+  key_type mask;
+
+  __device__
+  bool operator()(size_t i) const
+  {
+    return gdf_is_valid(valid, i) && (normalized_key<T>::encode(values[i]) & mask) == prefix;
+  }
+};
+
+// Key of a valid row above `bound`, or the largest key otherwise
+template <typename T>
+struct radix_select_key_above
+{
+  using key_type = typename normalized_key<T>::key_type;
+  T const * values;
+  gdf_valid_type const * valid;
+  key_type bound;
+
+  __device__
+  key_type operator()(size_t i) const
+  {
+    const key_type key = normalized_key<T>::encode(values[i]);
+    return (gdf_is_valid(valid, i) && key > bound) ? key : static_cast<key_type>(~key_type{0});
+  }
+};
+
+template <typename T>
+struct radix_select_encode_op
+{
+  using key_type = typename normalized_key<T>::key_type;
+
+  __host__ __device__
+  key_type operator()(T v) const
+  {
+    return normalized_key<T>::encode(v);
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Selects order statistics of the valid values of a device column
+ * without sorting or modifying it.
+ *
+ * The rank is resolved with the passes of the MSD radix select of
+ * ../orderby/radix_select.cuh, one RADIX_SELECT_DIGIT_BITS digit of the
+ * normalized key at a time, most significant first: every pass builds the
+ * histogram of the digit over the remaining candidates (the valid rows whose
+ * higher digits match the prefix found so far) and narrows them down to the
+ * bucket holding the rank. Once few candidates remain their keys are
+ * compacted, so the later passes only read those. The first pass counts the
+ * valid rows.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+struct radix_selector
+{
+  using key_type = typename normalized_key<T>::key_type;
+  static constexpr unsigned key_bits = 8 * sizeof(key_type);
+
+  T const * values;
+  gdf_valid_type const * valid;
+  size_t n;
+  cudaStream_t stream;
+
+  thrust::device_vector<radix_select_count> d_hist;
+  std::vector<radix_select_count> top_hist;   // histogram of the first pass
+  size_t num_valid;
+
+  radix_selector(T const * values, gdf_valid_type const * valid, size_t n,
+                 cudaStream_t stream = 0)
+    : values(values), valid(valid), n(n), stream(stream),
+      d_hist(RADIX_SELECT_BUCKETS), top_hist(RADIX_SELECT_BUCKETS, 0), num_valid(0)
+  {}
+
+  // Histogram of the digit at `shift` of the candidates matching `prefix`
+  template <typename Encoder, typename V>
+  gdf_error histogram(V const * keys, gdf_valid_type const * keys_valid, size_t num_keys,
+                      key_type prefix, key_type mask, unsigned shift,
+                      std::vector<radix_select_count> & h_hist)
+  {
+    return radix_select_digit_histogram<Encoder>(keys, keys_valid, num_keys, prefix, mask, shift,
+                                                 d_hist.data().get(), h_hist, stream);
+  }
+
+  // Counts the valid rows, with the first pass of every selection
+  gdf_error count(size_t & count)
+  {
+    gdf_error status = histogram<radix_select_value_key<T>>(values, valid, n, 0, 0,
+                                                            key_bits - RADIX_SELECT_DIGIT_BITS, top_hist);
+    if( GDF_SUCCESS != status )
+      return status;
+    num_valid = 0;
+    for(radix_select_count c : top_hist)
+      num_valid += c;
+    count = num_valid;
+    return GDF_SUCCESS;
+  }
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  Selects the value of rank `rank` (0-based, in ascending order)
+   * among the valid values, and optionally the value of the next rank.
+   *
+   * @Param[in] rank The rank to select, less than the count of valid values
+   * @Param[in] with_next Also select the value of rank `rank + 1`, which is
+   * `value` itself if `rank` is the last one
+   * @Param[out] value The value of rank `rank`
+   * @Param[out] next The value of rank `rank + 1`, if `with_next`
+   *
+   * @Returns GDF_SUCCESS upon successful completion; count() must be called
+   * first
+   */
+  /* ----------------------------------------------------------------------------*/
+  gdf_error select(size_t rank, bool with_next, T & value, T & next)
+  {
+    GDF_REQUIRE(rank < num_valid, GDF_INVALID_API_CALL);
+
+    size_t residual = rank;   // rank among the remaining candidates
+    key_type prefix = 0;
+    key_type mask = 0;
+    size_t candidates = num_valid;
+    std::vector<radix_select_count> h_hist(top_hist);
+    thrust::device_vector<key_type> d_candidates;
+    auto policy = thrust::cuda::par.on(stream);
+
+    for(int shift = key_bits - RADIX_SELECT_DIGIT_BITS; shift >= 0; shift -= RADIX_SELECT_DIGIT_BITS)
+    {
+      if( mask != 0 )
+      {
+        // Compact the candidates once, when few of the rows remain
+        if( d_candidates.empty() && candidates * RADIX_SELECT_COMPACT_RATIO <= n )
+        {
+          d_candidates.resize(candidates);
+          thrust::copy_if(policy,
+                          thrust::make_transform_iterator(values, radix_select_encode_op<T>()),
+                          thrust::make_transform_iterator(values + n, radix_select_encode_op<T>()),
+                          thrust::make_counting_iterator<size_t>(0),
+                          d_candidates.begin(),
+                          radix_select_is_candidate<T>{values, valid, prefix, mask});
+          CUDA_CHECK_LAST();
+        }
+
+        gdf_error status = d_candidates.empty()
+          ? histogram<radix_select_value_key<T>>(values, valid, n, prefix, mask, shift, h_hist)
+          : histogram<radix_select_identity_key<key_type>>(d_candidates.data().get(), nullptr,
+                                                           d_candidates.size(), prefix, mask,
+                                                           shift, h_hist);
+        if( GDF_SUCCESS != status )
+          return status;
+      }
+
+      // Bucket holding the rank among the candidates
+      const unsigned bucket = radix_select_bucket(h_hist, residual);
+      candidates = h_hist[bucket];
+      prefix |= static_cast<key_type>(bucket) << shift;
+      mask |= static_cast<key_type>(RADIX_SELECT_BUCKETS - 1) << shift;
+    }
+    value = normalized_key<T>::decode(prefix);
+
+    if( !with_next )
+      return GDF_SUCCESS;
+    if( residual + 1 < candidates || rank + 1 == num_valid )
+    {
+      // Tied with the next rank, or the last rank
+      next = value;
+      return GDF_SUCCESS;
+    }
+    const key_type next_key =
+      thrust::transform_reduce(policy,
+                               thrust::make_counting_iterator<size_t>(0),
+                               thrust::make_counting_iterator<size_t>(n),
+                               radix_select_key_above<T>{values, valid, prefix},
+                               static_cast<key_type>(~key_type{0}),
+                               thrust::minimum<key_type>());
+    CUDA_CHECK_LAST();
+    next = normalized_key<T>::decode(next_key);
+    return GDF_SUCCESS;
+  }
+};
+
+#endif // GDF_QUANTILES_RADIX_SELECT_CUH
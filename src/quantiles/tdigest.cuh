@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_QUANTILES_TDIGEST_CUH
+#define GDF_QUANTILES_TDIGEST_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <thrust/copy.h>
+#include <thrust/device_vector.h>
+#include <thrust/iterator/constant_iterator.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+#include <thrust/reduce.h>
+#include <thrust/sort.h>
+#include <thrust/system/cuda/execution_policy.h>
+
+#include <vector>
+
+#include "tdigest.h"
+
+struct tdigest_row_is_valid
+{
+  gdf_valid_type const * valid;
+
+  __device__
+  bool operator()(size_t row) const
+  {
+    return gdf_is_valid(valid, row);
+  }
+};
+
+struct tdigest_cluster_op
+{
+  size_t n;
+  double delta;
+
+  __host__ __device__
+  unsigned operator()(size_t i) const
+  {
+    return tdigest_cluster(i, n, delta);
+  }
+};
+
+template <typename T>
+struct tdigest_to_double
+{
+  __host__ __device__
+  double operator()(T v) const
+  {
+    return static_cast<double>(v);
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Adds the valid values of a device-resident column to a t-digest.
+ *
+ * The values are sorted on the device and every sorted value is assigned to
+ * its centroid by the scale function (tdigest_cluster); the centroids are
+ * then summed with a reduce by key, so that only about compression / 2
+ * centroids are copied back and merged into the host-resident digest.
+ *
+ * @Param[in,out] digest The digest to add the values to
+ * @Param[in] d_values The device array of values
+ * @Param[in] d_valid The device validity mask of the values, or nullptr
+ * @Param[in] n The number of values
+ * @Param[in] stream The stream on which to build the batch digest
+ *
+ * @Returns GDF_SUCCESS upon successful completion
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+gdf_error device_tdigest_add(tdigest &              digest,
+                             T const *              d_values,
+                             gdf_valid_type const * d_valid,
+                             size_t                 n,
+                             cudaStream_t           stream = 0)
+{
+  auto policy = thrust::cuda::par.on(stream);
+
+  thrust::device_vector<T> d_sorted(n);
+  if( nullptr != d_valid )
+  {
+    auto end = thrust::copy_if(policy, d_values, d_values + n,
+                               thrust::make_counting_iterator<size_t>(0),
+                               d_sorted.begin(), tdigest_row_is_valid{d_valid});
+    d_sorted.resize(end - d_sorted.begin());
+  }
+  else
+    thrust::copy(policy, d_values, d_values + n, d_sorted.begin());
+
+  const size_t m = d_sorted.size();
+  if( 0 == m )
+    return GDF_SUCCESS;
+  thrust::sort(policy, d_sorted.begin(), d_sorted.end());
+
+  const size_t max_clusters = tdigest_cluster(m - 1, m, digest.compression) + 1;
+  auto clusters = thrust::make_transform_iterator(thrust::make_counting_iterator<size_t>(0),
+                                                  tdigest_cluster_op{m, digest.compression});
+  thrust::device_vector<unsigned> d_keys(max_clusters);
+  thrust::device_vector<double> d_sums(max_clusters);
+  thrust::device_vector<double> d_weights(max_clusters);
+  auto sums_end = thrust::reduce_by_key(policy, clusters, clusters + m,
+                                        thrust::make_transform_iterator(d_sorted.begin(),
+                                                                        tdigest_to_double<T>()),
+                                        d_keys.begin(), d_sums.begin());
+  thrust::reduce_by_key(policy, clusters, clusters + m,
+                        thrust::make_constant_iterator(1.0),
+                        d_keys.begin(), d_weights.begin());
+  CUDA_CHECK_LAST();
+  const size_t num_clusters = sums_end.second - d_sums.begin();
+
+  tdigest batch(digest.compression);
+  batch.means.resize(num_clusters);
+  batch.weights.resize(num_clusters);
+  T extremes[2];
+  CUDA_TRY( cudaMemcpyAsync(batch.means.data(), d_sums.data().get(), num_clusters * sizeof(double),
+                            cudaMemcpyDeviceToHost, stream) );
+  CUDA_TRY( cudaMemcpyAsync(batch.weights.data(), d_weights.data().get(), num_clusters * sizeof(double),
+                            cudaMemcpyDeviceToHost, stream) );
+  CUDA_TRY( cudaMemcpyAsync(&extremes[0], d_sorted.data().get(), sizeof(T),
+                            cudaMemcpyDeviceToHost, stream) );
+  CUDA_TRY( cudaMemcpyAsync(&extremes[1], d_sorted.data().get() + m - 1, sizeof(T),
+                            cudaMemcpyDeviceToHost, stream) );
+  CUDA_TRY( cudaStreamSynchronize(stream) );
+
+  batch.min = static_cast<double>(extremes[0]);
+  batch.max = static_cast<double>(extremes[1]);
+  batch.finish_sums();
+  digest.merge(batch);
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_QUANTILES_TDIGEST_CUH
@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_QUANTILES_TDIGEST_H
+#define GDF_QUANTILES_TDIGEST_H
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+// Version tag of the serialized form of a t-digest
+constexpr double TDIGEST_SERIAL_VERSION = 1.0;
+// Doubles ahead of the centroids in the serialized form: version,
+// compression, min, max, number of centroids
+constexpr size_t TDIGEST_SERIAL_HEADER = 5;
+// A digest holds about compression / 2 centroids
+constexpr double TDIGEST_MAX_COMPRESSION = 1e7;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The k1 scale function of a t-digest of compression `delta`,
+ * which maps a quantile to a centroid index: centroids are small near the
+ * tails and large around the median. A centroid may span at most one unit of
+ * k, so that a digest holds about delta / 2 centroids.
+ */
+/* ----------------------------------------------------------------------------*/
+#ifdef __CUDACC__
+__host__ __device__
+#endif
+inline double tdigest_scale(double q, double delta)
+{
+  const double pi = 3.14159265358979323846;
+  q = (q < 0.0) ? 0.0 : ((q > 1.0) ? 1.0 : q);
+  return delta / (2.0 * pi) * asin(2.0 * q - 1.0);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The centroid of the t-digest of a sorted batch that holds its
+ * `i`th of `n` values, the same on the host and on the device: every
+ * centroid spans one unit of the scale function.
+ */
+/* ----------------------------------------------------------------------------*/
+#ifdef __CUDACC__
+__host__ __device__
+#endif
+inline unsigned tdigest_cluster(size_t i, size_t n, double delta)
+{
+  const double k = tdigest_scale(static_cast<double>(i) / static_cast<double>(n), delta)
+                 - tdigest_scale(0.0, delta);
+  return static_cast<unsigned>(k);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  A t-digest: a bounded-memory, mergeable sketch of a distribution
+ * that answers quantile queries with a small relative error, smallest in
+ * the tails.
+ *
+ * The digest is a list of centroids (mean, weight) sorted by mean. Batches
+ * are summarized with build_sorted (or the device batch builder), digests
+ * are combined with merge, and the result is re-compressed to about
+ * compression / 2 centroids whatever the number of values it summarizes.
+ * The serialized form is a flat array of doubles, so that digests built on
+ * different partitions can be shipped and merged anywhere.
+ */
+/* ----------------------------------------------------------------------------*/
+struct tdigest
+{
+  double compression;
+  double min;
+  double max;
+  std::vector<double> means;
+  std::vector<double> weights;
+
+  explicit tdigest(double compression = 100.0)
+    : compression(compression),
+      min(std::numeric_limits<double>::infinity()),
+      max(-std::numeric_limits<double>::infinity())
+  {}
+
+  // Finite and positive, and small enough for the centroid indices
+  static bool valid_compression(double compression)
+  {
+    return compression > 0.0 && compression <= TDIGEST_MAX_COMPRESSION;
+  }
+
+  size_t size() const { return means.size(); }
+
+  double total_weight() const
+  {
+    return std::accumulate(weights.begin(), weights.end(), 0.0);
+  }
+
+  // Summarizes a sorted batch of values and merges it in
+  template <typename T>
+  void add_sorted(T const * values, size_t n)
+  {
+    if( 0 == n )
+      return;
+    tdigest batch(compression);
+    batch.min = static_cast<double>(values[0]);
+    batch.max = static_cast<double>(values[n - 1]);
+    for(size_t i = 0; i < n; ++i)
+    {
+      const unsigned c = tdigest_cluster(i, n, compression);
+      if( batch.means.size() <= c )
+      {
+        batch.means.resize(c + 1, 0.0);
+        batch.weights.resize(c + 1, 0.0);
+      }
+      batch.means[c] += static_cast<double>(values[i]);
+      batch.weights[c] += 1.0;
+    }
+    batch.finish_sums();
+    merge(batch);
+  }
+
+  // Turns per-cluster sums into means, dropping the empty clusters
+  void finish_sums()
+  {
+    size_t out = 0;
+    for(size_t c = 0; c < means.size(); ++c)
+    {
+      if( weights[c] > 0.0 )
+      {
+        means[out] = means[c] / weights[c];
+        weights[out] = weights[c];
+        ++out;
+      }
+    }
+    means.resize(out);
+    weights.resize(out);
+  }
+
+  // Merges the centroids of another digest, then re-compresses
+  void merge(tdigest const & other)
+  {
+    if( other.means.empty() )
+      return;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+
+    std::vector<size_t> order(means.size() + other.means.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    auto mean_of = [&](size_t i) {
+      return (i < means.size()) ? means[i] : other.means[i - means.size()];
+    };
+    auto weight_of = [&](size_t i) {
+      return (i < weights.size()) ? weights[i] : other.weights[i - weights.size()];
+    };
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return mean_of(a) < mean_of(b); });
+
+    const double total = total_weight() + other.total_weight();
+    std::vector<double> merged_means;
+    std::vector<double> merged_weights;
+    double weight_so_far = 0.0;
+    double limit = 0.0;
+    for(size_t i : order)
+    {
+      const double m = mean_of(i);
+      const double w = weight_of(i);
+      const bool fits = !merged_means.empty() &&
+                        tdigest_scale((weight_so_far + w) / total, compression) <= limit;
+      if( fits )
+      {
+        double & cm = merged_means.back();
+        double & cw = merged_weights.back();
+        cm += (m - cm) * w / (cw + w);
+        cw += w;
+      }
+      else
+      {
+        // A new centroid may grow up to one unit of k past its left edge
+        limit = tdigest_scale(weight_so_far / total, compression) + 1.0;
+        merged_means.push_back(m);
+        merged_weights.push_back(w);
+      }
+      weight_so_far += w;
+    }
+    means.swap(merged_means);
+    weights.swap(merged_weights);
+  }
+
+  /* ------------------------------------------------------------------------*/
+  /**
+   * Estimates the quantile q in [0, 1], interpolating linearly between the
+   * centers of neighboring centroids, and from the extreme centroids to the
+   * min and max. Returns NaN for an empty digest.
+   */
+  /* ------------------------------------------------------------------------*/
+  double quantile(double q) const
+  {
+    if( means.empty() )
+      return std::numeric_limits<double>::quiet_NaN();
+    if( q <= 0.0 )
+      return min;
+    if( q >= 1.0 )
+      return max;
+
+    const double total = total_weight();
+    const double index = q * total;
+    double center = weights[0] / 2.0;
+    if( index < center )
+      return min + (means[0] - min) * (index / center);
+
+    for(size_t c = 0; c + 1 < means.size(); ++c)
+    {
+      const double next_center = center + (weights[c] + weights[c + 1]) / 2.0;
+      if( index < next_center )
+        return means[c] + (means[c + 1] - means[c]) * (index - center) / (next_center - center);
+      center = next_center;
+    }
+
+    const double last = total - weights.back() / 2.0;
+    if( index <= last || total <= last )
+      return means.back();
+    return means.back() + (max - means.back()) * (index - last) / (total - last);
+  }
+
+  size_t serialized_size() const
+  {
+    return (TDIGEST_SERIAL_HEADER + 2 * means.size()) * sizeof(double);
+  }
+
+  void serialize(void * buffer) const
+  {
+    std::vector<double> flat{TDIGEST_SERIAL_VERSION, compression, min, max,
+                             static_cast<double>(means.size())};
+    flat.insert(flat.end(), means.begin(), means.end());
+    flat.insert(flat.end(), weights.begin(), weights.end());
+    std::memcpy(buffer, flat.data(), flat.size() * sizeof(double));
+  }
+
+  // Returns false if the buffer does not hold a serialized digest
+  bool deserialize(void const * buffer, size_t bytes)
+  {
+    if( bytes < TDIGEST_SERIAL_HEADER * sizeof(double) )
+      return false;
+    std::vector<double> flat(bytes / sizeof(double));
+    std::memcpy(flat.data(), buffer, flat.size() * sizeof(double));
+    // The count is checked as a double first: NaN, negative or huge values
+    // cannot be converted to size_t
+    const double max_count = static_cast<double>((flat.size() - TDIGEST_SERIAL_HEADER) / 2);
+    if( flat[0] != TDIGEST_SERIAL_VERSION || !valid_compression(flat[1]) ||
+        !(flat[4] >= 0.0 && flat[4] <= max_count) || flat[4] != std::floor(flat[4]) )
+      return false;
+    const size_t count = static_cast<size_t>(flat[4]);
+    if( flat.size() != TDIGEST_SERIAL_HEADER + 2 * count )
+      return false;
+    compression = flat[1];
+    min = flat[2];
+    max = flat[3];
+    means.assign(flat.begin() + TDIGEST_SERIAL_HEADER,
+                 flat.begin() + TDIGEST_SERIAL_HEADER + count);
+    weights.assign(flat.begin() + TDIGEST_SERIAL_HEADER + count, flat.end());
+    return true;
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of the device batch builder: adds the valid
+ * values of a host-resident column to a t-digest.
+ *
+ * @Param[in,out] digest The digest to add the values to
+ * @Param[in] values The host array of values
+ * @Param[in] valid The host validity mask of the values, or nullptr
+ * @Param[in] n The number of values
+ *
+ * @Returns GDF_SUCCESS upon successful completion
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+gdf_error host_tdigest_add(tdigest &              digest,
+                           T const *              values,
+                           gdf_valid_type const * valid,
+                           size_t                 n)
+{
+  std::vector<T> sorted;
+  sorted.reserve(n);
+  for(size_t i = 0; i < n; ++i)
+    if( gdf_is_valid(valid, i) )
+      sorted.push_back(values[i]);
+  std::sort(sorted.begin(), sorted.end());
+  digest.add_sorted(sorted.data(), sorted.size());
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_QUANTILES_TDIGEST_H
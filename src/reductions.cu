@@ -6,6 +6,11 @@
 
 #include <limits>
 
+#include "reductions/column_stats.cuh"
+#include "reductions/reduce_batch.cuh"
+#include "reductions/reproducible_sum.cuh"
+#include "reductions/valid_words.h"
+
 #define REDUCTION_BLOCK_SIZE 128
 
 
@@ -19,6 +24,10 @@ struct IdentityLoader{
 
 /*
 Generic reduction implementation with support for validity mask
+
+Every warp reduces 32 consecutive rows at a time, reading their validity as
+one mask word: the values of a word of nulls are not read at all, and a word
+of valid rows is reduced without testing its rows one by one.
 */
 
 template<typename T, typename F, typename Ld>
@@ -35,26 +44,18 @@ void gpu_reduction_op(const T *data, const gdf_valid_type *mask,
     int blksz = blockDim.x;
     int gridsz = gridDim.x;
 
-    int step = blksz * gridsz;
+    gdf_size_type step = blksz * gridsz;
 
     T agg = identity;
 
-    for (int base=blkid * blksz; base<size; base+=step) {
-        // Threadblock synchronous loop
-        int i = base + tid;
-        // load
-        T loaded = identity;
-        if (i < size)
-            loaded = loader(data, i);
-        // set invalid location to identity
-        if ( !gdf_is_valid(mask, i) ) {
-             loaded = identity;
-        }
-        // Block reduce
-        T temp = BlockReduce(temp_storage).Reduce(loaded, functor);
-        // Add current block
-        agg = functor(agg, temp);
+    for (gdf_size_type i = blkid * blksz + tid; i < size; i += step) {
+        // The same word for the 32 rows of the warp
+        if ( !row_is_valid_in_word(mask, i, size) )
+            continue;
+        agg = functor(agg, loader(data, i));
     }
+    // Block reduce
+    agg = BlockReduce(temp_storage).Reduce(agg, functor);
     // First thread of each block stores the result.
     if (tid == 0)
         results[blkid] = agg;
@@ -220,6 +221,15 @@ gdf_error F(gdf_column *col, T *dev_result, gdf_size_type dev_result_size) {  \
     return ReduceOp<T, OP>::launch(col, ID, dev_result, dev_result_size);     \
 }
 
+// Floating point sums are compensated and do not depend on dev_result_size:
+// the result is the same from run to run and across launch configurations
+#define DEF_REDUCE_IMPL_REPRODUCIBLE_SUM(F, T)                                \
+gdf_error F(gdf_column *col, T *dev_result, gdf_size_type dev_result_size) {  \
+    GDF_REQUIRE(dev_result_size > 0, GDF_INVALID_API_CALL);                   \
+    return reproducible_sum((const T*)col->data, col->valid, col->size,       \
+                            dev_result);                                      \
+}
+
 
 unsigned int gdf_reduce_optimal_output_size() {
     return REDUCTION_BLOCK_SIZE;
@@ -229,8 +239,8 @@ unsigned int gdf_reduce_optimal_output_size() {
 /* Sum */
 
 DEF_REDUCE_OP_NUM(gdf_sum)
-DEF_REDUCE_IMPL(gdf_sum_f64, DeviceSum, double, 0)
-DEF_REDUCE_IMPL(gdf_sum_f32, DeviceSum, float, 0)
+DEF_REDUCE_IMPL_REPRODUCIBLE_SUM(gdf_sum_f64, double)
+DEF_REDUCE_IMPL_REPRODUCIBLE_SUM(gdf_sum_f32, float)
 DEF_REDUCE_IMPL(gdf_sum_i64, DeviceSum, int64_t, 0)
 DEF_REDUCE_IMPL(gdf_sum_i32, DeviceSum, int32_t, 0)
 DEF_REDUCE_IMPL(gdf_sum_i8,  DeviceSum, int8_t, 0)
@@ -267,3 +277,37 @@ DEF_REDUCE_IMPL(gdf_max_f32, DeviceMax, float, std::numeric_limits<float>::lowes
 DEF_REDUCE_IMPL(gdf_max_i64, DeviceMax, int64_t, std::numeric_limits<int64_t>::lowest())
 DEF_REDUCE_IMPL(gdf_max_i32, DeviceMax, int32_t, std::numeric_limits<int32_t>::lowest())
 DEF_REDUCE_IMPL(gdf_max_i8, DeviceMax, int8_t,  std::numeric_limits<int8_t>::lowest())
+
+/* Batched reductions */
+
+gdf_error gdf_reduce_batch(gdf_column **cols, gdf_reduction_op const *ops,
+                           int num_columns, void **results) {
+    GDF_REQUIRE(num_columns >= 0, GDF_INVALID_API_CALL);
+    return reduce_batch(cols, ops, num_columns, results);
+}
+
+/* Column statistics */
+
+template <typename T>
+gdf_error column_stats_generic(gdf_column *col, gdf_stats *stats) {
+    column_stats_accumulator acc;
+    gdf_error status = column_stats(static_cast<const T*>(col->data), col->valid,
+                                    col->size, acc);
+    if (status != GDF_SUCCESS)
+        return status;
+    finish_column_stats(acc, col->size, stats);
+    return GDF_SUCCESS;
+}
+
+gdf_error gdf_column_stats(gdf_column *col, gdf_stats *stats) {
+    GDF_REQUIRE(nullptr != col && nullptr != stats, GDF_INVALID_API_CALL);
+    switch ( col->dtype ) {
+    case GDF_FLOAT64: return column_stats_generic<double>(col, stats);
+    case GDF_FLOAT32: return column_stats_generic<float>(col, stats);
+    case GDF_INT64:   return column_stats_generic<int64_t>(col, stats);
+    case GDF_INT32:   return column_stats_generic<int32_t>(col, stats);
+    case GDF_INT16:   return column_stats_generic<int16_t>(col, stats);
+    case GDF_INT8:    return column_stats_generic<int8_t>(col, stats);
+    default:          return GDF_UNSUPPORTED_DTYPE;
+    }
+}
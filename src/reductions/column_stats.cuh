@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_REDUCTIONS_COLUMN_STATS_CUH
+#define GDF_REDUCTIONS_COLUMN_STATS_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <cub/block/block_reduce.cuh>
+
+#include <thrust/device_vector.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "column_stats.h"
+#include "valid_words.h"
+
+constexpr int COLUMN_STATS_BLOCK_SIZE = 256;
+constexpr int COLUMN_STATS_MAX_BLOCKS = 1024;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Every thread accumulates the statistics of its grid-stride rows
+ * with Welford's update, and every block merges those of its threads into
+ * one partial result.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+__global__
+void column_stats_kernel(T const *                  data,
+                         gdf_valid_type const *     valid,
+                         gdf_size_type              size,
+                         column_stats_accumulator * partial)
+{
+  typedef cub::BlockReduce<column_stats_accumulator, COLUMN_STATS_BLOCK_SIZE> BlockReduce;
+  __shared__ typename BlockReduce::TempStorage temp_storage;
+
+  // Every warp covers 32 consecutive rows, one word of the mask
+  column_stats_accumulator acc = column_stats_accumulator::identity();
+  for(gdf_size_type i = blockIdx.x * blockDim.x + threadIdx.x; i < size; i += blockDim.x * gridDim.x)
+  {
+    if( !row_is_valid_in_word(valid, i, size) )
+      continue;
+    acc.add(static_cast<double>(data[i]));
+  }
+
+  acc = BlockReduce(temp_storage).Reduce(acc, column_stats_merge());
+  if( threadIdx.x == 0 )
+    partial[blockIdx.x] = acc;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Statistics of the valid values of a device column in a single
+ * read of its data and validity: the per-block partial results, at most
+ * COLUMN_STATS_MAX_BLOCKS of them, are merged on the host.
+ *
+ * @Param[in] data The values
+ * @Param[in] valid The validity bitmask of the values, or nullptr
+ * @Param[in] size The number of rows
+ * @Param[out] acc The accumulated statistics
+ * @Param[in] stream The stream on which to reduce
+ *
+ * @Returns GDF_SUCCESS upon successful completion
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+gdf_error column_stats(T const *                  data,
+                       gdf_valid_type const *     valid,
+                       gdf_size_type              size,
+                       column_stats_accumulator & acc,
+                       cudaStream_t               stream = 0)
+{
+  acc = column_stats_accumulator::identity();
+  if( size == 0 )
+    return GDF_SUCCESS;
+
+  const int num_blocks = std::min<int>((size + COLUMN_STATS_BLOCK_SIZE - 1) / COLUMN_STATS_BLOCK_SIZE,
+                                       COLUMN_STATS_MAX_BLOCKS);
+  thrust::device_vector<column_stats_accumulator> d_partial(num_blocks);
+  column_stats_kernel<<<num_blocks, COLUMN_STATS_BLOCK_SIZE, 0, stream>>>(
+    data, valid, size, d_partial.data().get());
+  CUDA_CHECK_LAST();
+
+  std::vector<column_stats_accumulator> partial(num_blocks);
+  CUDA_TRY( cudaMemcpyAsync(partial.data(), d_partial.data().get(),
+                            num_blocks * sizeof(column_stats_accumulator),
+                            cudaMemcpyDeviceToHost, stream) );
+  CUDA_TRY( cudaStreamSynchronize(stream) );
+  for(auto const & p : partial)
+    acc = column_stats_accumulator::merge(acc, p);
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_REDUCTIONS_COLUMN_STATS_CUH
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_REDUCTIONS_COLUMN_STATS_H
+#define GDF_REDUCTIONS_COLUMN_STATS_H
+
+#include <gdf/gdf.h>
+
+#include <limits>
+
+#include "reduction_ops.h"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Running statistics of a set of values: count, sum, sum of
+ * squares, min, max, and the mean and sum of squared deviations from it
+ * maintained with Welford's update. Partial statistics of disjoint sets are
+ * merged with Chan's formula, so they can be reduced in any order.
+ */
+/* ----------------------------------------------------------------------------*/
+struct column_stats_accumulator
+{
+  double count;
+  double sum;
+  double sum_squares;
+  double min;
+  double max;
+  double mean;
+  double m2;    /**< Sum of the squared deviations from the mean */
+
+  GDF_REDUCE_FUNC
+  static column_stats_accumulator identity()
+  {
+    return column_stats_accumulator{0, 0, 0,
+                                    std::numeric_limits<double>::infinity(),
+                                    -std::numeric_limits<double>::infinity(),
+                                    0, 0};
+  }
+
+  GDF_REDUCE_FUNC
+  void add(double v)
+  {
+    count += 1;
+    sum += v;
+    sum_squares += v * v;
+    min = v < min ? v : min;
+    max = v > max ? v : max;
+    const double delta = v - mean;
+    mean += delta / count;
+    m2 += delta * (v - mean);
+  }
+
+  GDF_REDUCE_FUNC
+  static column_stats_accumulator merge(column_stats_accumulator const & a,
+                                        column_stats_accumulator const & b)
+  {
+    if( a.count == 0 )
+      return b;
+    if( b.count == 0 )
+      return a;
+    column_stats_accumulator r;
+    r.count = a.count + b.count;
+    r.sum = a.sum + b.sum;
+    r.sum_squares = a.sum_squares + b.sum_squares;
+    r.min = a.min < b.min ? a.min : b.min;
+    r.max = a.max > b.max ? a.max : b.max;
+    const double delta = b.mean - a.mean;
+    r.mean = a.mean + delta * (b.count / r.count);
+    r.m2 = a.m2 + b.m2 + delta * delta * (a.count * b.count / r.count);
+    return r;
+  }
+};
+
+struct column_stats_merge
+{
+  GDF_REDUCE_FUNC
+  column_stats_accumulator operator()(column_stats_accumulator const & a,
+                                      column_stats_accumulator const & b) const
+  {
+    return column_stats_accumulator::merge(a, b);
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Fills the public statistics of a column of `size` rows from the
+ * accumulated statistics of its valid rows.
+ */
+/* ----------------------------------------------------------------------------*/
+inline void finish_column_stats(column_stats_accumulator const & acc,
+                                gdf_size_type                    size,
+                                gdf_stats *                      stats)
+{
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  stats->count = static_cast<gdf_size_type>(acc.count);
+  stats->null_count = size - stats->count;
+  stats->sum = acc.sum;
+  stats->sum_squares = acc.sum_squares;
+  stats->min = acc.count > 0 ? acc.min : nan;
+  stats->max = acc.count > 0 ? acc.max : nan;
+  stats->mean = acc.count > 0 ? acc.mean : nan;
+  stats->variance = acc.count > 1 ? acc.m2 / (acc.count - 1) : nan;
+}
+
+#endif // GDF_REDUCTIONS_COLUMN_STATS_H
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_REDUCTIONS_COMPENSATED_SUM_H
+#define GDF_REDUCTIONS_COMPENSATED_SUM_H
+
+#include "reduction_ops.h"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  A floating point sum that carries the rounding error of its
+ * additions along (Neumaier's variant of Kahan summation), so that the
+ * result is accurate to about one rounding whatever the number of values.
+ * Partial sums are merged the same way, so they can be reduced as a tree.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+struct compensated_sum
+{
+  T sum;
+  T compensation;   /**< Accumulated rounding error of `sum` */
+
+  GDF_REDUCE_FUNC
+  static compensated_sum identity()
+  {
+    return compensated_sum{T{0}, T{0}};
+  }
+
+  GDF_REDUCE_FUNC
+  void add(T v)
+  {
+    const T t = sum + v;
+    const T abs_sum = sum < T{0} ? -sum : sum;
+    const T abs_v = v < T{0} ? -v : v;
+    compensation += (abs_sum >= abs_v) ? (sum - t) + v : (v - t) + sum;
+    sum = t;
+  }
+
+  GDF_REDUCE_FUNC
+  static compensated_sum merge(compensated_sum const & a, compensated_sum const & b)
+  {
+    compensated_sum r = a;
+    r.add(b.sum);
+    r.compensation += b.compensation;
+    return r;
+  }
+
+  // An infinite or NaN sum has no meaningful rounding error
+  GDF_REDUCE_FUNC
+  T value() const
+  {
+    return (sum - sum == T{0}) ? sum + compensation : sum;
+  }
+};
+
+template <typename T>
+struct compensated_sum_merge
+{
+  GDF_REDUCE_FUNC
+  compensated_sum<T> operator()(compensated_sum<T> const & a, compensated_sum<T> const & b) const
+  {
+    return compensated_sum<T>::merge(a, b);
+  }
+};
+
+template <typename T>
+struct compensated_sum_of
+{
+  GDF_REDUCE_FUNC
+  compensated_sum<T> operator()(T v) const
+  {
+    return compensated_sum<T>{v, T{0}};
+  }
+};
+
+template <typename T>
+struct compensated_sum_value
+{
+  GDF_REDUCE_FUNC
+  T operator()(compensated_sum<T> const & s) const
+  {
+    return s.value();
+  }
+};
+
+#endif // GDF_REDUCTIONS_COMPENSATED_SUM_H
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_REDUCTIONS_HOST_COLUMN_STATS_H
+#define GDF_REDUCTIONS_HOST_COLUMN_STATS_H
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "column_stats.h"
+#include "valid_words.h"
+#include "../util/host_parallel.h"
+
+// Values reduced at once: a block stays in L1 between its two passes
+constexpr size_t HOST_STATS_BLOCK = 1024;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Statistics of the valid values of rows [begin, end), in a
+ * single read of the column.
+ *
+ * Rather than a Welford update per value, which serializes on a division,
+ * every block of HOST_STATS_BLOCK valid values is gathered into a small
+ * buffer, reduced with branch-free loops the compiler vectorizes (count, sums
+ * and extremes first, then the squared deviations from the block mean while
+ * the block is still in cache), and merged into the running statistics with
+ * Chan's formula.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+column_stats_accumulator host_column_stats_range(T const *              data,
+                                                 gdf_valid_type const * valid,
+                                                 size_t                 begin,
+                                                 size_t                 end)
+{
+  column_stats_accumulator acc = column_stats_accumulator::identity();
+  double block[HOST_STATS_BLOCK];
+  size_t fill = 0;
+
+  auto flush = [&]() {
+    if( fill == 0 )
+      return;
+    double sum = 0, sum_squares = 0;
+    double lo = block[0], hi = block[0];
+    for(size_t j = 0; j < fill; ++j)
+    {
+      sum += block[j];
+      sum_squares += block[j] * block[j];
+      lo = std::min(lo, block[j]);
+      hi = std::max(hi, block[j]);
+    }
+    const double mean = sum / fill;
+    double m2 = 0;
+    for(size_t j = 0; j < fill; ++j)
+      m2 += (block[j] - mean) * (block[j] - mean);
+    acc = column_stats_accumulator::merge(acc,
+            column_stats_accumulator{static_cast<double>(fill), sum, sum_squares, lo, hi, mean, m2});
+    fill = 0;
+  };
+
+  host_for_each_valid_run(valid, begin, end, [&](size_t first, size_t last) {
+    while( first < last )
+    {
+      const size_t n = std::min(last - first, HOST_STATS_BLOCK - fill);
+      for(size_t j = 0; j < n; ++j)
+        block[fill + j] = static_cast<double>(data[first + j]);
+      fill += n;
+      first += n;
+      if( fill == HOST_STATS_BLOCK )
+        flush();
+    }
+  });
+  flush();
+  return acc;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of gdf_column_stats: count, null count, sum,
+ * sum of squares, min, max, mean and sample variance of the valid values of a
+ * host resident column, in one pass split between host threads.
+ *
+ * @Param[in] data The values
+ * @Param[in] valid The validity bitmask of the values, or nullptr
+ * @Param[in] size The number of rows
+ * @Param[out] stats The statistics
+ *
+ * @Returns GDF_SUCCESS upon successful completion
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+gdf_error host_column_stats(T const *              data,
+                            gdf_valid_type const * valid,
+                            gdf_size_type          size,
+                            gdf_stats *            stats)
+{
+  const size_t n = static_cast<size_t>(size);
+  const unsigned num_threads = gdf::util::host_num_threads(n);
+  std::vector<column_stats_accumulator> partial(num_threads, column_stats_accumulator::identity());
+  gdf::util::host_parallel_for(n, num_threads,
+    [&](unsigned t, size_t first, size_t last) {
+      partial[t] = host_column_stats_range(data, valid, first, last);
+    });
+
+  column_stats_accumulator acc = column_stats_accumulator::identity();
+  for(auto const & p : partial)
+    acc = column_stats_accumulator::merge(acc, p);
+  finish_column_stats(acc, size, stats);
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_REDUCTIONS_HOST_COLUMN_STATS_H
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_REDUCTIONS_HOST_REDUCE_BATCH_H
+#define GDF_REDUCTIONS_HOST_REDUCE_BATCH_H
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+
+#include <vector>
+
+#include "reduction_ops.h"
+#include "valid_words.h"
+#include "../util/host_parallel.h"
+
+// Rows per tile: many tiles per thread even for a few columns
+constexpr gdf_size_type HOST_REDUCE_BATCH_TILE_ROWS = 1 << 14;
+
+template <typename T, typename Op>
+void host_reduce_tile(reduction_column const & col, reduction_tile const & tile)
+{
+  const Op op;
+  T const * data = static_cast<T const *>(col.data);
+  T acc = Op::template identity<T>();
+  host_for_each_valid_run(col.valid, tile.begin, tile.end, [&](size_t first, size_t last) {
+    for(size_t i = first; i < last; ++i)
+      acc = op(acc, Op::load(data[i]));
+  });
+  *static_cast<T *>(tile.out) = acc;
+}
+
+template <typename T>
+void host_reduce_tile_op(reduction_column const & col, reduction_tile const & tile)
+{
+  switch(col.op) {
+    case GDF_REDUCE_SUM:         host_reduce_tile<T, reduce_sum>(col, tile); break;
+    case GDF_REDUCE_PRODUCT:     host_reduce_tile<T, reduce_product>(col, tile); break;
+    case GDF_REDUCE_SUM_SQUARED: host_reduce_tile<T, reduce_sum_squared>(col, tile); break;
+    case GDF_REDUCE_MIN:         host_reduce_tile<T, reduce_min>(col, tile); break;
+    case GDF_REDUCE_MAX:         host_reduce_tile<T, reduce_max>(col, tile); break;
+    default:                     break;
+  }
+}
+
+inline void host_reduce_tiles(std::vector<reduction_column> const & cols,
+                              std::vector<reduction_tile> const & tiles)
+{
+  const unsigned num_threads = gdf::util::host_num_threads(tiles.size(), 4);
+  gdf::util::host_parallel_for(tiles.size(), num_threads,
+    [&](unsigned, size_t first, size_t last) {
+      for(size_t t = first; t < last; ++t)
+      {
+        reduction_column const & col = cols[tiles[t].column];
+        switch(col.dtype) {
+          case GDF_INT8:    host_reduce_tile_op<int8_t>(col, tiles[t]); break;
+          case GDF_INT16:   host_reduce_tile_op<int16_t>(col, tiles[t]); break;
+          case GDF_INT32:   host_reduce_tile_op<int32_t>(col, tiles[t]); break;
+          case GDF_INT64:   host_reduce_tile_op<int64_t>(col, tiles[t]); break;
+          case GDF_FLOAT32: host_reduce_tile_op<float>(col, tiles[t]); break;
+          case GDF_FLOAT64: host_reduce_tile_op<double>(col, tiles[t]); break;
+          default:          break;
+        }
+      }
+    });
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of reduce_batch: reduces any number of host
+ * resident columns, each with its own reduction, skipping null rows.
+ *
+ * The columns are split into tiles of HOST_REDUCE_BATCH_TILE_ROWS rows which
+ * are spread over the host threads regardless of the column they belong to,
+ * so that a few long columns keep every thread busy as well as many short
+ * ones; the partial results of every column are then reduced in tile order.
+ *
+ * @Param[in] cols The columns
+ * @Param[in] ops The reduction of every column
+ * @Param[in] num_columns The number of columns
+ * @Param[out] results One pointer per column, to a value of its type
+ *
+ * @Returns GDF_SUCCESS upon successful completion, GDF_UNSUPPORTED_DTYPE if a
+ * reduction does not support the dtype of its column
+ */
+/* ----------------------------------------------------------------------------*/
+inline gdf_error host_reduce_batch(gdf_column const * const * cols,
+                                   gdf_reduction_op const *   ops,
+                                   int                        num_columns,
+                                   void * const *             results)
+{
+  std::vector<reduction_column> columns(num_columns);
+  std::vector<gdf_size_type> sizes(num_columns);
+  std::vector<size_t> value_sizes(num_columns);
+  for(int c = 0; c < num_columns; ++c)
+  {
+    value_sizes[c] = reduction_value_size(cols[c]->dtype, ops[c]);
+    if( value_sizes[c] == 0 )
+      return GDF_UNSUPPORTED_DTYPE;
+    columns[c] = reduction_column{cols[c]->data, cols[c]->valid, cols[c]->dtype, ops[c]};
+    sizes[c] = cols[c]->size;
+  }
+
+  std::vector<reduction_tile> tiles;
+  std::vector<int> first_tile;
+  plan_reduction_tiles(sizes.data(), num_columns, HOST_REDUCE_BATCH_TILE_ROWS, tiles, first_tile);
+  std::vector<char> partial(tiles.size() * 8);
+  place_reduction_partials(tiles, first_tile, value_sizes.data(), partial.data());
+  host_reduce_tiles(columns, tiles);
+
+  std::vector<reduction_tile> partial_tiles(num_columns);
+  for(int c = 0; c < num_columns; ++c)
+  {
+    columns[c].data = partial.data() + first_tile[c] * 8;
+    columns[c].valid = nullptr;
+    if( ops[c] == GDF_REDUCE_SUM_SQUARED )
+      columns[c].op = GDF_REDUCE_SUM;
+    partial_tiles[c] = reduction_tile{c, 0, static_cast<gdf_size_type>(first_tile[c + 1] - first_tile[c]),
+                                      results[c]};
+  }
+  host_reduce_tiles(columns, partial_tiles);
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_REDUCTIONS_HOST_REDUCE_BATCH_H
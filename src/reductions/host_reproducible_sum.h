@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_REDUCTIONS_HOST_REPRODUCIBLE_SUM_H
+#define GDF_REDUCTIONS_HOST_REPRODUCIBLE_SUM_H
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "compensated_sum.h"
+#include "valid_words.h"
+#include "../util/host_parallel.h"
+
+// Values per chunk, the blocking of the sum whatever the number of threads
+constexpr size_t HOST_REPRODUCIBLE_SUM_CHUNK = 4096;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of reproducible_sum: compensated sum of the
+ * valid values of a column, which is the same whatever the number of host
+ * threads.
+ *
+ * Every chunk of HOST_REPRODUCIBLE_SUM_CHUNK values is summed in order to a
+ * compensated partial sum, the chunks being split between host threads; the
+ * partials are then reduced by chunks in the same way until one is left.
+ *
+ * @Param[in] data The values
+ * @Param[in] valid The validity mask of the values, or nullptr
+ * @Param[in] size The number of values
+ *
+ * @Returns The sum, 0 if there is no valid value
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+T host_reproducible_sum(T const * data, gdf_valid_type const * valid, size_t size)
+{
+  if( size == 0 )
+    return T{0};
+
+  auto num_chunks = [](size_t n) {
+    return (n + HOST_REPRODUCIBLE_SUM_CHUNK - 1) / HOST_REPRODUCIBLE_SUM_CHUNK;
+  };
+
+  std::vector<compensated_sum<T>> partial(num_chunks(size));
+  const unsigned num_threads = gdf::util::host_num_threads(size);
+  gdf::util::host_parallel_for(partial.size(), num_threads,
+    [&](unsigned, size_t first, size_t last) {
+      for(size_t c = first; c < last; ++c)
+      {
+        const size_t begin = c * HOST_REPRODUCIBLE_SUM_CHUNK;
+        const size_t end = std::min(begin + HOST_REPRODUCIBLE_SUM_CHUNK, size);
+        compensated_sum<T> acc = compensated_sum<T>::identity();
+        host_for_each_valid_run(valid, begin, end, [&](size_t first, size_t last) {
+          for(size_t i = first; i < last; ++i)
+            acc.add(data[i]);
+        });
+        partial[c] = acc;
+      }
+    });
+
+  // Few partials are left: merge them on one thread
+  while( partial.size() > 1 )
+  {
+    std::vector<compensated_sum<T>> next(num_chunks(partial.size()));
+    for(size_t c = 0; c < next.size(); ++c)
+    {
+      const size_t begin = c * HOST_REPRODUCIBLE_SUM_CHUNK;
+      const size_t end = std::min(begin + HOST_REPRODUCIBLE_SUM_CHUNK, partial.size());
+      compensated_sum<T> acc = compensated_sum<T>::identity();
+      for(size_t i = begin; i < end; ++i)
+        acc = compensated_sum<T>::merge(acc, partial[i]);
+      next[c] = acc;
+    }
+    partial.swap(next);
+  }
+  return partial[0].value();
+}
+
+#endif // GDF_REDUCTIONS_HOST_REPRODUCIBLE_SUM_H
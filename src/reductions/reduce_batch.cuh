@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_REDUCTIONS_REDUCE_BATCH_CUH
+#define GDF_REDUCTIONS_REDUCE_BATCH_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <cub/block/block_reduce.cuh>
+
+#include <thrust/device_vector.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "reduction_ops.h"
+#include "valid_words.h"
+
+constexpr int REDUCE_BATCH_BLOCK_SIZE = 256;
+constexpr int REDUCE_BATCH_MAX_BLOCKS = 1024;
+// Rows per tile: enough work per block to stay bandwidth bound
+constexpr gdf_size_type REDUCE_BATCH_TILE_ROWS = 1 << 16;
+
+template <typename T, typename Op>
+__device__
+void reduce_batch_tile(reduction_column const & col, reduction_tile const & tile)
+{
+  typedef cub::BlockReduce<T, REDUCE_BATCH_BLOCK_SIZE> BlockReduce;
+  __shared__ typename BlockReduce::TempStorage temp_storage;
+
+  const Op op;
+  T const * data = static_cast<T const *>(col.data);
+  T acc = Op::template identity<T>();
+  // Tiles start on a mask word: every warp covers the 32 rows of one word
+  for(gdf_size_type i = tile.begin + threadIdx.x; i < tile.end; i += blockDim.x)
+  {
+    if( !row_is_valid_in_word(col.valid, i, tile.end) )
+      continue;
+    acc = op(acc, Op::load(data[i]));
+  }
+
+  acc = BlockReduce(temp_storage).Reduce(acc, op);
+  if( threadIdx.x == 0 )
+    *static_cast<T *>(tile.out) = acc;
+  // The temporary storage is reused by the next tile of the block
+  __syncthreads();
+}
+
+template <typename T>
+__device__
+void reduce_batch_tile_op(reduction_column const & col, reduction_tile const & tile)
+{
+  switch(col.op) {
+    case GDF_REDUCE_SUM:         reduce_batch_tile<T, reduce_sum>(col, tile); break;
+    case GDF_REDUCE_PRODUCT:     reduce_batch_tile<T, reduce_product>(col, tile); break;
+    case GDF_REDUCE_SUM_SQUARED: reduce_batch_tile<T, reduce_sum_squared>(col, tile); break;
+    case GDF_REDUCE_MIN:         reduce_batch_tile<T, reduce_min>(col, tile); break;
+    case GDF_REDUCE_MAX:         reduce_batch_tile<T, reduce_max>(col, tile); break;
+    default:                     break;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Every block reduces tiles of any of the columns in turn, so
+ * that the whole batch is a single launch whatever the number and sizes of
+ * its columns. The dtype and reduction are uniform across a block.
+ */
+/* ----------------------------------------------------------------------------*/
+__global__
+void reduce_batch_kernel(reduction_column const * cols,
+                         reduction_tile const *   tiles,
+                         int                      num_tiles)
+{
+  for(int t = blockIdx.x; t < num_tiles; t += gridDim.x)
+  {
+    const reduction_tile tile = tiles[t];
+    const reduction_column col = cols[tile.column];
+    switch(col.dtype) {
+      case GDF_INT8:    reduce_batch_tile_op<int8_t>(col, tile); break;
+      case GDF_INT16:   reduce_batch_tile_op<int16_t>(col, tile); break;
+      case GDF_INT32:   reduce_batch_tile_op<int32_t>(col, tile); break;
+      case GDF_INT64:   reduce_batch_tile_op<int64_t>(col, tile); break;
+      case GDF_FLOAT32: reduce_batch_tile_op<float>(col, tile); break;
+      case GDF_FLOAT64: reduce_batch_tile_op<double>(col, tile); break;
+      default:          break;
+    }
+  }
+}
+
+inline gdf_error launch_reduce_batch(std::vector<reduction_column> const & cols,
+                                     std::vector<reduction_tile> const & tiles,
+                                     cudaStream_t stream)
+{
+  thrust::device_vector<reduction_column> d_cols(cols);
+  thrust::device_vector<reduction_tile> d_tiles(tiles);
+  const int num_tiles = static_cast<int>(tiles.size());
+  const int num_blocks = std::min(num_tiles, REDUCE_BATCH_MAX_BLOCKS);
+  reduce_batch_kernel<<<num_blocks, REDUCE_BATCH_BLOCK_SIZE, 0, stream>>>(
+    d_cols.data().get(), d_tiles.data().get(), num_tiles);
+  CUDA_CHECK_LAST();
+  // The device vectors are freed on return
+  CUDA_TRY( cudaStreamSynchronize(stream) );
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Reduces any number of device columns, each with its own
+ * reduction, in two launches.
+ *
+ * The columns are split into tiles of REDUCE_BATCH_TILE_ROWS rows that the
+ * first launch reduces to one partial result each, skipping null rows; the
+ * partial results of every column are then reduced by the second launch,
+ * one tile per column, and copied back at once.
+ *
+ * @Param[in] cols The columns
+ * @Param[in] ops The reduction of every column
+ * @Param[in] num_columns The number of columns
+ * @Param[out] results One host pointer per column, to a value of its type
+ * @Param[in] stream The stream on which to reduce
+ *
+ * @Returns GDF_SUCCESS upon successful completion, GDF_UNSUPPORTED_DTYPE if a
+ * reduction does not support the dtype of its column
+ */
+/* ----------------------------------------------------------------------------*/
+inline gdf_error reduce_batch(gdf_column * const *     cols,
+                              gdf_reduction_op const * ops,
+                              int                      num_columns,
+                              void * const *           results,
+                              cudaStream_t             stream = 0)
+{
+  if( num_columns == 0 )
+    return GDF_SUCCESS;
+
+  std::vector<reduction_column> columns(num_columns);
+  std::vector<gdf_size_type> sizes(num_columns);
+  std::vector<size_t> value_sizes(num_columns);
+  for(int c = 0; c < num_columns; ++c)
+  {
+    value_sizes[c] = reduction_value_size(cols[c]->dtype, ops[c]);
+    GDF_REQUIRE(value_sizes[c] > 0, GDF_UNSUPPORTED_DTYPE);
+    columns[c] = reduction_column{cols[c]->data, cols[c]->valid, cols[c]->dtype, ops[c]};
+    sizes[c] = cols[c]->size;
+  }
+
+  // First pass: the tiles of every column
+  std::vector<reduction_tile> tiles;
+  std::vector<int> first_tile;
+  plan_reduction_tiles(sizes.data(), num_columns, REDUCE_BATCH_TILE_ROWS, tiles, first_tile);
+  thrust::device_vector<char> d_partial(tiles.size() * 8);
+  place_reduction_partials(tiles, first_tile, value_sizes.data(), d_partial.data().get());
+  gdf_error status = launch_reduce_batch(columns, tiles, stream);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  // Second pass: the partial results of every column, as one tile
+  thrust::device_vector<char> d_results(num_columns * 8);
+  std::vector<reduction_column> partial_columns(num_columns);
+  std::vector<reduction_tile> partial_tiles(num_columns);
+  for(int c = 0; c < num_columns; ++c)
+  {
+    const gdf_reduction_op second = (ops[c] == GDF_REDUCE_SUM_SQUARED) ? GDF_REDUCE_SUM : ops[c];
+    partial_columns[c] = reduction_column{d_partial.data().get() + first_tile[c] * 8, nullptr,
+                                          cols[c]->dtype, second};
+    partial_tiles[c] = reduction_tile{c, 0, static_cast<gdf_size_type>(first_tile[c + 1] - first_tile[c]),
+                                      d_results.data().get() + c * 8};
+  }
+  status = launch_reduce_batch(partial_columns, partial_tiles, stream);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  std::vector<char> h_results(num_columns * 8);
+  CUDA_TRY( cudaMemcpyAsync(h_results.data(), d_results.data().get(), h_results.size(),
+                            cudaMemcpyDeviceToHost, stream) );
+  CUDA_TRY( cudaStreamSynchronize(stream) );
+  for(int c = 0; c < num_columns; ++c)
+    std::copy(h_results.data() + c * 8, h_results.data() + c * 8 + value_sizes[c],
+              static_cast<char *>(results[c]));
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_REDUCTIONS_REDUCE_BATCH_CUH
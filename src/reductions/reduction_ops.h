@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_REDUCTIONS_REDUCTION_OPS_H
+#define GDF_REDUCTIONS_REDUCTION_OPS_H
+
+#include <gdf/gdf.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#ifdef __CUDACC__
+#define GDF_REDUCE_FUNC __host__ __device__ __forceinline__
+#else
+#define GDF_REDUCE_FUNC inline
+#endif
+
+/*
+ * The reductions of gdf_reduction_op, shared by the device and host batched
+ * reductions: `load` maps a valid value onto its contribution, `combine`
+ * merges two partial results, and `identity` is the result of no values.
+ * Partial results are combined with the same reduction, except for the sum of
+ * squares whose partial sums are simply added.
+ */
+struct reduce_sum
+{
+  template <typename T> GDF_REDUCE_FUNC static T identity() { return T{0}; }
+  template <typename T> GDF_REDUCE_FUNC static T load(T v) { return v; }
+  template <typename T> GDF_REDUCE_FUNC T operator()(T a, T b) const { return a + b; }
+};
+
+struct reduce_product
+{
+  template <typename T> GDF_REDUCE_FUNC static T identity() { return T{1}; }
+  template <typename T> GDF_REDUCE_FUNC static T load(T v) { return v; }
+  template <typename T> GDF_REDUCE_FUNC T operator()(T a, T b) const { return a * b; }
+};
+
+struct reduce_sum_squared
+{
+  template <typename T> GDF_REDUCE_FUNC static T identity() { return T{0}; }
+  template <typename T> GDF_REDUCE_FUNC static T load(T v) { return v * v; }
+  template <typename T> GDF_REDUCE_FUNC T operator()(T a, T b) const { return a + b; }
+};
+
+struct reduce_min
+{
+  template <typename T> GDF_REDUCE_FUNC static T identity() { return std::numeric_limits<T>::max(); }
+  template <typename T> GDF_REDUCE_FUNC static T load(T v) { return v; }
+  template <typename T> GDF_REDUCE_FUNC T operator()(T a, T b) const { return a <= b ? a : b; }
+};
+
+struct reduce_max
+{
+  template <typename T> GDF_REDUCE_FUNC static T identity() { return std::numeric_limits<T>::lowest(); }
+  template <typename T> GDF_REDUCE_FUNC static T load(T v) { return v; }
+  template <typename T> GDF_REDUCE_FUNC T operator()(T a, T b) const { return a >= b ? a : b; }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Returns the width in bytes of the values of a column that can be
+ * reduced with `op`, or 0 if the reduction does not support its dtype.
+ */
+/* ----------------------------------------------------------------------------*/
+inline size_t reduction_value_size(gdf_dtype dtype, gdf_reduction_op op)
+{
+  const bool real = (dtype == GDF_FLOAT32 || dtype == GDF_FLOAT64);
+  if( op < GDF_REDUCE_SUM || op >= N_GDF_REDUCTION_OPS || (op == GDF_REDUCE_SUM_SQUARED && !real) )
+    return 0;
+  switch(dtype) {
+    case GDF_INT8:    return 1;
+    case GDF_INT16:   return 2;
+    case GDF_INT32:
+    case GDF_FLOAT32: return 4;
+    case GDF_INT64:
+    case GDF_FLOAT64: return 8;
+    default:          return 0;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  A column of a batched reduction, and a range of rows of one of
+ * them: the unit of work the columns are split into.
+ */
+/* ----------------------------------------------------------------------------*/
+struct reduction_column
+{
+  void const * data;
+  gdf_valid_type const * valid;
+  gdf_dtype dtype;
+  gdf_reduction_op op;
+};
+
+struct reduction_tile
+{
+  int column;           /**< Index of the reduction_column */
+  gdf_size_type begin;  /**< First row */
+  gdf_size_type end;    /**< One past the last row */
+  void * out;           /**< Where the partial result of the tile goes */
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Splits the columns of a batched reduction into tiles of at most
+ * `tile_rows` rows, every column into at least one (possibly empty) tile.
+ *
+ * @Param[in] sizes The number of rows of every column
+ * @Param[in] num_columns The number of columns
+ * @Param[in] tile_rows The maximum number of rows per tile
+ * @Param[out] tiles The tiles, column by column
+ * @Param[out] first_tile The first tile of every column, and the number of
+ * tiles last
+ */
+/* ----------------------------------------------------------------------------*/
+inline void plan_reduction_tiles(gdf_size_type const * sizes,
+                                 int                   num_columns,
+                                 gdf_size_type         tile_rows,
+                                 std::vector<reduction_tile> & tiles,
+                                 std::vector<int> & first_tile)
+{
+  tiles.clear();
+  first_tile.assign(1, 0);
+  for(int c = 0; c < num_columns; ++c)
+  {
+    gdf_size_type begin = 0;
+    do
+    {
+      const gdf_size_type end = (sizes[c] - begin > tile_rows) ? begin + tile_rows : sizes[c];
+      tiles.push_back(reduction_tile{c, begin, end, nullptr});
+      begin = end;
+    } while( begin < sizes[c] );
+    first_tile.push_back(static_cast<int>(tiles.size()));
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Points the tiles at their partial results: those of column `c`
+ * are an array of its type at `partial + first_tile[c] * 8`, so that they can
+ * in turn be reduced like a column. `partial` holds 8 bytes per tile.
+ */
+/* ----------------------------------------------------------------------------*/
+inline void place_reduction_partials(std::vector<reduction_tile> & tiles,
+                                     std::vector<int> const &      first_tile,
+                                     size_t const *                value_sizes,
+                                     char *                        partial)
+{
+  for(size_t c = 0; c + 1 < first_tile.size(); ++c)
+    for(int t = first_tile[c]; t < first_tile[c + 1]; ++t)
+      tiles[t].out = partial + first_tile[c] * 8 + (t - first_tile[c]) * value_sizes[c];
+}
+
+#endif // GDF_REDUCTIONS_REDUCTION_OPS_H
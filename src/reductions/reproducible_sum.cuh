@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_REDUCTIONS_REPRODUCIBLE_SUM_CUH
+#define GDF_REDUCTIONS_REPRODUCIBLE_SUM_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <cub/block/block_reduce.cuh>
+
+#include <thrust/device_vector.h>
+#include <thrust/execution_policy.h>
+#include <thrust/transform.h>
+
+#include <algorithm>
+
+#include "compensated_sum.h"
+#include "valid_words.h"
+
+constexpr int REPRODUCIBLE_SUM_BLOCK_SIZE = 256;
+constexpr int REPRODUCIBLE_SUM_MAX_BLOCKS = 1024;
+// Values per chunk: the blocking of the sum, independent of the launch
+constexpr gdf_size_type REPRODUCIBLE_SUM_CHUNK = REPRODUCIBLE_SUM_BLOCK_SIZE * 16;
+
+template <typename T>
+__device__
+compensated_sum<T> reproducible_sum_load(T const * data, gdf_size_type i)
+{
+  return compensated_sum<T>{data[i], T{0}};
+}
+
+template <typename T>
+__device__
+compensated_sum<T> reproducible_sum_load(compensated_sum<T> const * data, gdf_size_type i)
+{
+  return data[i];
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Reduces every chunk of REPRODUCIBLE_SUM_CHUNK values to one
+ * compensated partial sum. Within a chunk, every thread accumulates a fixed
+ * stride of values and the threads are combined by the fixed tree of the
+ * block reduction, so a partial only depends on the values of its chunk and
+ * never on which block, or how many blocks, reduced it.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T, typename InT>
+__global__
+void reproducible_sum_chunks(InT const *             data,
+                             gdf_valid_type const *  valid,
+                             gdf_size_type           size,
+                             compensated_sum<T> *    partial)
+{
+  typedef cub::BlockReduce<compensated_sum<T>, REPRODUCIBLE_SUM_BLOCK_SIZE> BlockReduce;
+  __shared__ typename BlockReduce::TempStorage temp_storage;
+
+  const gdf_size_type num_chunks = (size + REPRODUCIBLE_SUM_CHUNK - 1) / REPRODUCIBLE_SUM_CHUNK;
+  for(gdf_size_type chunk = blockIdx.x; chunk < num_chunks; chunk += gridDim.x)
+  {
+    const gdf_size_type begin = chunk * REPRODUCIBLE_SUM_CHUNK;
+    const gdf_size_type end = (size - begin < REPRODUCIBLE_SUM_CHUNK) ? size : begin + REPRODUCIBLE_SUM_CHUNK;
+
+    // Every warp covers 32 consecutive rows, one word of the mask
+    compensated_sum<T> acc = compensated_sum<T>::identity();
+    for(gdf_size_type i = begin + threadIdx.x; i < end; i += REPRODUCIBLE_SUM_BLOCK_SIZE)
+    {
+      if( !row_is_valid_in_word(valid, i, size) )
+        continue;
+      acc = compensated_sum<T>::merge(acc, reproducible_sum_load(data, i));
+    }
+
+    acc = BlockReduce(temp_storage).Reduce(acc, compensated_sum_merge<T>{});
+    if( threadIdx.x == 0 )
+      partial[chunk] = acc;
+    // The temporary storage is reused by the next chunk of the block
+    __syncthreads();
+  }
+}
+
+template <typename T, typename InT>
+gdf_error launch_reproducible_sum_chunks(InT const * data, gdf_valid_type const * valid,
+                                         gdf_size_type size, compensated_sum<T> * partial,
+                                         cudaStream_t stream)
+{
+  const gdf_size_type num_chunks = (size + REPRODUCIBLE_SUM_CHUNK - 1) / REPRODUCIBLE_SUM_CHUNK;
+  const int num_blocks = static_cast<int>(
+    std::min<gdf_size_type>(num_chunks, REPRODUCIBLE_SUM_MAX_BLOCKS));
+  reproducible_sum_chunks<T><<<num_blocks, REPRODUCIBLE_SUM_BLOCK_SIZE, 0, stream>>>(
+    data, valid, size, partial);
+  CUDA_CHECK_LAST();
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Compensated sum of the valid values of a device column, which is
+ * bitwise reproducible from run to run and whatever the launch configuration.
+ *
+ * The values are reduced by chunks of REPRODUCIBLE_SUM_CHUNK to compensated
+ * partial sums, that are themselves reduced by chunks until a single one is
+ * left. The blocking only depends on the number of values.
+ *
+ * @Param[in] data The values
+ * @Param[in] valid The validity mask of the values, or nullptr
+ * @Param[in] size The number of values
+ * @Param[out] d_result Device pointer to the sum, 0 if there is no valid value
+ * @Param[in] stream The stream on which to reduce
+ *
+ * @Returns GDF_SUCCESS upon successful completion
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+gdf_error reproducible_sum(T const *              data,
+                           gdf_valid_type const * valid,
+                           gdf_size_type          size,
+                           T *                    d_result,
+                           cudaStream_t           stream = 0)
+{
+  if( size == 0 )
+  {
+    CUDA_TRY( cudaMemsetAsync(d_result, 0, sizeof(T), stream) );
+    return GDF_SUCCESS;
+  }
+
+  gdf_size_type num_partials = (size + REPRODUCIBLE_SUM_CHUNK - 1) / REPRODUCIBLE_SUM_CHUNK;
+  thrust::device_vector<compensated_sum<T>> d_partial(num_partials);
+  thrust::device_vector<compensated_sum<T>> d_next((num_partials + REPRODUCIBLE_SUM_CHUNK - 1)
+                                                   / REPRODUCIBLE_SUM_CHUNK);
+  gdf_error status = launch_reproducible_sum_chunks(data, valid, size,
+                                                    d_partial.data().get(), stream);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  while( num_partials > 1 )
+  {
+    status = launch_reproducible_sum_chunks<T>(d_partial.data().get(), nullptr, num_partials,
+                                               d_next.data().get(), stream);
+    if( GDF_SUCCESS != status )
+      return status;
+    num_partials = (num_partials + REPRODUCIBLE_SUM_CHUNK - 1) / REPRODUCIBLE_SUM_CHUNK;
+    d_partial.swap(d_next);
+  }
+
+  thrust::transform(thrust::cuda::par.on(stream), d_partial.begin(), d_partial.begin() + 1,
+                    d_result, compensated_sum_value<T>{});
+  // The partial sums are freed on return
+  CUDA_TRY( cudaStreamSynchronize(stream) );
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_REDUCTIONS_REPRODUCIBLE_SUM_CUH
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_REDUCTIONS_VALID_WORDS_H
+#define GDF_REDUCTIONS_VALID_WORDS_H
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "reduction_ops.h"
+
+/*
+ * Reductions read the validity bitmask a word at a time rather than a bit
+ * at a time: the device kernels one 32-bit word per warp of 32 consecutive
+ * rows, so that a word of nulls skips the loads of its values and a word of
+ * valid rows needs no per-row test, and the host loops one 64-bit word per
+ * 64 rows, classified by its popcount.
+ */
+typedef uint32_t valid_word_t;
+constexpr gdf_size_type VALID_WORD_BITS = 32;
+constexpr valid_word_t VALID_WORD_ALL = ~valid_word_t{0};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The validity of rows [32 w, 32 w + 32) of a column, with the
+ * bits of rows past its end cleared. Without a mask every row is valid.
+ *
+ * Full words are read at once from the mask, which is allocated word aligned
+ * (as for the 32-bit mask reads of validops.cu); the last, partial, word of
+ * the column is read byte by byte so as not to read past the mask.
+ */
+/* ----------------------------------------------------------------------------*/
+GDF_REDUCE_FUNC
+valid_word_t load_valid_word(gdf_valid_type const * valid, gdf_size_type w, gdf_size_type size)
+{
+  const gdf_size_type first = w * VALID_WORD_BITS;
+  if( first >= size )
+    return 0;
+  const gdf_size_type rows = size - first;
+  const valid_word_t in_range = (rows >= VALID_WORD_BITS) ? VALID_WORD_ALL
+                                                          : ((valid_word_t{1} << rows) - 1);
+  if( nullptr == valid )
+    return in_range;
+  if( rows >= VALID_WORD_BITS )
+  {
+#ifdef __CUDA_ARCH__
+    return reinterpret_cast<valid_word_t const *>(valid)[w];
+#else
+    valid_word_t bits;
+    std::memcpy(&bits, valid + first / GDF_VALID_BITSIZE, sizeof(bits));
+    return bits;
+#endif
+  }
+  valid_word_t bits = 0;
+  for(gdf_size_type b = 0; b * GDF_VALID_BITSIZE < rows; ++b)
+    bits |= static_cast<valid_word_t>(valid[first / GDF_VALID_BITSIZE + b]) << (b * GDF_VALID_BITSIZE);
+  return bits & in_range;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Whether row `i` of a column of `size` rows is valid, read from
+ * the word of its 32 rows: the threads of a warp load the same word, and
+ * skip a word of nulls, or take a word of valid rows, without a bit test.
+ */
+/* ----------------------------------------------------------------------------*/
+GDF_REDUCE_FUNC
+bool row_is_valid_in_word(gdf_valid_type const * valid, gdf_size_type i, gdf_size_type size)
+{
+  const valid_word_t bits = load_valid_word(valid, i / VALID_WORD_BITS, size);
+  return (bits == VALID_WORD_ALL) || ((bits != 0) && ((bits >> (i % VALID_WORD_BITS)) & 1));
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Stores the validity of rows [32 w, 32 w + 32) of a column, the
+ * counterpart of load_valid_word: a full word at once, and the last, partial,
+ * word of the column byte by byte so as not to write past the mask.
+ */
+/* ----------------------------------------------------------------------------*/
+GDF_REDUCE_FUNC
+void store_valid_word(gdf_valid_type * valid, gdf_size_type w, valid_word_t bits, gdf_size_type size)
+{
+  const gdf_size_type first = w * VALID_WORD_BITS;
+  if( first >= size )
+    return;
+  const gdf_size_type rows = size - first;
+  if( rows >= VALID_WORD_BITS )
+  {
+#ifdef __CUDA_ARCH__
+    reinterpret_cast<valid_word_t *>(valid)[w] = bits;
+#else
+    std::memcpy(valid + first / GDF_VALID_BITSIZE, &bits, sizeof(bits));
+#endif
+    return;
+  }
+  for(gdf_size_type b = 0; b * GDF_VALID_BITSIZE < rows; ++b)
+    valid[first / GDF_VALID_BITSIZE + b] = static_cast<gdf_valid_type>(bits >> (b * GDF_VALID_BITSIZE));
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Calls `run(first, last)` for every maximal run of valid rows
+ * within [begin, end), in order: a column without nulls is a single run.
+ *
+ * Rows are classified 64 at a time from the popcount of their mask word: a
+ * full word extends the current run, an empty one ends it without looking at
+ * its rows, and a mixed one is split into runs with count-trailing-zeros.
+ * The caller reduces every run with a dense loop the compiler can vectorize.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Run>
+void host_for_each_valid_run(gdf_valid_type const * valid, size_t begin, size_t end, Run run)
+{
+  if( nullptr == valid )
+  {
+    if( begin < end )
+      run(begin, end);
+    return;
+  }
+
+  size_t pending = begin;   // first row of the current run, which ends at `at`
+  auto close = [&](size_t at, size_t next) {
+    if( pending < at )
+      run(pending, at);
+    pending = next;
+  };
+  auto row_by_row = [&](size_t first, size_t last) {
+    for(size_t i = first; i < last; ++i)
+      if( !gdf_is_valid(valid, i) )
+        close(i, i + 1);
+  };
+
+  size_t i = begin;
+  const size_t aligned = std::min(end, (begin + 63) / 64 * 64);
+  row_by_row(i, aligned);
+  for(i = aligned; i + 64 <= end; i += 64)
+  {
+    uint64_t bits;
+    std::memcpy(&bits, valid + i / GDF_VALID_BITSIZE, sizeof(bits));
+    const int count = __builtin_popcountll(bits);
+    if( count == 64 )
+      continue;
+    if( count == 0 )
+    {
+      close(i, i + 64);
+      continue;
+    }
+    for(unsigned k = 0; k < 64; )
+    {
+      const uint64_t rest = bits >> k;
+      if( rest & 1 )
+        k += (~rest == 0) ? 64 - k : __builtin_ctzll(~rest);
+      else
+      {
+        const unsigned nulls = (rest == 0) ? 64 - k : __builtin_ctzll(rest);
+        close(i + k, i + k + nulls);
+        k += nulls;
+      }
+    }
+  }
+  row_by_row(i, end);
+  close(end, end);
+}
+
+#endif // GDF_REDUCTIONS_VALID_WORDS_H
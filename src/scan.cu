@@ -2,74 +2,157 @@
 #include <gdf/utils.h>
 #include <gdf/errorutils.h>
 
+#include "scan/scan.cuh"
+#include "reductions/reduction_ops.h"
 
-#include <cub/device/device_scan.cuh>
 
+gdf_scan_plan_type* cffi_wrap(ScanPlan* obj){
+    return reinterpret_cast<gdf_scan_plan_type*>(obj);
+}
 
+ScanPlan* cffi_unwrap(gdf_scan_plan_type* hdl){
+    return reinterpret_cast<ScanPlan*>(hdl);
+}
 
-template <class T>
-struct Scan {
-    static
-    gdf_error call(const T *inp, T *out, size_t size, bool inclusive) {
-        using cub::DeviceScan;
 
-        auto scan_function = (inclusive? inclusive_sum : exclusive_sum);
+gdf_scan_plan_type* gdf_scan_plan(size_t num_items){
+    return cffi_wrap(new ScanPlan(num_items));
+}
 
-        // Prepare temp storage
-        void *temp_storage = NULL;
-        size_t temp_storage_bytes = 0;
-        scan_function(temp_storage, temp_storage_bytes, inp, out, size);
-        CUDA_TRY( cudaMalloc(&temp_storage, temp_storage_bytes) );
-        // Do scan
-        scan_function(temp_storage, temp_storage_bytes, inp, out, size);
-        // Cleanup
-        CUDA_TRY( cudaFree(temp_storage) );
+gdf_error gdf_scan_plan_setup(gdf_scan_plan_type *hdl)
+{
+    return cffi_unwrap(hdl)->setup();
+}
+
+gdf_error gdf_scan_plan_free(gdf_scan_plan_type *hdl) {
+    auto plan = cffi_unwrap(hdl);
+    gdf_error status = plan->teardown();
+    delete plan;
+    return status;
+}
 
-        return GDF_SUCCESS;
-    }
 
-    static
-    gdf_error exclusive_sum(void *&temp_storage, size_t &temp_storage_bytes,
-                            const T *inp, T *out, size_t size) {
-        cub::DeviceScan::ExclusiveSum(temp_storage, temp_storage_bytes,
-                                      inp, out, size);
-        CUDA_CHECK_LAST();
+namespace {
+
+// The output rows are null where the input rows are
+gdf_error scan_output_valid(ScanPlan *plan, gdf_column *inp, gdf_column *out) {
+    if (!out->valid)
         return GDF_SUCCESS;
+    const gdf_size_type bytes = gdf_get_num_chars_bitmask(inp->size);
+    if (inp->valid) {
+        CUDA_TRY( cudaMemcpyAsync(out->valid, inp->valid, bytes,
+                                  cudaMemcpyDeviceToDevice, plan->stream) );
+    }
+    else {
+        CUDA_TRY( cudaMemsetAsync(out->valid, 0xff, bytes, plan->stream) );
     }
+    out->null_count = inp->valid ? inp->null_count : 0;
+    return GDF_SUCCESS;
+}
 
-    static
-    gdf_error inclusive_sum(void *&temp_storage, size_t &temp_storage_bytes,
-                            const T *inp, T *out, size_t size) {
-        cub::DeviceScan::InclusiveSum(temp_storage, temp_storage_bytes,
-                                      inp, out, size);
-        CUDA_CHECK_LAST();
-        return GDF_SUCCESS;
+gdf_error scan_column(ScanPlan *plan, gdf_column *inp, gdf_column *out,
+                      gdf_reduction_op op, bool inclusive, bool segmented) {
+    GDF_REQUIRE( inp->size == out->size, GDF_COLUMN_SIZE_MISMATCH );
+    GDF_REQUIRE( inp->dtype == out->dtype, GDF_UNSUPPORTED_DTYPE );
+    GDF_REQUIRE( reduction_value_size(inp->dtype, op) > 0, GDF_UNSUPPORTED_DTYPE );
+    GDF_REQUIRE( inp->size <= plan->num_items, GDF_COLUMN_SIZE_TOO_BIG );
+
+    gdf_error status = GDF_SUCCESS;
+    switch (inp->dtype) {
+    case GDF_INT8:    status = device_scan(plan, (const int8_t*)inp->data, inp->valid, inp->size,
+                                           (int8_t*)out->data, op, inclusive, segmented); break;
+    case GDF_INT16:   status = device_scan(plan, (const int16_t*)inp->data, inp->valid, inp->size,
+                                           (int16_t*)out->data, op, inclusive, segmented); break;
+    case GDF_INT32:   status = device_scan(plan, (const int32_t*)inp->data, inp->valid, inp->size,
+                                           (int32_t*)out->data, op, inclusive, segmented); break;
+    case GDF_INT64:   status = device_scan(plan, (const int64_t*)inp->data, inp->valid, inp->size,
+                                           (int64_t*)out->data, op, inclusive, segmented); break;
+    case GDF_FLOAT32: status = device_scan(plan, (const float*)inp->data, inp->valid, inp->size,
+                                           (float*)out->data, op, inclusive, segmented); break;
+    case GDF_FLOAT64: status = device_scan(plan, (const double*)inp->data, inp->valid, inp->size,
+                                           (double*)out->data, op, inclusive, segmented); break;
+    default:          return GDF_UNSUPPORTED_DTYPE;
     }
-};
+    if (status != GDF_SUCCESS)
+        return status;
+    return scan_output_valid(plan, inp, out);
+}
 
-#define SCAN_IMPL(F, T)                                                       \
-gdf_error gdf_prefixsum_##F(gdf_column *inp, gdf_column *out, int inclusive) {\
-    GDF_REQUIRE( inp->size == out->size, GDF_COLUMN_SIZE_MISMATCH );          \
-    GDF_REQUIRE( inp->dtype == out->dtype, GDF_UNSUPPORTED_DTYPE );           \
-    GDF_REQUIRE( !inp->valid , GDF_VALIDITY_UNSUPPORTED );                    \
-    GDF_REQUIRE( !out->valid , GDF_VALIDITY_UNSUPPORTED );                    \
-    return Scan<T>::call((const T*)inp->data, (T*)out->data, inp->size,       \
-                         inclusive);                                          \
+} // namespace
+
+
+gdf_error gdf_scan(gdf_scan_plan_type *hdl, gdf_column *inp, gdf_column *out,
+                   gdf_reduction_op op, int inclusive)
+{
+    return scan_column(cffi_unwrap(hdl), inp, out, op, inclusive, false);
 }
 
+gdf_error gdf_scan_by_key(gdf_scan_plan_type *hdl, gdf_column *keys,
+                          gdf_column *inp, gdf_column *out,
+                          gdf_reduction_op op, int inclusive)
+{
+    ScanPlan *plan = cffi_unwrap(hdl);
+    GDF_REQUIRE( keys->size == inp->size, GDF_COLUMN_SIZE_MISMATCH );
+    GDF_REQUIRE( inp->size <= plan->num_items, GDF_COLUMN_SIZE_TOO_BIG );
+    gdf_error status = plan->reserve_segmented();
+    if (status != GDF_SUCCESS)
+        return status;
 
-SCAN_IMPL(i8,  int8_t)
-SCAN_IMPL(i32, int32_t)
-SCAN_IMPL(i64, int64_t)
+    switch (keys->dtype) {
+    case GDF_INT8:      status = segment_heads_by_key(plan, (const int8_t*)keys->data, keys->valid, keys->size); break;
+    case GDF_INT16:     status = segment_heads_by_key(plan, (const int16_t*)keys->data, keys->valid, keys->size); break;
+    case GDF_INT32:
+    case GDF_DATE32:    status = segment_heads_by_key(plan, (const int32_t*)keys->data, keys->valid, keys->size); break;
+    case GDF_INT64:
+    case GDF_DATE64:
+    case GDF_TIMESTAMP: status = segment_heads_by_key(plan, (const int64_t*)keys->data, keys->valid, keys->size); break;
+    case GDF_FLOAT32:   status = segment_heads_by_key(plan, (const float*)keys->data, keys->valid, keys->size); break;
+    case GDF_FLOAT64:   status = segment_heads_by_key(plan, (const double*)keys->data, keys->valid, keys->size); break;
+    default:            return GDF_UNSUPPORTED_DTYPE;
+    }
+    if (status != GDF_SUCCESS)
+        return status;
+    return scan_column(plan, inp, out, op, inclusive, true);
+}
+
+gdf_error gdf_segmented_scan(gdf_scan_plan_type *hdl,
+                             gdf_column *inp, gdf_column *out,
+                             gdf_reduction_op op, int inclusive,
+                             unsigned num_segments,
+                             unsigned *d_begin_offsets)
+{
+    ScanPlan *plan = cffi_unwrap(hdl);
+    GDF_REQUIRE( inp->size <= plan->num_items, GDF_COLUMN_SIZE_TOO_BIG );
+    gdf_error status = plan->reserve_segmented();
+    if (status != GDF_SUCCESS)
+        return status;
+    status = segment_heads_by_offsets(plan, inp->size, num_segments, d_begin_offsets);
+    if (status != GDF_SUCCESS)
+        return status;
+    return scan_column(plan, inp, out, op, inclusive, true);
+}
 
 
+/* prefixsum: a sum scan in a plan of its own */
+
 gdf_error gdf_prefixsum_generic(gdf_column *inp, gdf_column *out,
                                 int inclusive)
 {
-    switch (inp->dtype) {
-    case GDF_INT8:    return gdf_prefixsum_i8(inp, out, inclusive);
-    case GDF_INT32:   return gdf_prefixsum_i32(inp, out, inclusive);
-    case GDF_INT64:   return gdf_prefixsum_i64(inp, out, inclusive);
-    default: return GDF_SUCCESS;
-    }
+    ScanPlan plan(inp->size);
+    gdf_error status = plan.setup();
+    if (status == GDF_SUCCESS)
+        status = scan_column(&plan, inp, out, GDF_REDUCE_SUM, inclusive, false);
+    gdf_error teardown_status = plan.teardown();
+    return (status != GDF_SUCCESS) ? status : teardown_status;
+}
+
+#define SCAN_IMPL(F, DTYPE)                                                   \
+gdf_error gdf_prefixsum_##F(gdf_column *inp, gdf_column *out, int inclusive) {\
+    GDF_REQUIRE( inp->dtype == DTYPE, GDF_UNSUPPORTED_DTYPE );                \
+    return gdf_prefixsum_generic(inp, out, inclusive);                        \
 }
+
+
+SCAN_IMPL(i8,  GDF_INT8)
+SCAN_IMPL(i32, GDF_INT32)
+SCAN_IMPL(i64, GDF_INT64)
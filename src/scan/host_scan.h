@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_SCAN_HOST_SCAN_H
+#define GDF_SCAN_HOST_SCAN_H
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "scan_ops.h"
+#include "../util/host_parallel.h"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of device_scan, with the same semantics.
+ *
+ * Every host thread reduces its range of rows to a running value, the
+ * ranges are scanned in order on the calling thread, and every thread then
+ * scans its range again from the running value of the ranges before it.
+ *
+ * @Param[in] data The values
+ * @Param[in] valid The validity mask of the values, or nullptr
+ * @Param[in] size The number of values
+ * @Param[out] out The running values
+ * @Param[in] inclusive Whether row i is part of out[i]
+ * @Param[in] head The segment head flags of the rows, or nullptr for a
+ * scan of the whole column
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T, typename Op>
+void host_scan(T const *              data,
+               gdf_valid_type const * valid,
+               size_t                 size,
+               T *                    out,
+               bool                   inclusive,
+               uint8_t const *        head)
+{
+  if( size == 0 )
+    return;
+
+  // Without segments, only the first row is a head
+  std::vector<uint8_t> heads;
+  if( !head )
+  {
+    heads.assign(size, 0);
+    heads[0] = 1;
+    head = heads.data();
+  }
+
+  const segmented_scan_load<T, Op> load{scan_load<T, Op>{data, valid}, head, inclusive};
+  const segmented_scan_op<T, Op> op;
+
+  const unsigned num_threads = gdf::util::host_num_threads(size);
+  std::vector<segmented_value<T>> carry(num_threads);
+  std::vector<bool> has_rows(num_threads, false);
+
+  gdf::util::host_parallel_for(size, num_threads,
+    [&](unsigned t, size_t begin, size_t end) {
+      if( begin == end )
+        return;
+      segmented_value<T> acc = load(begin);
+      for(size_t i = begin + 1; i < end; ++i)
+        acc = op(acc, load(i));
+      carry[t] = acc;
+      has_rows[t] = true;
+    });
+
+  // Running value before every range; row 0 is a head, so the first
+  // range ignores its identity
+  std::vector<segmented_value<T>> before(num_threads);
+  segmented_value<T> running{Op::template identity<T>(), 0};
+  for(unsigned t = 0; t < num_threads; ++t)
+  {
+    before[t] = running;
+    if( has_rows[t] )
+      running = op(running, carry[t]);
+  }
+
+  gdf::util::host_parallel_for(size, num_threads,
+    [&](unsigned t, size_t begin, size_t end) {
+      segmented_value<T> acc = before[t];
+      for(size_t i = begin; i < end; ++i)
+      {
+        acc = op(acc, load(i));
+        out[i] = acc.value;
+      }
+    });
+}
+
+template <typename T>
+gdf_error host_scan(T const * data, gdf_valid_type const * valid, size_t size, T * out,
+                    gdf_reduction_op op, bool inclusive, uint8_t const * head)
+{
+  switch(op) {
+    case GDF_REDUCE_SUM:         host_scan<T, reduce_sum>(data, valid, size, out, inclusive, head); break;
+    case GDF_REDUCE_PRODUCT:     host_scan<T, reduce_product>(data, valid, size, out, inclusive, head); break;
+    case GDF_REDUCE_SUM_SQUARED: host_scan<T, reduce_sum_squared>(data, valid, size, out, inclusive, head); break;
+    case GDF_REDUCE_MIN:         host_scan<T, reduce_min>(data, valid, size, out, inclusive, head); break;
+    case GDF_REDUCE_MAX:         host_scan<T, reduce_max>(data, valid, size, out, inclusive, head); break;
+    default:                     return GDF_INVALID_API_CALL;
+  }
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of the segment head flags of a plan: from a
+ * key column, or from the first row of every segment.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename K>
+void host_segment_heads_by_key(K const * keys, gdf_valid_type const * valid, size_t size,
+                               uint8_t * head)
+{
+  const segment_head_by_key<K> is_head{keys, valid};
+  for(size_t i = 0; i < size; ++i)
+    head[i] = is_head(i);
+}
+
+inline void host_segment_heads_by_offsets(size_t size, unsigned num_segments,
+                                          unsigned const * begin_offsets, uint8_t * head)
+{
+  std::fill(head, head + size, uint8_t{0});
+  for(unsigned s = 0; s < num_segments; ++s)
+    head[begin_offsets[s]] = 1;
+  if( size > 0 )
+    head[0] = 1;
+}
+
+#endif // GDF_SCAN_HOST_SCAN_H
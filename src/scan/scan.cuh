@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_SCAN_SCAN_CUH
+#define GDF_SCAN_SCAN_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <cub/device/device_scan.cuh>
+
+#include <thrust/binary_search.h>
+#include <thrust/execution_policy.h>
+#include <thrust/fill.h>
+#include <thrust/iterator/constant_iterator.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+#include <thrust/scatter.h>
+#include <thrust/sort.h>
+#include <thrust/transform.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#include "scan_ops.h"
+
+/*
+ * Sizes (with a null storage) any cub scan the plans run over values of type
+ * T, plain or segmented, of up to `num_items` items.
+ */
+template <typename T>
+size_t scan_storage_bytes(size_t num_items)
+{
+  size_t plain_bytes = 0, segmented_bytes = 0;
+  cub::DeviceScan::InclusiveScan(nullptr, plain_bytes, (T const *)nullptr, (T *)nullptr,
+                                 reduce_sum{}, num_items);
+  cub::DeviceScan::InclusiveScan(nullptr, segmented_bytes,
+                                 (segmented_value<T> const *)nullptr, (segmented_value<T> *)nullptr,
+                                 segmented_scan_op<T, reduce_sum>{}, num_items);
+  return std::max(plain_bytes, segmented_bytes);
+}
+
+inline size_t scan_storage_bytes(size_t num_items)
+{
+  return std::max({scan_storage_bytes<int8_t>(num_items),
+                   scan_storage_bytes<int16_t>(num_items),
+                   scan_storage_bytes<int32_t>(num_items),
+                   scan_storage_bytes<int64_t>(num_items),
+                   scan_storage_bytes<float>(num_items),
+                   scan_storage_bytes<double>(num_items)});
+}
+
+/*
+ * A plan scans any number of columns of up to its capacity, `num_items`,
+ * rows. The temporary storage of the scans is sized for the capacity and
+ * any dtype in setup(); the segment head flags and the running values of
+ * segmented scans are allocated on the first segmented scan.
+ */
+struct ScanPlan {
+    const size_t num_items;
+    void *storage;
+    size_t storage_bytes;
+    uint8_t *head;
+    void *segmented;
+
+    cudaStream_t stream;
+
+    explicit ScanPlan(size_t num_items)
+        :   num_items(num_items),
+            storage(nullptr), storage_bytes(0),
+            head(nullptr), segmented(nullptr),
+            stream(0)
+    {}
+
+    gdf_error setup() {
+        storage_bytes = scan_storage_bytes(num_items);
+        CUDA_TRY(cudaMalloc(&storage, storage_bytes));
+        return GDF_SUCCESS;
+    }
+
+    gdf_error reserve_segmented() {
+        if (!head) {
+            CUDA_TRY(cudaMalloc(&head, num_items));
+            CUDA_TRY(cudaMalloc(&segmented, num_items * sizeof(segmented_value<double>)));
+        }
+        return GDF_SUCCESS;
+    }
+
+    gdf_error teardown() {
+        CUDA_TRY(cudaFree(storage));
+        CUDA_TRY(cudaFree(head));
+        CUDA_TRY(cudaFree(segmented));
+        return GDF_SUCCESS;
+    }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Flags the rows of the plan that start a segment, from a key
+ * column (a segment is a run of equal keys) or from the first row of every
+ * segment.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename K>
+gdf_error segment_heads_by_key(ScanPlan * plan, K const * keys, gdf_valid_type const * valid,
+                               gdf_size_type size)
+{
+  thrust::transform(thrust::cuda::par.on(plan->stream),
+                    thrust::make_counting_iterator<gdf_size_type>(0),
+                    thrust::make_counting_iterator<gdf_size_type>(size),
+                    plan->head,
+                    segment_head_by_key<K>{keys, valid});
+  CUDA_CHECK_LAST();
+  return GDF_SUCCESS;
+}
+
+// The offsets must be non-decreasing and at most `size`; those equal to
+// `size` begin empty segments and flag no row
+inline gdf_error segment_heads_by_offsets(ScanPlan * plan, gdf_size_type size,
+                                          unsigned num_segments, unsigned const * d_begin_offsets)
+{
+  auto policy = thrust::cuda::par.on(plan->stream);
+  unsigned const * offsets_end = d_begin_offsets;
+  if( num_segments > 0 )
+  {
+    GDF_REQUIRE(nullptr != d_begin_offsets, GDF_DATASET_EMPTY);
+    GDF_REQUIRE(thrust::is_sorted(policy, d_begin_offsets, d_begin_offsets + num_segments),
+                GDF_INVALID_API_CALL);
+    unsigned last;
+    CUDA_TRY( cudaMemcpyAsync(&last, d_begin_offsets + num_segments - 1, sizeof(unsigned),
+                              cudaMemcpyDeviceToHost, plan->stream) );
+    CUDA_TRY( cudaStreamSynchronize(plan->stream) );
+    GDF_REQUIRE(last <= static_cast<unsigned>(size), GDF_INVALID_API_CALL);
+    offsets_end = thrust::lower_bound(policy, d_begin_offsets, d_begin_offsets + num_segments,
+                                      static_cast<unsigned>(size));
+  }
+
+  thrust::fill(policy, plan->head, plan->head + size, uint8_t{0});
+  thrust::scatter(policy,
+                  thrust::make_constant_iterator<uint8_t>(1),
+                  thrust::make_constant_iterator<uint8_t>(1) + (offsets_end - d_begin_offsets),
+                  d_begin_offsets, plan->head);
+  // Rows before the first segment form a segment of their own
+  thrust::fill(policy, plan->head, plan->head + std::min<gdf_size_type>(size, 1), uint8_t{1});
+  CUDA_CHECK_LAST();
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Scans a column with the reduction Op, in the temporary storage
+ * of the plan. Null rows contribute the identity of the reduction.
+ *
+ * @Param[in] plan The plan, of capacity at least `size`; its head flags
+ * delimit the segments of a segmented scan
+ * @Param[in] data The values
+ * @Param[in] valid The validity mask of the values, or nullptr
+ * @Param[in] size The number of values
+ * @Param[out] out The running values: out[i] is the reduction of rows up to
+ * i (inclusive scan) or before i (exclusive scan), of its segment only when
+ * segmented
+ * @Param[in] inclusive Whether row i is part of out[i]
+ * @Param[in] segmented Whether the scan restarts at every head row
+ *
+ * @Returns GDF_SUCCESS upon successful completion, GDF_INVALID_API_CALL if
+ * the plan was not set up
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T, typename Op>
+gdf_error device_scan(ScanPlan *             plan,
+                      T const *              data,
+                      gdf_valid_type const * valid,
+                      gdf_size_type          size,
+                      T *                    out,
+                      bool                   inclusive,
+                      bool                   segmented)
+{
+  GDF_REQUIRE(size <= plan->num_items, GDF_COLUMN_SIZE_TOO_BIG);
+  if( size == 0 )
+    return GDF_SUCCESS;
+  // Without storage cub would only size it, and leave `out` unwritten
+  GDF_REQUIRE(nullptr != plan->storage, GDF_INVALID_API_CALL);
+
+  const scan_load<T, Op> load{data, valid};
+  auto rows = thrust::make_counting_iterator<gdf_size_type>(0);
+  if( !segmented )
+  {
+    auto in = thrust::make_transform_iterator(rows, load);
+    if( inclusive ) {
+      CUDA_TRY( cub::DeviceScan::InclusiveScan(plan->storage, plan->storage_bytes, in, out,
+                                               Op{}, size, plan->stream) );
+    }
+    else {
+      CUDA_TRY( cub::DeviceScan::ExclusiveScan(plan->storage, plan->storage_bytes, in, out,
+                                               Op{}, Op::template identity<T>(), size, plan->stream) );
+    }
+    return GDF_SUCCESS;
+  }
+
+  auto in = thrust::make_transform_iterator(rows, segmented_scan_load<T, Op>{load, plan->head, inclusive});
+  segmented_value<T> * running = static_cast<segmented_value<T> *>(plan->segmented);
+  CUDA_TRY( cub::DeviceScan::InclusiveScan(plan->storage, plan->storage_bytes, in, running,
+                                           segmented_scan_op<T, Op>{}, size, plan->stream) );
+  thrust::transform(thrust::cuda::par.on(plan->stream), running, running + size, out,
+                    segmented_value_of<T>{});
+  CUDA_CHECK_LAST();
+  return GDF_SUCCESS;
+}
+
+template <typename T>
+gdf_error device_scan(ScanPlan * plan, T const * data, gdf_valid_type const * valid,
+                      gdf_size_type size, T * out, gdf_reduction_op op,
+                      bool inclusive, bool segmented)
+{
+  switch(op) {
+    case GDF_REDUCE_SUM:         return device_scan<T, reduce_sum>(plan, data, valid, size, out, inclusive, segmented);
+    case GDF_REDUCE_PRODUCT:     return device_scan<T, reduce_product>(plan, data, valid, size, out, inclusive, segmented);
+    case GDF_REDUCE_SUM_SQUARED: return device_scan<T, reduce_sum_squared>(plan, data, valid, size, out, inclusive, segmented);
+    case GDF_REDUCE_MIN:         return device_scan<T, reduce_min>(plan, data, valid, size, out, inclusive, segmented);
+    case GDF_REDUCE_MAX:         return device_scan<T, reduce_max>(plan, data, valid, size, out, inclusive, segmented);
+    default:                     return GDF_INVALID_API_CALL;
+  }
+}
+
+#endif // GDF_SCAN_SCAN_CUH
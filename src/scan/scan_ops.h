@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_SCAN_SCAN_OPS_H
+#define GDF_SCAN_SCAN_OPS_H
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+
+#include <cstdint>
+
+#include "../reductions/reduction_ops.h"
+
+/*
+ * The scans reuse the reductions of gdf_reduction_op (see reduction_ops.h):
+ * null rows contribute the identity of the reduction, so that a scan skips
+ * them, and a segmented scan restarts at every row flagged as the head of a
+ * segment.
+ */
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  A running value of a segmented scan, and whether a segment
+ * starts within the rows it covers.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+struct segmented_value
+{
+  T value;
+  int head;
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Turns a reduction into the (associative) reduction of a
+ * segmented scan: the right operand is kept as is if a segment starts
+ * within its rows.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T, typename Op>
+struct segmented_scan_op
+{
+  GDF_REDUCE_FUNC
+  segmented_value<T> operator()(segmented_value<T> const & a, segmented_value<T> const & b) const
+  {
+    return b.head ? b : segmented_value<T>{Op{}(a.value, b.value), a.head};
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The contribution of row i to a scan, the identity for a null
+ * row.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T, typename Op>
+struct scan_load
+{
+  T const * data;
+  gdf_valid_type const * valid;
+
+  GDF_REDUCE_FUNC
+  T operator()(gdf_size_type i) const
+  {
+    return gdf_is_valid(valid, i) ? Op::load(data[i]) : Op::template identity<T>();
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The contribution of row i to a segmented scan.
+ *
+ * An exclusive segmented scan is the inclusive scan of the rows shifted by
+ * one within every segment: a head row contributes the identity, and any
+ * other row the value of the row before it.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T, typename Op>
+struct segmented_scan_load
+{
+  scan_load<T, Op> load;
+  uint8_t const * head;
+  bool inclusive;
+
+  GDF_REDUCE_FUNC
+  segmented_value<T> operator()(gdf_size_type i) const
+  {
+    const int h = head[i];
+    if( inclusive )
+      return segmented_value<T>{load(i), h};
+    return segmented_value<T>{h ? Op::template identity<T>() : load(i - 1), h};
+  }
+};
+
+template <typename T>
+struct segmented_value_of
+{
+  GDF_REDUCE_FUNC
+  T operator()(segmented_value<T> const & s) const
+  {
+    return s.value;
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Flags the rows of a key column that start a segment: the first
+ * one, and every one whose key differs from the key of the row before. Null
+ * keys are equal to each other.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename K>
+struct segment_head_by_key
+{
+  K const * keys;
+  gdf_valid_type const * valid;
+
+  GDF_REDUCE_FUNC
+  uint8_t operator()(gdf_size_type i) const
+  {
+    if( i == 0 )
+      return 1;
+    const bool v = gdf_is_valid(valid, i);
+    if( v != gdf_is_valid(valid, i - 1) )
+      return 1;
+    return (v && !(keys[i] == keys[i - 1])) ? 1 : 0;
+  }
+};
+
+#endif // GDF_SCAN_SCAN_OPS_H
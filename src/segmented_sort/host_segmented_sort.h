@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_SEGMENTED_SORT_HOST_SEGMENTED_SORT_H
+#define GDF_SEGMENTED_SORT_HOST_SEGMENTED_SORT_H
+
+#include <gdf/gdf.h>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "../orderby/normalized_key.h"
+#include "../util/host_parallel.h"
+
+// Segments up to this size are insertion sorted in place
+constexpr unsigned HOST_SEGSORT_INSERTION_ITEMS = 32;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Orders keys on their normalized representation, which is the
+ * order of the radix sort (-0.0 before +0.0, NaNs at the ends).
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Tk>
+struct segment_key_less
+{
+  bool descending;
+
+  GDF_KEY_FUNC
+  bool operator()(Tk a, Tk b) const
+  {
+    const auto ka = normalized_key<Tk>::encode(a);
+    const auto kb = normalized_key<Tk>::encode(b);
+    return descending ? (kb < ka) : (ka < kb);
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of segmented_sort: stable sort of the keys, and
+ * optionally the values, of every segment.
+ *
+ * The segments are split between host threads; tiny segments are insertion
+ * sorted in place, larger ones are sorted through a permutation with
+ * std::stable_sort.
+ *
+ * @Param[in,out] keys The keys, sorted within every segment in place
+ * @Param[in,out] vals The values, permuted along with the keys, or nullptr
+ * @Param[in] num_segments The number of segments
+ * @Param[in] begin_offsets The first item of every segment
+ * @Param[in] end_offsets One past the last item of every segment
+ * @Param[in] descending Sort every segment in descending order
+ *
+ * @Returns GDF_SUCCESS upon successful completion
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Tk, typename Tv>
+gdf_error host_segmented_sort(Tk *             keys,
+                              Tv *             vals,
+                              unsigned         num_segments,
+                              unsigned const * begin_offsets,
+                              unsigned const * end_offsets,
+                              bool             descending)
+{
+  const segment_key_less<Tk> less{descending};
+
+  // Segments are not rows: hand out fewer per thread than the row threshold
+  const unsigned num_threads = gdf::util::host_num_threads(num_segments, 1 << 10);
+  gdf::util::host_parallel_for(num_segments, num_threads,
+    [&](unsigned, size_t first, size_t last) {
+      std::vector<unsigned> perm;
+      std::vector<Tk> sorted_keys;
+      std::vector<Tv> sorted_vals;
+
+      for(size_t s = first; s < last; ++s)
+      {
+        const unsigned begin = begin_offsets[s];
+        const unsigned end = end_offsets[s];
+        if( end - begin < 2 )
+          continue;
+
+        if( end - begin <= HOST_SEGSORT_INSERTION_ITEMS )
+        {
+          for(unsigned i = begin + 1; i < end; ++i)
+          {
+            const Tk key = keys[i];
+            const Tv val = vals ? vals[i] : Tv{};
+            unsigned j = i;
+            for(; j > begin && less(key, keys[j - 1]); --j)
+            {
+              keys[j] = keys[j - 1];
+              if( vals )
+                vals[j] = vals[j - 1];
+            }
+            keys[j] = key;
+            if( vals )
+              vals[j] = val;
+          }
+          continue;
+        }
+
+        perm.resize(end - begin);
+        std::iota(perm.begin(), perm.end(), begin);
+        std::stable_sort(perm.begin(), perm.end(),
+                         [&](unsigned a, unsigned b) { return less(keys[a], keys[b]); });
+
+        sorted_keys.resize(perm.size());
+        for(size_t i = 0; i < perm.size(); ++i)
+          sorted_keys[i] = keys[perm[i]];
+        std::copy(sorted_keys.begin(), sorted_keys.end(), keys + begin);
+        if( vals )
+        {
+          sorted_vals.resize(perm.size());
+          for(size_t i = 0; i < perm.size(); ++i)
+            sorted_vals[i] = vals[perm[i]];
+          std::copy(sorted_vals.begin(), sorted_vals.end(), vals + begin);
+        }
+      }
+    });
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_SEGMENTED_SORT_HOST_SEGMENTED_SORT_H
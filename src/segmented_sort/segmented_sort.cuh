@@ -0,0 +1,462 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_SEGMENTED_SORT_SEGMENTED_SORT_CUH
+#define GDF_SEGMENTED_SORT_SEGMENTED_SORT_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/errorutils.h>
+
+#include <cub/device/device_segmented_radix_sort.cuh>
+
+#include <thrust/copy.h>
+#include <thrust/device_vector.h>
+#include <thrust/gather.h>
+#include <thrust/iterator/counting_iterator.h>
+
+#include <type_traits>
+
+#include "host_segmented_sort.h"
+
+// Segments of up to SEGSORT_WARP_ITEMS items are sorted by a sorting network
+// in the registers of (part of) a warp, segments of up to
+// SEGSORT_BLOCK_ITEMS items by a merge sort in the shared memory of one
+// block, and the larger ones by cub's segmented radix sort
+constexpr unsigned SEGSORT_WARP_ITEMS = 32;
+constexpr int SEGSORT_WARP_KERNEL_THREADS = 256;
+constexpr int SEGSORT_BLOCK_THREADS = 128;
+constexpr int SEGSORT_ITEMS_PER_THREAD = 8;
+constexpr unsigned SEGSORT_BLOCK_ITEMS = SEGSORT_BLOCK_THREADS * SEGSORT_ITEMS_PER_THREAD;
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Selects the segments whose number of items is in (min_items, max_items]
+ */
+/* ----------------------------------------------------------------------------*/
+struct segment_size_in_range
+{
+  unsigned const * begin_offsets;
+  unsigned const * end_offsets;
+  unsigned         min_items;
+  unsigned         max_items;
+
+  __device__
+  bool operator()(unsigned segment) const
+  {
+    const unsigned size = end_offsets[segment] - begin_offsets[segment];
+    return (size > min_items) && (size <= max_items);
+  }
+};
+
+template <typename T>
+__device__ __forceinline__
+T shfl_xor_any(T value, int lane_mask, int width)
+{
+  static_assert(sizeof(T) <= sizeof(long long), "Unsupported shuffle type");
+  using word_type = typename std::conditional<(sizeof(T) > sizeof(int)), long long, int>::type;
+  word_type word{0};
+  memcpy(&word, &value, sizeof(T));
+  word = __shfl_xor_sync(0xffffffff, word, lane_mask, width);
+  memcpy(&value, &word, sizeof(T));
+  return value;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Sorts segments of at most GROUP_SIZE items, one segment per
+ * group of GROUP_SIZE lanes, with a bitonic network over warp shuffles.
+ *
+ * Each lane holds one item; the lanes past the end of the segment hold
+ * padding that sorts last. Ties are broken by the original position so that
+ * the order matches the stable radix sort.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Tk, typename Tv, int GROUP_SIZE>
+__global__
+void warp_segmented_sort(Tk *             keys,
+                         Tv *             vals,
+                         unsigned const * segments,
+                         unsigned         num_segments,
+                         unsigned const * begin_offsets,
+                         unsigned const * end_offsets,
+                         bool             descending)
+{
+  const unsigned group = (blockIdx.x * blockDim.x + threadIdx.x) / GROUP_SIZE;
+  const int rank = threadIdx.x % GROUP_SIZE;
+
+  // Lanes without a segment still take part in the shuffles
+  unsigned begin{0};
+  unsigned size{0};
+  if( group < num_segments )
+  {
+    const unsigned segment = segments[group];
+    begin = begin_offsets[segment];
+    size = end_offsets[segment] - begin;
+  }
+
+  int valid = static_cast<unsigned>(rank) < size;
+  int pos = rank;
+  Tk key = valid ? keys[begin + rank] : Tk{};
+  Tv val = (valid && vals) ? vals[begin + rank] : Tv{};
+  const segment_key_less<Tk> less{descending};
+
+  for(int k = 2; k <= GROUP_SIZE; k <<= 1)
+  {
+    for(int j = k >> 1; j > 0; j >>= 1)
+    {
+      const Tk other_key = shfl_xor_any(key, j, GROUP_SIZE);
+      const Tv other_val = shfl_xor_any(val, j, GROUP_SIZE);
+      const int other_pos = shfl_xor_any(pos, j, GROUP_SIZE);
+      const int other_valid = shfl_xor_any(valid, j, GROUP_SIZE);
+
+      const bool other_first = other_valid &&
+        (!valid || less(other_key, key) || (!less(key, other_key) && other_pos < pos));
+      const bool keep_first = ((rank & j) == 0) == ((rank & k) == 0);
+      if( keep_first == other_first )
+      {
+        key = other_key;
+        val = other_val;
+        pos = other_pos;
+        valid = other_valid;
+      }
+    }
+  }
+
+  if( valid )
+  {
+    keys[begin + rank] = key;
+    if( vals )
+      vals[begin + rank] = val;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Sorts segments of at most SEGSORT_BLOCK_ITEMS items, one segment
+ * per block, with a stable merge sort in shared memory: every thread sorts
+ * SEGSORT_ITEMS_PER_THREAD items, then the sorted runs are merged pairwise,
+ * each thread producing SEGSORT_ITEMS_PER_THREAD outputs of every merge from
+ * its own merge path split.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Tk, typename Tv>
+__global__
+void block_segmented_sort(Tk *             keys,
+                          Tv *             vals,
+                          unsigned const * segments,
+                          unsigned const * begin_offsets,
+                          unsigned const * end_offsets,
+                          bool             descending)
+{
+  __shared__ Tk s_keys[2][SEGSORT_BLOCK_ITEMS];
+  __shared__ Tv s_vals[2][SEGSORT_BLOCK_ITEMS];
+
+  const unsigned segment = segments[blockIdx.x];
+  const unsigned begin = begin_offsets[segment];
+  const int size = end_offsets[segment] - begin;
+  const segment_key_less<Tk> less{descending};
+
+  for(int i = threadIdx.x; i < size; i += blockDim.x)
+  {
+    s_keys[0][i] = keys[begin + i];
+    s_vals[0][i] = vals ? vals[begin + i] : Tv{};
+  }
+  __syncthreads();
+
+  // Stable insertion sort of this thread's run
+  const int run_begin = threadIdx.x * SEGSORT_ITEMS_PER_THREAD;
+  const int run_end = min(run_begin + SEGSORT_ITEMS_PER_THREAD, size);
+  for(int i = run_begin + 1; i < run_end; ++i)
+  {
+    const Tk key = s_keys[0][i];
+    const Tv val = s_vals[0][i];
+    int j = i;
+    for(; j > run_begin && less(key, s_keys[0][j - 1]); --j)
+    {
+      s_keys[0][j] = s_keys[0][j - 1];
+      s_vals[0][j] = s_vals[0][j - 1];
+    }
+    s_keys[0][j] = key;
+    s_vals[0][j] = val;
+  }
+  __syncthreads();
+
+  int src = 0;
+  for(int width = SEGSORT_ITEMS_PER_THREAD; width < size; width <<= 1)
+  {
+    const int out_begin = run_begin;
+    if( out_begin < size )
+    {
+      const int a_begin = (out_begin / (2 * width)) * (2 * width);
+      const int a_end = min(a_begin + width, size);
+      const int b_end = min(a_begin + 2 * width, size);
+      const int a_size = a_end - a_begin;
+      const int b_size = b_end - a_end;
+      Tk const * a_keys = s_keys[src] + a_begin;
+      Tk const * b_keys = s_keys[src] + a_end;
+      Tv const * a_vals = s_vals[src] + a_begin;
+      Tv const * b_vals = s_vals[src] + a_end;
+
+      // Merge path: on ties the items of the first run go first
+      const int diag = out_begin - a_begin;
+      int lo = max(0, diag - b_size);
+      int hi = min(diag, a_size);
+      while( lo < hi )
+      {
+        const int mid = (lo + hi) / 2;
+        if( !less(b_keys[diag - 1 - mid], a_keys[mid]) )
+          lo = mid + 1;
+        else
+          hi = mid;
+      }
+
+      int i = lo;
+      int j = diag - lo;
+      const int out_end = min(out_begin + SEGSORT_ITEMS_PER_THREAD, b_end);
+      for(int k = out_begin; k < out_end; ++k)
+      {
+        const bool take_a = (i < a_size) && ((j >= b_size) || !less(b_keys[j], a_keys[i]));
+        s_keys[src ^ 1][k] = take_a ? a_keys[i] : b_keys[j];
+        s_vals[src ^ 1][k] = take_a ? a_vals[i] : b_vals[j];
+        i += take_a;
+        j += !take_a;
+      }
+    }
+    src ^= 1;
+    __syncthreads();
+  }
+
+  for(int i = threadIdx.x; i < size; i += blockDim.x)
+  {
+    keys[begin + i] = s_keys[src][i];
+    if( vals )
+      vals[begin + i] = s_vals[src][i];
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Ids of the segments whose number of items is in (min_items, max_items]
+ */
+/* ----------------------------------------------------------------------------*/
+inline
+thrust::device_vector<unsigned> bin_segments(unsigned         num_segments,
+                                             unsigned const * d_begin_offsets,
+                                             unsigned const * d_end_offsets,
+                                             unsigned         min_items,
+                                             unsigned         max_items,
+                                             cudaStream_t     stream)
+{
+  thrust::device_vector<unsigned> d_bin(num_segments);
+  thrust::counting_iterator<unsigned> segments(0);
+  auto end = thrust::copy_if(thrust::cuda::par.on(stream),
+                             segments, segments + num_segments,
+                             d_bin.begin(),
+                             segment_size_in_range{d_begin_offsets, d_end_offsets,
+                                                   min_items, max_items});
+  d_bin.resize(end - d_bin.begin());
+  return d_bin;
+}
+
+template <typename Tk, typename Tv, int GROUP_SIZE>
+gdf_error warp_sort_bin(Tk *                                    d_keys,
+                        Tv *                                    d_vals,
+                        thrust::device_vector<unsigned> const & d_bin,
+                        unsigned const *                        d_begin_offsets,
+                        unsigned const *                        d_end_offsets,
+                        bool                                    descending,
+                        cudaStream_t                            stream)
+{
+  if( d_bin.empty() )
+    return GDF_SUCCESS;
+
+  constexpr unsigned groups_per_block = SEGSORT_WARP_KERNEL_THREADS / GROUP_SIZE;
+  const unsigned num_blocks = (d_bin.size() + groups_per_block - 1) / groups_per_block;
+  warp_segmented_sort<Tk, Tv, GROUP_SIZE><<<num_blocks, SEGSORT_WARP_KERNEL_THREADS, 0, stream>>>(
+    d_keys, d_vals, d_bin.data().get(), d_bin.size(), d_begin_offsets, d_end_offsets, descending);
+  CUDA_CHECK_LAST();
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Sorts the large segments with cub's segmented radix sort. The
+ * alternate buffers are first made a copy of the keys and values, so that
+ * the items outside of the sorted segments are the same in whichever buffer
+ * cub leaves its result.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Tk, typename Tv>
+gdf_error radix_sort_bin(Tk *                                    d_keys,
+                         Tv *                                    d_vals,
+                         Tk *                                    d_keys_alt,
+                         Tv *                                    d_vals_alt,
+                         size_t                                  num_items,
+                         thrust::device_vector<unsigned> const & d_bin,
+                         unsigned const *                        d_begin_offsets,
+                         unsigned const *                        d_end_offsets,
+                         bool                                    descending,
+                         void * &                                d_storage,
+                         size_t &                                storage_bytes,
+                         cudaStream_t                            stream)
+{
+  if( d_bin.empty() )
+    return GDF_SUCCESS;
+
+  thrust::device_vector<unsigned> d_begin(d_bin.size());
+  thrust::device_vector<unsigned> d_end(d_bin.size());
+  thrust::gather(thrust::cuda::par.on(stream), d_bin.begin(), d_bin.end(),
+                 d_begin_offsets, d_begin.begin());
+  thrust::gather(thrust::cuda::par.on(stream), d_bin.begin(), d_bin.end(),
+                 d_end_offsets, d_end.begin());
+
+  CUDA_TRY( cudaMemcpyAsync(d_keys_alt, d_keys, num_items * sizeof(Tk),
+                            cudaMemcpyDeviceToDevice, stream) );
+  if( d_vals )
+    CUDA_TRY( cudaMemcpyAsync(d_vals_alt, d_vals, num_items * sizeof(Tv),
+                              cudaMemcpyDeviceToDevice, stream) );
+
+  cub::DoubleBuffer<Tk> keys(d_keys, d_keys_alt);
+  cub::DoubleBuffer<Tv> vals(d_vals, d_vals_alt);
+  const int num_segments = d_bin.size();
+  constexpr int end_bit = sizeof(Tk) * 8;
+
+  auto sort = [&](void * storage, size_t & bytes) -> cudaError_t {
+    if( d_vals )
+      return descending
+        ? cub::DeviceSegmentedRadixSort::SortPairsDescending(storage, bytes, keys, vals, num_items,
+            num_segments, d_begin.data().get(), d_end.data().get(), 0, end_bit, stream)
+        : cub::DeviceSegmentedRadixSort::SortPairs(storage, bytes, keys, vals, num_items,
+            num_segments, d_begin.data().get(), d_end.data().get(), 0, end_bit, stream);
+    return descending
+      ? cub::DeviceSegmentedRadixSort::SortKeysDescending(storage, bytes, keys, num_items,
+          num_segments, d_begin.data().get(), d_end.data().get(), 0, end_bit, stream)
+      : cub::DeviceSegmentedRadixSort::SortKeys(storage, bytes, keys, num_items,
+          num_segments, d_begin.data().get(), d_end.data().get(), 0, end_bit, stream);
+  };
+
+  // The temporary storage only grows
+  size_t required_bytes{0};
+  CUDA_TRY( sort(nullptr, required_bytes) );
+  if( required_bytes > storage_bytes )
+  {
+    CUDA_TRY( cudaFree(d_storage) );
+    CUDA_TRY( cudaMalloc(&d_storage, required_bytes) );
+    storage_bytes = required_bytes;
+  }
+  CUDA_TRY( sort(d_storage, storage_bytes) );
+
+  if( keys.Current() != d_keys )
+    CUDA_TRY( cudaMemcpyAsync(d_keys, keys.Current(), num_items * sizeof(Tk),
+                              cudaMemcpyDeviceToDevice, stream) );
+  if( d_vals && vals.Current() != d_vals )
+    CUDA_TRY( cudaMemcpyAsync(d_vals, vals.Current(), num_items * sizeof(Tv),
+                              cudaMemcpyDeviceToDevice, stream) );
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Stable segmented sort of keys, and optionally values, that bins
+ * the segments by size and sorts every bin with the cheapest algorithm for
+ * its segments: a warp (or 8/16 lane) sorting network for up to 32 items, a
+ * shared memory block merge sort for up to SEGSORT_BLOCK_ITEMS items, and a
+ * segmented radix sort above. Millions of tiny segments thus cost a few
+ * passes over the data instead of a radix sort launch per segment tile.
+ *
+ * @Param[in,out] d_keys The keys, sorted within every segment in place
+ * @Param[in,out] d_vals The values, permuted along with the keys, or nullptr
+ * @Param d_keys_alt Scratch buffer of num_items keys
+ * @Param d_vals_alt Scratch buffer of num_items values (unused if d_vals is nullptr)
+ * @Param[in] num_items The number of keys
+ * @Param[in] num_segments The number of segments
+ * @Param[in] d_begin_offsets Device array of the first item of every segment
+ * @Param[in] d_end_offsets Device array of one past the last item of every segment
+ * @Param[in] descending Sort every segment in descending order
+ * @Param[in,out] d_storage Radix sort temporary storage, reallocated if too small
+ * @Param[in,out] storage_bytes The size of d_storage
+ * @Param[in] stream The stream on which to sort
+ *
+ * @Returns GDF_SUCCESS upon successful completion
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Tk, typename Tv>
+gdf_error segmented_sort(Tk *             d_keys,
+                         Tv *             d_vals,
+                         Tk *             d_keys_alt,
+                         Tv *             d_vals_alt,
+                         size_t           num_items,
+                         unsigned         num_segments,
+                         unsigned const * d_begin_offsets,
+                         unsigned const * d_end_offsets,
+                         bool             descending,
+                         void * &         d_storage,
+                         size_t &         storage_bytes,
+                         cudaStream_t     stream = 0)
+{
+  if( 0 == num_segments || 0 == num_items )
+    return GDF_SUCCESS;
+
+  // Segments of one item are sorted already. The radix sort runs first as it
+  // rewrites the keys and values outside of its segments.
+  gdf_error status = radix_sort_bin(d_keys, d_vals, d_keys_alt, d_vals_alt, num_items,
+                                    bin_segments(num_segments, d_begin_offsets, d_end_offsets,
+                                                 SEGSORT_BLOCK_ITEMS, ~0u, stream),
+                                    d_begin_offsets, d_end_offsets, descending,
+                                    d_storage, storage_bytes, stream);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  status = warp_sort_bin<Tk, Tv, 8>(d_keys, d_vals,
+                                    bin_segments(num_segments, d_begin_offsets, d_end_offsets,
+                                                 1, 8, stream),
+                                    d_begin_offsets, d_end_offsets, descending, stream);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  status = warp_sort_bin<Tk, Tv, 16>(d_keys, d_vals,
+                                     bin_segments(num_segments, d_begin_offsets, d_end_offsets,
+                                                  8, 16, stream),
+                                     d_begin_offsets, d_end_offsets, descending, stream);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  status = warp_sort_bin<Tk, Tv, SEGSORT_WARP_ITEMS>(d_keys, d_vals,
+                                                     bin_segments(num_segments, d_begin_offsets,
+                                                                  d_end_offsets, 16,
+                                                                  SEGSORT_WARP_ITEMS, stream),
+                                                     d_begin_offsets, d_end_offsets,
+                                                     descending, stream);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  thrust::device_vector<unsigned> d_block_bin = bin_segments(num_segments, d_begin_offsets,
+                                                             d_end_offsets, SEGSORT_WARP_ITEMS,
+                                                             SEGSORT_BLOCK_ITEMS, stream);
+  if( !d_block_bin.empty() )
+  {
+    block_segmented_sort<Tk, Tv><<<d_block_bin.size(), SEGSORT_BLOCK_THREADS, 0, stream>>>(
+      d_keys, d_vals, d_block_bin.data().get(), d_begin_offsets, d_end_offsets, descending);
+    CUDA_CHECK_LAST();
+  }
+
+  // The bins are released on return
+  CUDA_TRY( cudaStreamSynchronize(stream) );
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_SEGMENTED_SORT_SEGMENTED_SORT_CUH
@@ -4,6 +4,8 @@
 
 #include <cub/device/device_segmented_radix_sort.cuh>
 
+#include "segmented_sort/segmented_sort.cuh"
+
 
 struct SegmentedRadixSortPlan{
     const size_t num_items;
@@ -49,14 +51,18 @@ struct SegmentedRadixSortPlan{
 template <typename Tk, typename Tv>
 struct SegmentedRadixSort {
 
+    // Sorts the segments of the first `num_items` (at most the plan's
+    // capacity) items
     static
     gdf_error sort( SegmentedRadixSortPlan *plan,
                     Tk *d_key_buf, Tv *d_value_buf,
+                    size_t num_items,
                     unsigned num_segments,
                     unsigned *d_begin_offsets,
                     unsigned *d_end_offsets) {
 
-        unsigned  num_items = plan->num_items;
+        GDF_REQUIRE(num_items <= plan->num_items, GDF_COLUMN_SIZE_TOO_BIG);
+
         Tk *d_key_alt_buf = (Tk*)plan->back_key;
         Tv *d_value_alt_buf = (Tv*)plan->back_val;
 
@@ -65,92 +71,68 @@ struct SegmentedRadixSort {
         unsigned begin_bit = plan->begin_bit;
         unsigned end_bit = plan->end_bit;
 
+        // Whole keys: sort every segment with the cheapest algorithm for
+        // its size rather than with a radix sort pass per digit
+        if (begin_bit == 0 && end_bit == sizeof(Tk) * 8) {
+            return segmented_sort(d_key_buf, d_value_buf,
+                                  d_key_alt_buf, d_value_alt_buf,
+                                  num_items, num_segments,
+                                  d_begin_offsets, d_end_offsets,
+                                  descending != 0,
+                                  plan->storage, plan->storage_bytes,
+                                  stream);
+        }
+
         cub::DoubleBuffer<Tk> d_keys(d_key_buf, d_key_alt_buf);
+        cub::DoubleBuffer<Tv> d_values(d_value_buf, d_value_alt_buf);
 
         typedef cub::DeviceSegmentedRadixSort Sorter;
 
-        if (d_value_buf) {
-            // Sort KeyValue pairs
-            cub::DoubleBuffer<Tv> d_values(d_value_buf, d_value_alt_buf);
-            if (descending) {
-                Sorter::SortPairsDescending(plan->storage,
-                                            plan->storage_bytes,
-                                            d_keys,
-                                            d_values,
-                                            num_items,
-                                            num_segments,
-                                            d_begin_offsets,
-                                            d_end_offsets,
-                                            begin_bit,
-                                            end_bit,
-                                            stream);
-            } else {
-                Sorter::SortPairs(  plan->storage,
-                                    plan->storage_bytes,
-                                    d_keys,
-                                    d_values,
-                                    num_items,
-                                    num_segments,
-                                    d_begin_offsets,
-                                    d_end_offsets,
-                                    begin_bit,
-                                    end_bit,
-                                    stream    );
-            }
-            CUDA_CHECK_LAST();
-            if (plan->storage && d_value_buf != d_values.Current()){
-                cudaMemcpyAsync(d_value_buf, d_value_alt_buf,
-                                num_items * sizeof(Tv),
-                                cudaMemcpyDeviceToDevice,
-                                stream);
-                CUDA_CHECK_LAST();
+        auto sort = [&](void *storage, size_t &storage_bytes) -> cudaError_t {
+            if (d_value_buf) {
+                // Sort KeyValue pairs
+                return descending
+                    ? Sorter::SortPairsDescending(storage, storage_bytes,
+                                                  d_keys, d_values, num_items,
+                                                  num_segments,
+                                                  d_begin_offsets, d_end_offsets,
+                                                  begin_bit, end_bit, stream)
+                    : Sorter::SortPairs(storage, storage_bytes,
+                                        d_keys, d_values, num_items,
+                                        num_segments,
+                                        d_begin_offsets, d_end_offsets,
+                                        begin_bit, end_bit, stream);
             }
-        } else {
             // Sort Keys only
-            if (descending) {
-                Sorter::SortKeysDescending(   plan->storage,
-                                              plan->storage_bytes,
-                                              d_keys,
-                                              num_items,
-                                              num_segments,
-                                              d_begin_offsets,
-                                              d_end_offsets,
-                                              begin_bit,
-                                              end_bit,
-                                              stream  );
-                CUDA_CHECK_LAST()
-
-            } else {
-                Sorter::SortKeys( plan->storage,
-                                  plan->storage_bytes,
-                                  d_keys,
-                                  num_items,
-                                  num_segments,
-                                  d_begin_offsets,
-                                  d_end_offsets,
-                                  begin_bit,
-                                  end_bit,
-                                  stream  );
-            }
-
-            CUDA_CHECK_LAST();
+            return descending
+                ? Sorter::SortKeysDescending(storage, storage_bytes,
+                                             d_keys, num_items, num_segments,
+                                             d_begin_offsets, d_end_offsets,
+                                             begin_bit, end_bit, stream)
+                : Sorter::SortKeys(storage, storage_bytes,
+                                   d_keys, num_items, num_segments,
+                                   d_begin_offsets, d_end_offsets,
+                                   begin_bit, end_bit, stream);
+        };
+
+        // The temporary storage is kept by the plan and only grows
+        size_t required_bytes = 0;
+        CUDA_TRY( sort(nullptr, required_bytes) );
+        if (required_bytes > plan->storage_bytes) {
+            CUDA_TRY( cudaFree(plan->storage) );
+            CUDA_TRY( cudaMalloc(&plan->storage, required_bytes) );
+            plan->storage_bytes = required_bytes;
         }
+        CUDA_TRY( sort(plan->storage, plan->storage_bytes) );
 
-        if ( plan->storage ) {
-            // We have operated and the result is not in front buffer
-            if (d_key_buf != d_keys.Current()){
-                cudaMemcpyAsync(d_key_buf, d_key_alt_buf, num_items * sizeof(Tk),
-                                cudaMemcpyDeviceToDevice, stream);
-                CUDA_CHECK_LAST();
-            }
-        } else {
-            // We have not operated.
-            // Just checking for temporary storage requirement
-            cudaMalloc(&plan->storage, plan->storage_bytes);
-            CUDA_CHECK_LAST();
-            // Now that we have allocated, do real work.
-            return sort(plan, d_key_buf, d_value_buf, num_segments,
-                        d_begin_offsets, d_end_offsets);
+        // The result is not in front buffer
+        if (d_key_buf != d_keys.Current()){
+            CUDA_TRY( cudaMemcpyAsync(d_key_buf, d_key_alt_buf, num_items * sizeof(Tk),
+                                      cudaMemcpyDeviceToDevice, stream) );
+        }
+        if (d_value_buf && d_value_buf != d_values.Current()){
+            CUDA_TRY( cudaMemcpyAsync(d_value_buf, d_value_alt_buf, num_items * sizeof(Tv),
+                                      cudaMemcpyDeviceToDevice, stream) );
         }
         return GDF_SUCCESS;
     }
@@ -205,8 +187,8 @@ gdf_error gdf_segmented_radixsort_##Fn(gdf_segmented_radixsort_plan_type *hdl, \
     /* size of columns must match */                                        \
     GDF_REQUIRE(keycol->size == valcol->size, GDF_COLUMN_SIZE_MISMATCH);    \
     SegmentedRadixSortPlan *plan = cffi_unwrap(hdl);                        \
-    /* num_items must match */                                              \
-    GDF_REQUIRE(plan->num_items == keycol->size, GDF_COLUMN_SIZE_MISMATCH); \
+    /* num_items must fit the plan */                                       \
+    GDF_REQUIRE(plan->num_items >= keycol->size, GDF_COLUMN_SIZE_TOO_BIG);  \
     /* back buffer size must match */                                       \
     GDF_REQUIRE(sizeof(Tk) * plan->num_items == plan->back_key_size,        \
                 GDF_COLUMN_SIZE_MISMATCH);                                  \
@@ -215,7 +197,8 @@ gdf_error gdf_segmented_radixsort_##Fn(gdf_segmented_radixsort_plan_type *hdl, \
     /* Do sort */                                                           \
     return SegmentedRadixSort<Tk, Tv>::sort(plan,                           \
                                    (Tk*)keycol->data, (Tv*)valcol->data,            \
-                                    num_segments, d_begin_offsets, d_end_offsets);  \
+                                   keycol->size,                                    \
+                                   num_segments, d_begin_offsets, d_end_offsets);   \
 }
 
 
@@ -2,137 +2,11 @@
 #include <gdf/utils.h>
 #include <gdf/errorutils.h>
 
-#include <cub/device/device_radix_sort.cuh>
-
-struct RadixSortPlan{
-    const size_t num_items;
-    // temporary storage
-    void *storage;
-    size_t storage_bytes;
-    void *back_key, *back_val;
-    size_t back_key_size, back_val_size;
-
-    cudaStream_t stream;
-    int descending;
-    unsigned begin_bit, end_bit;
-
-    RadixSortPlan(size_t num_items, int descending,
-                  unsigned begin_bit, unsigned end_bit)
-        :   num_items(num_items),
-            storage(nullptr), storage_bytes(0),
-            back_key(nullptr), back_val(nullptr),
-            back_key_size(0), back_val_size(0),
-            stream(0), descending(descending),
-            begin_bit(begin_bit), end_bit(end_bit)
-    {}
-
-    gdf_error setup(size_t sizeof_key, size_t sizeof_val) {
-        back_key_size = num_items * sizeof_key;
-        back_val_size = num_items * sizeof_val;
-        CUDA_TRY(cudaMalloc(&back_key, back_key_size));
-        CUDA_TRY(cudaMalloc(&back_val, back_val_size));
-        return GDF_SUCCESS;
-    }
+#include <limits>
+#include <vector>
 
-    gdf_error teardown() {
-        CUDA_TRY(cudaFree(back_key));
-        CUDA_TRY(cudaFree(back_val));
-        CUDA_TRY(cudaFree(storage));
-        return GDF_SUCCESS;
-    }
-};
-
-
-template <typename Tk, typename Tv>
-struct RadixSort {
-
-    static
-    gdf_error sort( RadixSortPlan *plan, Tk *d_key_buf, Tv *d_value_buf) {
-
-        unsigned  num_items = plan->num_items;
-        Tk *d_key_alt_buf = (Tk*)plan->back_key;
-        Tv *d_value_alt_buf = (Tv*)plan->back_val;
-
-        cudaStream_t stream = plan->stream;
-        int descending = plan->descending;
-        unsigned begin_bit = plan->begin_bit;
-        unsigned end_bit = plan->end_bit;
-
-        cub::DoubleBuffer<Tk> d_keys(d_key_buf, d_key_alt_buf);
-
-        if (d_value_buf) {
-            // Sort KeyValue pairs
-            cub::DoubleBuffer<Tv> d_values(d_value_buf, d_value_alt_buf);
-            if (descending) {
-                cub::DeviceRadixSort::SortPairsDescending(plan->storage,
-                                                          plan->storage_bytes,
-                                                          d_keys,
-                                                          d_values,
-                                                          num_items,
-                                                          begin_bit,
-                                                          end_bit,
-                                                          stream);
-            } else {
-                cub::DeviceRadixSort::SortPairs(  plan->storage,
-                                                  plan->storage_bytes,
-                                                  d_keys,
-                                                  d_values,
-                                                  num_items,
-                                                  begin_bit,
-                                                  end_bit,
-                                                  stream    );
-            }
-            CUDA_CHECK_LAST();
-            if (plan->storage && d_value_buf != d_values.Current()){
-                cudaMemcpyAsync(d_value_buf, d_value_alt_buf,
-                                num_items * sizeof(Tv),
-                                cudaMemcpyDeviceToDevice,
-                                stream);
-                CUDA_CHECK_LAST();
-            }
-        } else {
-            // Sort Keys only
-            if (descending) {
-                cub::DeviceRadixSort::SortKeysDescending(   plan->storage,
-                                                            plan->storage_bytes,
-                                                            d_keys,
-                                                            num_items,
-                                                            begin_bit,
-                                                            end_bit,
-                                                            stream  );
-                CUDA_CHECK_LAST()
-
-            } else {
-                cub::DeviceRadixSort::SortKeys( plan->storage,
-                                                plan->storage_bytes,
-                                                d_keys,
-                                                num_items,
-                                                begin_bit,
-                                                end_bit,
-                                                stream  );
-            }
-
-            CUDA_CHECK_LAST();
-        }
-
-        if ( plan->storage ) {
-            // We have operated and the result is not in front buffer
-            if (d_key_buf != d_keys.Current()){
-                cudaMemcpyAsync(d_key_buf, d_key_alt_buf, num_items * sizeof(Tk),
-                                cudaMemcpyDeviceToDevice, stream);
-                CUDA_CHECK_LAST();
-            }
-        } else {
-            // We have not operated.
-            // Just checking for temporary storage requirement
-            cudaMalloc(&plan->storage, plan->storage_bytes);
-            CUDA_CHECK_LAST();
-            // Now that we have allocated, do real work.
-            return sort(plan, d_key_buf, d_value_buf);
-        }
-        return GDF_SUCCESS;
-    }
-};
+#include "sorting.cuh"
+#include "segmented_sort/segmented_sort.cuh"
 
 gdf_radixsort_plan_type* cffi_wrap(RadixSortPlan* obj){
     return reinterpret_cast<gdf_radixsort_plan_type*>(obj);
@@ -175,8 +49,8 @@ gdf_error gdf_radixsort_##Fn(gdf_radixsort_plan_type *hdl,
     /* size of columns must match */                                        \
     GDF_REQUIRE(keycol->size == valcol->size, GDF_COLUMN_SIZE_MISMATCH);    \
     RadixSortPlan *plan = cffi_unwrap(hdl);                                 \
-    /* num_items must match */                                              \
-    GDF_REQUIRE(plan->num_items == keycol->size, GDF_COLUMN_SIZE_MISMATCH); \
+    /* num_items must fit the plan */                                       \
+    GDF_REQUIRE(plan->num_items >= keycol->size, GDF_COLUMN_SIZE_TOO_BIG);  \
     /* back buffer size must match */                                       \
     GDF_REQUIRE(sizeof(Tk) * plan->num_items == plan->back_key_size,        \
                 GDF_COLUMN_SIZE_MISMATCH);                                  \
@@ -184,7 +58,8 @@ gdf_error gdf_radixsort_##Fn(gdf_radixsort_plan_type *hdl,
                 GDF_COLUMN_SIZE_MISMATCH);                                  \
     /* Do sort */                                                           \
     return RadixSort<Tk, Tv>::sort(plan,                                    \
-                                   (Tk*)keycol->data, (Tv*)valcol->data);   \
+                                   (Tk*)keycol->data, (Tv*)valcol->data,    \
+                                   keycol->size);                           \
 }
 
 
@@ -212,3 +87,182 @@ gdf_error gdf_radixsort_generic(gdf_radixsort_plan_type *hdl,
     }
 }
 
+namespace {
+
+// Copies the items of a batch of arrays to (or back from) the staging
+// buffer where they lie back to back; the array of staged item i is found
+// by a binary search of the staging offsets
+template <typename T>
+__global__
+void batch_stage_items(T * const *      arrays,
+                       unsigned const * offsets,
+                       unsigned         num_arrays,
+                       T *              staged,
+                       size_t           num_items,
+                       bool             to_staging)
+{
+    for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < num_items;
+         i += blockDim.x * gridDim.x) {
+        // The last array starting at or before i holds it (empty arrays
+        // start at the same offset as the next one)
+        unsigned lo = 0, hi = num_arrays;
+        while (hi - lo > 1) {
+            const unsigned mid = (lo + hi) / 2;
+            if (offsets[mid] <= i)
+                lo = mid;
+            else
+                hi = mid;
+        }
+        T *array = arrays[lo];
+        const size_t j = i - offsets[lo];
+        if (to_staging)
+            staged[i] = array[j];
+        else
+            array[j] = staged[i];
+    }
+}
+
+template <typename T>
+gdf_error stage_batch(T * const *arrays, unsigned const *offsets, unsigned num_arrays,
+                      T *staged, size_t num_items, bool to_staging, cudaStream_t stream)
+{
+    const int block_size = 256;
+    const int num_blocks = std::min<size_t>((num_items + block_size - 1) / block_size, 4096);
+    batch_stage_items<<<num_blocks, block_size, 0, stream>>>(
+        arrays, offsets, num_arrays, staged, num_items, to_staging);
+    CUDA_CHECK_LAST();
+    return GDF_SUCCESS;
+}
+
+template <typename Tk, typename Tv>
+gdf_error radixsort_batch(RadixSortPlan *plan,
+                          gdf_column **keycols,
+                          gdf_column **valcols,
+                          size_t num_arrays)
+{
+    // Reject an array larger than the plan before any array is sorted in place
+    for (size_t a = 0; a < num_arrays; ++a)
+        GDF_REQUIRE(keycols[a]->size <= plan->num_items, GDF_COLUMN_SIZE_TOO_BIG);
+
+    // The segmented sort orders whole keys only: sort a partial bit range
+    // array by array, still reusing the plan's buffers
+    if (plan->begin_bit != 0 || plan->end_bit != sizeof(Tk) * 8) {
+        for (size_t a = 0; a < num_arrays; ++a) {
+            gdf_error status = RadixSort<Tk, Tv>::sort(plan, (Tk*)keycols[a]->data,
+                valcols ? (Tv*)valcols[a]->data : nullptr, keycols[a]->size);
+            if (GDF_SUCCESS != status)
+                return status;
+        }
+        CUDA_TRY( cudaStreamSynchronize(plan->stream) );
+        return GDF_SUCCESS;
+    }
+
+    GDF_REQUIRE(plan->num_items <= std::numeric_limits<unsigned>::max(),
+                GDF_COLUMN_SIZE_TOO_BIG);
+    gdf_error status = plan->reserve_batch(num_arrays);
+    if (GDF_SUCCESS != status)
+        return status;
+
+    Tk *batch_key = (Tk*)plan->batch_key;
+    Tv *batch_val = valcols ? (Tv*)plan->batch_val : nullptr;
+    Tk **d_key_ptrs = (Tk**)plan->batch_ptrs;
+    Tv **d_val_ptrs = (Tv**)(plan->batch_ptrs + num_arrays);
+
+    std::vector<unsigned> h_offsets;
+    std::vector<void*> h_ptrs;
+    for (size_t first = 0; first < num_arrays; ) {
+        // Stage as many arrays as fit the plan's capacity, then sort all of
+        // them at once as the segments of one segmented sort
+        h_offsets.assign(1, 0);
+        size_t last = first;
+        while (last < num_arrays &&
+               h_offsets.back() + keycols[last]->size <= plan->num_items) {
+            h_offsets.push_back(h_offsets.back() + keycols[last]->size);
+            ++last;
+        }
+
+        const unsigned count = last - first;
+        const size_t staged_items = h_offsets.back();
+        h_ptrs.assign(2 * num_arrays, nullptr);
+        for (size_t a = first; a < last; ++a) {
+            h_ptrs[a - first] = keycols[a]->data;
+            h_ptrs[num_arrays + a - first] = valcols ? valcols[a]->data : nullptr;
+        }
+        CUDA_TRY( cudaMemcpyAsync(plan->batch_offsets, h_offsets.data(),
+                                  h_offsets.size() * sizeof(unsigned),
+                                  cudaMemcpyHostToDevice, plan->stream) );
+        CUDA_TRY( cudaMemcpyAsync(plan->batch_ptrs, h_ptrs.data(),
+                                  h_ptrs.size() * sizeof(void*),
+                                  cudaMemcpyHostToDevice, plan->stream) );
+
+        status = stage_batch(d_key_ptrs, plan->batch_offsets, count,
+                             batch_key, staged_items, true, plan->stream);
+        if (GDF_SUCCESS == status && batch_val)
+            status = stage_batch(d_val_ptrs, plan->batch_offsets, count,
+                                 batch_val, staged_items, true, plan->stream);
+        if (GDF_SUCCESS == status)
+            status = segmented_sort(batch_key, batch_val,
+                                    (Tk*)plan->back_key, (Tv*)plan->back_val,
+                                    staged_items, count,
+                                    plan->batch_offsets, plan->batch_offsets + 1,
+                                    plan->descending != 0,
+                                    plan->storage, plan->storage_bytes,
+                                    plan->stream);
+        if (GDF_SUCCESS == status)
+            status = stage_batch(d_key_ptrs, plan->batch_offsets, count,
+                                 batch_key, staged_items, false, plan->stream);
+        if (GDF_SUCCESS == status && batch_val)
+            status = stage_batch(d_val_ptrs, plan->batch_offsets, count,
+                                 batch_val, staged_items, false, plan->stream);
+        if (GDF_SUCCESS != status)
+            return status;
+
+        // The offsets and pointers are reused by the next group
+        CUDA_TRY( cudaStreamSynchronize(plan->stream) );
+        first = last;
+    }
+    return GDF_SUCCESS;
+}
+
+} // namespace
+
+gdf_error gdf_radixsort_batch(gdf_radixsort_plan_type *hdl,
+                              gdf_column **keycols,
+                              gdf_column **valcols,
+                              size_t num_arrays)
+{
+    GDF_REQUIRE(nullptr != keycols, GDF_DATASET_EMPTY);
+    if (0 == num_arrays)
+        return GDF_SUCCESS;
+
+    RadixSortPlan *plan = cffi_unwrap(hdl);
+    const gdf_dtype dtype = keycols[0]->dtype;
+    for (size_t a = 0; a < num_arrays; ++a) {
+        /* all the arrays share the plan's schema */
+        GDF_REQUIRE(keycols[a]->dtype == dtype, GDF_DTYPE_MISMATCH);
+        GDF_REQUIRE(!keycols[a]->valid, GDF_VALIDITY_UNSUPPORTED);
+        if (valcols) {
+            GDF_REQUIRE(valcols[a]->dtype == GDF_INT64, GDF_UNSUPPORTED_DTYPE);
+            GDF_REQUIRE(!valcols[a]->valid, GDF_VALIDITY_UNSUPPORTED);
+            GDF_REQUIRE(keycols[a]->size == valcols[a]->size, GDF_COLUMN_SIZE_MISMATCH);
+        }
+    }
+
+    int key_width = 0;
+    gdf_error status = get_column_byte_width(keycols[0], &key_width);
+    if (GDF_SUCCESS != status)
+        return status;
+    /* back buffer size must match */
+    GDF_REQUIRE(key_width * plan->num_items == plan->back_key_size, GDF_COLUMN_SIZE_MISMATCH);
+    GDF_REQUIRE(sizeof(int64_t) * plan->num_items == plan->back_val_size, GDF_COLUMN_SIZE_MISMATCH);
+
+    // dispatch table
+    switch ( dtype ) {
+    case GDF_INT8:    return radixsort_batch<int8_t,  int64_t>(plan, keycols, valcols, num_arrays);
+    case GDF_INT32:   return radixsort_batch<int32_t, int64_t>(plan, keycols, valcols, num_arrays);
+    case GDF_INT64:   return radixsort_batch<int64_t, int64_t>(plan, keycols, valcols, num_arrays);
+    case GDF_FLOAT32: return radixsort_batch<float,   int64_t>(plan, keycols, valcols, num_arrays);
+    case GDF_FLOAT64: return radixsort_batch<double,  int64_t>(plan, keycols, valcols, num_arrays);
+    default:          return GDF_UNSUPPORTED_DTYPE;
+    }
+}
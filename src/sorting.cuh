@@ -0,0 +1,198 @@
+#ifndef GDF_SORTING_CUH
+#define GDF_SORTING_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <cub/device/device_radix_sort.cuh>
+
+#include <algorithm>
+#include <cstdint>
+
+/*
+ * Runs (or, with a null storage, sizes) one cub radix sort of keys, and of
+ * values if `with_values`, in the requested direction.
+ */
+template <typename Tk, typename Tv>
+cudaError_t radix_sort_call(void *storage, size_t &storage_bytes,
+                            cub::DoubleBuffer<Tk> &d_keys,
+                            cub::DoubleBuffer<Tv> &d_values,
+                            bool with_values, size_t num_items, int descending,
+                            unsigned begin_bit, unsigned end_bit,
+                            cudaStream_t stream)
+{
+    if (with_values) {
+        return descending
+            ? cub::DeviceRadixSort::SortPairsDescending(storage, storage_bytes,
+                                                        d_keys, d_values, num_items,
+                                                        begin_bit, end_bit, stream)
+            : cub::DeviceRadixSort::SortPairs(storage, storage_bytes,
+                                              d_keys, d_values, num_items,
+                                              begin_bit, end_bit, stream);
+    }
+    return descending
+        ? cub::DeviceRadixSort::SortKeysDescending(storage, storage_bytes,
+                                                   d_keys, num_items,
+                                                   begin_bit, end_bit, stream)
+        : cub::DeviceRadixSort::SortKeys(storage, storage_bytes,
+                                         d_keys, num_items,
+                                         begin_bit, end_bit, stream);
+}
+
+/*
+ * Temporary storage large enough for any radix sort of up to `num_items`
+ * keys of type Tk, with or without values of type Tv, on any bit range.
+ * The storage only depends on the sizes of the types, not on their kinds.
+ */
+template <typename Tk, typename Tv>
+size_t radix_sort_storage_bytes(size_t num_items) {
+    cub::DoubleBuffer<Tk> d_keys(nullptr, nullptr);
+    cub::DoubleBuffer<Tv> d_values(nullptr, nullptr);
+    size_t pairs_bytes = 0, keys_bytes = 0;
+    radix_sort_call(nullptr, pairs_bytes, d_keys, d_values, true, num_items,
+                    0, 0, 8 * sizeof(Tk), 0);
+    radix_sort_call(nullptr, keys_bytes, d_keys, d_values, false, num_items,
+                    0, 0, 8 * sizeof(Tk), 0);
+    return std::max(pairs_bytes, keys_bytes);
+}
+
+template <typename Tk>
+size_t radix_sort_storage_bytes(size_t num_items, size_t sizeof_val) {
+    switch (sizeof_val) {
+    case 1:  return radix_sort_storage_bytes<Tk, uint8_t>(num_items);
+    case 2:  return radix_sort_storage_bytes<Tk, uint16_t>(num_items);
+    case 4:  return radix_sort_storage_bytes<Tk, uint32_t>(num_items);
+    default: return radix_sort_storage_bytes<Tk, uint64_t>(num_items);
+    }
+}
+
+inline
+size_t radix_sort_storage_bytes(size_t num_items, size_t sizeof_key, size_t sizeof_val) {
+    switch (sizeof_key) {
+    case 1:  return radix_sort_storage_bytes<uint8_t>(num_items, sizeof_val);
+    case 2:  return radix_sort_storage_bytes<uint16_t>(num_items, sizeof_val);
+    case 4:  return radix_sort_storage_bytes<uint32_t>(num_items, sizeof_val);
+    default: return radix_sort_storage_bytes<uint64_t>(num_items, sizeof_val);
+    }
+}
+
+/*
+ * A plan sorts any number of items up to its capacity, `num_items`. All its
+ * device memory (the back buffers and the temporary storage) is sized for
+ * the capacity once, in setup(), and reused by every sort; the staging
+ * buffers of the batched sort are allocated on the first batch.
+ */
+struct RadixSortPlan{
+    const size_t num_items;
+    // temporary storage
+    void *storage;
+    size_t storage_bytes;
+    void *back_key, *back_val;
+    size_t back_key_size, back_val_size;
+
+    // batched sorting: arrays staged back to back, and per array offsets
+    // and device pointers
+    void *batch_key, *batch_val;
+    unsigned *batch_offsets;
+    void **batch_ptrs;
+    size_t batch_arrays;
+
+    cudaStream_t stream;
+    int descending;
+    unsigned begin_bit, end_bit;
+
+    RadixSortPlan(size_t num_items, int descending,
+                  unsigned begin_bit, unsigned end_bit)
+        :   num_items(num_items),
+            storage(nullptr), storage_bytes(0),
+            back_key(nullptr), back_val(nullptr),
+            back_key_size(0), back_val_size(0),
+            batch_key(nullptr), batch_val(nullptr),
+            batch_offsets(nullptr), batch_ptrs(nullptr),
+            batch_arrays(0),
+            stream(0), descending(descending),
+            begin_bit(begin_bit), end_bit(end_bit)
+    {}
+
+    gdf_error setup(size_t sizeof_key, size_t sizeof_val) {
+        back_key_size = num_items * sizeof_key;
+        back_val_size = num_items * sizeof_val;
+        CUDA_TRY(cudaMalloc(&back_key, back_key_size));
+        CUDA_TRY(cudaMalloc(&back_val, back_val_size));
+        storage_bytes = radix_sort_storage_bytes(num_items, sizeof_key, sizeof_val);
+        CUDA_TRY(cudaMalloc(&storage, storage_bytes));
+        return GDF_SUCCESS;
+    }
+
+    // Staging buffers for batches of up to `num_arrays` arrays
+    gdf_error reserve_batch(size_t num_arrays) {
+        if (!batch_key) {
+            CUDA_TRY(cudaMalloc(&batch_key, back_key_size));
+            CUDA_TRY(cudaMalloc(&batch_val, back_val_size));
+        }
+        if (num_arrays > batch_arrays) {
+            CUDA_TRY(cudaFree(batch_offsets));
+            CUDA_TRY(cudaFree(batch_ptrs));
+            CUDA_TRY(cudaMalloc(&batch_offsets, (num_arrays + 1) * sizeof(unsigned)));
+            CUDA_TRY(cudaMalloc(&batch_ptrs, 2 * num_arrays * sizeof(void*)));
+            batch_arrays = num_arrays;
+        }
+        return GDF_SUCCESS;
+    }
+
+    gdf_error teardown() {
+        CUDA_TRY(cudaFree(back_key));
+        CUDA_TRY(cudaFree(back_val));
+        CUDA_TRY(cudaFree(storage));
+        CUDA_TRY(cudaFree(batch_key));
+        CUDA_TRY(cudaFree(batch_val));
+        CUDA_TRY(cudaFree(batch_offsets));
+        CUDA_TRY(cudaFree(batch_ptrs));
+        return GDF_SUCCESS;
+    }
+};
+
+
+template <typename Tk, typename Tv>
+struct RadixSort {
+
+    static
+    gdf_error sort( RadixSortPlan *plan, Tk *d_key_buf, Tv *d_value_buf) {
+        return sort(plan, d_key_buf, d_value_buf, plan->num_items);
+    }
+
+    // Sorts the first `num_items` (at most the plan's capacity) items
+    static
+    gdf_error sort( RadixSortPlan *plan, Tk *d_key_buf, Tv *d_value_buf,
+                    size_t num_items) {
+
+        GDF_REQUIRE(num_items <= plan->num_items, GDF_COLUMN_SIZE_TOO_BIG);
+
+        Tk *d_key_alt_buf = (Tk*)plan->back_key;
+        Tv *d_value_alt_buf = (Tv*)plan->back_val;
+        cudaStream_t stream = plan->stream;
+
+        cub::DoubleBuffer<Tk> d_keys(d_key_buf, d_key_alt_buf);
+        cub::DoubleBuffer<Tv> d_values(d_value_buf, d_value_alt_buf);
+        const bool with_values = d_value_buf != nullptr;
+
+        CUDA_TRY( radix_sort_call(plan->storage, plan->storage_bytes,
+                                  d_keys, d_values, with_values, num_items,
+                                  plan->descending, plan->begin_bit, plan->end_bit,
+                                  stream) );
+
+        // The result is not in front buffer
+        if (d_key_buf != d_keys.Current()){
+            CUDA_TRY( cudaMemcpyAsync(d_key_buf, d_key_alt_buf, num_items * sizeof(Tk),
+                                      cudaMemcpyDeviceToDevice, stream) );
+        }
+        if (with_values && d_value_buf != d_values.Current()){
+            CUDA_TRY( cudaMemcpyAsync(d_value_buf, d_value_alt_buf, num_items * sizeof(Tv),
+                                      cudaMemcpyDeviceToDevice, stream) );
+        }
+        return GDF_SUCCESS;
+    }
+};
+
+#endif // GDF_SORTING_CUH
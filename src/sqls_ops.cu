@@ -9,11 +9,20 @@
 ///#include "../include/sqls_rtti_comp.hpp" -- CORRECT: put me back
 #include "sqls_rtti_comp.hpp"
 #include "groupby/groupby.cuh"
+#include "groupby/compensated_sum_sort.cuh"
 #include "groupby/hash/aggregation_operations.cuh"
+#include "orderby/radix_order_by.cuh"
+#include "orderby/radix_top_k.cuh"
+#include "orderby/is_sorted.cuh"
+#include "gather/table_gather.cuh"
 #include "nvtx_utils.h"
 
-//using IndexT = int;//okay...
-using IndexT = size_t;
+#include <type_traits>
+
+//the row indices of the group-by (and the permutations of the
+//order-by) are 32-bit whenever the number of rows allows it,
+//halving the index traffic of the sorts and gathers;
+//see use_int32_index()
 
 namespace{ //annonymus
 
@@ -41,117 +50,26 @@ namespace{ //annonymus
   template<typename T>
     using Vector = thrust::device_vector<T>;
 
-  void type_dispatcher(gdf_dtype col_type,
-                       int col_index,
-                       gdf_column** h_cols_in,
-                       gdf_column** h_cols_out,
-                       IndexT* d_indices,
-                       size_t nrows_new)
-  {
-    switch( col_type )
-      {
-      case GDF_INT8:
-        {
-          using ColType = int8_t;
-
-          ColType* d_in  = static_cast<ColType*>(h_cols_in[col_index]->data);//pointer semantics (2)
-          ColType* d_out = static_cast<ColType*>(h_cols_out[col_index]->data);
-          thrust::gather(thrust::device,
-                         d_indices, d_indices + nrows_new, //map of indices
-                         d_in,                             //source
-                         d_out);                           //=source[map]
-          break;
-        }
-      case GDF_INT16:
-        {
-          using ColType = int16_t;
-
-          ColType* d_in  = static_cast<ColType*>(h_cols_in[col_index]->data);
-          ColType* d_out = static_cast<ColType*>(h_cols_out[col_index]->data);
-          thrust::gather(thrust::device,
-                         d_indices, d_indices + nrows_new, //map of indices
-                         d_in,                             //source
-                         d_out);                           //=source[map]
-          break;
-        }
-      case GDF_INT32:
-        {
-          using ColType = int32_t;
-
-          ColType* d_in  = static_cast<ColType*>(h_cols_in[col_index]->data);
-          ColType* d_out = static_cast<ColType*>(h_cols_out[col_index]->data);
-          thrust::gather(thrust::device,
-                         d_indices, d_indices + nrows_new, //map of indices
-                         d_in,                             //source
-                         d_out);                           //=source[map]
-          break;
-        }
-      case GDF_INT64:
-        {
-          using ColType = int64_t;
-
-          ColType* d_in  = static_cast<ColType*>(h_cols_in[col_index]->data);
-          ColType* d_out = static_cast<ColType*>(h_cols_out[col_index]->data);
-          thrust::gather(thrust::device,
-                         d_indices, d_indices + nrows_new, //map of indices
-                         d_in,                             //source
-                         d_out);                           //=source[map]
-          break;
-        }
-      case GDF_FLOAT32:
-        {
-          using ColType = float;
-
-          ColType* d_in  = static_cast<ColType*>(h_cols_in[col_index]->data);
-          ColType* d_out = static_cast<ColType*>(h_cols_out[col_index]->data);
-          thrust::gather(thrust::device,
-                         d_indices, d_indices + nrows_new, //map of indices
-                         d_in,                             //source
-                         d_out);                           //=source[map]
-          break;
-        }
-      case GDF_FLOAT64:
-        {
-          using ColType = double;
-
-          ColType* d_in  = static_cast<ColType*>(h_cols_in[col_index]->data);
-          ColType* d_out = static_cast<ColType*>(h_cols_out[col_index]->data);
-          thrust::gather(thrust::device,
-                         d_indices, d_indices + nrows_new, //map of indices
-                         d_in,                             //source
-                         d_out);                           //=source[map]
-          break;
-        }
-
-      default:
-        assert( false );//type not handled
-      }
-    return;// State::True;
-  }
-
   //copy from a set of gdf_columns:    h_cols_in
   //of size (#ncols):                  ncols
   //to another set of columns        : h_cols_out
   //by gathering via array of indices: d_indices
   //of size:                           nrows_new
   //
-  void multi_gather_host(size_t ncols,  gdf_column** h_cols_in, gdf_column** h_cols_out, IndexT* d_indices, size_t nrows_new)
+  //(all the columns, and the validity of the output
+  // columns that have one, are gathered in one pass
+  // over d_indices)
+  //
+  template<typename IndexT>
+  gdf_error multi_gather_host(size_t ncols,  gdf_column** h_cols_in, gdf_column** h_cols_out, IndexT* d_indices, size_t nrows_new)
   {
     for(size_t col_index = 0; col_index<ncols; ++col_index)
       {
-        gdf_dtype col_type = h_cols_in[col_index]->dtype;
-        type_dispatcher(col_type,
-                        col_index,
-                        h_cols_in,
-                        h_cols_out,
-                        d_indices,
-                        nrows_new);
-
-        h_cols_out[col_index]->dtype = col_type;
+        h_cols_out[col_index]->dtype = h_cols_in[col_index]->dtype;
         h_cols_out[col_index]->size = nrows_new;
-        
-        //TODO: h_cols_out[col_index]->valid
       }
+
+    return gather_table(h_cols_in, h_cols_out, ncols, d_indices, nrows_new);
   }
 
   int dtype_size(gdf_dtype col_type)
@@ -262,6 +180,7 @@ namespace{ //annonymus
 //but it's nevessary because the gdf_column array is host
 //(even though its data slice is on device)
 //
+template<typename IndexT>
 gdf_error gdf_group_by_count(size_t nrows,     //in: # rows
                              gdf_column* cols, //in: host-side array of gdf_columns
                              size_t ncols,     //in: # cols
@@ -401,6 +320,7 @@ gdf_error gdf_group_by_count(size_t nrows,     //in: # rows
 //but it's necessary because the gdf_column array is host
 //(even though its data slice is on device)
 //
+template<typename IndexT>
 gdf_error gdf_group_by_sum(size_t nrows,     //in: # rows
                            gdf_column* cols, //in: host-side array of gdf_columns
                            size_t ncols,     //in: # cols
@@ -412,7 +332,8 @@ gdf_error gdf_group_by_sum(size_t nrows,     //in: # rows
                            gdf_column& agg_p, //out: reordering of d_agg after sorting; requires shallow (trivial) copy-construction (see static_assert below);
                            IndexT* d_kout,      //out: device-side array of rows after group-by
                            gdf_column& c_vout,//out: aggregated column; requires shallow (trivial) copy-construction (see static_assert below);
-                           size_t* new_sz)   //out: host-side # rows of d_count
+                           size_t* new_sz,   //out: host-side # rows of d_count
+                           bool compensated = false)//in: compensated, reproducible floating point sums (true) or not (false)
 {
   //not supported by g++-4.8:
   //
@@ -526,16 +447,28 @@ gdf_error gdf_group_by_sum(size_t nrows,     //in: # rows
         T* d_agg   = static_cast<T*>(agg_in.data);
         T* d_agg_p = static_cast<T*>(agg_p.data);
         T* d_vout  = static_cast<T*>(c_vout.data);
-        *new_sz = multi_col_group_by_sum_sort(nrows,
-                                              ncols,
-                                              d_cols,
-                                              d_types,
-                                              d_agg,
-                                              d_indx,
-                                              d_agg_p,
-                                              d_kout,
-                                              d_vout,
-                                              flag_sorted);
+        if( compensated )
+          *new_sz = multi_col_group_by_compensated_sum_sort(nrows,
+                                                            ncols,
+                                                            d_cols,
+                                                            d_types,
+                                                            d_agg,
+                                                            d_indx,
+                                                            d_agg_p,
+                                                            d_kout,
+                                                            d_vout,
+                                                            flag_sorted);
+        else
+          *new_sz = multi_col_group_by_sum_sort(nrows,
+                                                ncols,
+                                                d_cols,
+                                                d_types,
+                                                d_agg,
+                                                d_indx,
+                                                d_agg_p,
+                                                d_kout,
+                                                d_vout,
+                                                flag_sorted);
 	
         break;
       }
@@ -547,16 +480,28 @@ gdf_error gdf_group_by_sum(size_t nrows,     //in: # rows
         T* d_agg   = static_cast<T*>(agg_in.data);
         T* d_agg_p = static_cast<T*>(agg_p.data);
         T* d_vout  = static_cast<T*>(c_vout.data);
-        *new_sz = multi_col_group_by_sum_sort(nrows,
-                                              ncols,
-                                              d_cols,
-                                              d_types,
-                                              d_agg,
-                                              d_indx,
-                                              d_agg_p,
-                                              d_kout,
-                                              d_vout,
-                                              flag_sorted);
+        if( compensated )
+          *new_sz = multi_col_group_by_compensated_sum_sort(nrows,
+                                                            ncols,
+                                                            d_cols,
+                                                            d_types,
+                                                            d_agg,
+                                                            d_indx,
+                                                            d_agg_p,
+                                                            d_kout,
+                                                            d_vout,
+                                                            flag_sorted);
+        else
+          *new_sz = multi_col_group_by_sum_sort(nrows,
+                                                ncols,
+                                                d_cols,
+                                                d_types,
+                                                d_agg,
+                                                d_indx,
+                                                d_agg_p,
+                                                d_kout,
+                                                d_vout,
+                                                flag_sorted);
 	
         break;
       }
@@ -576,6 +521,7 @@ gdf_error gdf_group_by_sum(size_t nrows,     //in: # rows
 //but it's necessary because the gdf_column array is host
 //(even though its data slice is on device)
 //
+template<typename IndexT>
 gdf_error gdf_group_by_min(size_t nrows,     //in: # rows
                            gdf_column* cols, //in: host-side array of gdf_columns
                            size_t ncols,     //in: # cols
@@ -743,6 +689,7 @@ gdf_error gdf_group_by_min(size_t nrows,     //in: # rows
 //but it's necessary because the gdf_column array is host
 //(even though its data slice is on device)
 //
+template<typename IndexT>
 gdf_error gdf_group_by_max(size_t nrows,     //in: # rows
                            gdf_column* cols, //in: host-side array of gdf_columns
                            size_t ncols,     //in: # cols
@@ -909,6 +856,7 @@ gdf_error gdf_group_by_max(size_t nrows,     //in: # rows
 //but it's necessary because the gdf_column array is host
 //(even though its data slice is on device)
 //
+template<typename IndexT>
 gdf_error gdf_group_by_avg(size_t nrows,     //in: # rows
                            gdf_column* cols, //in: host-side array of gdf_columns
                            size_t ncols,     //in: # cols
@@ -921,7 +869,8 @@ gdf_error gdf_group_by_avg(size_t nrows,     //in: # rows
                            gdf_column& agg_p, //out: reordering of d_agg after sorting; requires shallow (trivial) copy-construction (see static_assert below);
                            IndexT* d_kout,      //out: device-side array of rows after gropu-by
                            gdf_column& c_vout,//out: aggregated column; requires shallow (trivial) copy-construction (see static_assert below);
-                           size_t* new_sz)   //out: host-side # rows of d_count
+                           size_t* new_sz,   //out: host-side # rows of d_count
+                           bool compensated = false)//in: compensated, reproducible floating point sums (true) or not (false)
 {
   //not supported by g++-4.8:
   //
@@ -1031,17 +980,30 @@ gdf_error gdf_group_by_avg(size_t nrows,     //in: # rows
         T* d_agg   = static_cast<T*>(agg_in.data);
         T* d_agg_p = static_cast<T*>(agg_p.data);
         T* d_vout  = static_cast<T*>(c_vout.data);
-        *new_sz = multi_col_group_by_avg_sort(nrows,
-                                              ncols,
-                                              d_cols,
-                                              d_types,
-                                              d_agg,
-                                              d_indx,
-                                              d_cout,
-                                              d_agg_p,
-                                              d_kout,
-                                              d_vout,
-                                              flag_sorted);
+        if( compensated )
+          *new_sz = multi_col_group_by_compensated_avg_sort(nrows,
+                                                            ncols,
+                                                            d_cols,
+                                                            d_types,
+                                                            d_agg,
+                                                            d_indx,
+                                                            d_cout,
+                                                            d_agg_p,
+                                                            d_kout,
+                                                            d_vout,
+                                                            flag_sorted);
+        else
+          *new_sz = multi_col_group_by_avg_sort(nrows,
+                                                ncols,
+                                                d_cols,
+                                                d_types,
+                                                d_agg,
+                                                d_indx,
+                                                d_cout,
+                                                d_agg_p,
+                                                d_kout,
+                                                d_vout,
+                                                flag_sorted);
 	
         break;
       }
@@ -1053,17 +1015,30 @@ gdf_error gdf_group_by_avg(size_t nrows,     //in: # rows
         T* d_agg   = static_cast<T*>(agg_in.data);
         T* d_agg_p = static_cast<T*>(agg_p.data);
         T* d_vout  = static_cast<T*>(c_vout.data);
-        *new_sz = multi_col_group_by_avg_sort(nrows,
-                                              ncols,
-                                              d_cols,
-                                              d_types,
-                                              d_agg,
-                                              d_indx,
-                                              d_cout,
-                                              d_agg_p,
-                                              d_kout,
-                                              d_vout,
-                                              flag_sorted);
+        if( compensated )
+          *new_sz = multi_col_group_by_compensated_avg_sort(nrows,
+                                                            ncols,
+                                                            d_cols,
+                                                            d_types,
+                                                            d_agg,
+                                                            d_indx,
+                                                            d_cout,
+                                                            d_agg_p,
+                                                            d_kout,
+                                                            d_vout,
+                                                            flag_sorted);
+        else
+          *new_sz = multi_col_group_by_avg_sort(nrows,
+                                                ncols,
+                                                d_cols,
+                                                d_types,
+                                                d_agg,
+                                                d_indx,
+                                                d_cout,
+                                                d_agg_p,
+                                                d_kout,
+                                                d_vout,
+                                                flag_sorted);
 	
         break;
       }
@@ -1075,6 +1050,213 @@ gdf_error gdf_group_by_avg(size_t nrows,     //in: # rows
   return GDF_SUCCESS;
 }
 
+//sort-based group-by, with row indices of type IndexT
+//
+template<typename IndexT>
+gdf_error gdf_group_by_sort(int ncols,                    // # columns
+                            gdf_column** cols,            //input cols
+                            gdf_column* col_agg,          //column to aggregate on
+                            gdf_column* out_col_indices,  //if not null return indices of re-ordered rows (size_t)
+                            gdf_column** out_col_values,  //if not null return the grouped-by columns
+                            gdf_column* out_col_agg,      //aggregation result
+                            gdf_context* ctxt,            //struct with additional info: bool is_sorted, flag_sort_or_hash, bool flag_count_distinct
+                            gdf_agg_op op)                //aggregation operation
+{
+  gdf_error gdf_error_code{GDF_SUCCESS};
+
+  std::vector<gdf_column> v_cols(ncols);
+  for(auto i = 0; i < ncols; ++i)
+    {
+      v_cols[i] = *(cols[i]);
+    }
+  
+  gdf_column* h_columns = &v_cols[0];
+  size_t nrows = h_columns[0].size;
+
+  size_t n_group = 0;
+
+  Vector<IndexT> d_indx;//allocate only if necessary (see below)
+  Vector<void*> d_cols(ncols, nullptr);
+  Vector<int>   d_types(ncols, 0);
+
+  void** d_col_data = d_cols.data().get();
+  int* d_col_types = d_types.data().get();
+
+  //out_col_indices holds size_t indices; narrower ones are
+  //computed in d_indx and widened at the end:
+  //
+  const bool direct_out_indices = (nullptr != out_col_indices) && std::is_same<IndexT, size_t>::value;
+
+  IndexT* ptr_d_indx = nullptr;
+  if( direct_out_indices )
+    ptr_d_indx = static_cast<IndexT*>(out_col_indices->data);
+  else
+    {
+      d_indx.resize(nrows);
+      ptr_d_indx = d_indx.data().get();
+    }
+
+  Vector<IndexT> d_sort(nrows, 0);
+  IndexT* ptr_d_sort = d_sort.data().get();
+
+  //order the rows up front with the radix engine, so that the
+  //reduce_by_key below runs on pre-sorted indices:
+  //
+  int flag_sorted = 1;
+  if( ctxt->flag_sorted )
+    thrust::sequence(thrust::device, d_sort.begin(), d_sort.end(), 0);
+  else
+    {
+      gdf_error_code = radix_order_by(nrows, h_columns, static_cast<size_t>(ncols),
+                                      nullptr, nullptr, ptr_d_sort);
+      if( gdf_error_code == GDF_UNSUPPORTED_DTYPE )
+        {
+          flag_sorted = 0;//fall back to comparison sort
+          gdf_error_code = GDF_SUCCESS;
+        }
+      else if( gdf_error_code != GDF_SUCCESS )
+        {
+          return gdf_error_code;
+        }
+    }
+  
+  gdf_column c_agg_p;
+  c_agg_p.dtype = col_agg->dtype;
+  c_agg_p.size = nrows;
+  Vector<char> d_agg_p(nrows * dtype_size(c_agg_p.dtype));//purpose: avoids a switch-case on type;
+  c_agg_p.data = d_agg_p.data().get();
+
+  switch( op )
+    {
+    case GDF_SUM:
+      gdf_group_by_sum(nrows,
+                       h_columns,
+                       static_cast<size_t>(ncols),
+                       flag_sorted,
+                       *col_agg,
+                       d_col_data, //allocated
+                       d_col_types,//allocated
+                       ptr_d_sort, //allocated
+                       c_agg_p,    //allocated
+                       ptr_d_indx, //allocated (or, passed in)
+                       *out_col_agg,
+                       &n_group,
+                       1 == ctxt->flag_reproducible_sum);
+      break;
+      
+    case GDF_MIN:
+      gdf_group_by_min(nrows,
+                       h_columns,
+                       static_cast<size_t>(ncols),
+                       flag_sorted,
+                       *col_agg,
+                       d_col_data, //allocated
+                       d_col_types,//allocated
+                       ptr_d_sort, //allocated
+                       c_agg_p,    //allocated
+                       ptr_d_indx, //allocated (or, passed in)
+                       *out_col_agg,
+                       &n_group);
+      break;
+
+    case GDF_MAX:
+      gdf_group_by_max(nrows,
+                       h_columns,
+                       static_cast<size_t>(ncols),
+                       flag_sorted,
+                       *col_agg,
+                       d_col_data, //allocated
+                       d_col_types,//allocated
+                       ptr_d_sort, //allocated
+                       c_agg_p,    //allocated
+                       ptr_d_indx, //allocated (or, passed in)
+                       *out_col_agg,
+                       &n_group);
+      break;
+
+    case GDF_AVG:
+      {
+        Vector<IndexT> d_cout(nrows, 0);
+        IndexT* ptr_d_cout = d_cout.data().get();
+        
+        gdf_group_by_avg(nrows,
+                         h_columns,
+                         static_cast<size_t>(ncols),
+                         flag_sorted,
+                         *col_agg,
+                         d_col_data, //allocated
+                         d_col_types,//allocated
+                         ptr_d_sort, //allocated
+                         ptr_d_cout, //allocated
+                         c_agg_p,    //allocated
+                         ptr_d_indx, //allocated (or, passed in)
+                         *out_col_agg,
+                         &n_group,
+                         1 == ctxt->flag_reproducible_sum);
+      }
+      break;
+    case GDF_COUNT_DISTINCT:
+      {
+        assert( out_col_agg );
+        assert( out_col_agg->size >= 1);
+
+        gdf_group_by_count(nrows,
+                           h_columns,
+                           static_cast<size_t>(ncols),
+                           flag_sorted,
+                           d_col_data, //allocated
+                           d_col_types,//allocated
+                           ptr_d_sort, //allocated
+                           ptr_d_indx, //allocated (or, passed in)
+                           *out_col_agg, //passed in
+                           &n_group,
+                           true);
+        
+      }
+      break;
+    case GDF_COUNT:
+      {
+        assert( out_col_agg );
+
+        gdf_group_by_count(nrows,
+                           h_columns,
+                           static_cast<size_t>(ncols),
+                           flag_sorted,
+                           d_col_data, //allocated
+                           d_col_types,//allocated
+                           ptr_d_sort, //allocated
+                           ptr_d_indx, //allocated (or, passed in)
+                           *out_col_agg, //passed in
+                           &n_group);
+        
+      }
+      break;
+    default: // To eliminate error for unhandled enumerant N_GDF_AGG_OPS
+      gdf_error_code = GDF_INVALID_API_CALL;
+    }
+
+  if( out_col_values )
+    {
+      gdf_error gather_error = multi_gather_host(ncols, cols, out_col_values, ptr_d_indx, n_group);
+      if( GDF_SUCCESS == gdf_error_code )
+        gdf_error_code = gather_error;
+    }
+
+  out_col_agg->size = n_group;
+  if( out_col_indices )
+    {
+      if( !direct_out_indices )
+        thrust::copy(thrust::device,
+                     ptr_d_indx, ptr_d_indx + n_group,
+                     static_cast<size_t*>(out_col_indices->data));
+      out_col_indices->size = n_group;
+    }
+
+  //TODO: out_<col>->valid = ?????
+
+  return gdf_error_code;
+}
+
 gdf_error gdf_group_by_single(int ncols,                    // # columns
                               gdf_column** cols,            //input cols
                               gdf_column* col_agg,          //column to aggregate on
@@ -1093,6 +1275,11 @@ gdf_error gdf_group_by_single(int ncols,                    // # columns
   {
     return GDF_DATASET_EMPTY;
   }
+
+  //not sorted unless the groupby succeeds, as for the join:
+  //
+  ctxt->flag_output_sorted = 0;
+
   for (int i = 0; i < ncols; ++i) {
 	GDF_REQUIRE(!cols[i]->valid, GDF_VALIDITY_UNSUPPORTED);
   }
@@ -1123,164 +1310,30 @@ gdf_error gdf_group_by_single(int ncols,                    // # columns
   gdf_error gdf_error_code{GDF_SUCCESS};
   
   PUSH_RANGE("LIBGDF_GROUPBY", GROUPBY_COLOR);
-  
-  if( ctxt->flag_method == GDF_SORT )
-    {
-      std::vector<gdf_column> v_cols(ncols);
-      for(auto i = 0; i < ncols; ++i)
-        {
-          v_cols[i] = *(cols[i]);
-        }
-      
-      gdf_column* h_columns = &v_cols[0];
-      size_t nrows = h_columns[0].size;
 
-      size_t n_group = 0;
-
-      Vector<IndexT> d_indx;//allocate only if necessary (see below)
-      Vector<void*> d_cols(ncols, nullptr);
-      Vector<int>   d_types(ncols, 0);
+  //the hash-based SUM and AVG accumulate with atomics, in no fixed order:
+  //reproducible floating point sums take the sort-based path
+  //
+  gdf_method method = ctxt->flag_method;
+  if( (1 == ctxt->flag_reproducible_sum)
+      && (op == GDF_SUM || op == GDF_AVG)
+      && (col_agg->dtype == GDF_FLOAT32 || col_agg->dtype == GDF_FLOAT64) )
+    method = GDF_SORT;
   
-      void** d_col_data = d_cols.data().get();
-      int* d_col_types = d_types.data().get();
-
-      IndexT* ptr_d_indx = nullptr;
-      if( out_col_indices )
-        ptr_d_indx = static_cast<IndexT*>(out_col_indices->data);
+  if( method == GDF_SORT )
+    {
+      //32-bit row indices unless there are too many rows:
+      //
+      if( use_int32_index(cols[0]->size) )
+        gdf_error_code = gdf_group_by_sort<int32_t>(ncols, cols, col_agg,
+                                                    out_col_indices, out_col_values,
+                                                    out_col_agg, ctxt, op);
       else
-        {
-          d_indx.resize(nrows);
-          ptr_d_indx = d_indx.data().get();
-        }
-
-      Vector<IndexT> d_sort(nrows, 0);
-      IndexT* ptr_d_sort = d_sort.data().get();
-      
-      gdf_column c_agg_p;
-      c_agg_p.dtype = col_agg->dtype;
-      c_agg_p.size = nrows;
-      Vector<char> d_agg_p(nrows * dtype_size(c_agg_p.dtype));//purpose: avoids a switch-case on type;
-      c_agg_p.data = d_agg_p.data().get();
-
-      switch( op )
-        {
-        case GDF_SUM:
-          gdf_group_by_sum(nrows,
-                           h_columns,
-                           static_cast<size_t>(ncols),
-                           ctxt->flag_sorted,
-                           *col_agg,
-                           d_col_data, //allocated
-                           d_col_types,//allocated
-                           ptr_d_sort, //allocated
-                           c_agg_p,    //allocated
-                           ptr_d_indx, //allocated (or, passed in)
-                           *out_col_agg,
-                           &n_group);
-          break;
-          
-        case GDF_MIN:
-          gdf_group_by_min(nrows,
-                           h_columns,
-                           static_cast<size_t>(ncols),
-                           ctxt->flag_sorted,
-                           *col_agg,
-                           d_col_data, //allocated
-                           d_col_types,//allocated
-                           ptr_d_sort, //allocated
-                           c_agg_p,    //allocated
-                           ptr_d_indx, //allocated (or, passed in)
-                           *out_col_agg,
-                           &n_group);
-          break;
-
-        case GDF_MAX:
-          gdf_group_by_max(nrows,
-                           h_columns,
-                           static_cast<size_t>(ncols),
-                           ctxt->flag_sorted,
-                           *col_agg,
-                           d_col_data, //allocated
-                           d_col_types,//allocated
-                           ptr_d_sort, //allocated
-                           c_agg_p,    //allocated
-                           ptr_d_indx, //allocated (or, passed in)
-                           *out_col_agg,
-                           &n_group);
-          break;
-
-        case GDF_AVG:
-          {
-            Vector<IndexT> d_cout(nrows, 0);
-            IndexT* ptr_d_cout = d_cout.data().get();
-            
-            gdf_group_by_avg(nrows,
-                             h_columns,
-                             static_cast<size_t>(ncols),
-                             ctxt->flag_sorted,
-                             *col_agg,
-                             d_col_data, //allocated
-                             d_col_types,//allocated
-                             ptr_d_sort, //allocated
-                             ptr_d_cout, //allocated
-                             c_agg_p,    //allocated
-                             ptr_d_indx, //allocated (or, passed in)
-                             *out_col_agg,
-                             &n_group);
-          }
-          break;
-        case GDF_COUNT_DISTINCT:
-          {
-            assert( out_col_agg );
-            assert( out_col_agg->size >= 1);
-
-            gdf_group_by_count(nrows,
-                               h_columns,
-                               static_cast<size_t>(ncols),
-                               ctxt->flag_sorted,
-                               d_col_data, //allocated
-                               d_col_types,//allocated
-                               ptr_d_sort, //allocated
-                               ptr_d_indx, //allocated (or, passed in)
-                               *out_col_agg, //passed in
-                               &n_group,
-                               true);
-            
-          }
-          break;
-        case GDF_COUNT:
-          {
-            assert( out_col_agg );
-
-            gdf_group_by_count(nrows,
-                               h_columns,
-                               static_cast<size_t>(ncols),
-                               ctxt->flag_sorted,
-                               d_col_data, //allocated
-                               d_col_types,//allocated
-                               ptr_d_sort, //allocated
-                               ptr_d_indx, //allocated (or, passed in)
-                               *out_col_agg, //passed in
-                               &n_group);
-            
-          }
-          break;
-        default: // To eliminate error for unhandled enumerant N_GDF_AGG_OPS
-          gdf_error_code = GDF_INVALID_API_CALL;
-        }
-
-      if( out_col_values )
-        {
-          multi_gather_host(ncols, cols, out_col_values, ptr_d_indx, n_group);
-        }
-
-      out_col_agg->size = n_group;
-      if( out_col_indices )
-        out_col_indices->size = n_group;
-
-      //TODO: out_<col>->valid = ?????
+        gdf_error_code = gdf_group_by_sort<size_t>(ncols, cols, col_agg,
+                                                   out_col_indices, out_col_values,
+                                                   out_col_agg, ctxt, op);
     }
-  else if( ctxt->flag_method == GDF_HASH )
+  else if( method == GDF_HASH )
     {
 
       bool sort_result = false;
@@ -1350,37 +1403,140 @@ gdf_error gdf_group_by_single(int ncols,                    // # columns
       gdf_error_code = GDF_UNSUPPORTED_METHOD;
     }
 
+  //the groups come out in key order from the sort-based groupby,
+  //and from the hash-based one when asked to sort its result:
+  //
+  if( gdf_error_code == GDF_SUCCESS )
+    ctxt->flag_output_sorted = (method == GDF_SORT) || (1 == ctxt->flag_sort_result);
+
   POP_RANGE();
   
   return gdf_error_code;
 }
 }//end unknown namespace
 
-//apparent duplication of info between
-//gdf_column array and two arrays:
-//           d_cols = data slice of gdf_column array;
-//           d_types = dtype slice of gdf_column array;
-//but it's nevessary because the gdf_column array is host
-//(even though its data slice is on device)
+//d_cols and d_types are no longer filled: the radix sort
+//reads the data and dtype of each column from cols
 //
 gdf_error gdf_order_by(size_t nrows,     //in: # rows
                        gdf_column* cols, //in: host-side array of gdf_columns
                        size_t ncols,     //in: # cols
-                       void** d_cols,    //out: pre-allocated device-side array to be filled with gdf_column::data for each column; slicing of gdf_column array (host)
-                       int* d_types,     //out: pre-allocated device-side array to be filled with gdf_colum::dtype for each column; slicing of gdf_column array (host)
+                       void** d_cols,    //in: ignored, kept for compatibility; may be NULL
+                       int* d_types,     //in: ignored, kept for compatibility; may be NULL
                        size_t* d_indx)   //out: device-side array of re-rdered row indices
 {
-  //copy H-D:
+  return radix_order_by_compact(nrows,
+                                cols,
+                                ncols,
+                                nullptr,//all ascending
+                                nullptr,//all NULLS LAST
+                                d_indx);
+}
+
+//same as gdf_order_by, with a per-column sort direction
+//and placement of NULLs (either array may be NULL for the defaults:
+//ascending, NULLS LAST)
+//
+gdf_error gdf_order_by_asc_desc(size_t nrows,                //in: # rows
+                                gdf_column* cols,            //in: host-side array of gdf_columns
+                                size_t ncols,                //in: # cols
+                                order_by_type* asc_desc,     //in: host-side array of per-column sort direction
+                                null_order_type* null_order, //in: host-side array of per-column NULL placement
+                                size_t* d_indx)              //out: device-side array of re-rdered row indices
+{
+  return radix_order_by_compact(nrows,
+                                cols,
+                                ncols,
+                                asc_desc,
+                                null_order,
+                                d_indx);
+}
+
+//key-only argsort: the permutation is written to a column of
+//GDF_INT32 (tables with fewer than 2^31 rows) or GDF_INT64 indices
+//
+gdf_error gdf_argsort(size_t nrows,                //in: # rows
+                      gdf_column* cols,            //in: host-side array of gdf_columns
+                      size_t ncols,                //in: # cols
+                      order_by_type* asc_desc,     //in: host-side array of per-column sort direction
+                      null_order_type* null_order, //in: host-side array of per-column NULL placement
+                      gdf_column* out_indices)     //out: column of nrows re-ordered row indices
+{
+  GDF_REQUIRE(nullptr != out_indices && nullptr != out_indices->data, GDF_DATASET_EMPTY);
+  GDF_REQUIRE(out_indices->size == nrows, GDF_COLUMN_SIZE_MISMATCH);
+
+  switch( out_indices->dtype )
+    {
+    case GDF_INT32:
+      GDF_REQUIRE(use_int32_index(nrows), GDF_COLUMN_SIZE_TOO_BIG);
+      return radix_order_by(nrows, cols, ncols, asc_desc, null_order,
+                            static_cast<int32_t*>(out_indices->data));
+    case GDF_INT64:
+      return radix_order_by_compact(nrows, cols, ncols, asc_desc, null_order,
+                                    static_cast<int64_t*>(out_indices->data));
+    default:
+      return GDF_UNSUPPORTED_DTYPE;
+    }
+}
+
+//checks whether the rows are already in the order of
+//gdf_order_by_asc_desc (ties allowed), e.g. to set
+//gdf_context::flag_sorted and skip the sort of a groupby
+//
+gdf_error gdf_is_sorted(size_t nrows,                //in: # rows
+                        gdf_column* cols,            //in: host-side array of gdf_columns
+                        size_t ncols,                //in: # cols
+                        order_by_type* asc_desc,     //in: host-side array of per-column sort direction
+                        null_order_type* null_order, //in: host-side array of per-column NULL placement
+                        int* is_sorted)              //out: host-side 1 if sorted, else 0
+{
+  GDF_REQUIRE(nullptr != cols && nullptr != is_sorted, GDF_DATASET_EMPTY);
+
+  bool sorted = false;
+  gdf_error status = use_int32_index(nrows)
+    ? rows_are_sorted<int32_t>(nrows, cols, ncols, asc_desc, null_order, sorted)
+    : rows_are_sorted<int64_t>(nrows, cols, ncols, asc_desc, null_order, sorted);
+  if( status != GDF_SUCCESS )
+    return status;
+
+  *is_sorted = sorted ? 1 : 0;
+  return GDF_SUCCESS;
+}
+
+//ORDER BY ... LIMIT k: the first k row indices of
+//gdf_order_by_asc_desc, without sorting the whole table
+//
+gdf_error gdf_top_k(size_t nrows,                //in: # rows
+                    gdf_column* cols,            //in: host-side array of gdf_columns
+                    size_t ncols,                //in: # cols
+                    order_by_type* asc_desc,     //in: host-side array of per-column sort direction
+                    null_order_type* null_order, //in: host-side array of per-column NULL placement
+                    size_t k,                    //in: # rows to return
+                    size_t* d_indx)              //out: device-side array of min(k, nrows) row indices
+{
+  if( !use_int32_index(nrows) )
+    return radix_top_k(nrows,
+                       cols,
+                       ncols,
+                       asc_desc,
+                       null_order,
+                       k,
+                       d_indx);
+
+  //select and sort 32-bit indices, widen the k results:
   //
-  GDF_REQUIRE(!cols->valid, GDF_VALIDITY_UNSUPPORTED);
-  soa_col_info(cols, ncols, d_cols, d_types);
-  
-  multi_col_order_by(nrows,
-                     ncols,
-                     d_cols,
-                     d_types,
-                     d_indx);
-  
+  Vector<int32_t> d_indx32(std::min(k, nrows));
+  gdf_error status = radix_top_k(nrows,
+                                 cols,
+                                 ncols,
+                                 asc_desc,
+                                 null_order,
+                                 k,
+                                 d_indx32.data().get());
+  if( status != GDF_SUCCESS )
+    return status;
+
+  thrust::copy(thrust::device, d_indx32.begin(), d_indx32.end(), d_indx);
   return GDF_SUCCESS;
 }
 
@@ -1416,6 +1572,38 @@ gdf_error gdf_filter(size_t nrows,     //in: # rows
   return GDF_SUCCESS;
 }
 
+//materializes the rows selected by gdf_order_by, gdf_argsort,
+//gdf_top_k or gdf_filter: out_cols[j][i] = in_cols[j][map[i]]
+//for all the columns, and their validity, in one pass over
+//the map (the size_t indices of gdf_order_by and gdf_filter
+//are passed as a GDF_INT64 column)
+//
+gdf_error gdf_gather_table(gdf_column** in_cols,   //in: host-side array of ncols input columns
+                           gdf_column** out_cols,  //out: host-side array of ncols pre-allocated columns of gather_map->size rows
+                           size_t ncols,           //in: # cols
+                           gdf_column* gather_map) //in: row indices into in_cols; dtype GDF_INT32 or GDF_INT64
+{
+  GDF_REQUIRE(nullptr != in_cols && nullptr != out_cols && nullptr != gather_map, GDF_DATASET_EMPTY);
+
+  for(size_t j = 0; j < ncols; ++j)
+    {
+      GDF_REQUIRE(in_cols[j]->dtype == out_cols[j]->dtype, GDF_DTYPE_MISMATCH);
+      GDF_REQUIRE(out_cols[j]->size >= gather_map->size, GDF_COLUMN_SIZE_MISMATCH);
+    }
+
+  switch( gather_map->dtype )
+    {
+    case GDF_INT32:
+      return gather_table(in_cols, out_cols, ncols,
+                          static_cast<int32_t const*>(gather_map->data), gather_map->size);
+    case GDF_INT64:
+      return gather_table(in_cols, out_cols, ncols,
+                          static_cast<int64_t const*>(gather_map->data), gather_map->size);
+    default:
+      return GDF_UNSUPPORTED_DTYPE;
+    }
+}
+
 gdf_error gdf_group_by_sum(int ncols,                    // # columns
                            gdf_column** cols,            //input cols
                            gdf_column* col_agg,          //column to aggregate on
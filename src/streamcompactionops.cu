@@ -37,6 +37,9 @@
 //std lib
 #include <map>
 
+#include "gather/table_gather.cuh"
+#include "util/exec_context.h"
+
 //wow the freaking example from iterator_adaptpr, what a break right!
 template<typename Iterator>
 class repeat_iterator
@@ -199,6 +202,11 @@ std::map<gdf_dtype, int16_t> column_type_width = {{GDF_INT8, sizeof(int8_t)}, {G
 //TODO: add a way for the space where we store temp bitmaps for compaction be allocated
 //on the outside
 gdf_error gpu_apply_stencil(gdf_column *lhs, gdf_column * stencil, gdf_column * output){
+	return gpu_apply_stencil_async(lhs, stencil, output, nullptr);
+}
+
+gdf_error gpu_apply_stencil_async(gdf_column *lhs, gdf_column * stencil, gdf_column * output, gdf_exec_context context){
+	GDF_REQUIRE(nullptr == gdf::util::exec_host(context), GDF_UNSUPPORTED_METHOD);
 	//OK: add a rquire here that output and lhs are the same size
 	GDF_REQUIRE(output->size == lhs->size, GDF_COLUMN_SIZE_MISMATCH);
 	GDF_REQUIRE(lhs->dtype == output->dtype, GDF_DTYPE_MISMATCH);
@@ -211,8 +219,8 @@ gdf_error gpu_apply_stencil(gdf_column *lhs, gdf_column * stencil, gdf_column *
 	searched_item = column_type_width.find(stencil->dtype);
 	int16_t stencil_width= searched_item->second; //width in bytes
 
-	cudaStream_t stream;
-	cudaStreamCreate(&stream);
+	//the stream of the context, rather than one created and destroyed on every call
+	cudaStream_t stream = gdf::util::exec_stream(context);
 
 	size_t n_bytes = get_number_of_bytes_for_valid(stencil->size);
 
@@ -320,14 +328,102 @@ gdf_error gpu_apply_stencil(gdf_column *lhs, gdf_column * stencil, gdf_column *
 	thrust::transform(thrust::cuda::par.on(stream), valid_bit_mask_group_8_iter, valid_bit_mask_group_8_iter + ((num_values + GDF_VALID_BITSIZE - 1) / GDF_VALID_BITSIZE),
 			thrust::detail::make_normal_iterator(thrust::device_pointer_cast(output->valid)),bit_mask_pack_op());
 
-	cudaStreamSynchronize(stream);
-
-	cudaStreamDestroy(stream);
+	CUDA_CHECK_LAST();
 
 	return GDF_SUCCESS;
 
 } 
 
+//whether the bit of a row is set in a packed stencil, a bitmask like the ones
+//written by gdf_comparison_mask
+struct is_mask_bit_set : public thrust::unary_function<gdf_size_type,bool>
+{
+	gdf_valid_type const * stencil;
+
+	is_mask_bit_set(gdf_valid_type const * stencil) : stencil(stencil) {}
+
+	__host__ __device__
+	bool operator()(gdf_size_type row) const
+	{
+		return gdf_is_valid(stencil, row);
+	}
+};
+
+template <typename T>
+gdf_size_type copy_if_mask_bit_set(void const * in, gdf_size_type size, gdf_valid_type const * stencil, void * out,
+                                   cudaStream_t stream){
+	T const * input_start = static_cast<T const *>(in);
+	T * output_start = static_cast<T *>(out);
+	T * output_end = thrust::copy_if(thrust::cuda::par.on(stream), input_start, input_start + size,
+			thrust::make_counting_iterator<gdf_size_type>(0), output_start, is_mask_bit_set(stencil));
+	return output_end - output_start;
+}
+
+//takes a packed stencil, one bit per row, and compacts a column with it. Unlike gpu_apply_stencil
+//the stencil is read in place, with no int8 stencil column nor bit position iterators, and the
+//validity of lhs is compacted along with its values
+gdf_error gpu_apply_stencil_mask(gdf_column *lhs, gdf_valid_type const * stencil, gdf_column * output){
+	return gpu_apply_stencil_mask_async(lhs, stencil, output, nullptr);
+}
+
+gdf_error gpu_apply_stencil_mask_async(gdf_column *lhs, gdf_valid_type const * stencil, gdf_column * output,
+                                       gdf_exec_context context){
+	GDF_REQUIRE(nullptr == gdf::util::exec_host(context), GDF_UNSUPPORTED_METHOD);
+	GDF_REQUIRE(nullptr != lhs && nullptr != output && nullptr != stencil, GDF_DATASET_EMPTY);
+	GDF_REQUIRE(output->size == lhs->size, GDF_COLUMN_SIZE_MISMATCH);
+	GDF_REQUIRE(lhs->dtype == output->dtype, GDF_DTYPE_MISMATCH);
+	GDF_REQUIRE(!lhs->valid || output->valid, GDF_VALIDITY_MISSING);
+
+	auto searched_item = column_type_width.find(lhs->dtype);
+	GDF_REQUIRE(searched_item != column_type_width.end(), GDF_UNSUPPORTED_DTYPE);
+	int16_t width = searched_item->second; //width in bytes
+	cudaStream_t stream = gdf::util::exec_stream(context);
+
+	//NOTE: as for gpu_apply_stencil, output->size is set to the number of rows kept but the
+	//allocation is not compacted
+	if(!lhs->valid){
+		gdf_size_type count = 0;
+		if(width == 1){
+			count = copy_if_mask_bit_set<int8_t>(lhs->data, lhs->size, stencil, output->data, stream);
+		}else if(width == 2){
+			count = copy_if_mask_bit_set<int16_t>(lhs->data, lhs->size, stencil, output->data, stream);
+		}else if(width == 4){
+			count = copy_if_mask_bit_set<int32_t>(lhs->data, lhs->size, stencil, output->data, stream);
+		}else if(width == 8){
+			count = copy_if_mask_bit_set<int64_t>(lhs->data, lhs->size, stencil, output->data, stream);
+		}
+		CUDA_CHECK_LAST();
+		output->size = count;
+		output->null_count = 0;
+		return GDF_SUCCESS;
+	}
+
+	//with nulls, the rows kept are gathered, values and validity at once
+	thrust::device_vector<gdf_size_type> gather_map(lhs->size);
+	auto map_end = thrust::copy_if(thrust::cuda::par.on(stream),
+			thrust::make_counting_iterator<gdf_size_type>(0),
+			thrust::make_counting_iterator<gdf_size_type>(lhs->size),
+			gather_map.begin(), is_mask_bit_set(stencil));
+	const gdf_size_type count = map_end - gather_map.begin();
+
+	gdf_column const * in_cols[] = {lhs};
+	gdf_column * out_cols[] = {output};
+	gdf_error status = gather_table<gdf_size_type>(in_cols, out_cols, 1, gather_map.data().get(), count,
+	                                               false, stream);
+	if(status != GDF_SUCCESS)
+		return status;
+	//the nulls are counted on another stream, once the gather is done
+	CUDA_TRY( cudaStreamSynchronize(stream) );
+
+	int valid_count = 0;
+	status = gdf_count_nonzero_mask(output->valid, count, &valid_count);
+	if(status != GDF_SUCCESS)
+		return status;
+	output->size = count;
+	output->null_count = count - valid_count;
+	return GDF_SUCCESS;
+}
+
 size_t  get_last_byte_length(size_t column_size) {
     size_t n_bytes = get_number_of_bytes_for_valid(column_size);
     size_t length = column_size - GDF_VALID_BITSIZE * (n_bytes - 1);
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrust/device_vector.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/cffi/functions.h>
+
+#include "gtest/gtest.h"
+
+template<typename T>
+using Vector = thrust::device_vector<T>;
+
+struct ExecContextTest : public ::testing::Test
+{
+  static constexpr size_t n = 100003;
+
+  std::vector<int64_t> h_a;
+  std::vector<double> h_b;
+  Vector<int64_t> d_a;
+  Vector<double> d_b;
+  gdf_column host_a, host_b, device_a, device_b;
+
+  void SetUp() override
+  {
+    std::mt19937 rng(75);
+    h_a.resize(n); h_b.resize(n);
+    for(size_t i = 0; i < n; ++i)
+    {
+      h_a[i] = static_cast<int64_t>(rng() % 201) - 100;
+      h_b[i] = static_cast<double>(rng() % 2001) / 10 - 100;
+    }
+    d_a = h_a; d_b = h_b;
+
+    gdf_column_view(&host_a, h_a.data(), nullptr, n, GDF_INT64);
+    gdf_column_view(&host_b, h_b.data(), nullptr, n, GDF_FLOAT64);
+    gdf_column_view(&device_a, d_a.data().get(), nullptr, n, GDF_INT64);
+    gdf_column_view(&device_b, d_b.data().get(), nullptr, n, GDF_FLOAT64);
+  }
+};
+
+TEST_F(ExecContextTest, DeviceAndHostContextsAgree)
+{
+  const size_t bytes = gdf_get_num_chars_bitmask(n);
+  gdf_exec_context device, host;
+  ASSERT_EQ(GDF_SUCCESS, gdf_exec_context_create(&device));
+  ASSERT_EQ(GDF_SUCCESS, gdf_exec_context_create_host(&host, 0));
+
+  // a < b and not a == 0, queued without waiting on either context
+  Vector<gdf_valid_type> d_lt(bytes), d_eq(bytes);
+  std::vector<gdf_valid_type> h_lt(bytes), h_eq(bytes);
+  gdf_scalar zero{};
+  zero.data.si64 = 0;
+  zero.dtype = GDF_INT64;
+
+  ASSERT_EQ(GDF_SUCCESS, gdf_comparison_mask_async(&device_a, &device_b, GDF_LESS_THAN, d_lt.data().get(), device));
+  ASSERT_EQ(GDF_SUCCESS, gdf_comparison_static_mask_async(&device_a, &zero, GDF_EQUALS, d_eq.data().get(), device));
+  ASSERT_EQ(GDF_SUCCESS, gdf_mask_not_async(d_eq.data().get(), d_eq.data().get(), n, device));
+  ASSERT_EQ(GDF_SUCCESS, gdf_mask_and_async(d_lt.data().get(), d_eq.data().get(), d_lt.data().get(), n, device));
+
+  ASSERT_EQ(GDF_SUCCESS, gdf_comparison_mask_async(&host_a, &host_b, GDF_LESS_THAN, h_lt.data(), host));
+  ASSERT_EQ(GDF_SUCCESS, gdf_comparison_static_mask_async(&host_a, &zero, GDF_EQUALS, h_eq.data(), host));
+  ASSERT_EQ(GDF_SUCCESS, gdf_mask_not_async(h_eq.data(), h_eq.data(), n, host));
+  ASSERT_EQ(GDF_SUCCESS, gdf_mask_and_async(h_lt.data(), h_eq.data(), h_lt.data(), n, host));
+
+  gdf_exec_event device_done, host_done;
+  ASSERT_EQ(GDF_SUCCESS, gdf_exec_event_record(device, &device_done));
+  ASSERT_EQ(GDF_SUCCESS, gdf_exec_event_record(host, &host_done));
+  ASSERT_EQ(GDF_SUCCESS, gdf_exec_event_synchronize(device_done));
+  ASSERT_EQ(GDF_SUCCESS, gdf_exec_event_synchronize(host_done));
+
+  int done = 0;
+  ASSERT_EQ(GDF_SUCCESS, gdf_exec_event_query(host_done, &done));
+  EXPECT_EQ(1, done);
+
+  std::vector<gdf_valid_type> actual(bytes);
+  thrust::copy(d_lt.begin(), d_lt.end(), actual.begin());
+  EXPECT_EQ(h_lt, actual);
+  for(size_t i = 0; i < n; ++i)
+    ASSERT_EQ(h_a[i] < h_b[i] && h_a[i] != 0, gdf_is_valid(h_lt.data(), i)) << "row " << i;
+
+  // A binary operator needs device columns
+  Vector<double> d_sum(n);
+  gdf_column sum{};
+  gdf_column_view(&sum, d_sum.data().get(), nullptr, n, GDF_FLOAT64);
+  EXPECT_EQ(GDF_UNSUPPORTED_METHOD, gdf_binary_op_async(&device_a, &device_b, &sum, GDF_BINARY_ADD, host));
+  ASSERT_EQ(GDF_SUCCESS, gdf_binary_op_async(&device_a, &device_b, &sum, GDF_BINARY_ADD, device));
+  ASSERT_EQ(GDF_SUCCESS, gdf_exec_context_synchronize(device));
+  std::vector<double> h_sum(n);
+  thrust::copy(d_sum.begin(), d_sum.end(), h_sum.begin());
+  for(size_t i = 0; i < n; ++i)
+    ASSERT_EQ(h_a[i] + h_b[i], h_sum[i]) << "row " << i;
+
+  EXPECT_EQ(GDF_SUCCESS, gdf_exec_event_destroy(device_done));
+  EXPECT_EQ(GDF_SUCCESS, gdf_exec_event_destroy(host_done));
+  EXPECT_EQ(GDF_SUCCESS, gdf_exec_context_destroy(device));
+  EXPECT_EQ(GDF_SUCCESS, gdf_exec_context_destroy(host));
+}
+
+TEST_F(ExecContextTest, FilterAndCompactOnAContext)
+{
+  gdf_exec_context device, host;
+  ASSERT_EQ(GDF_SUCCESS, gdf_exec_context_create(&device));
+  ASSERT_EQ(GDF_SUCCESS, gdf_exec_context_create_host(&host, 0));
+
+  std::vector<int64_t> expected;
+  for(size_t i = 0; i < n; ++i)
+    if( h_a[i] > 0 )
+      expected.push_back(h_a[i]);
+
+  // a > 0 as an int8 stencil, then a compacted with it
+  const size_t bytes = gdf_get_num_chars_bitmask(n);
+  Vector<gdf_valid_type> d_a_valid(bytes, 0xff), d_flags_valid(bytes), d_out_valid(bytes);
+  Vector<int8_t> d_flags(n);
+  Vector<int64_t> d_out(n);
+  gdf_column a = device_a, flags{}, out{};
+  a.valid = d_a_valid.data().get();
+  gdf_column_view(&flags, d_flags.data().get(), d_flags_valid.data().get(), n, GDF_INT8);
+  gdf_column_view(&out, d_out.data().get(), d_out_valid.data().get(), n, GDF_INT64);
+  EXPECT_EQ(GDF_UNSUPPORTED_METHOD, gpu_comparison_static_i64_async(&a, 0, &flags, GDF_GREATER_THAN, host));
+  ASSERT_EQ(GDF_SUCCESS, gpu_comparison_static_i64_async(&a, 0, &flags, GDF_GREATER_THAN, device));
+  ASSERT_EQ(GDF_SUCCESS, gpu_apply_stencil_async(&a, &flags, &out, device));
+  ASSERT_EQ(expected.size(), static_cast<size_t>(out.size));
+  std::vector<int64_t> actual(expected.size());
+  thrust::copy(d_out.begin(), d_out.begin() + out.size, actual.begin());
+  EXPECT_EQ(expected, actual);
+
+  // The same with a packed stencil
+  Vector<gdf_valid_type> d_stencil(bytes);
+  gdf_scalar zero{};
+  zero.data.si64 = 0;
+  zero.dtype = GDF_INT64;
+  gdf_column packed_out{};
+  gdf_column_view(&packed_out, d_out.data().get(), nullptr, n, GDF_INT64);
+  ASSERT_EQ(GDF_SUCCESS, gdf_comparison_static_mask_async(&device_a, &zero, GDF_GREATER_THAN,
+                                                          d_stencil.data().get(), device));
+  EXPECT_EQ(GDF_UNSUPPORTED_METHOD, gpu_apply_stencil_mask_async(&device_a, d_stencil.data().get(), &packed_out, host));
+  ASSERT_EQ(GDF_SUCCESS, gpu_apply_stencil_mask_async(&device_a, d_stencil.data().get(), &packed_out, device));
+  ASSERT_EQ(expected.size(), static_cast<size_t>(packed_out.size));
+  thrust::copy(d_out.begin(), d_out.begin() + packed_out.size, actual.begin());
+  EXPECT_EQ(expected, actual);
+
+  EXPECT_EQ(GDF_SUCCESS, gdf_exec_context_destroy(device));
+  EXPECT_EQ(GDF_SUCCESS, gdf_exec_context_destroy(host));
+}
+
+TEST_F(ExecContextTest, ContextsWaitForEachOther)
+{
+  gdf_exec_context first, second, host;
+  ASSERT_EQ(GDF_SUCCESS, gdf_exec_context_create(&first));
+  ASSERT_EQ(GDF_SUCCESS, gdf_exec_context_create(&second));
+  ASSERT_EQ(GDF_SUCCESS, gdf_exec_context_create_host(&host, 2));
+
+  // a * 2 on the first stream, then + b on the second once it is done
+  std::vector<gdf_expr_node> twice{{GDF_EXPR_COLUMN, 0}, {GDF_EXPR_INT, 0, 2}, {GDF_EXPR_MUL}};
+  std::vector<gdf_expr_node> plus{{GDF_EXPR_COLUMN, 0}, {GDF_EXPR_COLUMN, 1}, {GDF_EXPR_ADD}};
+  Vector<double> d_twice(n), d_out(n);
+  gdf_column twice_col{}, out{};
+  gdf_column_view(&twice_col, d_twice.data().get(), nullptr, n, GDF_FLOAT64);
+  gdf_column_view(&out, d_out.data().get(), nullptr, n, GDF_FLOAT64);
+  gdf_column * twice_in[] = {&device_a};
+  gdf_column * plus_in[] = {&twice_col, &device_b};
+
+  ASSERT_EQ(GDF_SUCCESS, gdf_expr_eval_async(twice.data(), twice.size(), twice_in, 1, &twice_col, first));
+  gdf_exec_event twice_done;
+  ASSERT_EQ(GDF_SUCCESS, gdf_exec_event_record(first, &twice_done));
+  ASSERT_EQ(GDF_SUCCESS, gdf_exec_context_wait(second, twice_done));
+  ASSERT_EQ(GDF_SUCCESS, gdf_expr_eval_async(plus.data(), plus.size(), plus_in, 2, &out, second));
+
+  // The same on the host, after the device results
+  std::vector<double> h_twice(n), h_out(n);
+  gdf_column host_twice{}, host_out{};
+  gdf_column_view(&host_twice, h_twice.data(), nullptr, n, GDF_FLOAT64);
+  gdf_column_view(&host_out, h_out.data(), nullptr, n, GDF_FLOAT64);
+  gdf_column * host_twice_in[] = {&host_a};
+  gdf_column * host_plus_in[] = {&host_twice, &host_b};
+  gdf_exec_event out_done;
+  ASSERT_EQ(GDF_SUCCESS, gdf_exec_event_record(second, &out_done));
+  ASSERT_EQ(GDF_SUCCESS, gdf_exec_context_wait(host, out_done));
+  // An event may be destroyed as soon as a context waits for it
+  EXPECT_EQ(GDF_SUCCESS, gdf_exec_event_destroy(out_done));
+  ASSERT_EQ(GDF_SUCCESS, gdf_expr_eval_async(twice.data(), twice.size(), host_twice_in, 1, &host_twice, host));
+  ASSERT_EQ(GDF_SUCCESS, gdf_expr_eval_async(plus.data(), plus.size(), host_plus_in, 2, &host_out, host));
+  ASSERT_EQ(GDF_SUCCESS, gdf_exec_context_synchronize(host));
+
+  std::vector<double> actual(n);
+  thrust::copy(d_out.begin(), d_out.end(), actual.begin());
+  EXPECT_EQ(h_out, actual);
+  for(size_t i = 0; i < n; ++i)
+    ASSERT_EQ(h_a[i] * 2 + h_b[i], h_out[i]) << "row " << i;
+
+  EXPECT_EQ(GDF_SUCCESS, gdf_exec_event_destroy(twice_done));
+  EXPECT_EQ(GDF_SUCCESS, gdf_exec_context_destroy(first));
+  EXPECT_EQ(GDF_SUCCESS, gdf_exec_context_destroy(second));
+  EXPECT_EQ(GDF_SUCCESS, gdf_exec_context_destroy(host));
+}
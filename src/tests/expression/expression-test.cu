@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrust/device_vector.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/cffi/functions.h>
+
+#include "gtest/gtest.h"
+
+#include "../test_utils/gdf_test_utils.cuh"
+
+#include "../../expression/host_expression.h"
+
+struct ExpressionTest : public ::testing::Test
+{
+  static constexpr size_t n = 100003;
+
+  std::vector<int32_t> h_a;
+  std::vector<double> h_b;
+  std::vector<int64_t> h_c, h_d;
+  std::vector<gdf_valid_type> h_valid;
+  Vector<int32_t> d_a;
+  Vector<double> d_b;
+  Vector<int64_t> d_c, d_d;
+  Vector<gdf_valid_type> d_valid;
+  gdf_column host_cols[4], device_cols[4];
+
+  void SetUp() override
+  {
+    std::mt19937 rng(71);
+    h_a.resize(n); h_b.resize(n); h_c.resize(n); h_d.resize(n);
+    for(size_t i = 0; i < n; ++i)
+    {
+      h_a[i] = static_cast<int32_t>(rng() % 2001) - 1000;
+      h_b[i] = static_cast<double>(rng() % 100000) / 64;
+      h_c[i] = static_cast<int64_t>(rng() % 201) - 100;
+      h_d[i] = static_cast<int64_t>(rng() % 9) - 4;
+    }
+    h_valid = random_valid(n, rng);
+    d_a = h_a; d_b = h_b; d_c = h_c; d_d = h_d;
+    d_valid = h_valid;
+
+    gdf_column_view(&host_cols[0], h_a.data(), h_valid.data(), n, GDF_INT32);
+    gdf_column_view(&host_cols[1], h_b.data(), nullptr, n, GDF_FLOAT64);
+    gdf_column_view(&host_cols[2], h_c.data(), nullptr, n, GDF_INT64);
+    gdf_column_view(&host_cols[3], h_d.data(), nullptr, n, GDF_INT64);
+    gdf_column_view(&device_cols[0], d_a.data().get(), d_valid.data().get(), n, GDF_INT32);
+    gdf_column_view(&device_cols[1], d_b.data().get(), nullptr, n, GDF_FLOAT64);
+    gdf_column_view(&device_cols[2], d_c.data().get(), nullptr, n, GDF_INT64);
+    gdf_column_view(&device_cols[3], d_d.data().get(), nullptr, n, GDF_INT64);
+  }
+
+  // Evaluates an expression on the device and on the host, and compares
+  template<typename T>
+  void expect_matches_host(std::vector<gdf_expr_node> const & nodes, gdf_dtype dtype)
+  {
+    gdf_column * hosts[] = {&host_cols[0], &host_cols[1], &host_cols[2], &host_cols[3]};
+    gdf_column * devices[] = {&device_cols[0], &device_cols[1], &device_cols[2], &device_cols[3]};
+
+    expr_program program;
+    ASSERT_EQ(GDF_SUCCESS, expr_compile(nodes.data(), nodes.size(), hosts, 4, program));
+    std::vector<T> expected(n);
+    std::vector<gdf_valid_type> expected_valid(gdf_get_num_chars_bitmask(n));
+    host_expression_evaluate(program, n, expected.data(), dtype, expected_valid.data());
+
+    Vector<T> d_out(n);
+    Vector<gdf_valid_type> d_out_valid(gdf_get_num_chars_bitmask(n));
+    gdf_column out{};
+    gdf_column_view(&out, d_out.data().get(), d_out_valid.data().get(), n, dtype);
+    ASSERT_EQ(GDF_SUCCESS, gdf_expr_eval(nodes.data(), nodes.size(), devices, 4, &out));
+
+    std::vector<T> actual(n);
+    std::vector<gdf_valid_type> actual_valid(d_out_valid.size());
+    thrust::copy(d_out.begin(), d_out.end(), actual.begin());
+    thrust::copy(d_out_valid.begin(), d_out_valid.end(), actual_valid.begin());
+    EXPECT_EQ(expected_valid, actual_valid);
+    for(size_t i = 0; i < n; ++i)
+      if( gdf_is_valid(expected_valid.data(), i) )
+        ASSERT_EQ(expected[i], actual[i]) << "row " << i;
+  }
+};
+
+TEST_F(ExpressionTest, FusedPredicate)
+{
+  // (a * b + c) > d
+  std::vector<gdf_expr_node> nodes{
+    {GDF_EXPR_COLUMN, 0}, {GDF_EXPR_COLUMN, 1}, {GDF_EXPR_MUL},
+    {GDF_EXPR_COLUMN, 2}, {GDF_EXPR_ADD}, {GDF_EXPR_COLUMN, 3}, {GDF_EXPR_GT}};
+  expect_matches_host<int8_t>(nodes, GDF_INT8);
+
+  // The host reference itself, on a few rows
+  expr_program program;
+  gdf_column * hosts[] = {&host_cols[0], &host_cols[1], &host_cols[2], &host_cols[3]};
+  ASSERT_EQ(GDF_SUCCESS, expr_compile(nodes.data(), nodes.size(), hosts, 4, program));
+  for(size_t i = 0; i < 100; ++i)
+    EXPECT_EQ((h_a[i] * h_b[i] + h_c[i]) > h_d[i], 0 != expr_evaluate(program, i).i);
+}
+
+TEST_F(ExpressionTest, IntegerArithmetic)
+{
+  // (-(c // d) + a) * 3, in int64, with floor division by zero giving 0
+  std::vector<gdf_expr_node> nodes{
+    {GDF_EXPR_COLUMN, 2}, {GDF_EXPR_COLUMN, 3}, {GDF_EXPR_FLOORDIV}, {GDF_EXPR_NEG},
+    {GDF_EXPR_COLUMN, 0}, {GDF_EXPR_ADD}, {GDF_EXPR_INT, 0, 3}, {GDF_EXPR_MUL}};
+  expect_matches_host<int64_t>(nodes, GDF_INT64);
+}
+
+TEST_F(ExpressionTest, MixedTypesAndLogic)
+{
+  // (b / 2.5 - c) into float32, and (a < 0 and not d == 0) or c >= 50
+  expect_matches_host<float>({
+    {GDF_EXPR_COLUMN, 1}, {GDF_EXPR_FLOAT, 0, 0, 2.5}, {GDF_EXPR_DIV},
+    {GDF_EXPR_COLUMN, 2}, {GDF_EXPR_SUB}}, GDF_FLOAT32);
+  expect_matches_host<int32_t>({
+    {GDF_EXPR_COLUMN, 0}, {GDF_EXPR_INT, 0, 0}, {GDF_EXPR_LT},
+    {GDF_EXPR_COLUMN, 3}, {GDF_EXPR_INT, 0, 0}, {GDF_EXPR_EQ}, {GDF_EXPR_NOT}, {GDF_EXPR_AND},
+    {GDF_EXPR_COLUMN, 2}, {GDF_EXPR_INT, 0, 50}, {GDF_EXPR_GE}, {GDF_EXPR_OR}}, GDF_INT32);
+}
+
+TEST_F(ExpressionTest, MalformedExpressions)
+{
+  gdf_column * devices[] = {&device_cols[0], &device_cols[1], &device_cols[2], &device_cols[3]};
+  Vector<double> d_out(n);
+  gdf_column out{};
+  gdf_column_view(&out, d_out.data().get(), nullptr, n, GDF_FLOAT64);
+
+  // Missing operand, value left over, unknown column
+  std::vector<gdf_expr_node> missing{{GDF_EXPR_COLUMN, 0}, {GDF_EXPR_ADD}};
+  std::vector<gdf_expr_node> extra{{GDF_EXPR_COLUMN, 0}, {GDF_EXPR_COLUMN, 1}};
+  std::vector<gdf_expr_node> unknown{{GDF_EXPR_COLUMN, 4}};
+  EXPECT_EQ(GDF_INVALID_API_CALL, gdf_expr_eval(missing.data(), missing.size(), devices, 4, &out));
+  EXPECT_EQ(GDF_INVALID_API_CALL, gdf_expr_eval(extra.data(), extra.size(), devices, 4, &out));
+  EXPECT_EQ(GDF_INVALID_API_CALL, gdf_expr_eval(unknown.data(), unknown.size(), devices, 4, &out));
+
+  // Deeper than the stack of the interpreter
+  std::vector<gdf_expr_node> deep(EXPR_MAX_STACK + 1, gdf_expr_node{GDF_EXPR_INT, 0, 1});
+  deep.insert(deep.end(), EXPR_MAX_STACK, gdf_expr_node{GDF_EXPR_ADD});
+  EXPECT_EQ(GDF_COLUMN_SIZE_TOO_BIG, gdf_expr_eval(deep.data(), deep.size(), devices, 4, &out));
+}
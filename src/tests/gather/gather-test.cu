@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrust/device_vector.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/cffi/functions.h>
+
+#include "gtest/gtest.h"
+
+#include "../test_utils/gdf_test_utils.cuh"
+
+#include "../../gather/host_table_gather.h"
+
+template <typename T, typename IndexT>
+void expect_gathered(std::vector<T> const & in, std::vector<T> const & out,
+                     std::vector<IndexT> const & map)
+{
+  for(size_t i = 0; i < map.size(); ++i)
+    EXPECT_EQ(in[map[i]], out[i]) << "row " << i;
+}
+
+template <typename IndexT>
+void expect_gathered_valid(std::vector<gdf_valid_type> const & in,
+                           std::vector<gdf_valid_type> const & out,
+                           std::vector<IndexT> const & map)
+{
+  for(size_t i = 0; i < map.size(); ++i)
+    EXPECT_EQ(gdf_is_valid(in.data(), map[i]), gdf_is_valid(out.data(), i)) << "row " << i;
+}
+
+TEST(GatherTableTest, MixedWidthsWithValidity)
+{
+  std::mt19937 rng(56);
+  const size_t nrows = 10007;
+  const size_t nrows_out = 7001;
+
+  std::vector<int8_t>  h_a = random_vector<int8_t>(nrows, -100, 100, rng);
+  std::vector<int16_t> h_b = random_vector<int16_t>(nrows, -100, 100, rng);
+  std::vector<int32_t> h_c = random_vector<int32_t>(nrows, -100, 100, rng);
+  std::vector<double>  h_d = random_vector<double>(nrows, -100, 100, rng);
+  std::vector<gdf_valid_type> h_c_valid = random_valid(nrows, rng);
+
+  std::vector<int32_t> h_map(nrows_out);
+  std::uniform_int_distribution<int32_t> row_dist(0, nrows - 1);
+  for(auto & i : h_map)
+    i = row_dist(rng);
+
+  Vector<int8_t> d_a(h_a), d_a_out(nrows_out);
+  Vector<int16_t> d_b(h_b), d_b_out(nrows_out);
+  Vector<int32_t> d_c(h_c), d_c_out(nrows_out);
+  Vector<double> d_d(h_d), d_d_out(nrows_out);
+  Vector<gdf_valid_type> d_c_valid(h_c_valid), d_c_valid_out(gdf_get_num_chars_bitmask(nrows_out));
+  Vector<gdf_valid_type> d_d_valid_out(gdf_get_num_chars_bitmask(nrows_out));
+  Vector<int32_t> d_map(h_map);
+
+  std::vector<gdf_column> in{
+    make_column(d_a.data().get(), nullptr, nrows, GDF_INT8),
+    make_column(d_b.data().get(), nullptr, nrows, GDF_INT16),
+    make_column(d_c.data().get(), d_c_valid.data().get(), nrows, GDF_INT32),
+    make_column(d_d.data().get(), nullptr, nrows, GDF_FLOAT64)};
+  std::vector<gdf_column> out{
+    make_column(d_a_out.data().get(), nullptr, nrows_out, GDF_INT8),
+    make_column(d_b_out.data().get(), nullptr, nrows_out, GDF_INT16),
+    make_column(d_c_out.data().get(), d_c_valid_out.data().get(), nrows_out, GDF_INT32),
+    make_column(d_d_out.data().get(), d_d_valid_out.data().get(), nrows_out, GDF_FLOAT64)};
+  gdf_column map = make_column(d_map.data().get(), nullptr, nrows_out, GDF_INT32);
+
+  std::vector<gdf_column*> in_ptrs{&in[0], &in[1], &in[2], &in[3]};
+  std::vector<gdf_column*> out_ptrs{&out[0], &out[1], &out[2], &out[3]};
+  ASSERT_EQ(GDF_SUCCESS, gdf_gather_table(in_ptrs.data(), out_ptrs.data(), in.size(), &map));
+
+  std::vector<int8_t> h_a_out(nrows_out);
+  std::vector<int16_t> h_b_out(nrows_out);
+  std::vector<int32_t> h_c_out(nrows_out);
+  std::vector<double> h_d_out(nrows_out);
+  std::vector<gdf_valid_type> h_c_valid_out(d_c_valid_out.size());
+  std::vector<gdf_valid_type> h_d_valid_out(d_d_valid_out.size());
+  thrust::copy(d_a_out.begin(), d_a_out.end(), h_a_out.begin());
+  thrust::copy(d_b_out.begin(), d_b_out.end(), h_b_out.begin());
+  thrust::copy(d_c_out.begin(), d_c_out.end(), h_c_out.begin());
+  thrust::copy(d_d_out.begin(), d_d_out.end(), h_d_out.begin());
+  thrust::copy(d_c_valid_out.begin(), d_c_valid_out.end(), h_c_valid_out.begin());
+  thrust::copy(d_d_valid_out.begin(), d_d_valid_out.end(), h_d_valid_out.begin());
+
+  expect_gathered(h_a, h_a_out, h_map);
+  expect_gathered(h_b, h_b_out, h_map);
+  expect_gathered(h_c, h_c_out, h_map);
+  expect_gathered(h_d, h_d_out, h_map);
+  expect_gathered_valid(h_c_valid, h_c_valid_out, h_map);
+  // No input mask: every gathered row is valid
+  for(size_t i = 0; i < nrows_out; ++i)
+    EXPECT_TRUE(gdf_is_valid(h_d_valid_out.data(), i));
+}
+
+TEST(GatherTableTest, InPlacePermutation)
+{
+  std::mt19937 rng(57);
+  const size_t nrows = 4099;
+
+  std::vector<int64_t> h_a = random_vector<int64_t>(nrows, -100, 100, rng);
+  std::vector<gdf_valid_type> h_valid = random_valid(nrows, rng);
+  std::vector<int64_t> h_map(nrows);
+  std::iota(h_map.begin(), h_map.end(), 0);
+  std::shuffle(h_map.begin(), h_map.end(), rng);
+
+  Vector<int64_t> d_a(h_a);
+  Vector<gdf_valid_type> d_valid(h_valid);
+  Vector<int64_t> d_map(h_map);
+
+  gdf_column col = make_column(d_a.data().get(), d_valid.data().get(), nrows, GDF_INT64);
+  gdf_column map = make_column(d_map.data().get(), nullptr, nrows, GDF_INT64);
+  gdf_column * col_ptr = &col;
+  ASSERT_EQ(GDF_SUCCESS, gdf_gather_table(&col_ptr, &col_ptr, 1, &map));
+
+  std::vector<int64_t> h_out(nrows);
+  std::vector<gdf_valid_type> h_valid_out(d_valid.size());
+  thrust::copy(d_a.begin(), d_a.end(), h_out.begin());
+  thrust::copy(d_valid.begin(), d_valid.end(), h_valid_out.begin());
+  expect_gathered(h_a, h_out, h_map);
+  expect_gathered_valid(h_valid, h_valid_out, h_map);
+}
+
+TEST(GatherTableTest, HostGatherTableRangeCheck)
+{
+  std::mt19937 rng(58);
+  const size_t nrows = 100003;
+  const size_t nrows_out = 150001;
+
+  std::vector<int32_t> h_a = random_vector<int32_t>(nrows, -100, 100, rng);
+  std::vector<float> h_b = random_vector<float>(nrows, -100, 100, rng);
+  std::vector<gdf_valid_type> h_a_valid = random_valid(nrows, rng);
+
+  // Some rows have no match, as in the output of an outer join
+  std::vector<int64_t> h_map(nrows_out);
+  std::uniform_int_distribution<int64_t> row_dist(-1, nrows - 1);
+  for(auto & i : h_map)
+    i = row_dist(rng);
+
+  std::vector<int32_t> h_a_out(nrows_out);
+  std::vector<float> h_b_out(nrows_out);
+  std::vector<gdf_valid_type> h_a_valid_out(gdf_get_num_chars_bitmask(nrows_out));
+  std::vector<gdf_valid_type> h_b_valid_out(gdf_get_num_chars_bitmask(nrows_out));
+
+  gdf_column in[] = {make_column(h_a.data(), h_a_valid.data(), nrows, GDF_INT32),
+                     make_column(h_b.data(), nullptr, nrows, GDF_FLOAT32)};
+  gdf_column out[] = {make_column(h_a_out.data(), h_a_valid_out.data(), nrows_out, GDF_INT32),
+                      make_column(h_b_out.data(), h_b_valid_out.data(), nrows_out, GDF_FLOAT32)};
+  gdf_column const * in_ptrs[] = {&in[0], &in[1]};
+  gdf_column * out_ptrs[] = {&out[0], &out[1]};
+
+  ASSERT_EQ(GDF_SUCCESS, host_gather_table(in_ptrs, out_ptrs, 2, h_map.data(), nrows_out, true));
+
+  for(size_t i = 0; i < nrows_out; ++i)
+  {
+    if( h_map[i] < 0 )
+    {
+      EXPECT_FALSE(gdf_is_valid(h_a_valid_out.data(), i));
+      EXPECT_FALSE(gdf_is_valid(h_b_valid_out.data(), i));
+      continue;
+    }
+    EXPECT_EQ(h_a[h_map[i]], h_a_out[i]);
+    EXPECT_EQ(h_b[h_map[i]], h_b_out[i]);
+    EXPECT_EQ(gdf_is_valid(h_a_valid.data(), h_map[i]), gdf_is_valid(h_a_valid_out.data(), i));
+    EXPECT_TRUE(gdf_is_valid(h_b_valid_out.data(), i));
+  }
+}
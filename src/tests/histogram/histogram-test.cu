@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrust/device_vector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/cffi/functions.h>
+
+#include "gtest/gtest.h"
+
+#include "../test_utils/gdf_test_utils.cuh"
+
+#include "../../histogram/host_histogram.h"
+
+TEST(HistogramTest, MatchesHostWithNulls)
+{
+  std::mt19937 rng(69);
+  const size_t n = 1000003;
+  std::vector<double> h_data(n);
+  std::normal_distribution<double> dist(0.0, 10.0);
+  for(auto & x : h_data)
+    x = dist(rng);
+  h_data[7] = std::numeric_limits<double>::quiet_NaN();
+  std::vector<gdf_valid_type> h_valid = random_valid(n, rng);
+
+  Vector<double> d_data(h_data);
+  Vector<gdf_valid_type> d_valid(h_valid);
+  gdf_column col{};
+  gdf_column_view(&col, d_data.data().get(), d_valid.data().get(), n, GDF_FLOAT64);
+
+  // Privatized bins in shared memory, and global bins past them
+  for(int num_bins : {1, 64, 100000})
+  {
+    std::vector<int64_t> expected(num_bins);
+    host_histogram(h_data.data(), h_valid.data(), n, fixed_width_bins(-25.0, 25.0, num_bins),
+                   expected.data());
+
+    Vector<int64_t> d_counts(num_bins, -1);
+    gdf_column counts{};
+    gdf_column_view(&counts, d_counts.data().get(), nullptr, num_bins, GDF_INT64);
+    ASSERT_EQ(GDF_SUCCESS, gdf_histogram(&col, -25.0, 25.0, &counts));
+
+    std::vector<int64_t> actual(num_bins);
+    thrust::copy(d_counts.begin(), d_counts.end(), actual.begin());
+    EXPECT_EQ(expected, actual) << num_bins;
+  }
+}
+
+TEST(HistogramTest, EdgesOfTheRange)
+{
+  std::vector<int32_t> h_data{0, 1, 9, 10, 11, -1, 5};
+  Vector<int32_t> d_data(h_data);
+  gdf_column col{};
+  gdf_column_view(&col, d_data.data().get(), nullptr, h_data.size(), GDF_DATE32);
+
+  Vector<int64_t> d_counts(2);
+  gdf_column counts{};
+  gdf_column_view(&counts, d_counts.data().get(), nullptr, 2, GDF_INT64);
+  ASSERT_EQ(GDF_SUCCESS, gdf_histogram(&col, 0.0, 10.0, &counts));
+
+  // The upper bound falls in the last bin; values outside are not counted
+  EXPECT_EQ(2, d_counts[0]);
+  EXPECT_EQ(3, d_counts[1]);
+
+  EXPECT_EQ(GDF_INVALID_API_CALL, gdf_histogram(&col, 10.0, 0.0, &counts));
+}
+
+TEST(DigitizeTest, AsNumpy)
+{
+  std::vector<float> h_data{-1.f, 0.f, 0.5f, 1.f, 2.5f, 4.f, 9.f, std::nanf("")};
+  std::vector<float> h_edges{0.f, 1.f, 2.5f, 4.f};
+  Vector<float> d_data(h_data), d_edges(h_edges);
+  Vector<int32_t> d_out(h_data.size());
+  gdf_column col{}, edges{}, out{};
+  gdf_column_view(&col, d_data.data().get(), nullptr, h_data.size(), GDF_FLOAT32);
+  gdf_column_view(&edges, d_edges.data().get(), nullptr, h_edges.size(), GDF_FLOAT32);
+  gdf_column_view(&out, d_out.data().get(), nullptr, h_data.size(), GDF_INT32);
+
+  out.null_count = -1;
+  ASSERT_EQ(GDF_SUCCESS, gdf_digitize(&col, &edges, 0, &out));
+  EXPECT_EQ(0, out.null_count);
+  std::vector<int32_t> left(h_data.size());
+  thrust::copy(d_out.begin(), d_out.end(), left.begin());
+  EXPECT_EQ((std::vector<int32_t>{0, 1, 1, 2, 3, 4, 4, 4}), left);
+
+  ASSERT_EQ(GDF_SUCCESS, gdf_digitize(&col, &edges, 1, &out));
+  std::vector<int32_t> right(h_data.size());
+  thrust::copy(d_out.begin(), d_out.end(), right.begin());
+  EXPECT_EQ((std::vector<int32_t>{0, 0, 1, 1, 2, 3, 4, 4}), right);
+}
+
+TEST(CutTest, MatchesHostWithNullsOutOfRange)
+{
+  std::mt19937 rng(690);
+  const size_t n = 100007;
+  std::vector<int64_t> h_data(n);
+  std::uniform_int_distribution<int64_t> dist(-100, 1100);
+  for(auto & x : h_data)
+    x = dist(rng);
+  std::vector<gdf_valid_type> h_valid = random_valid(n, rng);
+
+  // Few edges, staged in shared memory, and many, searched in place
+  for(size_t num_edges : {11u, 5001u})
+  {
+    std::vector<int64_t> h_edges(num_edges);
+    for(size_t e = 0; e < num_edges; ++e)
+      h_edges[e] = static_cast<int64_t>(e * 1000 / (num_edges - 1));
+
+    for(int right : {0, 1})
+    {
+      std::vector<int32_t> expected(n);
+      std::vector<gdf_valid_type> expected_valid(gdf_get_num_chars_bitmask(n));
+      host_digitize(h_data.data(), h_valid.data(), n, h_edges.data(), num_edges, 0 != right, true,
+                    expected.data(), expected_valid.data());
+
+      Vector<int64_t> d_data(h_data), d_edges(h_edges);
+      Vector<gdf_valid_type> d_valid(h_valid), d_out_valid(expected_valid.size());
+      Vector<int32_t> d_out(n);
+      gdf_column col{}, edges{}, out{};
+      gdf_column_view(&col, d_data.data().get(), d_valid.data().get(), n, GDF_TIMESTAMP);
+      gdf_column_view(&edges, d_edges.data().get(), nullptr, num_edges, GDF_TIMESTAMP);
+      gdf_column_view(&out, d_out.data().get(), d_out_valid.data().get(), n, GDF_INT32);
+      ASSERT_EQ(GDF_SUCCESS, gdf_cut(&col, &edges, right, &out));
+      gdf_size_type expected_nulls = 0;
+      for(size_t i = 0; i < n; ++i)
+        expected_nulls += gdf_is_valid(expected_valid.data(), i) ? 0 : 1;
+      EXPECT_EQ(expected_nulls, out.null_count);
+
+      std::vector<int32_t> actual(n);
+      std::vector<gdf_valid_type> actual_valid(expected_valid.size());
+      thrust::copy(d_out.begin(), d_out.end(), actual.begin());
+      thrust::copy(d_out_valid.begin(), d_out_valid.end(), actual_valid.begin());
+      EXPECT_EQ(expected_valid, actual_valid);
+      for(size_t i = 0; i < n; ++i)
+      {
+        if( gdf_is_valid(expected_valid.data(), i) )
+        {
+          ASSERT_EQ(expected[i], actual[i]) << i;
+          ASSERT_LE(h_edges[expected[i]], h_data[i]);
+          ASSERT_GE(h_edges[expected[i] + 1], h_data[i]);
+        }
+        else if( gdf_is_valid(h_valid.data(), i) )
+          ASSERT_TRUE(h_data[i] < 0 || h_data[i] > 1000) << i;
+      }
+    }
+  }
+}
+
+TEST(QcutTest, EquiDepthBins)
+{
+  std::mt19937 rng(6900);
+  const size_t n = 100000;
+  std::vector<double> h_data(n);
+  std::exponential_distribution<double> dist(0.1);
+  for(auto & x : h_data)
+    x = dist(rng);
+
+  Vector<double> d_data(h_data);
+  Vector<int32_t> d_out(n);
+  gdf_column col{}, out{};
+  gdf_column_view(&col, d_data.data().get(), nullptr, n, GDF_FLOAT64);
+  gdf_column_view(&out, d_out.data().get(), nullptr, n, GDF_INT32);
+
+  const int num_bins = 10;
+  std::vector<int32_t> first_bins;
+  // Sorting in place is allowed by the context, but the column is binned
+  // after its quantiles and must be left as it is
+  for(int sort_inplace : {0, 1})
+  {
+    gdf_context ctxt{0, GDF_SORT, 0, 0, sort_inplace};
+    out.null_count = -1;
+    ASSERT_EQ(GDF_SUCCESS, gdf_qcut(&col, num_bins, &out, &ctxt));
+    EXPECT_EQ(0, out.null_count);
+
+    std::vector<double> data_after(n);
+    thrust::copy(d_data.begin(), d_data.end(), data_after.begin());
+    EXPECT_EQ(h_data, data_after);
+
+    std::vector<int32_t> bins(n);
+    thrust::copy(d_out.begin(), d_out.end(), bins.begin());
+    std::vector<size_t> per_bin(num_bins, 0);
+    for(int32_t b : bins)
+    {
+      ASSERT_GE(b, 0);
+      ASSERT_LT(b, num_bins);
+      ++per_bin[b];
+    }
+    for(size_t count : per_bin)
+      EXPECT_NEAR(static_cast<double>(n / num_bins), static_cast<double>(count), 2.0);
+
+    if( first_bins.empty() )
+      first_bins = bins;
+    else
+      EXPECT_EQ(first_bins, bins);
+  }
+}
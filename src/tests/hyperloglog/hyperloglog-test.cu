@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrust/device_vector.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/cffi/functions.h>
+
+#include "gtest/gtest.h"
+
+#include "../../hyperloglog/host_hyperloglog.h"
+
+template<typename T>
+using Vector = thrust::device_vector<T>;
+
+// Two key columns, int32 and float64, drawn from `cardinality` distinct
+// pairs, with some nulls in the first one
+struct key_rows
+{
+  std::vector<int32_t> a;
+  std::vector<double> b;
+  std::vector<gdf_valid_type> a_valid;
+
+  key_rows(size_t n, size_t cardinality, std::mt19937 & rng)
+    : a(n), b(n), a_valid(gdf_get_num_chars_bitmask(n), 0)
+  {
+    for(size_t i = 0; i < n; ++i)
+    {
+      const size_t k = rng() % cardinality;
+      a[i] = static_cast<int32_t>(k / 7);
+      b[i] = 0.5 * static_cast<double>(k % 7);
+      if( rng() % 10 != 0 )
+        a_valid[i / GDF_VALID_BITSIZE] |= gdf_valid_type(1) << (i % GDF_VALID_BITSIZE);
+    }
+  }
+
+  size_t exact_distinct() const
+  {
+    std::set<std::pair<int32_t, double>> seen;
+    for(size_t i = 0; i < a.size(); ++i)
+      if( gdf_is_valid(a_valid.data(), i) )
+        seen.insert(std::make_pair(a[i], b[i]));
+    return seen.size();
+  }
+};
+
+// Device copies of rows [begin, end) of a key_rows
+struct device_key_rows
+{
+  Vector<int32_t> a;
+  Vector<double> b;
+  Vector<gdf_valid_type> a_valid;
+  gdf_column cols[2];
+  gdf_column * ptrs[2];
+
+  device_key_rows(key_rows const & rows, size_t begin, size_t end)
+    : a(rows.a.begin() + begin, rows.a.begin() + end),
+      b(rows.b.begin() + begin, rows.b.begin() + end)
+  {
+    // Re-align the validity bits of the slice to its first row
+    std::vector<gdf_valid_type> valid(gdf_get_num_chars_bitmask(end - begin), 0);
+    for(size_t i = begin; i < end; ++i)
+      if( gdf_is_valid(rows.a_valid.data(), i) )
+        valid[(i - begin) / GDF_VALID_BITSIZE] |= gdf_valid_type(1) << ((i - begin) % GDF_VALID_BITSIZE);
+    a_valid = valid;
+
+    cols[0] = gdf_column{};
+    cols[1] = gdf_column{};
+    gdf_column_view(&cols[0], a.data().get(), a_valid.data().get(), end - begin, GDF_INT32);
+    gdf_column_view(&cols[1], b.data().get(), nullptr, end - begin, GDF_FLOAT64);
+    ptrs[0] = &cols[0];
+    ptrs[1] = &cols[1];
+  }
+};
+
+std::vector<char> serialized(gdf_hll_type * hdl)
+{
+  size_t bytes = 0;
+  EXPECT_EQ(GDF_SUCCESS, gdf_hll_serialized_size(hdl, &bytes));
+  std::vector<char> buffer(bytes);
+  EXPECT_EQ(GDF_SUCCESS, gdf_hll_serialize(hdl, buffer.data()));
+  return buffer;
+}
+
+TEST(HyperLogLogTest, EstimateWithinErrorOfExactCount)
+{
+  std::mt19937 rng(68);
+  for(size_t cardinality : {10u, 1000u, 50000u, 2000000u})
+  {
+    key_rows rows(1 << 21, cardinality, rng);
+    device_key_rows d_rows(rows, 0, rows.a.size());
+
+    double estimate = 0;
+    ASSERT_EQ(GDF_SUCCESS, gdf_approx_count_distinct(2, d_rows.ptrs, 0, &estimate));
+
+    // Four standard errors of a sketch of 2^14 registers
+    const double exact = static_cast<double>(rows.exact_distinct());
+    EXPECT_NEAR(exact, estimate, 4 * 1.04 / 128 * exact + 1) << cardinality;
+  }
+}
+
+TEST(HyperLogLogTest, HostSketchEqualsDeviceSketch)
+{
+  std::mt19937 rng(680);
+  key_rows rows(300000, 100000, rng);
+  device_key_rows d_rows(rows, 0, rows.a.size());
+
+  gdf_hll_type * device_sketch = gdf_hll_create(12);
+  ASSERT_NE(nullptr, device_sketch);
+  ASSERT_EQ(GDF_SUCCESS, gdf_hll_add(device_sketch, 2, d_rows.ptrs));
+
+  gdf_column h_cols[2];
+  gdf_column * h_ptrs[2] = {&h_cols[0], &h_cols[1]};
+  gdf_column_view(&h_cols[0], rows.a.data(), rows.a_valid.data(), rows.a.size(), GDF_INT32);
+  gdf_column_view(&h_cols[1], rows.b.data(), nullptr, rows.b.size(), GDF_FLOAT64);
+  hyperloglog host_sketch(12);
+  ASSERT_EQ(GDF_SUCCESS, host_hll_add(host_sketch, 2, h_ptrs));
+
+  std::vector<char> expected(host_sketch.serialized_size());
+  host_sketch.serialize(expected.data());
+  EXPECT_EQ(expected, serialized(device_sketch));
+  gdf_hll_free(device_sketch);
+}
+
+TEST(HyperLogLogTest, MergedPartitionsEqualWholeSketch)
+{
+  std::mt19937 rng(6800);
+  key_rows rows(500000, 200000, rng);
+
+  gdf_hll_type * whole = gdf_hll_create(0);
+  {
+    device_key_rows d_rows(rows, 0, rows.a.size());
+    ASSERT_EQ(GDF_SUCCESS, gdf_hll_add(whole, 2, d_rows.ptrs));
+  }
+
+  gdf_hll_type * merged = gdf_hll_create(0);
+  const size_t cuts[] = {0, 1000, 123457, 400001, rows.a.size()};
+  for(size_t p = 0; p + 1 < 5; ++p)
+  {
+    device_key_rows d_rows(rows, cuts[p], cuts[p + 1]);
+    gdf_hll_type * part = gdf_hll_create(0);
+    ASSERT_EQ(GDF_SUCCESS, gdf_hll_add(part, 2, d_rows.ptrs));
+
+    // Ship the partition sketch through its serialized form
+    std::vector<char> buffer = serialized(part);
+    gdf_hll_type * copy = nullptr;
+    ASSERT_EQ(GDF_SUCCESS, gdf_hll_deserialize(buffer.data(), buffer.size(), &copy));
+    ASSERT_EQ(GDF_SUCCESS, gdf_hll_merge(merged, copy));
+    gdf_hll_free(copy);
+    gdf_hll_free(part);
+  }
+
+  EXPECT_EQ(serialized(whole), serialized(merged));
+  gdf_hll_free(whole);
+  gdf_hll_free(merged);
+}
+
+TEST(HyperLogLogTest, MergeAtTheSmallerPrecision)
+{
+  std::mt19937 rng(68000);
+  key_rows rows(100000, 30000, rng);
+  gdf_column h_cols[2];
+  gdf_column * h_ptrs[2] = {&h_cols[0], &h_cols[1]};
+  gdf_column_view(&h_cols[0], rows.a.data(), rows.a_valid.data(), rows.a.size(), GDF_INT32);
+  gdf_column_view(&h_cols[1], rows.b.data(), nullptr, rows.b.size(), GDF_FLOAT64);
+
+  hyperloglog fine(16), coarse(10), empty(10);
+  ASSERT_EQ(GDF_SUCCESS, host_hll_add(fine, 2, h_ptrs));
+  ASSERT_EQ(GDF_SUCCESS, host_hll_add(coarse, 2, h_ptrs));
+
+  // Folding the fine sketch gives the sketch built at the coarse precision
+  empty.merge(fine);
+  EXPECT_EQ(10, empty.precision);
+  EXPECT_EQ(coarse.registers, empty.registers);
+  fine.merge(coarse);
+  EXPECT_EQ(10, fine.precision);
+  EXPECT_EQ(coarse.registers, fine.registers);
+}
+
+TEST(HyperLogLogTest, InvalidArguments)
+{
+  EXPECT_EQ(nullptr, gdf_hll_create(3));
+  EXPECT_EQ(nullptr, gdf_hll_create(19));
+
+  Vector<int32_t> a(10, 1);
+  Vector<int32_t> b(11, 1);
+  gdf_column cols[2];
+  gdf_column * ptrs[2] = {&cols[0], &cols[1]};
+  gdf_column_view(&cols[0], a.data().get(), nullptr, a.size(), GDF_INT32);
+  gdf_column_view(&cols[1], b.data().get(), nullptr, b.size(), GDF_INT32);
+
+  double estimate = 0;
+  EXPECT_EQ(GDF_COLUMN_SIZE_MISMATCH, gdf_approx_count_distinct(2, ptrs, 0, &estimate));
+  EXPECT_EQ(GDF_INVALID_API_CALL, gdf_approx_count_distinct(1, ptrs, 30, &estimate));
+  ASSERT_EQ(GDF_SUCCESS, gdf_approx_count_distinct(1, ptrs, 0, &estimate));
+  EXPECT_NEAR(1.0, estimate, 0.01);
+
+  const char garbage[12] = {0};
+  gdf_hll_type * hdl = nullptr;
+  EXPECT_EQ(GDF_INVALID_API_CALL, gdf_hll_deserialize(garbage, sizeof(garbage), &hdl));
+}
@@ -0,0 +1,539 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrust/device_vector.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <gdf/gdf.h>
+#include <gdf/cffi/functions.h>
+
+#include "gtest/gtest.h"
+
+#include "../test_utils/gdf_test_utils.cuh"
+
+#include "../../orderby/host_radix_order_by.h"
+#include "../../orderby/host_top_k.h"
+#include "../../orderby/external_sort.h"
+#include "../../orderby/host_merge_sorted.h"
+#include "../../orderby/host_is_sorted.h"
+
+std::vector<size_t> device_order_by(std::vector<gdf_column> & cols)
+{
+  const size_t nrows = cols[0].size;
+  const size_t ncols = cols.size();
+
+  Vector<void*> d_cols(ncols, nullptr);
+  Vector<int>   d_types(ncols, 0);
+  Vector<size_t> d_indx(nrows, 0);
+
+  EXPECT_EQ(GDF_SUCCESS, gdf_order_by(nrows, cols.data(), ncols,
+                                      d_cols.data().get(), d_types.data().get(),
+                                      d_indx.data().get()));
+
+  std::vector<size_t> h_indx(nrows);
+  thrust::copy(d_indx.begin(), d_indx.end(), h_indx.begin());
+  return h_indx;
+}
+
+std::vector<size_t> device_order_by_asc_desc(std::vector<gdf_column> & cols,
+                                             std::vector<order_by_type> & asc_desc,
+                                             std::vector<null_order_type> & null_order)
+{
+  const size_t nrows = cols[0].size;
+  Vector<size_t> d_indx(nrows, 0);
+
+  EXPECT_EQ(GDF_SUCCESS, gdf_order_by_asc_desc(nrows, cols.data(), cols.size(),
+                                               asc_desc.data(), null_order.data(),
+                                               d_indx.data().get()));
+
+  std::vector<size_t> h_indx(nrows);
+  thrust::copy(d_indx.begin(), d_indx.end(), h_indx.begin());
+  return h_indx;
+}
+
+// Reference comparison of one key column honoring direction and NULL placement,
+// returns -1, 0 or 1
+template <typename T>
+int reference_compare(std::vector<T> const & data, std::vector<gdf_valid_type> const & valid,
+                      order_by_type dir, null_order_type nulls, size_t i, size_t j)
+{
+  const bool vi = valid.empty() || gdf_is_valid(valid.data(), i);
+  const bool vj = valid.empty() || gdf_is_valid(valid.data(), j);
+  if( !vi || !vj )
+  {
+    if( vi == vj ) return 0;
+    const int null_first = (GDF_NULLS_FIRST == nulls) ? -1 : 1;
+    return vi ? -null_first : null_first;
+  }
+  const int cmp = (data[i] < data[j]) ? -1 : ((data[j] < data[i]) ? 1 : 0);
+  return (GDF_ORDER_DESC == dir) ? -cmp : cmp;
+}
+
+template <typename Less>
+std::vector<size_t> reference_order_by(size_t nrows, Less less)
+{
+  std::vector<size_t> indx(nrows);
+  std::iota(indx.begin(), indx.end(), 0);
+  std::stable_sort(indx.begin(), indx.end(), less);
+  return indx;
+}
+
+TEST(OrderByTest, SingleInt32Column)
+{
+  std::mt19937 rng(1);
+  auto h_a = random_vector<int32_t>(10000, -1000, 1000, rng);
+  Vector<int32_t> d_a = h_a;
+
+  std::vector<gdf_column> cols{make_column(d_a, GDF_INT32)};
+
+  auto expected = reference_order_by(h_a.size(), [&](size_t i, size_t j){
+    return h_a[i] < h_a[j];
+  });
+  EXPECT_EQ(expected, device_order_by(cols));
+}
+
+TEST(OrderByTest, TwoInt32ColumnsPackedKey)
+{
+  std::mt19937 rng(2);
+  auto h_a = random_vector<int32_t>(10000, -5, 5, rng);
+  auto h_b = random_vector<int32_t>(10000, -100000, 100000, rng);
+  Vector<int32_t> d_a = h_a;
+  Vector<int32_t> d_b = h_b;
+
+  std::vector<gdf_column> cols{make_column(d_a, GDF_INT32), make_column(d_b, GDF_INT32)};
+
+  auto expected = reference_order_by(h_a.size(), [&](size_t i, size_t j){
+    return std::make_tuple(h_a[i], h_b[i]) < std::make_tuple(h_a[j], h_b[j]);
+  });
+  EXPECT_EQ(expected, device_order_by(cols));
+}
+
+TEST(OrderByTest, Int64AndDoubleColumns)
+{
+  std::mt19937 rng(3);
+  auto h_a = random_vector<int64_t>(10000, -3, 3, rng);
+  auto h_b = random_vector<double>(10000, -1000, 1000, rng);
+  for(auto & x : h_b) x /= 7.;
+  Vector<int64_t> d_a = h_a;
+  Vector<double> d_b = h_b;
+
+  std::vector<gdf_column> cols{make_column(d_a, GDF_INT64), make_column(d_b, GDF_FLOAT64)};
+
+  auto expected = reference_order_by(h_a.size(), [&](size_t i, size_t j){
+    return std::make_tuple(h_a[i], h_b[i]) < std::make_tuple(h_a[j], h_b[j]);
+  });
+  EXPECT_EQ(expected, device_order_by(cols));
+}
+
+TEST(OrderByTest, NarrowMixedColumns)
+{
+  std::mt19937 rng(4);
+  auto h_a = random_vector<int8_t>(10000, -128, 127, rng);
+  auto h_b = random_vector<int16_t>(10000, -20, 20, rng);
+  auto h_c = random_vector<float>(10000, -50, 50, rng);
+  for(auto & x : h_c) x /= 3.f;
+  Vector<int8_t> d_a = h_a;
+  Vector<int16_t> d_b = h_b;
+  Vector<float> d_c = h_c;
+
+  std::vector<gdf_column> cols{make_column(d_a, GDF_INT8),
+                               make_column(d_b, GDF_INT16),
+                               make_column(d_c, GDF_FLOAT32)};
+
+  auto expected = reference_order_by(h_a.size(), [&](size_t i, size_t j){
+    return std::make_tuple(h_a[i], h_b[i], h_c[i]) < std::make_tuple(h_a[j], h_b[j], h_c[j]);
+  });
+  EXPECT_EQ(expected, device_order_by(cols));
+}
+
+TEST(OrderByTest, HostRadixOrderBy)
+{
+  std::mt19937 rng(5);
+  auto h_a = random_vector<int32_t>(10000, -3, 3, rng);
+  auto h_b = random_vector<double>(10000, -1000, 1000, rng);
+  auto h_c = random_vector<int16_t>(10000, -1000, 1000, rng);
+
+  std::vector<gdf_column> cols{make_host_column(h_a, GDF_INT32),
+                               make_host_column(h_b, GDF_FLOAT64),
+                               make_host_column(h_c, GDF_INT16)};
+
+  std::vector<size_t> result(h_a.size());
+  EXPECT_EQ(GDF_SUCCESS, host_radix_order_by(h_a.size(), cols.data(), cols.size(),
+                                                     nullptr, nullptr, result.data()));
+
+  auto expected = reference_order_by(h_a.size(), [&](size_t i, size_t j){
+    return std::make_tuple(h_a[i], h_b[i], h_c[i]) < std::make_tuple(h_a[j], h_b[j], h_c[j]);
+  });
+  EXPECT_EQ(expected, result);
+}
+
+TEST(OrderByTest, DescendingAndNullOrder)
+{
+  std::mt19937 rng(6);
+  const size_t nrows = 10000;
+  auto h_a = random_vector<int16_t>(nrows, -4, 4, rng);
+  auto h_b = random_vector<int32_t>(nrows, -100, 100, rng);
+  auto h_c = random_vector<double>(nrows, -1000, 1000, rng);
+  auto h_a_valid = random_valid(nrows, rng);
+  auto h_c_valid = random_valid(nrows, rng);
+  std::vector<gdf_valid_type> no_valid;
+
+  Vector<int16_t> d_a = h_a;
+  Vector<int32_t> d_b = h_b;
+  Vector<double> d_c = h_c;
+  Vector<gdf_valid_type> d_a_valid = h_a_valid;
+  Vector<gdf_valid_type> d_c_valid = h_c_valid;
+
+  std::vector<gdf_column> cols{make_column(d_a, GDF_INT16),
+                               make_column(d_b, GDF_INT32),
+                               make_column(d_c, GDF_FLOAT64)};
+  cols[0].valid = d_a_valid.data().get();
+  cols[2].valid = d_c_valid.data().get();
+
+  std::vector<order_by_type> asc_desc{GDF_ORDER_DESC, GDF_ORDER_ASC, GDF_ORDER_DESC};
+  std::vector<null_order_type> null_order{GDF_NULLS_FIRST, GDF_NULLS_LAST, GDF_NULLS_LAST};
+
+  auto expected = reference_order_by(nrows, [&](size_t i, size_t j){
+    int cmp = reference_compare(h_a, h_a_valid, asc_desc[0], null_order[0], i, j);
+    if( 0 == cmp ) cmp = reference_compare(h_b, no_valid, asc_desc[1], null_order[1], i, j);
+    if( 0 == cmp ) cmp = reference_compare(h_c, h_c_valid, asc_desc[2], null_order[2], i, j);
+    return cmp < 0;
+  });
+  EXPECT_EQ(expected, device_order_by_asc_desc(cols, asc_desc, null_order));
+
+  std::vector<gdf_column> h_cols{make_host_column(h_a, GDF_INT16),
+                                 make_host_column(h_b, GDF_INT32),
+                                 make_host_column(h_c, GDF_FLOAT64)};
+  h_cols[0].valid = h_a_valid.data();
+  h_cols[2].valid = h_c_valid.data();
+
+  std::vector<size_t> result(nrows);
+  EXPECT_EQ(GDF_SUCCESS, host_radix_order_by(nrows, h_cols.data(), h_cols.size(),
+                                             asc_desc.data(), null_order.data(),
+                                             result.data()));
+  EXPECT_EQ(expected, result);
+}
+
+TEST(OrderByTest, TopK)
+{
+  std::mt19937 rng(7);
+  const size_t nrows = 100000;
+  auto h_a = random_vector<int32_t>(nrows, -50, 50, rng);
+  auto h_b = random_vector<double>(nrows, -1000, 1000, rng);
+  auto h_b_valid = random_valid(nrows, rng);
+  Vector<int32_t> d_a = h_a;
+  Vector<double> d_b = h_b;
+  Vector<gdf_valid_type> d_b_valid = h_b_valid;
+
+  std::vector<gdf_column> cols{make_column(d_a, GDF_INT32), make_column(d_b, GDF_FLOAT64)};
+  cols[1].valid = d_b_valid.data().get();
+  std::vector<gdf_column> h_cols{make_host_column(h_a, GDF_INT32), make_host_column(h_b, GDF_FLOAT64)};
+  h_cols[1].valid = h_b_valid.data();
+
+  std::vector<order_by_type> asc_desc{GDF_ORDER_DESC, GDF_ORDER_ASC};
+  std::vector<null_order_type> null_order{GDF_NULLS_LAST, GDF_NULLS_FIRST};
+
+  auto expected = device_order_by_asc_desc(cols, asc_desc, null_order);
+
+  for(size_t k : {size_t{1}, size_t{100}, size_t{5000}, nrows + 1})
+  {
+    const size_t nresult = std::min(k, nrows);
+
+    Vector<size_t> d_indx(nresult);
+    EXPECT_EQ(GDF_SUCCESS, gdf_top_k(nrows, cols.data(), cols.size(),
+                                     asc_desc.data(), null_order.data(),
+                                     k, d_indx.data().get()));
+    std::vector<size_t> result(nresult);
+    thrust::copy(d_indx.begin(), d_indx.end(), result.begin());
+    EXPECT_TRUE(std::equal(result.begin(), result.end(), expected.begin())) << "k = " << k;
+
+    std::vector<size_t> h_result(nresult);
+    EXPECT_EQ(GDF_SUCCESS, host_top_k(nrows, h_cols.data(), h_cols.size(),
+                                      asc_desc.data(), null_order.data(),
+                                      k, h_result.data()));
+    EXPECT_EQ(result, h_result) << "k = " << k;
+  }
+}
+
+TEST(OrderByTest, ExternalOrderBy)
+{
+  std::mt19937 rng(8);
+  const size_t nrows = 100003;
+  auto h_a = random_vector<int32_t>(nrows, -50, 50, rng);
+  auto h_b = random_vector<double>(nrows, -1000, 1000, rng);
+  auto h_c = random_vector<int64_t>(nrows, -1000000, 1000000, rng);
+  auto h_b_valid = random_valid(nrows, rng);
+
+  std::vector<gdf_column> h_cols{make_host_column(h_a, GDF_INT32),
+                                 make_host_column(h_b, GDF_FLOAT64),
+                                 make_host_column(h_c, GDF_INT64)};
+  h_cols[1].valid = h_b_valid.data();
+
+  std::vector<order_by_type> asc_desc{GDF_ORDER_DESC, GDF_ORDER_ASC, GDF_ORDER_ASC};
+  std::vector<null_order_type> null_order{GDF_NULLS_LAST, GDF_NULLS_FIRST, GDF_NULLS_LAST};
+
+  std::vector<size_t> expected(nrows);
+  EXPECT_EQ(GDF_SUCCESS, host_radix_order_by(nrows, h_cols.data(), h_cols.size(),
+                                             asc_desc.data(), null_order.data(),
+                                             expected.data()));
+
+  // From a single in-memory run to many spilled runs, and to more runs than
+  // a single merge pass takes
+  for(size_t budget : {size_t{1} << 30, size_t{1} << 20, size_t{1} << 16, size_t{1} << 12})
+  {
+    std::vector<size_t> result(nrows);
+    EXPECT_EQ(GDF_SUCCESS, gdf_external_order_by(nrows, h_cols.data(), h_cols.size(),
+                                                 asc_desc.data(), null_order.data(),
+                                                 budget, "/tmp", result.data()));
+    EXPECT_EQ(expected, result) << "budget = " << budget;
+
+    std::vector<size_t> h_result(nrows);
+    EXPECT_EQ(GDF_SUCCESS, host_external_order_by(nrows, h_cols.data(), h_cols.size(),
+                                                  asc_desc.data(), null_order.data(),
+                                                  budget, "/tmp", h_result.data()));
+    EXPECT_EQ(expected, h_result) << "budget = " << budget;
+  }
+}
+
+TEST(OrderByTest, ArgsortInt32AndInt64Indices)
+{
+  std::mt19937 rng(9);
+  const size_t nrows = 10000;
+  auto h_a = random_vector<int32_t>(nrows, -100, 100, rng);
+  auto h_b = random_vector<float>(nrows, -100, 100, rng);
+  Vector<int32_t> d_a = h_a;
+  Vector<float> d_b = h_b;
+
+  std::vector<gdf_column> cols{make_column(d_a, GDF_INT32), make_column(d_b, GDF_FLOAT32)};
+  std::vector<order_by_type> asc_desc{GDF_ORDER_ASC, GDF_ORDER_DESC};
+  std::vector<null_order_type> null_order{GDF_NULLS_LAST, GDF_NULLS_LAST};
+
+  auto expected = device_order_by_asc_desc(cols, asc_desc, null_order);
+
+  Vector<int32_t> d_indx32(nrows);
+  gdf_column out32 = make_column(d_indx32, GDF_INT32);
+  EXPECT_EQ(GDF_SUCCESS, gdf_argsort(nrows, cols.data(), cols.size(),
+                                     asc_desc.data(), null_order.data(), &out32));
+  std::vector<int32_t> h_indx32(nrows);
+  thrust::copy(d_indx32.begin(), d_indx32.end(), h_indx32.begin());
+  EXPECT_EQ(expected, std::vector<size_t>(h_indx32.begin(), h_indx32.end()));
+
+  Vector<int64_t> d_indx64(nrows);
+  gdf_column out64 = make_column(d_indx64, GDF_INT64);
+  EXPECT_EQ(GDF_SUCCESS, gdf_argsort(nrows, cols.data(), cols.size(),
+                                     asc_desc.data(), null_order.data(), &out64));
+  std::vector<int64_t> h_indx64(nrows);
+  thrust::copy(d_indx64.begin(), d_indx64.end(), h_indx64.begin());
+  EXPECT_EQ(expected, std::vector<size_t>(h_indx64.begin(), h_indx64.end()));
+
+  Vector<int8_t> d_bad(nrows);
+  gdf_column bad = make_column(d_bad, GDF_INT8);
+  EXPECT_EQ(GDF_UNSUPPORTED_DTYPE, gdf_argsort(nrows, cols.data(), cols.size(),
+                                               asc_desc.data(), null_order.data(), &bad));
+}
+
+TEST(OrderByTest, MergeSortedTables)
+{
+  std::mt19937 rng(10);
+  const std::vector<size_t> sizes{50000, 0, 1, 3000, 777, 12345};
+  std::vector<order_by_type> asc_desc{GDF_ORDER_ASC, GDF_ORDER_DESC};
+  std::vector<null_order_type> null_order{GDF_NULLS_FIRST, GDF_NULLS_LAST};
+
+  // Every table sorted by its two key columns; the payload column is the
+  // row number in the concatenation of the tables
+  std::vector<std::vector<int32_t>> h_a;
+  std::vector<std::vector<double>> h_b;
+  std::vector<std::vector<int64_t>> h_c;
+  std::vector<std::vector<gdf_valid_type>> h_a_valid;
+  std::vector<int32_t> all_a;
+  std::vector<double> all_b;
+  std::vector<gdf_valid_type> all_a_valid(
+    gdf_get_num_chars_bitmask(std::accumulate(sizes.begin(), sizes.end(), size_t{0})), 0);
+  size_t total = 0;
+  for(size_t t = 0; t < sizes.size(); ++t)
+  {
+    auto a = random_vector<int32_t>(sizes[t], -20, 20, rng);
+    auto b = random_vector<double>(sizes[t], -5, 5, rng);
+    auto a_valid = random_valid(sizes[t], rng);
+    std::vector<gdf_column> cols{make_host_column(a, GDF_INT32), make_host_column(b, GDF_FLOAT64)};
+    // Only the even tables have NULL keys
+    if( t % 2 == 0 )
+      cols[0].valid = a_valid.data();
+
+    std::vector<size_t> order(sizes[t]);
+    EXPECT_EQ(GDF_SUCCESS, host_radix_order_by(sizes[t], cols.data(), cols.size(),
+                                               asc_desc.data(), null_order.data(), order.data()));
+    h_a.emplace_back();
+    h_b.emplace_back();
+    h_c.emplace_back();
+    h_a_valid.emplace_back(gdf_get_num_chars_bitmask(sizes[t]), 0);
+    for(size_t i = 0; i < sizes[t]; ++i)
+    {
+      const bool valid = (t % 2 != 0) || gdf_is_valid(a_valid.data(), order[i]);
+      h_a.back().push_back(a[order[i]]);
+      h_b.back().push_back(b[order[i]]);
+      h_c.back().push_back(total + i);
+      if( valid )
+      {
+        h_a_valid.back()[i / 8] |= gdf_valid_type(1) << (i % 8);
+        all_a_valid[(total + i) / 8] |= gdf_valid_type(1) << ((total + i) % 8);
+      }
+      all_a.push_back(h_a.back().back());
+      all_b.push_back(h_b.back().back());
+    }
+    total += sizes[t];
+  }
+
+  std::vector<gdf_column> all_cols{make_host_column(all_a, GDF_INT32),
+                                   make_host_column(all_b, GDF_FLOAT64)};
+  all_cols[0].valid = all_a_valid.data();
+  std::vector<size_t> expected(total);
+  EXPECT_EQ(GDF_SUCCESS, host_radix_order_by(total, all_cols.data(), all_cols.size(),
+                                             asc_desc.data(), null_order.data(), expected.data()));
+
+  // Host merge
+  std::vector<std::vector<gdf_column>> h_tables;
+  std::vector<gdf_column const *> h_table_ptrs;
+  for(size_t t = 0; t < sizes.size(); ++t)
+  {
+    h_tables.push_back({make_host_column(h_a[t], GDF_INT32), make_host_column(h_b[t], GDF_FLOAT64)});
+    if( t % 2 == 0 )
+      h_tables.back()[0].valid = h_a_valid[t].data();
+  }
+  for(auto & table : h_tables)
+    h_table_ptrs.push_back(table.data());
+  std::vector<size_t> h_result(total);
+  EXPECT_EQ(GDF_SUCCESS, host_merge_sorted(h_table_ptrs.data(), sizes.size(), 2,
+                                           asc_desc.data(), null_order.data(), h_result.data()));
+  EXPECT_EQ(expected, h_result);
+
+  // Device merge, with the merged table
+  std::vector<Vector<int32_t>> d_a(h_a.begin(), h_a.end());
+  std::vector<Vector<double>> d_b(h_b.begin(), h_b.end());
+  std::vector<Vector<int64_t>> d_c(h_c.begin(), h_c.end());
+  std::vector<Vector<gdf_valid_type>> d_a_valid(h_a_valid.begin(), h_a_valid.end());
+  std::vector<std::vector<gdf_column>> d_tables;
+  std::vector<gdf_column *> d_table_ptrs;
+  for(size_t t = 0; t < sizes.size(); ++t)
+  {
+    d_tables.push_back({make_column(d_a[t], GDF_INT32), make_column(d_b[t], GDF_FLOAT64),
+                        make_column(d_c[t], GDF_INT64)});
+    if( t % 2 == 0 )
+      d_tables.back()[0].valid = d_a_valid[t].data().get();
+  }
+  for(auto & table : d_tables)
+    d_table_ptrs.push_back(table.data());
+
+  Vector<int64_t> d_indx(total);
+  Vector<int32_t> d_a_out(total);
+  Vector<double> d_b_out(total);
+  Vector<int64_t> d_c_out(total);
+  Vector<gdf_valid_type> d_a_valid_out(gdf_get_num_chars_bitmask(total));
+  gdf_column indx = make_column(d_indx, GDF_INT64);
+  std::vector<gdf_column> out{make_column(d_a_out, GDF_INT32), make_column(d_b_out, GDF_FLOAT64),
+                              make_column(d_c_out, GDF_INT64)};
+  out[0].valid = d_a_valid_out.data().get();
+  std::vector<gdf_column *> out_ptrs{&out[0], &out[1], &out[2]};
+  EXPECT_EQ(GDF_SUCCESS, gdf_merge_sorted(d_table_ptrs.data(), sizes.size(), 3, 2,
+                                          asc_desc.data(), null_order.data(),
+                                          &indx, out_ptrs.data()));
+
+  std::vector<int64_t> result(total);
+  std::vector<int64_t> h_c_out(total);
+  thrust::copy(d_indx.begin(), d_indx.end(), result.begin());
+  thrust::copy(d_c_out.begin(), d_c_out.end(), h_c_out.begin());
+  EXPECT_EQ(std::vector<int64_t>(expected.begin(), expected.end()), result);
+  EXPECT_EQ(result, h_c_out);
+
+  // Tables with different dtypes
+  d_tables[1][1].dtype = GDF_INT64;
+  EXPECT_EQ(GDF_DTYPE_MISMATCH, gdf_merge_sorted(d_table_ptrs.data(), sizes.size(), 3, 2,
+                                                 asc_desc.data(), null_order.data(),
+                                                 &indx, nullptr));
+}
+
+TEST(OrderByTest, IsSorted)
+{
+  std::mt19937 rng(11);
+  const size_t nrows = 100003;
+  std::vector<order_by_type> asc_desc{GDF_ORDER_DESC, GDF_ORDER_ASC};
+  std::vector<null_order_type> null_order{GDF_NULLS_FIRST, GDF_NULLS_LAST};
+
+  // Few distinct values in the first column: the second one decides the ties
+  auto h_a = random_vector<int32_t>(nrows, 0, 3, rng);
+  auto h_b = random_vector<int64_t>(nrows, -1000, 1000, rng);
+  auto h_a_valid = random_valid(nrows, rng);
+  std::vector<gdf_column> h_cols{make_host_column(h_a, GDF_INT32), make_host_column(h_b, GDF_INT64)};
+  h_cols[0].valid = h_a_valid.data();
+
+  std::vector<size_t> order(nrows);
+  EXPECT_EQ(GDF_SUCCESS, host_radix_order_by(nrows, h_cols.data(), h_cols.size(),
+                                             asc_desc.data(), null_order.data(), order.data()));
+  std::vector<int32_t> sorted_a(nrows);
+  std::vector<int64_t> sorted_b(nrows);
+  std::vector<gdf_valid_type> sorted_a_valid(h_a_valid.size(), 0);
+  for(size_t i = 0; i < nrows; ++i)
+  {
+    sorted_a[i] = h_a[order[i]];
+    sorted_b[i] = h_b[order[i]];
+    if( gdf_is_valid(h_a_valid.data(), order[i]) )
+      sorted_a_valid[i / 8] |= gdf_valid_type(1) << (i % 8);
+  }
+
+  // Sorted, then a single pair swapped in the second column
+  std::vector<int64_t> swapped_b(sorted_b);
+  size_t swap_at = nrows / 2;
+  while( sorted_a[swap_at] != sorted_a[swap_at + 1] || sorted_b[swap_at] == sorted_b[swap_at + 1] ||
+         gdf_is_valid(sorted_a_valid.data(), swap_at) != gdf_is_valid(sorted_a_valid.data(), swap_at + 1) )
+    ++swap_at;
+  std::swap(swapped_b[swap_at], swapped_b[swap_at + 1]);
+
+  for(auto const & b : {sorted_b, swapped_b})
+  {
+    const bool expected = (b == sorted_b);
+    Vector<int32_t> d_a = sorted_a;
+    Vector<int64_t> d_b = b;
+    Vector<gdf_valid_type> d_a_valid = sorted_a_valid;
+    std::vector<gdf_column> cols{make_column(d_a, GDF_INT32), make_column(d_b, GDF_INT64)};
+    cols[0].valid = d_a_valid.data().get();
+
+    int is_sorted = -1;
+    EXPECT_EQ(GDF_SUCCESS, gdf_is_sorted(nrows, cols.data(), cols.size(),
+                                         asc_desc.data(), null_order.data(), &is_sorted));
+    EXPECT_EQ(expected, is_sorted == 1);
+
+    std::vector<int64_t> h_b_copy(b);
+    std::vector<gdf_column> host_cols{make_host_column(sorted_a, GDF_INT32),
+                                      make_host_column(h_b_copy, GDF_INT64)};
+    host_cols[0].valid = sorted_a_valid.data();
+    bool host_sorted = !expected;
+    EXPECT_EQ(GDF_SUCCESS, host_rows_are_sorted(nrows, host_cols.data(), host_cols.size(),
+                                                asc_desc.data(), null_order.data(), host_sorted));
+    EXPECT_EQ(expected, host_sorted);
+  }
+
+  // The unsorted input
+  Vector<int32_t> d_a = h_a;
+  std::vector<gdf_column> cols{make_column(d_a, GDF_INT32)};
+  int is_sorted = -1;
+  EXPECT_EQ(GDF_SUCCESS, gdf_is_sorted(nrows, cols.data(), 1, nullptr, nullptr, &is_sorted));
+  EXPECT_EQ(0, is_sorted);
+}
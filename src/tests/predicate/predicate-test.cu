@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrust/device_vector.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/cffi/functions.h>
+
+#include "gtest/gtest.h"
+
+#include "../test_utils/gdf_test_utils.cuh"
+
+#include "../../predicate/host_predicate.h"
+
+struct PredicateTest : public ::testing::Test
+{
+  // Not a multiple of 32, for the last partial word of the stencils
+  static constexpr size_t n = 100003;
+
+  std::vector<int32_t> h_a;
+  std::vector<double> h_b;
+  std::vector<gdf_valid_type> h_valid;
+  Vector<int32_t> d_a;
+  Vector<double> d_b;
+  Vector<gdf_valid_type> d_valid;
+  gdf_column a, b;
+
+  void SetUp() override
+  {
+    std::mt19937 rng(74);
+    h_a.resize(n); h_b.resize(n);
+    for(size_t i = 0; i < n; ++i)
+    {
+      h_a[i] = static_cast<int32_t>(rng() % 21) - 10;
+      h_b[i] = static_cast<double>(static_cast<int>(rng() % 41) - 20) / 2;
+    }
+    h_valid = random_valid(n, rng);
+    d_a = h_a; d_b = h_b; d_valid = h_valid;
+
+    gdf_column_view(&a, d_a.data().get(), d_valid.data().get(), n, GDF_INT32);
+    gdf_column_view(&b, d_b.data().get(), nullptr, n, GDF_FLOAT64);
+  }
+
+  // a op b on the device, against the host packing and against row by row
+  template<gdf_comparison_operator Op>
+  void expect_comparison()
+  {
+    Vector<gdf_valid_type> d_stencil(gdf_get_num_chars_bitmask(n), 0xff);
+    ASSERT_EQ(GDF_SUCCESS, gdf_comparison_mask(&a, &b, Op, d_stencil.data().get()));
+    std::vector<gdf_valid_type> actual = to_host(d_stencil);
+
+    std::vector<gdf_valid_type> expected(actual.size());
+    host_compare_to_mask<comparison_op<Op>>(column_operand<int32_t, double>{h_a.data()}, h_valid.data(),
+                                            column_operand<double, double>{h_b.data()}, nullptr,
+                                            n, expected.data());
+    EXPECT_EQ(expected, actual);
+
+    const comparison_op<Op> cmp{};
+    for(size_t i = 0; i < n; ++i)
+      ASSERT_EQ(gdf_is_valid(h_valid.data(), i) && cmp(static_cast<double>(h_a[i]), h_b[i]),
+                gdf_is_valid(actual.data(), i)) << "row " << i;
+    for(size_t i = n; i < actual.size() * GDF_VALID_BITSIZE; ++i)
+      EXPECT_FALSE(gdf_is_valid(actual.data(), i));
+  }
+};
+
+TEST_F(PredicateTest, ColumnComparisons)
+{
+  expect_comparison<GDF_EQUALS>();
+  expect_comparison<GDF_NOT_EQUALS>();
+  expect_comparison<GDF_LESS_THAN>();
+  expect_comparison<GDF_LESS_THAN_OR_EQUALS>();
+  expect_comparison<GDF_GREATER_THAN>();
+  expect_comparison<GDF_GREATER_THAN_OR_EQUALS>();
+}
+
+TEST_F(PredicateTest, ScalarComparison)
+{
+  // An integer column against 2.5 is compared as doubles
+  gdf_scalar value{};
+  value.data.fp64 = 2.5;
+  value.dtype = GDF_FLOAT64;
+  Vector<gdf_valid_type> d_stencil(gdf_get_num_chars_bitmask(n));
+  ASSERT_EQ(GDF_SUCCESS, gdf_comparison_static_mask(&a, &value, GDF_LESS_THAN, d_stencil.data().get()));
+  std::vector<gdf_valid_type> actual = to_host(d_stencil);
+  for(size_t i = 0; i < n; ++i)
+    ASSERT_EQ(gdf_is_valid(h_valid.data(), i) && h_a[i] < 2.5, gdf_is_valid(actual.data(), i)) << "row " << i;
+
+  EXPECT_EQ(GDF_INVALID_API_CALL,
+            gdf_comparison_static_mask(&a, &value, static_cast<gdf_comparison_operator>(-1),
+                                       d_stencil.data().get()));
+}
+
+TEST_F(PredicateTest, ScalarComparisonOutOfRange)
+{
+  // Out of the range of the column, the scalar is not wrapped into it:
+  // 2^32 + 1 would be 1 as an int32, 300 would be 44 as an int8
+  gdf_scalar value{};
+  value.data.si64 = (int64_t{1} << 32) + 1;
+  value.dtype = GDF_INT64;
+  Vector<gdf_valid_type> d_stencil(gdf_get_num_chars_bitmask(n));
+  ASSERT_EQ(GDF_SUCCESS, gdf_comparison_static_mask(&a, &value, GDF_LESS_THAN, d_stencil.data().get()));
+  std::vector<gdf_valid_type> actual = to_host(d_stencil);
+  for(size_t i = 0; i < n; ++i)
+    ASSERT_EQ(gdf_is_valid(h_valid.data(), i), gdf_is_valid(actual.data(), i)) << "row " << i;
+
+  std::vector<int8_t> h_c{-128, -1, 0, 44, 127};
+  Vector<int8_t> d_c(h_c);
+  gdf_column c{};
+  gdf_column_view(&c, d_c.data().get(), nullptr, h_c.size(), GDF_INT8);
+  value.data.si32 = 300;
+  value.dtype = GDF_INT32;
+  Vector<gdf_valid_type> d_c_stencil(gdf_get_num_chars_bitmask(h_c.size()));
+  ASSERT_EQ(GDF_SUCCESS, gdf_comparison_static_mask(&c, &value, GDF_EQUALS, d_c_stencil.data().get()));
+  EXPECT_EQ(0, to_host(d_c_stencil)[0]);
+  ASSERT_EQ(GDF_SUCCESS, gdf_comparison_static_mask(&c, &value, GDF_LESS_THAN, d_c_stencil.data().get()));
+  EXPECT_EQ(0x1f, to_host(d_c_stencil)[0]);
+}
+
+TEST_F(PredicateTest, MaskOperations)
+{
+  const size_t bytes = gdf_get_num_chars_bitmask(n);
+  Vector<gdf_valid_type> d_lt(bytes), d_ge(bytes), d_out(bytes);
+  ASSERT_EQ(GDF_SUCCESS, gdf_comparison_mask(&a, &b, GDF_LESS_THAN, d_lt.data().get()));
+  ASSERT_EQ(GDF_SUCCESS, gdf_comparison_mask(&a, &b, GDF_GREATER_THAN_OR_EQUALS, d_ge.data().get()));
+  std::vector<gdf_valid_type> lt = to_host(d_lt), ge = to_host(d_ge), expected(bytes);
+
+  ASSERT_EQ(GDF_SUCCESS, gdf_mask_and(d_lt.data().get(), d_ge.data().get(), d_out.data().get(), n));
+  host_mask_apply(MASK_AND, lt.data(), ge.data(), n, expected.data());
+  EXPECT_EQ(expected, to_host(d_out));
+  EXPECT_EQ(std::vector<gdf_valid_type>(bytes, 0), expected);
+
+  // a < b or a >= b is the validity of a
+  ASSERT_EQ(GDF_SUCCESS, gdf_mask_or(d_lt.data().get(), d_ge.data().get(), d_out.data().get(), n));
+  host_mask_apply(MASK_OR, lt.data(), ge.data(), n, expected.data());
+  EXPECT_EQ(expected, to_host(d_out));
+  for(size_t i = 0; i < n; ++i)
+    ASSERT_EQ(gdf_is_valid(h_valid.data(), i), gdf_is_valid(expected.data(), i)) << "row " << i;
+
+  // In place, with the rows past the end left cleared
+  ASSERT_EQ(GDF_SUCCESS, gdf_mask_not(d_lt.data().get(), d_lt.data().get(), n));
+  host_mask_apply(MASK_NOT, lt.data(), nullptr, n, expected.data());
+  EXPECT_EQ(expected, to_host(d_lt));
+  for(size_t i = n; i < bytes * GDF_VALID_BITSIZE; ++i)
+    EXPECT_FALSE(gdf_is_valid(expected.data(), i));
+}
+
+TEST_F(PredicateTest, ApplyPackedStencil)
+{
+  Vector<gdf_valid_type> d_stencil(gdf_get_num_chars_bitmask(n));
+  ASSERT_EQ(GDF_SUCCESS, gdf_comparison_mask(&a, &b, GDF_GREATER_THAN, d_stencil.data().get()));
+  std::vector<gdf_valid_type> stencil = to_host(d_stencil);
+
+  std::vector<int32_t> expected;
+  for(size_t i = 0; i < n; ++i)
+    if( gdf_is_valid(stencil.data(), i) )
+      expected.push_back(h_a[i]);
+
+  // Without nulls
+  gdf_column values{};
+  gdf_column_view(&values, d_a.data().get(), nullptr, n, GDF_INT32);
+  Vector<int32_t> d_out(n);
+  gdf_column out{};
+  gdf_column_view(&out, d_out.data().get(), nullptr, n, GDF_INT32);
+  ASSERT_EQ(GDF_SUCCESS, gpu_apply_stencil_mask(&values, d_stencil.data().get(), &out));
+  ASSERT_EQ(static_cast<gdf_size_type>(expected.size()), out.size);
+  std::vector<int32_t> actual = to_host(d_out);
+  actual.resize(out.size);
+  EXPECT_EQ(expected, actual);
+
+  // With nulls, the stencil only keeps valid rows of a: the output has none
+  Vector<gdf_valid_type> d_out_valid(gdf_get_num_chars_bitmask(n));
+  gdf_column_view(&out, d_out.data().get(), d_out_valid.data().get(), n, GDF_INT32);
+  ASSERT_EQ(GDF_SUCCESS, gpu_apply_stencil_mask(&a, d_stencil.data().get(), &out));
+  ASSERT_EQ(static_cast<gdf_size_type>(expected.size()), out.size);
+  EXPECT_EQ(0, out.null_count);
+  actual = to_host(d_out);
+  actual.resize(out.size);
+  EXPECT_EQ(expected, actual);
+}
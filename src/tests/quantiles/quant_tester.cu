@@ -24,8 +24,10 @@
 #include <vector>
 #include <string>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <random>
 
 #include <gdf/gdf.h>
 #include <gdf/utils.h>
@@ -35,6 +37,7 @@
 #include "gtest/gtest.h"
 
 #include "quantiles.hpp"
+#include "../../quantiles/tdigest.h"
 
 template<typename T, typename Allocator, template<typename, typename> class Vector>
 __host__ __device__
@@ -170,6 +173,202 @@ TEST(gdf_quantile_i, IntegerVector)
     }
 }
 
+TEST(gdf_quantiles, MatchSingleQuantiles)
+{
+  using VType = double;
+  std::mt19937 rng(61);
+  std::normal_distribution<double> dist(0.0, 10.0);
+  std::vector<VType> v(1001);
+  for(auto& x : v)
+    x = dist(rng);
+  thrust::device_vector<VType> d_in = v;
+
+  gdf_column col_in{};
+  gdf_column_view(&col_in, d_in.data().get(), nullptr, d_in.size(), GDF_FLOAT64);
+  gdf_context ctxt{0, static_cast<gdf_method>(0), 0, 1};
+
+  std::vector<double> qvals{0.0, 0.01, 0.25, 0.33, 0.5, 0.9, 0.999, 1.0};
+  for(int m = GDF_QUANT_LINEAR; m <= GDF_QUANT_NEAREST; ++m)
+    {
+      auto prec = static_cast<gdf_quantile_method>(m);
+      std::vector<double> results(qvals.size(), 0.0);
+      EXPECT_EQ(GDF_SUCCESS, gdf_quantiles(&col_in, prec, qvals.data(), qvals.size(), results.data(), &ctxt));
+      for(size_t i = 0; i < qvals.size(); ++i)
+        {
+          double expected = 0;
+          EXPECT_EQ(GDF_SUCCESS, gdf_quantile_exact(&col_in, prec, qvals[i], &expected, &ctxt));
+          EXPECT_EQ(expected, results[i]) << "method " << m << ", q " << qvals[i];
+        }
+    }
+}
+
+template<typename VType>
+void check_quantiles_exclude_nulls(std::vector<VType> const& v, std::mt19937& rng, gdf_dtype dtype)
+{
+  const size_t n = v.size();
+  std::vector<gdf_valid_type> valid(gdf_get_num_chars_bitmask(n));
+  for(auto& b : valid)
+    b = static_cast<gdf_valid_type>(rng());
+
+  // Baseline: the sorted valid values, read without selection
+  std::vector<VType> sorted;
+  for(size_t i = 0; i < n; ++i)
+    if( gdf_is_valid(valid.data(), i) )
+      sorted.push_back(v[i]);
+  std::sort(sorted.begin(), sorted.end());
+
+  thrust::device_vector<VType> d_in = v;
+  thrust::device_vector<gdf_valid_type> d_valid = valid;
+  thrust::device_vector<VType> d_sorted = sorted;
+  gdf_column col_in{};
+  gdf_column col_sorted{};
+  gdf_column_view(&col_in, d_in.data().get(), d_valid.data().get(), n, dtype);
+  gdf_column_view(&col_sorted, d_sorted.data().get(), nullptr, sorted.size(), dtype);
+
+  gdf_context ctxt{0, static_cast<gdf_method>(0), 0, 1};
+  gdf_context ctxt_sorted{1, static_cast<gdf_method>(0), 0, 1};
+
+  std::vector<double> qvals{0.0, 0.001, 0.25, 0.33, 0.5, 0.75, 0.999, 1.0};
+  for(auto q : qvals)
+    {
+      VType approx = 0, expected_approx = 0;
+      EXPECT_EQ(GDF_SUCCESS, gdf_quantile_aprrox(&col_in, q, &approx, &ctxt));
+      EXPECT_EQ(GDF_SUCCESS, gdf_quantile_aprrox(&col_sorted, q, &expected_approx, &ctxt_sorted));
+      EXPECT_EQ(expected_approx, approx) << "q " << q;
+
+      for(int m = GDF_QUANT_LINEAR; m <= GDF_QUANT_NEAREST; ++m)
+        {
+          auto prec = static_cast<gdf_quantile_method>(m);
+          double exact = 0, expected = 0;
+          EXPECT_EQ(GDF_SUCCESS, gdf_quantile_exact(&col_in, prec, q, &exact, &ctxt));
+          EXPECT_EQ(GDF_SUCCESS, gdf_quantile_exact(&col_sorted, prec, q, &expected, &ctxt_sorted));
+          EXPECT_EQ(expected, exact) << "method " << m << ", q " << q;
+        }
+    }
+
+  std::vector<double> results(qvals.size(), 0.0);
+  std::vector<double> expected(qvals.size(), 0.0);
+  EXPECT_EQ(GDF_SUCCESS, gdf_quantiles(&col_in, GDF_QUANT_LINEAR, qvals.data(), qvals.size(), results.data(), &ctxt));
+  EXPECT_EQ(GDF_SUCCESS, gdf_quantiles(&col_sorted, GDF_QUANT_LINEAR, qvals.data(), qvals.size(), expected.data(), &ctxt_sorted));
+  EXPECT_EQ(expected, results);
+}
+
+TEST(gdf_quantile_select, ExcludesNulls)
+{
+  std::mt19937 rng(62);
+
+  // Few distinct values: long runs of ties
+  std::vector<int32_t> vi(100003);
+  for(auto& x : vi)
+    x = static_cast<int32_t>(rng() % 201) - 100;
+  check_quantiles_exclude_nulls(vi, rng, GDF_INT32);
+
+  // Signed values of all magnitudes: every digit pass, and compaction
+  std::vector<double> vd(1 << 20);
+  std::normal_distribution<double> dist(0.0, 1.0e6);
+  for(auto& x : vd)
+    x = dist(rng);
+  check_quantiles_exclude_nulls(vd, rng, GDF_FLOAT64);
+
+  std::vector<int8_t> vc(1001);
+  for(auto& x : vc)
+    x = static_cast<int8_t>(rng());
+  check_quantiles_exclude_nulls(vc, rng, GDF_INT8);
+}
+
+TEST(gdf_tdigest, MergedPartitionsMatchExactRanks)
+{
+  using VType = float;
+  const size_t n = 1 << 20;
+  const size_t num_parts = 4;
+  std::mt19937 rng(610);
+  std::lognormal_distribution<float> dist(0.0f, 1.0f);
+  std::vector<VType> v(n);
+  for(auto& x : v)
+    x = dist(rng);
+  std::vector<gdf_valid_type> valid(gdf_get_num_chars_bitmask(n));
+  for(auto& b : valid)
+    b = static_cast<gdf_valid_type>(rng());
+
+  thrust::device_vector<VType> d_in = v;
+  thrust::device_vector<gdf_valid_type> d_valid = valid;
+
+  // One digest per partition, merged after a serialization round trip
+  gdf_tdigest_type* merged = gdf_tdigest_create(100.0);
+  const size_t part_rows = n / num_parts;
+  for(size_t p = 0; p < num_parts; ++p)
+    {
+      gdf_column part{};
+      gdf_column_view(&part, d_in.data().get() + p * part_rows,
+                      d_valid.data().get() + p * part_rows / GDF_VALID_BITSIZE,
+                      part_rows, GDF_FLOAT32);
+      gdf_tdigest_type* digest = gdf_tdigest_create(100.0);
+      ASSERT_EQ(GDF_SUCCESS, gdf_tdigest_add(digest, &part));
+
+      size_t bytes = 0;
+      ASSERT_EQ(GDF_SUCCESS, gdf_tdigest_serialized_size(digest, &bytes));
+      std::vector<char> buffer(bytes);
+      ASSERT_EQ(GDF_SUCCESS, gdf_tdigest_serialize(digest, buffer.data()));
+      gdf_tdigest_type* copy = nullptr;
+      ASSERT_EQ(GDF_SUCCESS, gdf_tdigest_deserialize(buffer.data(), bytes, &copy));
+      ASSERT_EQ(GDF_SUCCESS, gdf_tdigest_merge(merged, copy));
+      gdf_tdigest_free(copy);
+      gdf_tdigest_free(digest);
+    }
+
+  tdigest host_digest(100.0);
+  host_tdigest_add(host_digest, v.data(), valid.data(), n);
+
+  std::vector<VType> sorted;
+  for(size_t i = 0; i < n; ++i)
+    if( gdf_is_valid(valid.data(), i) )
+      sorted.push_back(v[i]);
+  std::sort(sorted.begin(), sorted.end());
+
+  std::vector<double> qvals{0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999};
+  std::vector<double> results(qvals.size(), 0.0);
+  ASSERT_EQ(GDF_SUCCESS, gdf_tdigest_quantiles(merged, qvals.data(), qvals.size(), results.data()));
+  gdf_tdigest_free(merged);
+
+  for(size_t i = 0; i < qvals.size(); ++i)
+    {
+      const double host_result = host_digest.quantile(qvals[i]);
+      for(double r : {results[i], host_result})
+        {
+          const double rank = static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), r)
+                                                  - sorted.begin()) / sorted.size();
+          EXPECT_NEAR(qvals[i], rank, 0.005) << "q " << qvals[i];
+        }
+    }
+}
+
+TEST(gdf_tdigest, RejectsInvalidCompressionAndBuffers)
+{
+  for(double compression : {0.0, -1.0, std::nan(""), 1e300})
+    EXPECT_EQ(nullptr, gdf_tdigest_create(compression)) << compression;
+
+  tdigest digest(100.0);
+  std::vector<float> v{1.0f, 2.0f, 3.0f};
+  digest.add_sorted(v.data(), v.size());
+  std::vector<double> flat(digest.serialized_size() / sizeof(double));
+  digest.serialize(flat.data());
+
+  // Corrupted centroid counts and compressions
+  for(size_t field : {size_t{1}, size_t{4}})
+    for(double bad : {std::nan(""), -1.0, 1e300})
+      {
+        std::vector<double> corrupt(flat);
+        corrupt[field] = bad;
+        gdf_tdigest_type* copy = nullptr;
+        EXPECT_EQ(GDF_INVALID_API_CALL,
+                  gdf_tdigest_deserialize(corrupt.data(), corrupt.size() * sizeof(double), &copy))
+          << "field " << field << " value " << bad;
+      }
+  gdf_tdigest_type* copy = nullptr;
+  ASSERT_EQ(GDF_SUCCESS, gdf_tdigest_deserialize(flat.data(), flat.size() * sizeof(double), &copy));
+  gdf_tdigest_free(copy);
+}
+
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
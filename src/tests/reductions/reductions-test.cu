@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrust/device_vector.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/cffi/functions.h>
+
+#include "gtest/gtest.h"
+
+#include "../test_utils/gdf_test_utils.cuh"
+
+#include "../../reductions/host_column_stats.h"
+#include "../../reductions/host_reduce_batch.h"
+#include "../../reductions/host_reproducible_sum.h"
+
+void expect_stats_near(gdf_stats const & expected, gdf_stats const & actual, double rel)
+{
+  EXPECT_EQ(expected.count, actual.count);
+  EXPECT_EQ(expected.null_count, actual.null_count);
+  EXPECT_EQ(expected.min, actual.min);
+  EXPECT_EQ(expected.max, actual.max);
+  EXPECT_NEAR(expected.sum, actual.sum, rel * std::abs(expected.sum) + 1e-9);
+  EXPECT_NEAR(expected.sum_squares, actual.sum_squares, rel * std::abs(expected.sum_squares) + 1e-9);
+  EXPECT_NEAR(expected.mean, actual.mean, rel * std::abs(expected.mean) + 1e-9);
+  EXPECT_NEAR(expected.variance, actual.variance, rel * std::abs(expected.variance) + 1e-9);
+}
+
+TEST(ColumnStatsTest, MatchesHostWithNulls)
+{
+  std::mt19937 rng(63);
+  const size_t n = 1000003;
+
+  // Large offset, small spread: the variance needs the Welford update
+  std::vector<double> h_data(n);
+  std::normal_distribution<double> dist(1.0e6, 3.0);
+  for(auto & x : h_data)
+    x = dist(rng);
+  std::vector<gdf_valid_type> h_valid = random_valid(n, rng);
+
+  gdf_stats expected;
+  ASSERT_EQ(GDF_SUCCESS, host_column_stats(h_data.data(), h_valid.data(), n, &expected));
+
+  Vector<double> d_data(h_data);
+  Vector<gdf_valid_type> d_valid(h_valid);
+  gdf_column col{};
+  gdf_column_view(&col, d_data.data().get(), d_valid.data().get(), n, GDF_FLOAT64);
+
+  gdf_stats stats;
+  ASSERT_EQ(GDF_SUCCESS, gdf_column_stats(&col, &stats));
+  expect_stats_near(expected, stats, 1e-9);
+  EXPECT_NEAR(9.0, stats.variance, 0.1);
+}
+
+TEST(ColumnStatsTest, MatchesSeparateReductions)
+{
+  std::mt19937 rng(630);
+  const size_t n = 100007;
+  std::vector<int32_t> h_data(n);
+  std::uniform_int_distribution<int32_t> dist(-1000, 1000);
+  for(auto & x : h_data)
+    x = dist(rng);
+
+  Vector<int32_t> d_data(h_data);
+  gdf_column col{};
+  gdf_column_view(&col, d_data.data().get(), nullptr, n, GDF_INT32);
+
+  gdf_stats stats;
+  ASSERT_EQ(GDF_SUCCESS, gdf_column_stats(&col, &stats));
+
+  const gdf_size_type out_size = gdf_reduce_optimal_output_size();
+  Vector<int32_t> d_result(out_size);
+  int32_t sum = 0, min = 0, max = 0;
+  ASSERT_EQ(GDF_SUCCESS, gdf_sum_i32(&col, d_result.data().get(), out_size));
+  sum = d_result[0];
+  ASSERT_EQ(GDF_SUCCESS, gdf_min_i32(&col, d_result.data().get(), out_size));
+  min = d_result[0];
+  ASSERT_EQ(GDF_SUCCESS, gdf_max_i32(&col, d_result.data().get(), out_size));
+  max = d_result[0];
+
+  EXPECT_EQ(static_cast<gdf_size_type>(n), stats.count);
+  EXPECT_EQ(0u, stats.null_count);
+  EXPECT_EQ(static_cast<double>(sum), stats.sum);
+  EXPECT_EQ(static_cast<double>(min), stats.min);
+  EXPECT_EQ(static_cast<double>(max), stats.max);
+
+  gdf_stats expected;
+  ASSERT_EQ(GDF_SUCCESS, host_column_stats(h_data.data(), nullptr, n, &expected));
+  expect_stats_near(expected, stats, 1e-12);
+}
+
+TEST(ColumnStatsTest, AllNulls)
+{
+  const size_t n = 100;
+  Vector<float> d_data(n, 1.0f);
+  Vector<gdf_valid_type> d_valid(gdf_get_num_chars_bitmask(n), 0);
+  gdf_column col{};
+  gdf_column_view(&col, d_data.data().get(), d_valid.data().get(), n, GDF_FLOAT32);
+
+  gdf_stats stats;
+  ASSERT_EQ(GDF_SUCCESS, gdf_column_stats(&col, &stats));
+  EXPECT_EQ(0u, stats.count);
+  EXPECT_EQ(static_cast<gdf_size_type>(n), stats.null_count);
+  EXPECT_EQ(0.0, stats.sum);
+  EXPECT_TRUE(std::isnan(stats.mean));
+  EXPECT_TRUE(std::isnan(stats.variance));
+}
+
+TEST(ReduceBatchTest, ManyColumnsMatchHostAndSingleReductions)
+{
+  std::mt19937 rng(64);
+  const int num_columns = 200;
+
+  // Columns of every size from empty to several tiles, alternating types
+  std::vector<std::vector<int32_t>> h_ints(num_columns);
+  std::vector<std::vector<double>> h_reals(num_columns);
+  std::vector<std::vector<gdf_valid_type>> h_valid(num_columns);
+  std::vector<Vector<int32_t>> d_ints(num_columns);
+  std::vector<Vector<double>> d_reals(num_columns);
+  std::vector<Vector<gdf_valid_type>> d_valid(num_columns);
+  std::vector<gdf_column> h_cols(num_columns), d_cols(num_columns);
+  std::vector<gdf_reduction_op> ops(num_columns);
+
+  for(int c = 0; c < num_columns; ++c)
+  {
+    const size_t n = (c % 10 == 0) ? 0 : rng() % 300000;
+    const bool real = (c % 2 == 1);
+    const bool nullable = (c % 3 != 0);
+    h_ints[c].resize(n);
+    h_reals[c].resize(n);
+    for(size_t i = 0; i < n; ++i)
+    {
+      h_ints[c][i] = static_cast<int32_t>(rng() % 2001) - 1000;
+      h_reals[c][i] = static_cast<double>(static_cast<int>(rng() % 2001) - 1000) * 0.25;
+    }
+    h_valid[c] = random_valid(n, rng);
+    d_ints[c] = h_ints[c];
+    d_reals[c] = h_reals[c];
+    d_valid[c] = h_valid[c];
+
+    // No products: they overflow
+    const gdf_reduction_op choices[] = {GDF_REDUCE_SUM, GDF_REDUCE_MIN, GDF_REDUCE_MAX,
+                                        real ? GDF_REDUCE_SUM_SQUARED : GDF_REDUCE_SUM};
+    ops[c] = choices[rng() % 4];
+
+    gdf_column_view(&h_cols[c], real ? static_cast<void*>(h_reals[c].data()) : static_cast<void*>(h_ints[c].data()),
+                    nullable ? h_valid[c].data() : nullptr, n, real ? GDF_FLOAT64 : GDF_INT32);
+    gdf_column_view(&d_cols[c], real ? static_cast<void*>(d_reals[c].data().get()) : static_cast<void*>(d_ints[c].data().get()),
+                    nullable ? d_valid[c].data().get() : nullptr, n, real ? GDF_FLOAT64 : GDF_INT32);
+  }
+
+  std::vector<int64_t> results(num_columns), expected(num_columns);
+  std::vector<void*> result_ptrs, expected_ptrs;
+  std::vector<gdf_column*> d_col_ptrs;
+  std::vector<gdf_column const*> h_col_ptrs;
+  for(int c = 0; c < num_columns; ++c)
+  {
+    result_ptrs.push_back(&results[c]);
+    expected_ptrs.push_back(&expected[c]);
+    d_col_ptrs.push_back(&d_cols[c]);
+    h_col_ptrs.push_back(&h_cols[c]);
+  }
+
+  ASSERT_EQ(GDF_SUCCESS, gdf_reduce_batch(d_col_ptrs.data(), ops.data(), num_columns, result_ptrs.data()));
+  ASSERT_EQ(GDF_SUCCESS, host_reduce_batch(h_col_ptrs.data(), ops.data(), num_columns, expected_ptrs.data()));
+
+  // Quarters of small integers: every sum is exact whatever the order
+  const gdf_size_type out_size = gdf_reduce_optimal_output_size();
+  Vector<int64_t> d_single(out_size);
+  for(int c = 0; c < num_columns; ++c)
+  {
+    if( d_cols[c].dtype == GDF_FLOAT64 )
+    {
+      double result, host_result;
+      std::memcpy(&result, &results[c], sizeof(double));
+      std::memcpy(&host_result, &expected[c], sizeof(double));
+      EXPECT_EQ(host_result, result) << "column " << c;
+    }
+    else
+    {
+      EXPECT_EQ(static_cast<int32_t>(expected[c]), static_cast<int32_t>(results[c])) << "column " << c;
+    }
+
+    // The single column reductions agree on non-empty columns
+    if( d_cols[c].size == 0 )
+      continue;
+    void * single = d_single.data().get();
+    switch(ops[c])
+    {
+      case GDF_REDUCE_SUM:         ASSERT_EQ(GDF_SUCCESS, gdf_sum_generic(&d_cols[c], single, out_size)); break;
+      case GDF_REDUCE_SUM_SQUARED: ASSERT_EQ(GDF_SUCCESS, gdf_sum_squared_generic(&d_cols[c], single, out_size)); break;
+      case GDF_REDUCE_MIN:         ASSERT_EQ(GDF_SUCCESS, gdf_min_generic(&d_cols[c], single, out_size)); break;
+      case GDF_REDUCE_MAX:         ASSERT_EQ(GDF_SUCCESS, gdf_max_generic(&d_cols[c], single, out_size)); break;
+      default:                     break;
+    }
+    int64_t single_result = d_single[0];
+    EXPECT_EQ(0, std::memcmp(&single_result, &results[c], d_cols[c].dtype == GDF_FLOAT64 ? 8 : 4))
+      << "column " << c;
+  }
+}
+
+TEST(ReduceBatchTest, UnsupportedDtype)
+{
+  Vector<int32_t> d_data(10, 1);
+  gdf_column col{};
+  gdf_column_view(&col, d_data.data().get(), nullptr, 10, GDF_INT32);
+  gdf_column * col_ptr = &col;
+  gdf_reduction_op op = GDF_REDUCE_SUM_SQUARED;
+  int32_t result = 0;
+  void * result_ptr = &result;
+  EXPECT_EQ(GDF_UNSUPPORTED_DTYPE, gdf_reduce_batch(&col_ptr, &op, 1, &result_ptr));
+}
+
+template <typename T>
+void check_reproducible_sum(size_t n)
+{
+  std::mt19937 rng(65);
+  // Mixed magnitudes and signs: a plain sum loses the small values
+  std::vector<T> h_data(n);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  for(size_t i = 0; i < n; ++i)
+    h_data[i] = static_cast<T>(dist(rng) * ((i % 4 == 0) ? 1.0e6 : 1.0e-3) + ((i % 4 == 0) ? 0.0 : 1.0));
+  std::vector<gdf_valid_type> h_valid = random_valid(n, rng);
+
+  long double reference = 0;
+  for(size_t i = 0; i < n; ++i)
+    if( gdf_is_valid(h_valid.data(), i) )
+      reference += h_data[i];
+
+  Vector<T> d_data(h_data);
+  Vector<gdf_valid_type> d_valid(h_valid);
+  gdf_column col{};
+  gdf_column_view(&col, d_data.data().get(), d_valid.data().get(), n,
+                  sizeof(T) == 4 ? GDF_FLOAT32 : GDF_FLOAT64);
+
+  // The result does not depend on the size of the working space
+  std::vector<T> sums;
+  for(gdf_size_type result_size : {1u, 7u, gdf_reduce_optimal_output_size()})
+  {
+    Vector<T> d_result(result_size);
+    ASSERT_EQ(GDF_SUCCESS, gdf_sum_generic(&col, d_result.data().get(), result_size));
+    sums.push_back(static_cast<T>(d_result[0]));
+  }
+  EXPECT_EQ(sums[0], sums[1]);
+  EXPECT_EQ(sums[0], sums[2]);
+
+  const T host_sum = host_reproducible_sum(h_data.data(), h_valid.data(), n);
+  const double tolerance = 4 * std::numeric_limits<T>::epsilon() * std::abs(static_cast<double>(reference)) + 1e-9;
+  EXPECT_NEAR(static_cast<double>(reference), sums[0], tolerance);
+  EXPECT_NEAR(static_cast<double>(reference), host_sum, tolerance);
+}
+
+TEST(ReproducibleSumTest, Float32MatchesHighPrecisionReference)
+{
+  check_reproducible_sum<float>(4000037);
+}
+
+TEST(ReproducibleSumTest, Float64MatchesHighPrecisionReference)
+{
+  check_reproducible_sum<double>(1000003);
+}
+
+TEST(ReproducibleSumTest, EmptyAndAllNulls)
+{
+  Vector<float> d_data(100, 1.0f);
+  Vector<gdf_valid_type> d_valid(gdf_get_num_chars_bitmask(100), 0);
+  gdf_column col{};
+  gdf_column_view(&col, d_data.data().get(), d_valid.data().get(), 100, GDF_FLOAT32);
+
+  Vector<float> d_result(1, -1.0f);
+  ASSERT_EQ(GDF_SUCCESS, gdf_sum_f32(&col, d_result.data().get(), 1));
+  EXPECT_EQ(0.0f, static_cast<float>(d_result[0]));
+
+  col.size = 0;
+  d_result[0] = -1.0f;
+  ASSERT_EQ(GDF_SUCCESS, gdf_sum_f32(&col, d_result.data().get(), 1));
+  EXPECT_EQ(0.0f, static_cast<float>(d_result[0]));
+}
+
+// Validity of mostly null, mostly valid and mixed mask words
+std::vector<gdf_valid_type> word_pattern_valid(size_t n, std::mt19937 & rng)
+{
+  std::vector<gdf_valid_type> valid(gdf_get_num_chars_bitmask(n));
+  for(size_t b = 0; b < valid.size(); ++b)
+  {
+    switch((b / 4) % 3) {
+      case 0:  valid[b] = 0; break;
+      case 1:  valid[b] = 0xff; break;
+      default: valid[b] = static_cast<gdf_valid_type>(rng()); break;
+    }
+  }
+  return valid;
+}
+
+TEST(ReductionsTest, MaskWordsMatchHost)
+{
+  std::mt19937 rng(67);
+  for(size_t n : {size_t{1}, size_t{31}, size_t{33}, size_t{1000003}})
+  {
+    std::vector<int64_t> h_data(n);
+    for(auto & x : h_data)
+      x = static_cast<int64_t>(rng() % 2001) - 1000;
+    std::vector<gdf_valid_type> h_valid = word_pattern_valid(n, rng);
+
+    gdf_column h_col{};
+    gdf_column_view(&h_col, h_data.data(), h_valid.data(), n, GDF_INT64);
+    gdf_column const * h_col_ptr = &h_col;
+
+    Vector<int64_t> d_data(h_data);
+    Vector<gdf_valid_type> d_valid(h_valid);
+    gdf_column col{};
+    gdf_column_view(&col, d_data.data().get(), d_valid.data().get(), n, GDF_INT64);
+
+    for(gdf_reduction_op op : {GDF_REDUCE_SUM, GDF_REDUCE_MIN, GDF_REDUCE_MAX})
+    {
+      int64_t expected = 0;
+      void * expected_ptr = &expected;
+      ASSERT_EQ(GDF_SUCCESS, host_reduce_batch(&h_col_ptr, &op, 1, &expected_ptr));
+
+      Vector<int64_t> d_result(gdf_reduce_optimal_output_size());
+      gdf_error status = (op == GDF_REDUCE_SUM) ? gdf_sum_i64(&col, d_result.data().get(), d_result.size())
+                       : (op == GDF_REDUCE_MIN) ? gdf_min_i64(&col, d_result.data().get(), d_result.size())
+                                                : gdf_max_i64(&col, d_result.data().get(), d_result.size());
+      ASSERT_EQ(GDF_SUCCESS, status);
+      EXPECT_EQ(expected, static_cast<int64_t>(d_result[0])) << "op " << op << " rows " << n;
+    }
+  }
+}
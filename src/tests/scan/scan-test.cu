@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrust/device_vector.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/cffi/functions.h>
+
+#include "gtest/gtest.h"
+
+#include "../test_utils/gdf_test_utils.cuh"
+
+#include "../../scan/host_scan.h"
+
+// Small values, so that sums and products of integers stay exact
+template <typename T>
+std::vector<T> random_values(size_t n, std::mt19937 & rng, gdf_reduction_op op)
+{
+  std::vector<T> v(n);
+  for(auto & x : v)
+    x = (op == GDF_REDUCE_PRODUCT) ? static_cast<T>(rng() % 3 == 0 ? -1 : 1)
+                                   : static_cast<T>(static_cast<int>(rng() % 21) - 10);
+  return v;
+}
+
+enum class segments { none, by_key, by_offsets };
+
+template <typename T>
+void check_scan(gdf_scan_plan_type * plan, gdf_dtype dtype, gdf_reduction_op op,
+                bool inclusive, segments seg, size_t n, std::mt19937 & rng)
+{
+  std::vector<T> h_data = random_values<T>(n, rng, op);
+  std::vector<gdf_valid_type> h_valid = random_valid(n, rng);
+
+  // Segments of 1 to 100 rows
+  std::vector<int32_t> h_keys(n);
+  std::vector<unsigned> h_offsets;
+  int32_t key = 0;
+  for(size_t i = 0; i < n; ++i)
+  {
+    if( i == 0 || rng() % 50 == 0 )
+    {
+      ++key;
+      h_offsets.push_back(static_cast<unsigned>(i));
+    }
+    h_keys[i] = key;
+  }
+
+  std::vector<uint8_t> h_head(n);
+  if( seg == segments::by_key )
+    host_segment_heads_by_key(h_keys.data(), static_cast<gdf_valid_type const *>(nullptr), n, h_head.data());
+  else
+    host_segment_heads_by_offsets(n, h_offsets.size(), h_offsets.data(), h_head.data());
+
+  std::vector<T> expected(n);
+  ASSERT_EQ(GDF_SUCCESS, host_scan(h_data.data(), h_valid.data(), n, expected.data(), op, inclusive,
+                                   seg == segments::none ? nullptr : h_head.data()));
+
+  Vector<T> d_data(h_data), d_out(n);
+  Vector<gdf_valid_type> d_valid(h_valid), d_out_valid(h_valid.size(), 0);
+  Vector<int32_t> d_keys(h_keys);
+  Vector<unsigned> d_offsets(h_offsets);
+
+  gdf_column in{}, out{}, keys{};
+  gdf_column_view(&in, d_data.data().get(), d_valid.data().get(), n, dtype);
+  gdf_column_view(&out, d_out.data().get(), d_out_valid.data().get(), n, dtype);
+  gdf_column_view(&keys, d_keys.data().get(), nullptr, n, GDF_INT32);
+
+  gdf_error status = GDF_SUCCESS;
+  switch(seg) {
+    case segments::none:
+      status = gdf_scan(plan, &in, &out, op, inclusive);
+      break;
+    case segments::by_key:
+      status = gdf_scan_by_key(plan, &keys, &in, &out, op, inclusive);
+      break;
+    case segments::by_offsets:
+      status = gdf_segmented_scan(plan, &in, &out, op, inclusive,
+                                  h_offsets.size(), d_offsets.data().get());
+      break;
+  }
+  ASSERT_EQ(GDF_SUCCESS, status);
+
+  std::vector<T> h_out(n);
+  std::vector<gdf_valid_type> h_out_valid(h_valid.size());
+  thrust::copy(d_out.begin(), d_out.end(), h_out.begin());
+  thrust::copy(d_out_valid.begin(), d_out_valid.end(), h_out_valid.begin());
+  EXPECT_EQ(expected, h_out) << "op " << op << " inclusive " << inclusive;
+  EXPECT_EQ(h_valid, h_out_valid);
+}
+
+TEST(ScanTest, AllOpsAndSegmentationsMatchHost)
+{
+  std::mt19937 rng(66);
+  const size_t capacity = 200003;
+  gdf_scan_plan_type * plan = gdf_scan_plan(capacity);
+  ASSERT_EQ(GDF_SUCCESS, gdf_scan_plan_setup(plan));
+
+  // One plan for every dtype, reduction and size
+  for(segments seg : {segments::none, segments::by_key, segments::by_offsets})
+    for(gdf_reduction_op op : {GDF_REDUCE_SUM, GDF_REDUCE_PRODUCT, GDF_REDUCE_MIN, GDF_REDUCE_MAX})
+      for(bool inclusive : {true, false})
+      {
+        check_scan<int8_t>(plan, GDF_INT8, op, inclusive, seg, 1001, rng);
+        check_scan<int16_t>(plan, GDF_INT16, op, inclusive, seg, 30011, rng);
+        check_scan<int32_t>(plan, GDF_INT32, op, inclusive, seg, capacity, rng);
+        check_scan<int64_t>(plan, GDF_INT64, op, inclusive, seg, 100003, rng);
+        check_scan<float>(plan, GDF_FLOAT32, op, inclusive, seg, 4099, rng);
+        check_scan<double>(plan, GDF_FLOAT64, op, inclusive, seg, capacity, rng);
+      }
+  // Small integers are exact as floating point too
+  check_scan<double>(plan, GDF_FLOAT64, GDF_REDUCE_SUM_SQUARED, true, segments::by_key, 5003, rng);
+
+  EXPECT_EQ(GDF_SUCCESS, gdf_scan_plan_free(plan));
+}
+
+TEST(ScanTest, RejectsUnsupportedInputs)
+{
+  gdf_scan_plan_type * plan = gdf_scan_plan(100);
+  ASSERT_EQ(GDF_SUCCESS, gdf_scan_plan_setup(plan));
+
+  Vector<int32_t> d_data(1000, 1), d_out(1000);
+  gdf_column in{}, out{};
+  gdf_column_view(&in, d_data.data().get(), nullptr, 1000, GDF_INT32);
+  gdf_column_view(&out, d_out.data().get(), nullptr, 1000, GDF_INT32);
+  EXPECT_EQ(GDF_COLUMN_SIZE_TOO_BIG, gdf_scan(plan, &in, &out, GDF_REDUCE_SUM, 1));
+
+  in.size = out.size = 100;
+  EXPECT_EQ(GDF_UNSUPPORTED_DTYPE, gdf_scan(plan, &in, &out, GDF_REDUCE_SUM_SQUARED, 1));
+  EXPECT_EQ(GDF_SUCCESS, gdf_scan(plan, &in, &out, GDF_REDUCE_SUM, 1));
+  EXPECT_EQ(100, static_cast<int32_t>(d_out[99]));
+
+  // Segment offsets must be non-decreasing and at most the size
+  std::vector<unsigned> h_offsets{0, 40, 40, 100};
+  Vector<unsigned> d_offsets(h_offsets);
+  EXPECT_EQ(GDF_SUCCESS, gdf_segmented_scan(plan, &in, &out, GDF_REDUCE_SUM, 1, 4, d_offsets.data().get()));
+  EXPECT_EQ(40, static_cast<int32_t>(d_out[79]));
+  d_offsets[3] = 101;
+  EXPECT_EQ(GDF_INVALID_API_CALL, gdf_segmented_scan(plan, &in, &out, GDF_REDUCE_SUM, 1, 4, d_offsets.data().get()));
+  d_offsets[3] = 30;
+  EXPECT_EQ(GDF_INVALID_API_CALL, gdf_segmented_scan(plan, &in, &out, GDF_REDUCE_SUM, 1, 4, d_offsets.data().get()));
+
+  EXPECT_EQ(GDF_SUCCESS, gdf_scan_plan_free(plan));
+
+  // A plan that was not set up has no storage to scan in
+  plan = gdf_scan_plan(100);
+  EXPECT_EQ(GDF_INVALID_API_CALL, gdf_scan(plan, &in, &out, GDF_REDUCE_SUM, 1));
+  EXPECT_EQ(GDF_SUCCESS, gdf_scan_plan_free(plan));
+}
+
+TEST(ScanTest, PrefixSumSkipsNulls)
+{
+  std::vector<float> h_data{1, 2, 3, 4, 5};
+  std::vector<gdf_valid_type> h_valid{0x1b}; // row 2 is null
+  Vector<float> d_data(h_data), d_out(5);
+  Vector<gdf_valid_type> d_valid(h_valid);
+
+  gdf_column in{}, out{};
+  gdf_column_view(&in, d_data.data().get(), d_valid.data().get(), 5, GDF_FLOAT32);
+  gdf_column_view(&out, d_out.data().get(), nullptr, 5, GDF_FLOAT32);
+  ASSERT_EQ(GDF_SUCCESS, gdf_prefixsum_generic(&in, &out, 1));
+
+  std::vector<float> h_out(5);
+  thrust::copy(d_out.begin(), d_out.end(), h_out.begin());
+  EXPECT_EQ((std::vector<float>{1, 3, 3, 7, 12}), h_out);
+}
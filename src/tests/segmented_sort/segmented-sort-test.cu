@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrust/device_vector.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gdf/gdf.h>
+#include <gdf/cffi/functions.h>
+
+#include "gtest/gtest.h"
+
+#include "../../segmented_sort/host_segmented_sort.h"
+
+template<typename T>
+using Vector = thrust::device_vector<T>;
+
+// Offsets of consecutive segments covering [0, num_items) whose sizes are
+// drawn from `segment_size`
+struct segments
+{
+  std::vector<unsigned> begin;
+  std::vector<unsigned> end;
+};
+
+segments make_segments(unsigned num_items, std::function<unsigned()> segment_size)
+{
+  segments s;
+  for(unsigned pos = 0; pos < num_items; )
+  {
+    s.begin.push_back(pos);
+    pos = std::min(num_items, pos + std::max(1u, segment_size()));
+    s.end.push_back(pos);
+  }
+  return s;
+}
+
+// Segment size distributions: name and generator
+std::vector<std::pair<std::string, std::function<unsigned()>>> segment_distributions(std::mt19937 & rng)
+{
+  return {
+    {"pairs",          [&rng]() { return 2u; }},
+    {"uniform 1-32",   [&rng]() { return 1u + rng() % 32; }},
+    {"uniform 1-1000", [&rng]() { return 1u + rng() % 1000; }},
+    {"power law",      [&rng]() { return 1u + static_cast<unsigned>(
+                                     4.0 / std::pow(std::uniform_real_distribution<double>(1e-4, 1.0)(rng), 1.5)); }},
+    {"few large",      [&rng]() { return 100000u + rng() % 100000; }}};
+}
+
+template <typename Tk>
+gdf_error device_segmented_sort(std::vector<Tk> & keys, std::vector<int64_t> & vals,
+                                segments const & s, bool descending, unsigned end_bit,
+                                double * elapsed_ms = nullptr)
+{
+  const size_t n = keys.size();
+  Vector<Tk> d_keys(keys);
+  Vector<int64_t> d_vals(vals);
+  Vector<unsigned> d_begin(s.begin);
+  Vector<unsigned> d_end(s.end);
+
+  gdf_column keycol{};
+  gdf_column valcol{};
+  gdf_column_view(&keycol, d_keys.data().get(), nullptr, n,
+                  sizeof(Tk) == 4 ? GDF_INT32 : GDF_FLOAT64);
+  gdf_column_view(&valcol, d_vals.data().get(), nullptr, n, GDF_INT64);
+
+  gdf_segmented_radixsort_plan_type * plan = gdf_segmented_radixsort_plan(n, descending, 0, end_bit);
+  gdf_error status = gdf_segmented_radixsort_plan_setup(plan, sizeof(Tk), sizeof(int64_t));
+  if( GDF_SUCCESS != status )
+    return status;
+
+  cudaDeviceSynchronize();
+  auto start = std::chrono::high_resolution_clock::now();
+  status = gdf_segmented_radixsort_generic(plan, &keycol, &valcol, s.begin.size(),
+                                           d_begin.data().get(), d_end.data().get());
+  cudaDeviceSynchronize();
+  auto stop = std::chrono::high_resolution_clock::now();
+  if( elapsed_ms )
+    *elapsed_ms = std::chrono::duration<double, std::milli>(stop - start).count();
+
+  gdf_segmented_radixsort_plan_free(plan);
+  thrust::copy(d_keys.begin(), d_keys.end(), keys.begin());
+  thrust::copy(d_vals.begin(), d_vals.end(), vals.begin());
+  return status;
+}
+
+template <typename Tk>
+void check_distributions(bool descending)
+{
+  std::mt19937 rng(57);
+  const unsigned num_items = 1 << 20;
+
+  for(auto const & dist : segment_distributions(rng))
+  {
+    segments s = make_segments(num_items, dist.second);
+
+    std::uniform_int_distribution<int> key_dist(-50, 50);
+    std::vector<Tk> keys(num_items);
+    std::vector<int64_t> vals(num_items);
+    for(unsigned i = 0; i < num_items; ++i)
+    {
+      keys[i] = static_cast<Tk>(key_dist(rng));
+      vals[i] = i;
+    }
+
+    std::vector<Tk> expected_keys(keys);
+    std::vector<int64_t> expected_vals(vals);
+    ASSERT_EQ(GDF_SUCCESS, host_segmented_sort(expected_keys.data(), expected_vals.data(),
+                                               s.begin.size(), s.begin.data(), s.end.data(),
+                                               descending));
+
+    ASSERT_EQ(GDF_SUCCESS, device_segmented_sort(keys, vals, s, descending, sizeof(Tk) * 8));
+    EXPECT_EQ(expected_keys, keys) << dist.first;
+    EXPECT_EQ(expected_vals, vals) << dist.first;
+  }
+}
+
+TEST(SegmentedSortTest, Int32AscendingAllSegmentSizes)
+{
+  check_distributions<int32_t>(false);
+}
+
+TEST(SegmentedSortTest, Float64DescendingAllSegmentSizes)
+{
+  check_distributions<double>(true);
+}
+
+TEST(SegmentedSortTest, ItemsOutsideOfSegmentsAreUntouched)
+{
+  // Segments of every bin, with gaps between them
+  segments s;
+  unsigned pos = 3;
+  for(unsigned size : {2u, 7u, 13u, 32u, 500u, 3000u, 1u, 31u})
+  {
+    s.begin.push_back(pos);
+    s.end.push_back(pos + size);
+    pos += size + 5;
+  }
+
+  std::mt19937 rng(570);
+  std::vector<int32_t> keys(pos);
+  std::vector<int64_t> vals(pos);
+  for(unsigned i = 0; i < pos; ++i)
+  {
+    keys[i] = static_cast<int32_t>(rng() % 1000) - 500;
+    vals[i] = i;
+  }
+
+  std::vector<int32_t> expected_keys(keys);
+  std::vector<int64_t> expected_vals(vals);
+  host_segmented_sort(expected_keys.data(), expected_vals.data(), s.begin.size(),
+                      s.begin.data(), s.end.data(), false);
+
+  ASSERT_EQ(GDF_SUCCESS, device_segmented_sort(keys, vals, s, false, 32));
+  EXPECT_EQ(expected_keys, keys);
+  EXPECT_EQ(expected_vals, vals);
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST(SegmentedSortTest, DISABLED_BenchmarkSegmentSizeDistributions)
+{
+  std::mt19937 rng(5700);
+  const unsigned num_items = 1 << 24;
+
+  for(auto const & dist : segment_distributions(rng))
+  {
+    segments s = make_segments(num_items, dist.second);
+
+    // Non-negative keys: sorting their low 31 bits gives the same order, and
+    // takes the plain segmented radix sort path
+    std::vector<int32_t> keys(num_items);
+    std::vector<int64_t> vals(num_items);
+    for(unsigned i = 0; i < num_items; ++i)
+    {
+      keys[i] = static_cast<int32_t>(rng() & 0x7fffffff);
+      vals[i] = i;
+    }
+
+    std::vector<int32_t> binned_keys(keys), radix_keys(keys), host_keys(keys);
+    std::vector<int64_t> binned_vals(vals), radix_vals(vals), host_vals(vals);
+    double binned_ms{0}, radix_ms{0};
+    ASSERT_EQ(GDF_SUCCESS, device_segmented_sort(binned_keys, binned_vals, s, false, 32, &binned_ms));
+    ASSERT_EQ(GDF_SUCCESS, device_segmented_sort(radix_keys, radix_vals, s, false, 31, &radix_ms));
+
+    auto start = std::chrono::high_resolution_clock::now();
+    host_segmented_sort(host_keys.data(), host_vals.data(), s.begin.size(),
+                        s.begin.data(), s.end.data(), false);
+    auto stop = std::chrono::high_resolution_clock::now();
+    const double host_ms = std::chrono::duration<double, std::milli>(stop - start).count();
+
+    EXPECT_EQ(radix_vals, binned_vals) << dist.first;
+    EXPECT_EQ(radix_vals, host_vals) << dist.first;
+    std::cout << dist.first << ": " << s.begin.size() << " segments, "
+              << "binned " << binned_ms << " ms, radix " << radix_ms << " ms, "
+              << "host " << host_ms << " ms\n";
+  }
+}
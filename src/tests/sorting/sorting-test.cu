@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrust/device_vector.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gdf/gdf.h>
+#include <gdf/cffi/functions.h>
+
+#include "gtest/gtest.h"
+
+template<typename T>
+using Vector = thrust::device_vector<T>;
+
+// Stable sort of the values by key, as the radix sort orders them
+template <typename Tk>
+void expected_sort(std::vector<Tk> & keys, std::vector<int64_t> & vals, bool descending)
+{
+  std::vector<size_t> perm(keys.size());
+  std::iota(perm.begin(), perm.end(), 0);
+  std::stable_sort(perm.begin(), perm.end(), [&](size_t a, size_t b) {
+    return descending ? keys[b] < keys[a] : keys[a] < keys[b];
+  });
+  std::vector<Tk> sorted_keys(keys.size());
+  std::vector<int64_t> sorted_vals(vals.size());
+  for(size_t i = 0; i < perm.size(); ++i)
+  {
+    sorted_keys[i] = keys[perm[i]];
+    sorted_vals[i] = vals[perm[i]];
+  }
+  keys.swap(sorted_keys);
+  vals.swap(sorted_vals);
+}
+
+std::vector<int32_t> random_keys(size_t n, std::mt19937 & rng)
+{
+  std::uniform_int_distribution<int32_t> dist(-1000, 1000);
+  std::vector<int32_t> keys(n);
+  for(auto & k : keys)
+    k = dist(rng);
+  return keys;
+}
+
+TEST(RadixSortPlanTest, ReusedAcrossSizesUpToCapacity)
+{
+  std::mt19937 rng(58);
+  const size_t capacity = 100000;
+
+  gdf_radixsort_plan_type * plan = gdf_radixsort_plan(capacity, false, 0, 32);
+  ASSERT_EQ(GDF_SUCCESS, gdf_radixsort_plan_setup(plan, sizeof(int32_t), sizeof(int64_t)));
+
+  for(size_t n : {capacity, size_t{1}, size_t{0}, size_t{777}, capacity / 2, capacity})
+  {
+    std::vector<int32_t> keys = random_keys(n, rng);
+    std::vector<int64_t> vals(n);
+    std::iota(vals.begin(), vals.end(), 0);
+
+    Vector<int32_t> d_keys(keys);
+    Vector<int64_t> d_vals(vals);
+    gdf_column keycol{};
+    gdf_column valcol{};
+    gdf_column_view(&keycol, d_keys.data().get(), nullptr, n, GDF_INT32);
+    gdf_column_view(&valcol, d_vals.data().get(), nullptr, n, GDF_INT64);
+    ASSERT_EQ(GDF_SUCCESS, gdf_radixsort_i32(plan, &keycol, &valcol)) << n;
+
+    expected_sort(keys, vals, false);
+    std::vector<int32_t> h_keys(n);
+    std::vector<int64_t> h_vals(n);
+    thrust::copy(d_keys.begin(), d_keys.end(), h_keys.begin());
+    thrust::copy(d_vals.begin(), d_vals.end(), h_vals.begin());
+    EXPECT_EQ(keys, h_keys) << n;
+    EXPECT_EQ(vals, h_vals) << n;
+  }
+
+  // Above the capacity
+  Vector<int32_t> d_big(capacity + 1);
+  Vector<int64_t> d_big_vals(capacity + 1);
+  gdf_column keycol{};
+  gdf_column valcol{};
+  gdf_column_view(&keycol, d_big.data().get(), nullptr, capacity + 1, GDF_INT32);
+  gdf_column_view(&valcol, d_big_vals.data().get(), nullptr, capacity + 1, GDF_INT64);
+  EXPECT_EQ(GDF_COLUMN_SIZE_TOO_BIG, gdf_radixsort_i32(plan, &keycol, &valcol));
+
+  ASSERT_EQ(GDF_SUCCESS, gdf_radixsort_plan_free(plan));
+}
+
+void check_batch(unsigned begin_bit, unsigned end_bit, bool descending)
+{
+  std::mt19937 rng(580);
+  const size_t capacity = 50000;
+
+  // More arrays than fit the capacity at once, of every size up to it
+  std::vector<size_t> sizes{0, 1, 2, 17, 32, 33, 1000, 1025, 5000, capacity, 3, capacity - 3, 40000};
+  for(int i = 0; i < 200; ++i)
+    sizes.push_back(1 + rng() % 300);
+
+  std::vector<std::vector<int32_t>> keys;
+  std::vector<std::vector<int64_t>> vals;
+  std::vector<Vector<int32_t>> d_keys;
+  std::vector<Vector<int64_t>> d_vals;
+  for(size_t n : sizes)
+  {
+    // Non-negative keys, as a partial bit range sorts their low bits only
+    keys.push_back(random_keys(n, rng));
+    for(auto & k : keys.back())
+      k = std::abs(k);
+    vals.emplace_back(n);
+    std::iota(vals.back().begin(), vals.back().end(), 0);
+    d_keys.emplace_back(keys.back());
+    d_vals.emplace_back(vals.back());
+  }
+
+  std::vector<gdf_column> keycols(sizes.size());
+  std::vector<gdf_column> valcols(sizes.size());
+  std::vector<gdf_column*> keycol_ptrs, valcol_ptrs;
+  for(size_t a = 0; a < sizes.size(); ++a)
+  {
+    gdf_column_view(&keycols[a], d_keys[a].data().get(), nullptr, sizes[a], GDF_INT32);
+    gdf_column_view(&valcols[a], d_vals[a].data().get(), nullptr, sizes[a], GDF_INT64);
+    keycol_ptrs.push_back(&keycols[a]);
+    valcol_ptrs.push_back(&valcols[a]);
+  }
+
+  gdf_radixsort_plan_type * plan = gdf_radixsort_plan(capacity, descending, begin_bit, end_bit);
+  ASSERT_EQ(GDF_SUCCESS, gdf_radixsort_plan_setup(plan, sizeof(int32_t), sizeof(int64_t)));
+  // Twice: the second batch reuses the staging buffers of the first
+  for(int pass = 0; pass < 2; ++pass)
+    ASSERT_EQ(GDF_SUCCESS, gdf_radixsort_batch(plan, keycol_ptrs.data(), valcol_ptrs.data(),
+                                               sizes.size()));
+  ASSERT_EQ(GDF_SUCCESS, gdf_radixsort_plan_free(plan));
+
+  for(size_t a = 0; a < sizes.size(); ++a)
+  {
+    expected_sort(keys[a], vals[a], descending);
+    std::vector<int32_t> h_keys(sizes[a]);
+    std::vector<int64_t> h_vals(sizes[a]);
+    thrust::copy(d_keys[a].begin(), d_keys[a].end(), h_keys.begin());
+    thrust::copy(d_vals[a].begin(), d_vals[a].end(), h_vals.begin());
+    EXPECT_EQ(keys[a], h_keys) << "array " << a;
+    // Sorting twice is stable: ties keep their original order
+    EXPECT_EQ(vals[a], h_vals) << "array " << a;
+  }
+}
+
+TEST(RadixSortPlanTest, BatchAscending)
+{
+  check_batch(0, 32, false);
+}
+
+TEST(RadixSortPlanTest, BatchDescending)
+{
+  check_batch(0, 32, true);
+}
+
+TEST(RadixSortPlanTest, BatchPartialBitRange)
+{
+  // Keys below 2^11 are ordered by their low 11 bits
+  check_batch(0, 11, false);
+}
+
+TEST(RadixSortPlanTest, BatchKeysOnly)
+{
+  std::mt19937 rng(5800);
+  std::vector<std::vector<int32_t>> keys{random_keys(100, rng), random_keys(3000, rng), random_keys(1, rng)};
+  std::vector<Vector<int32_t>> d_keys(keys.begin(), keys.end());
+  std::vector<gdf_column> keycols(keys.size());
+  std::vector<gdf_column*> keycol_ptrs;
+  for(size_t a = 0; a < keys.size(); ++a)
+  {
+    gdf_column_view(&keycols[a], d_keys[a].data().get(), nullptr, keys[a].size(), GDF_INT32);
+    keycol_ptrs.push_back(&keycols[a]);
+  }
+
+  gdf_radixsort_plan_type * plan = gdf_radixsort_plan(4096, false, 0, 32);
+  ASSERT_EQ(GDF_SUCCESS, gdf_radixsort_plan_setup(plan, sizeof(int32_t), sizeof(int64_t)));
+  ASSERT_EQ(GDF_SUCCESS, gdf_radixsort_batch(plan, keycol_ptrs.data(), nullptr, keys.size()));
+  ASSERT_EQ(GDF_SUCCESS, gdf_radixsort_plan_free(plan));
+
+  for(size_t a = 0; a < keys.size(); ++a)
+  {
+    std::sort(keys[a].begin(), keys[a].end());
+    std::vector<int32_t> h_keys(keys[a].size());
+    thrust::copy(d_keys[a].begin(), d_keys[a].end(), h_keys.begin());
+    EXPECT_EQ(keys[a], h_keys) << "array " << a;
+  }
+}
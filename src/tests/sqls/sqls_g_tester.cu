@@ -35,10 +35,12 @@
 #include <type_traits>
 #include <numeric>
 #include <unordered_map>
+#include <random>
 //
 
 #include <cassert>
 #include <cmath>
+#include <cstring>
 
 //
 
@@ -861,6 +863,120 @@ TEST(gdf_group_by_max, UsageTestMax)
   EXPECT_EQ( flag, true ) << "GROUP-BY MAX aggregation returns unexpected result";
 }
 
+TEST(gdf_group_by_sum, ReproducibleFloatSumAndAvg)
+{
+  //few groups of many float values of mixed magnitudes,
+  //where a plain float sum drifts:
+  //
+  const size_t nrows = 300007;
+  const int ngroups = 5;
+  std::vector<int> vk(nrows);
+  std::vector<float> vf(nrows);
+  std::vector<long double> expected_sum(ngroups, 0);
+  std::vector<size_t> expected_count(ngroups, 0);
+  for(size_t i = 0; i < nrows; ++i)
+    {
+      vk[i] = static_cast<int>((i * 7919) % ngroups);
+      vf[i] = (i % 3 == 0) ? 1.0e4f + static_cast<float>(i % 101) : 1.0e-2f * static_cast<float>(i % 13);
+      expected_sum[vk[i]] += vf[i];
+      ++expected_count[vk[i]];
+    }
+
+  Vector<int> dk = vk;
+  Vector<float> df = vf;
+
+  gdf_column c_key{};
+  gdf_column_view(&c_key, dk.data().get(), nullptr, nrows, GDF_INT32);
+  gdf_column c_agg{};
+  gdf_column_view(&c_agg, df.data().get(), nullptr, nrows, GDF_FLOAT32);
+  gdf_column* cols[] = {&c_key};
+
+  for(gdf_agg_op op : {GDF_SUM, GDF_AVG})
+    {
+      std::vector<std::vector<float>> runs;
+      for(gdf_method method : {GDF_HASH, GDF_SORT})
+        {
+          Vector<float> d_out(nrows, 0);
+          gdf_column c_vout{};
+          gdf_column_view(&c_vout, d_out.data().get(), nullptr, nrows, GDF_FLOAT32);
+
+          //hash-based SUM and AVG fall back to the sort-based ones:
+          //
+          gdf_context ctxt{0, method, 0, 0};
+          ctxt.flag_reproducible_sum = 1;
+          gdf_error status = (op == GDF_SUM)
+            ? gdf_group_by_sum(1, cols, &c_agg, nullptr, nullptr, &c_vout, &ctxt)
+            : gdf_group_by_avg(1, cols, &c_agg, nullptr, nullptr, &c_vout, &ctxt);
+          ASSERT_EQ( GDF_SUCCESS, status );
+          ASSERT_EQ( static_cast<size_t>(ngroups), c_vout.size );
+          EXPECT_EQ( 1, ctxt.flag_output_sorted );
+
+          std::vector<float> h_out(ngroups);
+          thrust::copy_n(d_out.begin(), ngroups, h_out.begin());
+          runs.push_back(h_out);
+        }
+      EXPECT_EQ( runs[0], runs[1] );
+
+      for(int g = 0; g < ngroups; ++g)
+        {
+          long double expected = expected_sum[g];
+          if( op == GDF_AVG )
+            expected /= expected_count[g];
+          EXPECT_NEAR( static_cast<double>(expected), runs[0][g], 1.e-6 * std::abs(static_cast<double>(expected)) )
+            << "group " << g;
+        }
+    }
+}
+
+TEST(gdf_group_by_sum, ReproducibleFloatSumIsBitwiseStable)
+{
+  //values of both signs over many orders of magnitude, where any change
+  //in the order of the additions changes the rounding of the sums:
+  //
+  const size_t nrows = 1000003;
+  const int ngroups = 3;
+  std::vector<int> vk(nrows);
+  std::vector<double> vd(nrows);
+  std::mt19937 rng(65);
+  std::uniform_real_distribution<double> mantissa(-1.0, 1.0);
+  std::uniform_int_distribution<int> exponent(-40, 40);
+  for(size_t i = 0; i < nrows; ++i)
+    {
+      vk[i] = static_cast<int>(rng() % ngroups);
+      vd[i] = std::ldexp(mantissa(rng), exponent(rng));
+    }
+
+  Vector<int> dk = vk;
+  Vector<double> dd = vd;
+
+  gdf_column c_key{};
+  gdf_column_view(&c_key, dk.data().get(), nullptr, nrows, GDF_INT32);
+  gdf_column c_agg{};
+  gdf_column_view(&c_agg, dd.data().get(), nullptr, nrows, GDF_FLOAT64);
+  gdf_column* cols[] = {&c_key};
+
+  std::vector<std::vector<double>> runs;
+  for(int run = 0; run < 4; ++run)
+    {
+      Vector<double> d_out(nrows, 0);
+      gdf_column c_vout{};
+      gdf_column_view(&c_vout, d_out.data().get(), nullptr, nrows, GDF_FLOAT64);
+
+      gdf_context ctxt{0, GDF_SORT, 0, 0};
+      ctxt.flag_reproducible_sum = 1;
+      ASSERT_EQ( GDF_SUCCESS, gdf_group_by_sum(1, cols, &c_agg, nullptr, nullptr, &c_vout, &ctxt) );
+      ASSERT_EQ( static_cast<size_t>(ngroups), c_vout.size );
+
+      std::vector<double> h_out(ngroups);
+      thrust::copy_n(d_out.begin(), ngroups, h_out.begin());
+      runs.push_back(h_out);
+    }
+
+  for(size_t run = 1; run < runs.size(); ++run)
+    EXPECT_EQ( 0, std::memcmp(runs[0].data(), runs[run].data(), ngroups * sizeof(double)) )
+      << "run " << run;
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -24,10 +24,16 @@
 #include <bitset>
 #include <numeric> // for std::accumulate
 #include <memory>
+#include <random>
+#include <vector>
 #include "../../util/bit_util.cuh"
 
+#include <thrust/device_vector.h>
 #include <thrust/equal.h>
 
+template <typename T>
+using Vector = thrust::device_vector<T>;
+
 // Type for a unique_ptr to a gdf_column with a custom deleter
 // Custom deleter is defined at construction
 using gdf_col_pointer = typename std::unique_ptr<gdf_column, 
@@ -347,5 +353,81 @@ bool gdf_equal_columns(gdf_column* left, gdf_column* right)
   return true;
 }
 
+/** ---------------------------------------------------------------------------*
+ * @brief Random validity bitmask for n rows
+ *
+ * @param n The number of rows
+ * @param rng The generator to draw from
+ * @param mostly_valid Sets each bit with probability 3/4 instead of 1/2
+ * @return std::vector<gdf_valid_type> The bitmask
+ * ---------------------------------------------------------------------------**/
+inline std::vector<gdf_valid_type> random_valid(size_t n, std::mt19937 & rng,
+                                                bool mostly_valid = false)
+{
+  std::vector<gdf_valid_type> valid(gdf_get_num_chars_bitmask(n));
+  for(auto & v : valid)
+    v = static_cast<gdf_valid_type>(mostly_valid ? rng() | rng() : rng());
+  return valid;
+}
+
+/** ---------------------------------------------------------------------------*
+ * @brief n values drawn uniformly from the integers in [lo, hi]
+ * ---------------------------------------------------------------------------**/
+template <typename T>
+std::vector<T> random_vector(size_t n, int lo, int hi, std::mt19937 & rng)
+{
+  std::uniform_int_distribution<int> dist(lo, hi);
+  std::vector<T> v(n);
+  for(auto & x : v)
+    x = static_cast<T>(dist(rng));
+  return v;
+}
+
+/** ---------------------------------------------------------------------------*
+ * @brief Copies a device vector back to the host
+ * ---------------------------------------------------------------------------**/
+template <typename T>
+std::vector<T> to_host(Vector<T> const & d)
+{
+  std::vector<T> h(d.size());
+  thrust::copy(d.begin(), d.end(), h.begin());
+  return h;
+}
+
+/** ---------------------------------------------------------------------------*
+ * @brief Wraps existing data and validity in a gdf_column without taking
+ * ownership of either
+ * ---------------------------------------------------------------------------**/
+template <typename T>
+gdf_column make_column(T * data, gdf_valid_type * valid, size_t size, gdf_dtype dtype)
+{
+  gdf_column col{};
+  col.data = data;
+  col.valid = valid;
+  col.size = size;
+  col.dtype = dtype;
+  col.null_count = 0;
+  return col;
+}
+
+/** ---------------------------------------------------------------------------*
+ * @brief Wraps a device vector in a gdf_column with no validity
+ * ---------------------------------------------------------------------------**/
+template <typename T>
+gdf_column make_column(Vector<T> & d_data, gdf_dtype dtype)
+{
+  return make_column(d_data.data().get(), nullptr, d_data.size(), dtype);
+}
+
+/** ---------------------------------------------------------------------------*
+ * @brief Wraps a host vector in a gdf_column with no validity, for the host
+ * reference implementations
+ * ---------------------------------------------------------------------------**/
+template <typename T>
+gdf_column make_host_column(std::vector<T> & h_data, gdf_dtype dtype)
+{
+  return make_column(h_data.data(), nullptr, h_data.size(), dtype);
+}
+
 
 #endif
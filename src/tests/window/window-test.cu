@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrust/device_vector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/cffi/functions.h>
+
+#include "gtest/gtest.h"
+
+#include "../test_utils/gdf_test_utils.cuh"
+
+#include "../../window/host_window.h"
+
+const std::vector<window_reduction_type> all_reductions{
+  GDF_WINDOW_AVG, GDF_WINDOW_SUM, GDF_WINDOW_MAX, GDF_WINDOW_MIN,
+  GDF_WINDOW_COUNT, GDF_WINDOW_STDDEV, GDF_WINDOW_VAR};
+
+// Runs one reduction of a device column and copies the aggregates and their
+// validity back
+void device_window(gdf_column * values, window_reduction_type reduction,
+                   gdf_column ** partitions, int num_partitions,
+                   gdf_column ** orders, order_by_type * order_by_types, int num_orders,
+                   window_function_type type, double preceding, double following,
+                   gdf_size_type min_periods,
+                   std::vector<double> & out, std::vector<gdf_valid_type> & out_valid)
+{
+  const size_t n = values->size;
+  Vector<double> d_out(n);
+  Vector<gdf_valid_type> d_out_valid(gdf_get_num_chars_bitmask(n));
+  gdf_column out_col{};
+  gdf_column_view(&out_col, d_out.data().get(), d_out_valid.data().get(), n, GDF_FLOAT64);
+  gdf_column * out_ptr = &out_col;
+
+  ASSERT_EQ(GDF_SUCCESS, gdf_window_function(&values, &reduction, 1,
+                                             partitions, num_partitions,
+                                             orders, order_by_types, num_orders,
+                                             type, preceding, following, min_periods,
+                                             &out_ptr));
+  out.resize(n);
+  out_valid.resize(d_out_valid.size());
+  thrust::copy(d_out.begin(), d_out.end(), out.begin());
+  thrust::copy(d_out_valid.begin(), d_out_valid.end(), out_valid.begin());
+}
+
+void expect_window_near(std::vector<double> const & expected,
+                        std::vector<gdf_valid_type> const & expected_valid,
+                        std::vector<double> const & actual,
+                        std::vector<gdf_valid_type> const & actual_valid,
+                        window_reduction_type reduction)
+{
+  ASSERT_EQ(expected_valid, actual_valid) << reduction;
+  for(size_t i = 0; i < expected.size(); ++i)
+    if( gdf_is_valid(expected_valid.data(), i) )
+      ASSERT_NEAR(expected[i], actual[i], 1e-9 * std::abs(expected[i]) + 1e-9)
+        << reduction << " row " << i;
+}
+
+TEST(WindowTest, RollingMatchesHostWithNulls)
+{
+  std::mt19937 rng(70);
+  const size_t n = 100003;
+  std::vector<double> h_data(n);
+  std::normal_distribution<double> dist(1000.0, 5.0);
+  for(auto & x : h_data)
+    x = dist(rng);
+  std::vector<gdf_valid_type> h_valid = random_valid(n, rng, true);
+
+  Vector<double> d_data(h_data);
+  Vector<gdf_valid_type> d_valid(h_valid);
+  gdf_column col{};
+  gdf_column_view(&col, d_data.data().get(), d_valid.data().get(), n, GDF_FLOAT64);
+
+  const window_frame frame{GDF_WINDOW_ROW, 5, 2};
+  for(window_reduction_type reduction : all_reductions)
+  {
+    std::vector<double> expected(n);
+    std::vector<gdf_valid_type> expected_valid(gdf_get_num_chars_bitmask(n));
+    host_window_rows(h_data.data(), h_valid.data(), std::vector<size_t>{0, n}, frame,
+                     reduction, 2, expected.data(), expected_valid.data());
+
+    std::vector<double> actual;
+    std::vector<gdf_valid_type> actual_valid;
+    device_window(&col, reduction, nullptr, 0, nullptr, nullptr, 0,
+                  GDF_WINDOW_ROW, 5, 2, 2, actual, actual_valid);
+    expect_window_near(expected, expected_valid, actual, actual_valid, reduction);
+  }
+}
+
+TEST(WindowTest, PartitionedAndOrderedMatchesHost)
+{
+  std::mt19937 rng(700);
+  const size_t n = 50000;
+  std::vector<int32_t> h_keys(n);
+  std::vector<int64_t> h_time(n);
+  std::vector<int32_t> h_data(n);
+  std::iota(h_time.begin(), h_time.end(), 0);
+  std::shuffle(h_time.begin(), h_time.end(), rng);
+  for(size_t i = 0; i < n; ++i)
+  {
+    h_keys[i] = static_cast<int32_t>(rng() % 37);
+    h_data[i] = static_cast<int32_t>(rng() % 2001) - 1000;
+  }
+  std::vector<gdf_valid_type> h_valid = random_valid(n, rng, true);
+
+  // Host reference: rows sorted by key, then time descending
+  std::vector<size_t> perm(n);
+  std::iota(perm.begin(), perm.end(), 0);
+  std::sort(perm.begin(), perm.end(), [&](size_t a, size_t b) {
+    return h_keys[a] != h_keys[b] ? h_keys[a] < h_keys[b] : h_time[a] > h_time[b];
+  });
+  std::vector<int32_t> sorted_data(n);
+  std::vector<gdf_valid_type> sorted_valid(h_valid.size(), 0);
+  std::vector<size_t> offsets;
+  for(size_t i = 0; i < n; ++i)
+  {
+    sorted_data[i] = h_data[perm[i]];
+    if( gdf_is_valid(h_valid.data(), perm[i]) )
+      sorted_valid[i / GDF_VALID_BITSIZE] |= gdf_valid_type(1) << (i % GDF_VALID_BITSIZE);
+    if( i == 0 || h_keys[perm[i]] != h_keys[perm[i - 1]] )
+      offsets.push_back(i);
+  }
+  offsets.push_back(n);
+
+  Vector<int32_t> d_keys(h_keys), d_data(h_data);
+  Vector<int64_t> d_time(h_time);
+  Vector<gdf_valid_type> d_valid(h_valid);
+  gdf_column keys{}, time{}, col{};
+  gdf_column_view(&keys, d_keys.data().get(), nullptr, n, GDF_INT32);
+  gdf_column_view(&time, d_time.data().get(), nullptr, n, GDF_TIMESTAMP);
+  gdf_column_view(&col, d_data.data().get(), d_valid.data().get(), n, GDF_INT32);
+  gdf_column * partitions[] = {&keys};
+  gdf_column * orders[] = {&time};
+  order_by_type order_by_types[] = {GDF_ORDER_DESC};
+
+  // Sliding, and cumulative (UNBOUNDED PRECEDING to the current row)
+  for(window_frame frame : {window_frame{GDF_WINDOW_ROW, 3, 3}, window_frame{GDF_WINDOW_ROW, -1, 0}})
+  {
+    for(window_reduction_type reduction : all_reductions)
+    {
+      std::vector<double> sorted_expected(n);
+      std::vector<gdf_valid_type> sorted_expected_valid(h_valid.size());
+      host_window_rows(sorted_data.data(), sorted_valid.data(), offsets, frame, reduction, 1,
+                       sorted_expected.data(), sorted_expected_valid.data());
+      std::vector<double> expected(n);
+      std::vector<gdf_valid_type> expected_valid(h_valid.size(), 0);
+      for(size_t i = 0; i < n; ++i)
+      {
+        expected[perm[i]] = sorted_expected[i];
+        if( gdf_is_valid(sorted_expected_valid.data(), i) )
+          expected_valid[perm[i] / GDF_VALID_BITSIZE] |= gdf_valid_type(1) << (perm[i] % GDF_VALID_BITSIZE);
+      }
+
+      std::vector<double> actual;
+      std::vector<gdf_valid_type> actual_valid;
+      device_window(&col, reduction, partitions, 1, orders, order_by_types, 1,
+                    GDF_WINDOW_ROW, frame.preceding, frame.following, 1, actual, actual_valid);
+      expect_window_near(expected, expected_valid, actual, actual_valid, reduction);
+    }
+  }
+}
+
+TEST(WindowTest, RangeFrames)
+{
+  // Order values with ties and gaps, in a single partition
+  std::vector<int32_t> h_time{1, 2, 2, 5, 6, 10};
+  std::vector<double> h_data{1, 2, 3, 4, 5, 6};
+  const size_t n = h_time.size();
+  Vector<int32_t> d_time(h_time);
+  Vector<double> d_data(h_data);
+  gdf_column time{}, col{};
+  gdf_column_view(&time, d_time.data().get(), nullptr, n, GDF_DATE32);
+  gdf_column_view(&col, d_data.data().get(), nullptr, n, GDF_FLOAT64);
+  gdf_column * orders[] = {&time};
+
+  // RANGE BETWEEN 1 PRECEDING AND CURRENT ROW, peers included
+  std::vector<double> sums;
+  std::vector<gdf_valid_type> valid;
+  device_window(&col, GDF_WINDOW_SUM, nullptr, 0, orders, nullptr, 1,
+                GDF_WINDOW_RANGE, 1, 0, 1, sums, valid);
+  EXPECT_EQ((std::vector<double>{1, 6, 6, 4, 9, 6}), sums);
+
+  std::vector<double> maxima;
+  device_window(&col, GDF_WINDOW_MAX, nullptr, 0, orders, nullptr, 1,
+                GDF_WINDOW_RANGE, 4, -1, 1, maxima, valid);
+  EXPECT_EQ((std::vector<double>{6, 6, 6, 6, 6, 6}), maxima);
+
+  std::vector<double> minima;
+  device_window(&col, GDF_WINDOW_MIN, nullptr, 0, orders, nullptr, 1,
+                GDF_WINDOW_RANGE, 4, 0, 1, minima, valid);
+  EXPECT_EQ((std::vector<double>{1, 1, 1, 1, 2, 5}), minima);
+}
+
+TEST(WindowTest, CountIntoInt64)
+{
+  const size_t n = 10;
+  Vector<float> d_data(n, 1.0f);
+  std::vector<gdf_valid_type> h_valid{0x55, 0x03};
+  Vector<gdf_valid_type> d_valid(h_valid);
+  gdf_column col{};
+  gdf_column_view(&col, d_data.data().get(), d_valid.data().get(), n, GDF_FLOAT32);
+  gdf_column * cols[] = {&col};
+
+  Vector<int64_t> d_out(n);
+  gdf_column out{};
+  gdf_column_view(&out, d_out.data().get(), nullptr, n, GDF_INT64);
+  gdf_column * outs[] = {&out};
+  window_reduction_type reduction = GDF_WINDOW_COUNT;
+  ASSERT_EQ(GDF_SUCCESS, gdf_window_function(cols, &reduction, 1, nullptr, 0, nullptr, nullptr, 0,
+                                             GDF_WINDOW_ROW, 1, 1, 0, outs));
+
+  std::vector<int64_t> counts(n);
+  thrust::copy(d_out.begin(), d_out.end(), counts.begin());
+  EXPECT_EQ((std::vector<int64_t>{1, 2, 1, 2, 1, 2, 1, 2, 2, 2}), counts);
+
+  // Only counts can be written as integers
+  reduction = GDF_WINDOW_SUM;
+  EXPECT_EQ(GDF_UNSUPPORTED_DTYPE,
+            gdf_window_function(cols, &reduction, 1, nullptr, 0, nullptr, nullptr, 0,
+                                GDF_WINDOW_ROW, 1, 1, 0, outs));
+}
+
+TEST(WindowTest, RowBoundsPastThePartition)
+{
+  const size_t n = 6;
+  std::vector<double> h_data{1, 2, 3, 4, 5, 6};
+  Vector<double> d_data(h_data);
+  gdf_column col{};
+  gdf_column_view(&col, d_data.data().get(), nullptr, n, GDF_FLOAT64);
+
+  // Bounds too large for any index cover the whole column
+  std::vector<double> sums;
+  std::vector<gdf_valid_type> valid;
+  device_window(&col, GDF_WINDOW_SUM, nullptr, 0, nullptr, nullptr, 0,
+                GDF_WINDOW_ROW, 1e300, INFINITY, 1, sums, valid);
+  EXPECT_EQ(std::vector<double>(n, 21), sums);
+
+  Vector<double> d_out(n);
+  gdf_column out{};
+  gdf_column_view(&out, d_out.data().get(), nullptr, n, GDF_FLOAT64);
+  gdf_column * cols[] = {&col};
+  gdf_column * outs[] = {&out};
+  window_reduction_type reduction = GDF_WINDOW_SUM;
+  EXPECT_EQ(GDF_INVALID_API_CALL,
+            gdf_window_function(cols, &reduction, 1, nullptr, 0, nullptr, nullptr, 0,
+                                GDF_WINDOW_ROW, NAN, 1, 0, outs));
+  EXPECT_EQ(GDF_INVALID_API_CALL,
+            gdf_window_function(cols, &reduction, 1, nullptr, 0, nullptr, nullptr, 0,
+                                GDF_WINDOW_RANGE, 1, NAN, 0, outs));
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <future>
+#include <memory>
+
+#include <gdf/gdf.h>
+
+#include "host_executor.h"
+
+/**
+ * @brief An execution context: a CUDA stream for device columns, or a
+ * host_executor for host columns. Operations queued on a context run
+ * asynchronously and in order.
+ */
+struct gdf_exec_context_
+{
+  cudaStream_t stream = 0;                          // device contexts
+  bool owns_stream = false;
+  std::unique_ptr<gdf::util::host_executor> host;   // host contexts
+};
+
+/**
+ * @brief A point in the work of an execution context: a CUDA event, or the
+ * future of a host_executor.
+ */
+struct gdf_exec_event_
+{
+  cudaEvent_t event = nullptr;                      // device contexts
+  std::shared_future<void> done;                    // host contexts
+};
+
+namespace gdf {
+namespace util {
+
+/**
+ * @brief The stream of a context; a null context is the default stream.
+ */
+inline cudaStream_t exec_stream(gdf_exec_context context)
+{
+  return (nullptr != context) ? context->stream : 0;
+}
+
+/**
+ * @brief The executor of a host context, nullptr for a device one.
+ */
+inline host_executor * exec_host(gdf_exec_context context)
+{
+  return (nullptr != context) ? context->host.get() : nullptr;
+}
+
+} // namespace util
+} // namespace gdf
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "host_parallel.h"
+
+namespace gdf {
+namespace util {
+
+/**
+ * @brief The host counterpart of a CUDA stream: operations are queued and
+ * run asynchronously, one after the other in the order they were queued, on
+ * a pool of threads that lives as long as the executor.
+ *
+ * Each operation runs on the dispatcher thread, and splits its rows between
+ * all the threads of the pool with `parallel_for`, so that queuing an
+ * operation creates no thread. Completion is observed through the futures
+ * returned by `record`, the counterpart of CUDA events.
+ */
+class host_executor
+{
+public:
+  /**
+   * @brief Starts a pool of `num_threads` threads, the dispatcher included;
+   * 0 for the hardware concurrency.
+   */
+  explicit host_executor(unsigned num_threads = 0)
+  {
+    if( 0 == num_threads )
+      num_threads = std::max(1u, std::thread::hardware_concurrency());
+    for(unsigned t = 1; t < num_threads; ++t)
+      helpers_.emplace_back(&host_executor::helper_loop, this, t);
+    dispatcher_ = std::thread(&host_executor::dispatcher_loop, this);
+  }
+
+  /**
+   * @brief Waits for the queued operations, then stops the pool.
+   */
+  ~host_executor()
+  {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      stopping_ = true;
+    }
+    queue_cv_.notify_all();
+    dispatcher_.join();
+    {
+      std::lock_guard<std::mutex> lock(job_mutex_);
+      ++job_generation_;
+      job_ = nullptr;
+    }
+    job_cv_.notify_all();
+    for(auto & helper : helpers_)
+      helper.join();
+  }
+
+  host_executor(host_executor const &) = delete;
+  host_executor & operator=(host_executor const &) = delete;
+
+  unsigned num_threads() const { return static_cast<unsigned>(helpers_.size()) + 1; }
+
+  /**
+   * @brief Queues an operation, to run after all those queued before it.
+   */
+  void enqueue(std::function<void()> operation)
+  {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      queue_.push_back(std::move(operation));
+    }
+    queue_cv_.notify_one();
+  }
+
+  /**
+   * @brief A future that is ready once all the operations queued so far
+   * are done.
+   */
+  std::shared_future<void> record()
+  {
+    auto done = std::make_shared<std::promise<void>>();
+    std::shared_future<void> future = done->get_future().share();
+    enqueue([done]() { done->set_value(); });
+    return future;
+  }
+
+  /**
+   * @brief Waits for all the operations queued so far.
+   */
+  void synchronize() { record().wait(); }
+
+  /**
+   * @brief From within an operation: splits [0, n) into at most
+   * `num_threads` contiguous ranges and calls `f(thread_id, begin, end)` for
+   * each of them on the threads of the pool, as host_parallel_for does.
+   * Returns once every range is done.
+   */
+  template <typename Functor>
+  void parallel_for(size_t n, unsigned num_threads, Functor f)
+  {
+    num_threads = std::max(1u, std::min(num_threads, this->num_threads()));
+    const size_t chunk = (n + num_threads - 1) / num_threads;
+    if( num_threads == 1 )
+    {
+      f(0u, size_t{0}, n);
+      return;
+    }
+
+    std::function<void(unsigned)> range = [&](unsigned t) {
+      const size_t begin = std::min(n, t * chunk);
+      const size_t end = std::min(n, begin + chunk);
+      if( t < num_threads && begin < end )
+        f(t, begin, end);
+    };
+    {
+      std::lock_guard<std::mutex> lock(job_mutex_);
+      job_ = range;
+      job_remaining_ = static_cast<unsigned>(helpers_.size());
+      ++job_generation_;
+    }
+    job_cv_.notify_all();
+    range(0);
+
+    std::unique_lock<std::mutex> lock(job_mutex_);
+    job_done_cv_.wait(lock, [this]() { return 0 == job_remaining_; });
+    job_ = nullptr;
+  }
+
+private:
+  void dispatcher_loop()
+  {
+    for(;;)
+    {
+      std::function<void()> operation;
+      {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        queue_cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+        if( queue_.empty() )
+          return;
+        operation = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      operation();
+    }
+  }
+
+  void helper_loop(unsigned t)
+  {
+    unsigned long seen = 0;
+    for(;;)
+    {
+      std::function<void(unsigned)> job;
+      {
+        std::unique_lock<std::mutex> lock(job_mutex_);
+        job_cv_.wait(lock, [&]() { return job_generation_ != seen; });
+        seen = job_generation_;
+        if( !job_ )
+          return;
+        job = job_;
+      }
+      job(t);
+      {
+        std::lock_guard<std::mutex> lock(job_mutex_);
+        --job_remaining_;
+      }
+      job_done_cv_.notify_one();
+    }
+  }
+
+  // The queue of operations
+  std::mutex queue_mutex_;
+  std::condition_variable queue_cv_;
+  std::deque<std::function<void()>> queue_;
+  bool stopping_ = false;
+  std::thread dispatcher_;
+
+  // The ranges of the current parallel_for
+  std::mutex job_mutex_;
+  std::condition_variable job_cv_;
+  std::condition_variable job_done_cv_;
+  std::function<void(unsigned)> job_;
+  unsigned long job_generation_ = 0;
+  unsigned job_remaining_ = 0;
+  std::vector<std::thread> helpers_;
+};
+
+/**
+ * @brief host_parallel_for on the pool of an executor, or on threads of its
+ * own without one.
+ */
+template <typename Functor>
+void host_parallel_for(host_executor * executor, size_t n, unsigned num_threads, Functor f)
+{
+  if( nullptr != executor )
+    executor->parallel_for(n, num_threads, f);
+  else
+    host_parallel_for(n, num_threads, f);
+}
+
+} // namespace util
+} // namespace gdf
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace gdf {
+namespace util {
+
+// Minimum amount of work (rows) worth handing to a separate host thread
+static constexpr size_t HostMinRowsPerThread = 1 << 15;
+
+/**
+ * @brief Number of host threads to use for `n` rows of work: at most the
+ * hardware concurrency, and at least HostMinRowsPerThread rows per thread.
+ */
+inline unsigned host_num_threads(size_t n, size_t min_rows_per_thread = HostMinRowsPerThread)
+{
+  const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+  const size_t by_size = std::max<size_t>(1, n / std::max<size_t>(1, min_rows_per_thread));
+  return static_cast<unsigned>(std::min(hw, by_size));
+}
+
+/**
+ * @brief Splits [0, n) into `num_threads` contiguous ranges and calls
+ * `f(thread_id, begin, end)` for each of them, the first one on the calling
+ * thread. Returns once every range is done.
+ */
+template <typename Functor>
+void host_parallel_for(size_t n, unsigned num_threads, Functor f)
+{
+  num_threads = std::max(1u, num_threads);
+  const size_t chunk = (n + num_threads - 1) / num_threads;
+
+  std::vector<std::thread> threads;
+  for(unsigned t = 1; t < num_threads; ++t)
+  {
+    const size_t begin = std::min(n, t * chunk);
+    const size_t end = std::min(n, begin + chunk);
+    threads.emplace_back(f, t, begin, end);
+  }
+  f(0u, size_t{0}, std::min(n, chunk));
+  for(auto & thread : threads)
+    thread.join();
+}
+
+} // namespace util
+} // namespace gdf
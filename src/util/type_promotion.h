@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <gdf/gdf.h>
+
+#include <limits>
+#include <type_traits>
+
+namespace gdf {
+namespace util {
+
+/**
+ * @brief The type two operands are promoted to: the wider of two integers;
+ * double if either is a double, or a float meets an integer of 32 bits or
+ * more, as int32 does not fit in a float; float otherwise. Divisions promote
+ * integers to double.
+ */
+template <typename L, typename R>
+struct PromotedType {
+  static const bool any_real = std::is_floating_point<L>::value || std::is_floating_point<R>::value;
+  static const bool any_double = std::is_same<L, double>::value || std::is_same<R, double>::value;
+  static const bool wide_integer = (std::is_integral<L>::value && sizeof(L) >= 4) ||
+                                   (std::is_integral<R>::value && sizeof(R) >= 4);
+
+  typedef typename std::conditional<(sizeof(L) >= sizeof(R)), L, R>::type wider_integer;
+  typedef typename std::conditional<any_double || wide_integer, double, float>::type real;
+  typedef typename std::conditional<any_real, real, wider_integer>::type type;
+  typedef typename std::conditional<any_real, real, double>::type division;
+};
+
+/**
+ * @brief The type a column of T is compared in with a scalar of S: the
+ * promoted type for an integer column, so that an int8 column is not compared
+ * to a truncated 300 or 2.5; the type of the column otherwise, so that a
+ * float column is compared with a double scalar as floats.
+ */
+template <typename T, typename S>
+struct ScalarComparisonType {
+  typedef typename std::conditional<std::is_integral<T>::value,
+                                    typename PromotedType<T, S>::type, T>::type type;
+};
+
+/**
+ * @brief Whether the value of a scalar is represented exactly in T. Only the
+ * range of integers is checked: a real value converted to a real type is
+ * rounded, not wrapped.
+ */
+template <typename T, typename S>
+bool scalar_fits(S value) {
+  return !(std::is_integral<T>::value && std::is_integral<S>::value) ||
+         (static_cast<typename PromotedType<T, S>::type>(value) >=
+            static_cast<typename PromotedType<T, S>::type>(std::numeric_limits<T>::lowest()) &&
+          static_cast<typename PromotedType<T, S>::type>(value) <=
+            static_cast<typename PromotedType<T, S>::type>(std::numeric_limits<T>::max()));
+}
+
+inline bool is_date_dtype(gdf_dtype dtype) {
+  return GDF_DATE32 == dtype || GDF_DATE64 == dtype || GDF_TIMESTAMP == dtype;
+}
+
+/**
+ * @brief Calls `f(value)` with the value of a numeric or date scalar, in the
+ * type it is stored as.
+ */
+template <typename F>
+gdf_error scalar_dispatch(const gdf_scalar &scalar, F &f) {
+  switch ( scalar.dtype ) {
+  case GDF_INT8:      return f(scalar.data.si08);
+  case GDF_INT16:     return f(scalar.data.si16);
+  case GDF_INT32:
+  case GDF_DATE32:    return f(scalar.data.si32);
+  case GDF_INT64:
+  case GDF_DATE64:
+  case GDF_TIMESTAMP: return f(scalar.data.si64);
+  case GDF_FLOAT32:   return f(scalar.data.fp32);
+  case GDF_FLOAT64:   return f(scalar.data.fp64);
+  default:            return GDF_UNSUPPORTED_DTYPE;
+  }
+}
+
+}  // namespace util
+}  // namespace gdf
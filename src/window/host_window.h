@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_WINDOW_HOST_WINDOW_H
+#define GDF_WINDOW_HOST_WINDOW_H
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+
+#include "window.h"
+#include "../util/host_parallel.h"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Aggregates the rows of one partition over row frames.
+ *
+ * Both ends of a row frame only move forward, so the frame is slid one row
+ * at a time: count, sum and sum of squares add the row that enters it and
+ * subtract the one that leaves it, in O(1), and min and max keep a monotonic
+ * deque of the positions that may still be the extremum of a later frame,
+ * so that every row is pushed and popped once.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+void host_window_partition(T const *              data,
+                           gdf_valid_type const * valid,
+                           size_t                 begin,
+                           size_t                 end,
+                           window_frame const &   frame,
+                           window_reduction_type  reduction,
+                           double                 shift,
+                           int64_t                min_periods,
+                           double *               out,
+                           uint8_t *              out_flags)
+{
+  const bool is_min = GDF_WINDOW_MIN == reduction;
+  const bool extremum = window_is_extremum(reduction);
+  const double rows = static_cast<double>(end);
+  const size_t preceding = static_cast<size_t>(std::min(std::max(frame.preceding, 0.0), rows));
+  const size_t following = static_cast<size_t>(std::min(std::max(frame.following, 0.0), rows));
+
+  int64_t count = 0;
+  double sum = 0, sum_squares = 0;
+  std::deque<size_t> candidates;
+  size_t lo = begin, hi = begin;    // the current frame [lo, hi)
+
+  for(size_t i = begin; i < end; ++i)
+  {
+    const size_t next_hi = (frame.unbounded_following() || end - i <= following) ? end : i + following + 1;
+    const size_t next_lo = (frame.unbounded_preceding() || i - begin <= preceding) ? begin : i - preceding;
+    for(; hi < next_hi; ++hi)
+    {
+      if( !gdf_is_valid(valid, hi) )
+        continue;
+      const double v = static_cast<double>(data[hi]);
+      ++count;
+      sum += v - shift;
+      sum_squares += (v - shift) * (v - shift);
+      if( extremum )
+      {
+        while( !candidates.empty() &&
+               (is_min ? static_cast<double>(data[candidates.back()]) >= v
+                       : static_cast<double>(data[candidates.back()]) <= v) )
+          candidates.pop_back();
+        candidates.push_back(hi);
+      }
+    }
+    for(; lo < next_lo; ++lo)
+    {
+      if( !gdf_is_valid(valid, lo) )
+        continue;
+      const double v = static_cast<double>(data[lo]);
+      --count;
+      sum -= v - shift;
+      sum_squares -= (v - shift) * (v - shift);
+    }
+    while( !candidates.empty() && candidates.front() < lo )
+      candidates.pop_front();
+
+    double result = 0;
+    const double ext = candidates.empty() ? 0 : static_cast<double>(data[candidates.front()]);
+    const bool is_valid = window_result(reduction, count, sum, sum_squares, ext, shift,
+                                        min_periods, result);
+    out[i] = is_valid ? result : std::numeric_limits<double>::quiet_NaN();
+    out_flags[i] = is_valid;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of window_aggregate for row frames: aggregates
+ * a host column, already in window order, over the row frames of every
+ * partition.
+ *
+ * Partitions are split between host threads, each one slid over with
+ * host_window_partition. The aggregates are written as doubles, and null
+ * ones as NaN.
+ *
+ * @Param[in] data The values, in window order
+ * @Param[in] valid The validity bitmask of the values, or nullptr
+ * @Param[in] partition_offsets The first row of every partition, and the
+ * number of rows last
+ * @Param[in] frame A GDF_WINDOW_ROW frame
+ * @Param[in] reduction The aggregate
+ * @Param[in] min_periods The least number of valid values of a non-null
+ * aggregate
+ * @Param[out] out The aggregate of every row
+ * @Param[out] out_valid The validity of the aggregates, or nullptr
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+void host_window_rows(T const *                   data,
+                      gdf_valid_type const *      valid,
+                      std::vector<size_t> const & partition_offsets,
+                      window_frame const &        frame,
+                      window_reduction_type       reduction,
+                      int64_t                     min_periods,
+                      double *                    out,
+                      gdf_valid_type *            out_valid)
+{
+  const size_t num_rows = partition_offsets.back();
+  const size_t num_partitions = partition_offsets.size() - 1;
+
+  // Sums are taken about the mean of the valid values, as on the device
+  double shift = 0;
+  size_t num_valid = 0;
+  if( !window_is_extremum(reduction) )
+    for(size_t i = 0; i < num_rows; ++i)
+      if( gdf_is_valid(valid, i) )
+      {
+        ++num_valid;
+        shift += (static_cast<double>(data[i]) - shift) / num_valid;
+      }
+
+  // Threads would share the bytes of the mask at partition boundaries: the
+  // validity of every row is packed once they are done
+  std::vector<uint8_t> flags(num_rows);
+  gdf::util::host_parallel_for(num_partitions, gdf::util::host_num_threads(num_rows),
+    [&](unsigned, size_t first, size_t last) {
+      for(size_t p = first; p < last; ++p)
+        host_window_partition(data, valid, partition_offsets[p], partition_offsets[p + 1],
+                              frame, reduction, shift, min_periods, out, flags.data());
+    });
+
+  if( nullptr == out_valid )
+    return;
+  std::fill(out_valid, out_valid + gdf_get_num_chars_bitmask(num_rows), 0);
+  for(size_t i = 0; i < num_rows; ++i)
+    if( flags[i] )
+      out_valid[i / GDF_VALID_BITSIZE] |= gdf_valid_type(1) << (i % GDF_VALID_BITSIZE);
+}
+
+#endif // GDF_WINDOW_HOST_WINDOW_H
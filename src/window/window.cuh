@@ -0,0 +1,647 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_WINDOW_WINDOW_CUH
+#define GDF_WINDOW_WINDOW_CUH
+
+#include <gdf/gdf.h>
+#include <gdf/utils.h>
+#include <gdf/errorutils.h>
+
+#include <thrust/device_vector.h>
+#include <thrust/execution_policy.h>
+#include <thrust/functional.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/reverse_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+#include <thrust/scan.h>
+#include <thrust/scatter.h>
+#include <thrust/system/cuda/execution_policy.h>
+#include <thrust/transform.h>
+#include <thrust/transform_reduce.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "window.h"
+#include "../orderby/radix_order_by.cuh"
+
+constexpr int WINDOW_BLOCK_SIZE = 256;
+constexpr int WINDOW_MAX_BLOCKS = 1024;
+
+inline int window_num_blocks(gdf_size_type n)
+{
+  return static_cast<int>(std::min<gdf_size_type>((n + WINDOW_BLOCK_SIZE - 1) / WINDOW_BLOCK_SIZE,
+                                                  WINDOW_MAX_BLOCKS));
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The rows of a table in window order, i.e. sorted by partition
+ * then by the order columns, with the partition of every row as the range
+ * [begin[i], end[i]) of window positions. Without partition or order
+ * columns the permutation is the identity and is left empty, as are the
+ * partition bounds without partition columns.
+ */
+/* ----------------------------------------------------------------------------*/
+struct window_layout
+{
+  gdf_size_type num_rows{0};
+  thrust::device_vector<gdf_size_type> perm;      // window position -> row
+  thrust::device_vector<gdf_size_type> inverse;   // row -> window position
+  thrust::device_vector<gdf_size_type> begin;
+  thrust::device_vector<gdf_size_type> end;
+  thrust::device_vector<gdf_size_type> lo;        // first row of the frame
+  thrust::device_vector<gdf_size_type> hi;        // one past its last row
+
+  gdf_size_type const * perm_ptr() const { return perm.empty() ? nullptr : perm.data().get(); }
+  gdf_size_type const * inverse_ptr() const { return inverse.empty() ? nullptr : inverse.data().get(); }
+  gdf_size_type const * begin_ptr() const { return begin.empty() ? nullptr : begin.data().get(); }
+  gdf_size_type const * end_ptr() const { return end.empty() ? nullptr : end.data().get(); }
+};
+
+// Marks the window positions whose partition key word differs from the
+// previous position's
+template <typename KeyT>
+__global__
+void window_mark_heads(KeyT const * keys, gdf_size_type n, uint8_t * heads)
+{
+  for(gdf_size_type i = blockIdx.x * blockDim.x + threadIdx.x + 1; i < n; i += blockDim.x * gridDim.x)
+    if( keys[i] != keys[i - 1] )
+      heads[i] = 1;
+}
+
+// Start of the partition of every position: the last head at or before it
+struct window_head_position
+{
+  uint8_t const * heads;
+
+  __device__
+  gdf_size_type operator()(gdf_size_type i) const { return heads[i] ? i : 0; }
+};
+
+// End of the partition of every position: the first head after it
+struct window_next_head_position
+{
+  uint8_t const * heads;
+  gdf_size_type   n;
+
+  __device__
+  gdf_size_type operator()(gdf_size_type i) const
+  {
+    return (i + 1 == n || heads[i + 1]) ? i + 1 : n;
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Sorts the rows into window order with radix_order_by, and finds
+ * the partitions as the runs of equal partition keys in that order: the key
+ * words radix_order_by sorted on are built again through the permutation and
+ * compared between neighbours, so that partitions are exact whatever the
+ * number and types of the partition columns.
+ */
+/* ----------------------------------------------------------------------------*/
+inline
+gdf_error window_order(gdf_column * const *  partition_cols,
+                       int                   num_partition_cols,
+                       gdf_column * const *  order_cols,
+                       order_by_type const * order_by_types,
+                       int                   num_order_cols,
+                       window_layout &       layout,
+                       cudaStream_t          stream = 0)
+{
+  const gdf_size_type n = layout.num_rows;
+  if( 0 == num_partition_cols + num_order_cols || 0 == n )
+    return GDF_SUCCESS;
+
+  std::vector<gdf_column> keys;
+  std::vector<order_by_type> asc_desc;
+  for(int c = 0; c < num_partition_cols; ++c)
+  {
+    keys.push_back(*partition_cols[c]);
+    asc_desc.push_back(GDF_ORDER_ASC);
+  }
+  for(int c = 0; c < num_order_cols; ++c)
+  {
+    keys.push_back(*order_cols[c]);
+    asc_desc.push_back(nullptr != order_by_types ? order_by_types[c] : GDF_ORDER_ASC);
+  }
+  for(auto const & key : keys)
+    GDF_REQUIRE(key.size == n, GDF_COLUMN_SIZE_MISMATCH);
+
+  layout.perm.resize(n);
+  gdf_error status = radix_order_by_compact(n, keys.data(), keys.size(), asc_desc.data(),
+                                            nullptr, layout.perm.data().get(), stream);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  layout.inverse.resize(n);
+  thrust::scatter(thrust::cuda::par.on(stream),
+                  thrust::make_counting_iterator<gdf_size_type>(0),
+                  thrust::make_counting_iterator<gdf_size_type>(n),
+                  layout.perm.begin(), layout.inverse.begin());
+  CUDA_CHECK_LAST();
+
+  if( 0 == num_partition_cols )
+    return GDF_SUCCESS;
+
+  std::vector<key_field> fields;
+  std::vector<key_word> words;
+  status = plan_key_words(keys.data(), num_partition_cols, fields, words);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  thrust::device_vector<uint8_t> heads(n, 0);
+  thrust::device_vector<uint64_t> key_words(n);
+  for(auto const & word : words)
+  {
+    status = build_key_word(keys.data(), asc_desc.data(), nullptr, fields.data(), word, n,
+                            key_words.data().get(), layout.perm.data().get(), stream);
+    if( GDF_SUCCESS != status )
+      return status;
+    window_mark_heads<<<window_num_blocks(n), WINDOW_BLOCK_SIZE, 0, stream>>>(
+      key_words.data().get(), n, heads.data().get());
+    CUDA_CHECK_LAST();
+  }
+
+  layout.begin.resize(n);
+  layout.end.resize(n);
+  auto counting = thrust::make_counting_iterator<gdf_size_type>(0);
+  thrust::inclusive_scan(thrust::cuda::par.on(stream),
+                         thrust::make_transform_iterator(counting, window_head_position{heads.data().get()}),
+                         thrust::make_transform_iterator(counting + n, window_head_position{heads.data().get()}),
+                         layout.begin.begin(), thrust::maximum<gdf_size_type>());
+  auto next_heads = thrust::make_transform_iterator(counting,
+                                                    window_next_head_position{heads.data().get(), n});
+  thrust::inclusive_scan(thrust::cuda::par.on(stream),
+                         thrust::make_reverse_iterator(next_heads + n),
+                         thrust::make_reverse_iterator(next_heads),
+                         layout.end.rbegin(), thrust::minimum<gdf_size_type>());
+  CUDA_CHECK_LAST();
+  return GDF_SUCCESS;
+}
+
+// Row frames: clamped offsets from the position, within its partition
+template <typename IndexT>
+__global__
+void window_row_frames(IndexT         n,
+                       IndexT const * begin,
+                       IndexT const * end,
+                       window_frame   frame,
+                       IndexT *       lo,
+                       IndexT *       hi)
+{
+  // Clamped to [0, n] first, as a bound past the partition would not fit IndexT
+  const IndexT preceding = static_cast<IndexT>(fmin(fmax(frame.preceding, 0.0), static_cast<double>(n)));
+  const IndexT following = static_cast<IndexT>(fmin(fmax(frame.following, 0.0), static_cast<double>(n)));
+  for(IndexT i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x)
+  {
+    const IndexT b = begin ? begin[i] : 0;
+    const IndexT e = end ? end[i] : n;
+    lo[i] = (frame.preceding < 0 || i - b <= preceding) ? b : i - preceding;
+    hi[i] = (frame.following < 0 || e - i <= following) ? e : i + following + 1;
+  }
+}
+
+// Range frames: binary searches of the sorted order values of the partition
+template <typename IndexT>
+__global__
+void window_range_frames(IndexT         n,
+                         IndexT const * begin,
+                         IndexT const * end,
+                         double const * keys,
+                         window_frame   frame,
+                         IndexT *       lo,
+                         IndexT *       hi)
+{
+  for(IndexT i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x)
+  {
+    const IndexT b = begin ? begin[i] : 0;
+    const IndexT e = end ? end[i] : n;
+
+    // first position of [b, i] whose key is >= key - preceding
+    IndexT first = b;
+    if( frame.preceding >= 0 )
+    {
+      const double bound = keys[i] - frame.preceding;
+      IndexT count = i - b;
+      while( count > 0 )
+      {
+        const IndexT half = count / 2;
+        if( keys[first + half] < bound )
+        {
+          first += half + 1;
+          count -= half + 1;
+        }
+        else
+          count = half;
+      }
+    }
+
+    // first position of (i, e) whose key is > key + following
+    IndexT last = e;
+    if( frame.following >= 0 )
+    {
+      const double bound = keys[i] + frame.following;
+      last = i + 1;
+      IndexT count = e - last;
+      while( count > 0 )
+      {
+        const IndexT half = count / 2;
+        if( keys[last + half] <= bound )
+        {
+          last += half + 1;
+          count -= half + 1;
+        }
+        else
+          count = half;
+      }
+    }
+    lo[i] = first;
+    hi[i] = last;
+  }
+}
+
+// Loads column values in window order as doubles: the valid ones minus
+// `shift`, the null ones as `fill`, with a 0/1 validity flag
+template <typename T>
+__global__
+void window_load_values(T const *              data,
+                        gdf_valid_type const * valid,
+                        gdf_size_type const *  perm,
+                        gdf_size_type          n,
+                        double                 shift,
+                        double                 fill,
+                        double *               values,
+                        int64_t *              flags)
+{
+  for(gdf_size_type i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x)
+  {
+    const gdf_size_type row = perm ? perm[i] : i;
+    const bool is_valid = gdf_is_valid(valid, row);
+    values[i] = is_valid ? static_cast<double>(data[row]) - shift : fill;
+    flags[i] = is_valid ? 1 : 0;
+  }
+}
+
+struct window_values_loader
+{
+  gdf_column const *    col;
+  gdf_size_type const * perm;
+  double                shift;
+  double                fill;
+  double *              values;
+  int64_t *             flags;
+  cudaStream_t          stream;
+
+  template <typename T>
+  gdf_error operator()(T)
+  {
+    const gdf_size_type n = col->size;
+    window_load_values<<<window_num_blocks(n), WINDOW_BLOCK_SIZE, 0, stream>>>(
+      static_cast<T const *>(col->data), col->valid, perm, n, shift, fill, values, flags);
+    CUDA_CHECK_LAST();
+    return GDF_SUCCESS;
+  }
+};
+
+// The order value of a window position, negated when descending so that the
+// values ascend within every partition
+template <typename T>
+struct window_key_op
+{
+  T const *             data;
+  gdf_size_type const * perm;
+  double                sign;
+
+  __device__
+  double operator()(gdf_size_type i) const
+  {
+    return sign * static_cast<double>(data[perm ? perm[i] : i]);
+  }
+};
+
+struct window_keys_loader
+{
+  gdf_column const *    col;
+  gdf_size_type const * perm;
+  bool                  descending;
+  double *              keys;
+  cudaStream_t          stream;
+
+  template <typename T>
+  gdf_error operator()(T)
+  {
+    thrust::transform(thrust::cuda::par.on(stream),
+                      thrust::make_counting_iterator<gdf_size_type>(0),
+                      thrust::make_counting_iterator<gdf_size_type>(col->size),
+                      keys,
+                      window_key_op<T>{static_cast<T const *>(col->data), perm,
+                                       descending ? -1.0 : 1.0});
+    CUDA_CHECK_LAST();
+    return GDF_SUCCESS;
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Computes the frame [lo[i], hi[i]) of every window position.
+ */
+/* ----------------------------------------------------------------------------*/
+inline
+gdf_error window_frames(window_layout &       layout,
+                        window_frame const &  frame,
+                        gdf_column const *    order_col,
+                        order_by_type const * order_by_types,
+                        cudaStream_t          stream = 0)
+{
+  const gdf_size_type n = layout.num_rows;
+  layout.lo.resize(n);
+  layout.hi.resize(n);
+  if( 0 == n )
+    return GDF_SUCCESS;
+
+  if( GDF_WINDOW_ROW == frame.type )
+  {
+    window_row_frames<<<window_num_blocks(n), WINDOW_BLOCK_SIZE, 0, stream>>>(
+      n, layout.begin_ptr(), layout.end_ptr(), frame, layout.lo.data().get(), layout.hi.data().get());
+    CUDA_CHECK_LAST();
+    return GDF_SUCCESS;
+  }
+
+  thrust::device_vector<double> keys(n);
+  window_keys_loader loader{order_col, layout.perm_ptr(),
+                            nullptr != order_by_types && GDF_ORDER_DESC == order_by_types[0],
+                            keys.data().get(), stream};
+  gdf_error status = dispatch_key_type(order_col->dtype, loader);
+  if( GDF_SUCCESS != status )
+    return status;
+  window_range_frames<<<window_num_blocks(n), WINDOW_BLOCK_SIZE, 0, stream>>>(
+    n, layout.begin_ptr(), layout.end_ptr(), keys.data().get(), frame,
+    layout.lo.data().get(), layout.hi.data().get());
+  CUDA_CHECK_LAST();
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  One level of a sparse table of minima (or maxima): the level-k
+ * extremum of every window whose length has k as its floor log2 is the
+ * extremum of the two, overlapping, ranges of 2^k values at either end of
+ * the window; the next level then covers twice the length.
+ */
+/* ----------------------------------------------------------------------------*/
+template <bool is_min>
+__global__
+void window_extremum_level(double const *        level,
+                           gdf_size_type         n,
+                           int                   k,
+                           gdf_size_type const * lo,
+                           gdf_size_type const * hi,
+                           double *              extrema,
+                           double *              next_level)
+{
+  const gdf_size_type width = gdf_size_type{1} << k;
+  for(gdf_size_type i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x)
+  {
+    const gdf_size_type len = hi[i] - lo[i];
+    if( len >= width && len < 2 * width )
+    {
+      const double a = level[lo[i]];
+      const double b = level[hi[i] - width];
+      extrema[i] = is_min ? (a < b ? a : b) : (a > b ? a : b);
+    }
+    if( next_level )
+    {
+      const double a = level[i];
+      const double b = i + width < n ? level[i + width] : a;
+      next_level[i] = is_min ? (a < b ? a : b) : (a > b ? a : b);
+    }
+  }
+}
+
+struct window_frame_length
+{
+  gdf_size_type const * lo;
+  gdf_size_type const * hi;
+
+  __device__
+  gdf_size_type operator()(gdf_size_type i) const { return hi[i] - lo[i]; }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The min or max of every frame, with a sparse table built one
+ * level at a time: only the current level is kept, and the frames whose
+ * length calls for it are answered before the next one is built. This takes
+ * log2 of the longest frame passes but two buffers of values, where the full
+ * table would take one buffer per level.
+ */
+/* ----------------------------------------------------------------------------*/
+inline
+gdf_error window_extrema(window_layout const &           layout,
+                         bool                            is_min,
+                         thrust::device_vector<double> & values,
+                         thrust::device_vector<double> & extrema,
+                         cudaStream_t                    stream = 0)
+{
+  const gdf_size_type n = layout.num_rows;
+  gdf_size_type const * lo = layout.lo.data().get();
+  gdf_size_type const * hi = layout.hi.data().get();
+  const gdf_size_type longest = thrust::transform_reduce(
+      thrust::cuda::par.on(stream),
+      thrust::make_counting_iterator<gdf_size_type>(0),
+      thrust::make_counting_iterator<gdf_size_type>(n),
+      window_frame_length{lo, hi}, gdf_size_type{0}, thrust::maximum<gdf_size_type>());
+
+  extrema.resize(n);
+  thrust::device_vector<double> next(n);
+  for(int k = 0; (gdf_size_type{1} << k) <= longest; ++k)
+  {
+    const bool last = (gdf_size_type{2} << k) > longest;
+    double * next_level = last ? nullptr : next.data().get();
+    if( is_min )
+      window_extremum_level<true><<<window_num_blocks(n), WINDOW_BLOCK_SIZE, 0, stream>>>(
+        values.data().get(), n, k, lo, hi, extrema.data().get(), next_level);
+    else
+      window_extremum_level<false><<<window_num_blocks(n), WINDOW_BLOCK_SIZE, 0, stream>>>(
+        values.data().get(), n, k, lo, hi, extrema.data().get(), next_level);
+    CUDA_CHECK_LAST();
+    if( !last )
+      values.swap(next);
+  }
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Writes the aggregate of every row, in row order, from the
+ * prefix sums of its window order: a frame's count, sum and sum of squares
+ * are differences of two prefix sums, whatever its length. The validity bits
+ * of a warp's 32 rows are assembled with a ballot and stored as whole bytes;
+ * without an output mask, null aggregates are written as NaN.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename OutT>
+__global__
+void window_finalize(gdf_size_type         n,
+                     gdf_size_type const * inverse,
+                     gdf_size_type const * lo,
+                     gdf_size_type const * hi,
+                     int64_t const *       count_prefix,
+                     double const *        sum_prefix,
+                     double const *        squares_prefix,
+                     double const *        extrema,
+                     double                shift,
+                     window_reduction_type reduction,
+                     int64_t               min_periods,
+                     OutT *                out,
+                     gdf_valid_type *      out_valid)
+{
+  const unsigned lane = threadIdx.x % warpSize;
+  for(gdf_size_type tile = static_cast<gdf_size_type>(blockIdx.x) * blockDim.x;
+      tile < n;
+      tile += static_cast<gdf_size_type>(blockDim.x) * gridDim.x)
+  {
+    const gdf_size_type row = tile + threadIdx.x;
+    const bool active = row < n;
+    bool is_valid = false;
+    if( active )
+    {
+      const gdf_size_type i = inverse ? inverse[row] : row;
+      const gdf_size_type a = lo[i];
+      const gdf_size_type b = hi[i];
+      const int64_t count = count_prefix[b] - count_prefix[a];
+      const double sum = sum_prefix ? sum_prefix[b] - sum_prefix[a] : 0;
+      const double squares = squares_prefix ? squares_prefix[b] - squares_prefix[a] : 0;
+      double result = 0;
+      is_valid = window_result(reduction, count, sum, squares, extrema ? extrema[i] : 0,
+                               shift, min_periods, result);
+      out[row] = static_cast<OutT>(is_valid ? result : std::numeric_limits<double>::quiet_NaN());
+    }
+
+    if( nullptr != out_valid )
+    {
+      const unsigned bits = __ballot_sync(0xffffffff, is_valid);
+      if( (0 == lane % GDF_VALID_BITSIZE) && active )
+        out_valid[row / GDF_VALID_BITSIZE] = static_cast<gdf_valid_type>(bits >> lane);
+    }
+  }
+}
+
+struct window_square
+{
+  __device__
+  double operator()(double v) const { return v * v; }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Aggregates one column over the frames of a window layout into
+ * an output column of GDF_FLOAT64, or GDF_INT64 for GDF_WINDOW_COUNT.
+ *
+ * Count, sum, mean, variance and deviation take O(1) per row from exclusive
+ * prefix sums of the valid values in window order, taken about their mean
+ * `shift`; min and max use window_extrema.
+ *
+ * @Param[in] layout The window order and frames
+ * @Param[in] col The values; null rows are skipped
+ * @Param[in] reduction The aggregate
+ * @Param[in] shift The mean of the valid values, or any value close to them
+ * @Param[in] min_periods The least number of valid values of a non-null
+ * aggregate
+ * @Param[out] out The aggregate of every row's frame, in row order
+ * @Param[in] stream The stream on which to aggregate
+ *
+ * @Returns GDF_SUCCESS upon successful completion
+ */
+/* ----------------------------------------------------------------------------*/
+inline
+gdf_error window_aggregate(window_layout const & layout,
+                           gdf_column const *    col,
+                           window_reduction_type reduction,
+                           double                shift,
+                           gdf_size_type         min_periods,
+                           gdf_column *          out,
+                           cudaStream_t          stream = 0)
+{
+  const gdf_size_type n = layout.num_rows;
+  if( 0 == n )
+    return GDF_SUCCESS;
+
+  const bool extremum = window_is_extremum(reduction);
+  const double inf = std::numeric_limits<double>::infinity();
+  if( extremum )
+    shift = 0;
+  const double fill = (GDF_WINDOW_MIN == reduction) ? inf : (GDF_WINDOW_MAX == reduction ? -inf : 0);
+
+  thrust::device_vector<double> values(n);
+  thrust::device_vector<int64_t> flags(n);
+  window_values_loader loader{col, layout.perm_ptr(), shift, fill,
+                              values.data().get(), flags.data().get(), stream};
+  gdf_error status = dispatch_key_type(col->dtype, loader);
+  if( GDF_SUCCESS != status )
+    return status;
+
+  auto policy = thrust::cuda::par.on(stream);
+  thrust::device_vector<int64_t> count_prefix(n + 1, 0);
+  thrust::inclusive_scan(policy, flags.begin(), flags.end(), count_prefix.begin() + 1);
+  thrust::device_vector<double> sum_prefix;
+  thrust::device_vector<double> squares_prefix;
+  if( window_needs_sum(reduction) )
+  {
+    sum_prefix.resize(n + 1, 0);
+    thrust::inclusive_scan(policy, values.begin(), values.end(), sum_prefix.begin() + 1);
+  }
+  if( window_needs_sum_squares(reduction) )
+  {
+    squares_prefix.resize(n + 1, 0);
+    thrust::inclusive_scan(policy,
+                           thrust::make_transform_iterator(values.begin(), window_square{}),
+                           thrust::make_transform_iterator(values.end(), window_square{}),
+                           squares_prefix.begin() + 1);
+  }
+  CUDA_CHECK_LAST();
+
+  thrust::device_vector<double> extrema;
+  if( extremum )
+  {
+    status = window_extrema(layout, GDF_WINDOW_MIN == reduction, values, extrema, stream);
+    if( GDF_SUCCESS != status )
+      return status;
+  }
+
+  double const * sums = sum_prefix.empty() ? nullptr : sum_prefix.data().get();
+  double const * squares = squares_prefix.empty() ? nullptr : squares_prefix.data().get();
+  double const * ext = extrema.empty() ? nullptr : extrema.data().get();
+  if( GDF_INT64 == out->dtype )
+    window_finalize<int64_t><<<window_num_blocks(n), WINDOW_BLOCK_SIZE, 0, stream>>>(
+      n, layout.inverse_ptr(), layout.lo.data().get(), layout.hi.data().get(),
+      count_prefix.data().get(), sums, squares, ext, shift, reduction, min_periods,
+      static_cast<int64_t *>(out->data), out->valid);
+  else
+    window_finalize<double><<<window_num_blocks(n), WINDOW_BLOCK_SIZE, 0, stream>>>(
+      n, layout.inverse_ptr(), layout.lo.data().get(), layout.hi.data().get(),
+      count_prefix.data().get(), sums, squares, ext, shift, reduction, min_periods,
+      static_cast<double *>(out->data), out->valid);
+  CUDA_CHECK_LAST();
+  return GDF_SUCCESS;
+}
+
+#endif // GDF_WINDOW_WINDOW_CUH
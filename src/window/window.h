@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GDF_WINDOW_WINDOW_H
+#define GDF_WINDOW_WINDOW_H
+
+#include <gdf/gdf.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#ifdef __CUDACC__
+#define GDF_WINDOW_FUNC __host__ __device__ __forceinline__
+#else
+#define GDF_WINDOW_FUNC inline
+#endif
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The frame of a window: the rows [i - preceding, i + following]
+ * of row i for GDF_WINDOW_ROW, or the rows whose order value lies within
+ * [v - preceding, v + following] for GDF_WINDOW_RANGE, never beyond the
+ * partition of row i. A negative bound is UNBOUNDED.
+ */
+/* ----------------------------------------------------------------------------*/
+struct window_frame
+{
+  window_function_type type;
+  double preceding;
+  double following;
+
+  bool unbounded_preceding() const { return preceding < 0; }
+  bool unbounded_following() const { return following < 0; }
+};
+
+// Whether a reduction needs the sum, or the sum of squares, of its window
+inline bool window_needs_sum(window_reduction_type r)
+{
+  return r == GDF_WINDOW_SUM || r == GDF_WINDOW_AVG || r == GDF_WINDOW_STDDEV || r == GDF_WINDOW_VAR;
+}
+
+inline bool window_needs_sum_squares(window_reduction_type r)
+{
+  return r == GDF_WINDOW_STDDEV || r == GDF_WINDOW_VAR;
+}
+
+inline bool window_is_extremum(window_reduction_type r)
+{
+  return r == GDF_WINDOW_MIN || r == GDF_WINDOW_MAX;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The aggregate of a window from its count of valid values, and
+ * the sum and sum of squares of those values minus `shift`; `extremum` is
+ * their min or max. Sums are taken about a shift close to the values so that
+ * the variance does not cancel out.
+ *
+ * Windows with fewer than max(min_periods, 1) valid values are null, but for
+ * COUNT; so are the variance and deviation of fewer than two values.
+ */
+/* ----------------------------------------------------------------------------*/
+GDF_WINDOW_FUNC
+bool window_result(window_reduction_type reduction,
+                   int64_t               count,
+                   double                sum,
+                   double                sum_squares,
+                   double                extremum,
+                   double                shift,
+                   int64_t               min_periods,
+                   double &              result)
+{
+  if( reduction == GDF_WINDOW_COUNT )
+  {
+    result = static_cast<double>(count);
+    return true;
+  }
+  if( count < (min_periods > 1 ? min_periods : 1) )
+    return false;
+
+  const double n = static_cast<double>(count);
+  switch( reduction )
+  {
+  case GDF_WINDOW_SUM: result = sum + shift * n; return true;
+  case GDF_WINDOW_AVG: result = shift + sum / n; return true;
+  case GDF_WINDOW_MIN:
+  case GDF_WINDOW_MAX: result = extremum; return true;
+  case GDF_WINDOW_VAR:
+  case GDF_WINDOW_STDDEV:
+  {
+    if( count < 2 )
+      return false;
+    double var = (sum_squares - sum * sum / n) / (n - 1);
+    var = var > 0 ? var : 0;
+    result = reduction == GDF_WINDOW_VAR ? var : sqrt(var);
+    return true;
+  }
+  default: return false;
+  }
+}
+
+#endif // GDF_WINDOW_WINDOW_H
@@ -1,148 +1,142 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Window (rolling and partitioned) aggregates
+
+#include <cmath>
+
 #include <gdf/gdf.h>
 #include <gdf/utils.h>
 #include <gdf/errorutils.h>
 #include <gdf/cffi/functions.h>
 
-#include <cuda_runtime.h>
-
-#include <thrust/transform.h>
-#include <thrust/functional.h>
-#include <thrust/execution_policy.h>
-#include <thrust/iterator/iterator_adaptor.h>
+#include "window/window.cuh"
+#include "reductions/column_stats.cuh"
 
-//TODO: I pulled this rom Andrei's sql ops code, we should consider putting this somewhere
-//others can access this api
 namespace{ //annonymus
 
-  //helper function:
-  //flatten AOS info from gdf_columns into SOA (2 arrays):
-  //(1) column array pointers and (2) types;
-  //
-  void soa_col_info(gdf_column** cols, size_t ncols, void** d_cols, int* d_types, cudaStream_t stream)
+  bool window_supported_dtype(gdf_dtype dtype)
   {
-    std::vector<void*> v_cols(ncols,nullptr);
-    std::vector<int>   v_types(ncols, 0);
-    for(int i=0;i<ncols;++i)
+    switch( dtype )
       {
-	v_cols[i] = cols[i]->data;
-	v_types[i] = cols[i]->dtype;
+      case GDF_INT8:
+      case GDF_INT16:
+      case GDF_INT32:
+      case GDF_INT64:
+      case GDF_FLOAT32:
+      case GDF_FLOAT64:
+      case GDF_DATE32:
+      case GDF_DATE64:
+      case GDF_TIMESTAMP: return true;
+      default:            return false;
       }
+  }
 
-    void** h_cols = &v_cols[0];
-    int* h_types = &v_types[0];
-    cudaMemcpyAsync(d_cols, h_cols, ncols*sizeof(void*), cudaMemcpyHostToDevice,stream);//TODO: add streams
-    cudaMemcpy(d_types, h_types, ncols*sizeof(int), cudaMemcpyHostToDevice,stream);//TODO: add streams
+  //mean of the valid values of a column, the shift of its window sums
+  struct window_shift
+  {
+    gdf_column const* col;
+    double* mean;
+
+    template<typename T>
+    gdf_error operator()(T)
+    {
+      column_stats_accumulator acc;
+      gdf_error status = column_stats(static_cast<T const*>(col->data), col->valid, col->size, acc);
+      *mean = acc.count > 0 ? acc.mean : 0;
+      return status;
+    }
+  };
+
+  gdf_error check_window_output(gdf_column const* col,
+                                window_reduction_type reduction,
+                                gdf_column const* out)
+  {
+    GDF_REQUIRE(nullptr != col && nullptr != out, GDF_DATASET_EMPTY);
+    GDF_REQUIRE(window_supported_dtype(col->dtype), GDF_UNSUPPORTED_DTYPE);
+    GDF_REQUIRE(GDF_FLOAT64 == out->dtype ||
+                (GDF_WINDOW_COUNT == reduction && GDF_INT64 == out->dtype), GDF_UNSUPPORTED_DTYPE);
+    GDF_REQUIRE(out->size == col->size, GDF_COLUMN_SIZE_MISMATCH);
+    return GDF_SUCCESS;
   }
-}
+
+}//unknown namespace
 
 
+//The rows are sorted once into window order (partition columns, then order
+//columns) and split into partitions, the frame of every row is found, and
+//every reduction column is then aggregated over those frames; the results
+//are written in the original row order.
+//
+gdf_error gdf_window_function(gdf_column** window_reduction_columns, window_reduction_type* reductions, int num_window_reduction_columns,
+			      gdf_column** window_partition_columns, int num_window_partition_columns,
+			      gdf_column** window_order_columns, order_by_type* order_by_types, int num_window_order_columns,
+			      window_function_type window_type, double preceding, double following, gdf_size_type min_periods,
+			      gdf_column** output_columns){
 
-gdf_error gpu_window_function(gdf_column ** window_order_columns, int num_window_order_columns, window_function_type window_type,
-		gdf_column ** window_reduction_columns, int num_window_reduction_columns, window_reduction_type * reductions,
-		gdf_column ** window_partition_columns, int num_window_partition_columns,
-		order_by_type * order_by_types, char * workspace,gdf_size_type & workspace_size){
+	GDF_REQUIRE(num_window_reduction_columns > 0 && nullptr != window_reduction_columns
+		    && nullptr != reductions && nullptr != output_columns, GDF_DATASET_EMPTY);
+	GDF_REQUIRE(!std::isnan(preceding) && !std::isnan(following), GDF_INVALID_API_CALL);
 
 	//will always have at least one reduction
-	gdf_size_type num_rows = window_reduction_columns[0].size;
-
-	if(num_window_partition_columns > 0){
-
-		//can be used to get the amount of space that should be preallocated for this
-		if(workspace == nullptr){
-			workspace_size = 0;
-			if(num_window_partition_columns > 1){
-				//more than one partition column so we will hash the data together
-				workspace_size += sizeof(unsigned long long) * window_partition_columns[0].size + ((window_partition_columns[0].size + (GDF_VALID_BITSIZE -1 )) /GDF_VALID_BITSIZE));
-			}
-			return GDF_SUCCESS;
-		}
+	const gdf_size_type num_rows = window_reduction_columns[0]->size;
+	for(int i = 0; i < num_window_reduction_columns; i++){
+		gdf_error status = check_window_output(window_reduction_columns[i], reductions[i], output_columns[i]);
+		if(status != GDF_SUCCESS)
+			return status;
+		GDF_REQUIRE(window_reduction_columns[i]->size == num_rows, GDF_COLUMN_SIZE_MISMATCH);
 	}
 
-	//a gdf column
-
-	cudaStream_t stream;
-	cudaStreamCreate(&stream);
-
-
-	//hash the partition columns
-	gdf_column hashed_data;
-
-	if(num_window_partition_columns > 0){
-		gpu_hash_columns(window_partition_columns, num_window_partition_columns,
-				&hashed_data, &stream);
-		gdf_column-view(&data, (void *) data,
-				(gdf_valid_type *) ( ((char *) data ) + (sizeof(unsigned long long) * num_rows))
-				,window_partition_columns[0].size,GDF_INT64);
-
-	}else{
-		hashed_data.size = 0;
+	//a range frame is over the values of a single order column
+	gdf_column const* range_column = nullptr;
+	if(window_type == GDF_WINDOW_RANGE){
+		GDF_REQUIRE(num_window_order_columns == 1, GDF_INVALID_API_CALL);
+		range_column = window_order_columns[0];
+		GDF_REQUIRE(window_supported_dtype(range_column->dtype), GDF_UNSUPPORTED_DTYPE);
+		GDF_REQUIRE(nullptr == range_column->valid || 0 == range_column->null_count, GDF_VALIDITY_UNSUPPORTED);
 	}
 
+	window_layout layout;
+	layout.num_rows = num_rows;
+	gdf_error status = window_order(window_partition_columns, num_window_partition_columns,
+					window_order_columns, order_by_types, num_window_order_columns,
+					layout);
+	if(status != GDF_SUCCESS)
+		return status;
+
+	status = window_frames(layout, window_frame{window_type, preceding, following},
+			       range_column, order_by_types);
+	if(status != GDF_SUCCESS)
+		return status;
+
+	for(int i = 0; i < num_window_reduction_columns; i++){
+		double shift = 0;
+		if(window_needs_sum(reductions[i])){
+			window_shift mean{window_reduction_columns[i], &shift};
+			status = dispatch_key_type(window_reduction_columns[i]->dtype, mean);
+			if(status != GDF_SUCCESS)
+				return status;
+		}
 
-
-	//stable sort backwards starting with the least significant order by
-	/*template<typename IndexT>
-__host__ __device__
-void multi_col_order_by(size_t nrows,
-			size_t ncols,
-			void* const* d_cols,
-			int* const  d_gdf_t,
-			IndexT*      d_indx,
-cudaStream_t stream = NULL)*/
-
-	void ** device_order_columns;
-	cudaMalloc(&device_order_columns,sizeof(void *) * num_window_order_columns + 1);
-
-	//copy copy device pointers
-
-	int * device_column_types;
-	cudaMalloc(&device_column_types,sizeof(int) * num_window_order_columns + 1);
-
-	gdf_column** order_by_cols = new gdf_column*[num_window_order_columns + 1];
-	for(int i = 0; i < num_window_order_columns; i++){
-		order_by_cols[i] = window_order_columns[i];
+		status = window_aggregate(layout, window_reduction_columns[i], reductions[i],
+					  shift, min_periods, output_columns[i]);
+		if(status != GDF_SUCCESS)
+			return status;
 	}
-	order_by_cols[num_window_order_columns] = &hashed_data;
 
-	soa_col_info(order_by_cols, num_window_order_columns + 1,
-			device_order_columns, device_column_types, stream);
-
-	gdf_size_type * device_index_outputs;
-	cudaMalloc(&device_index_outputs,sizeof(gdf_size_type) * num_rows);
-
-	multi_col_order_by(num_rows,num_window_order_columns + 1,device_order_columns
-			,device_column_types,device_index_outputs, stream);
-
-
-	//now we have our ordered arangement for the table
-	//process reduction
-
-
-
-
-	delete[] order_by_cols;
-	cudaFree(device_order_columns);
-	cudaFree(device_column_types);
-
-	//no stable sort by the hash of the partition column
-
-
-	//perform windowed functions here
-
-
-	cudaStreamSynchronize(stream);
-	cudaStreamDestroy(stream);
+	CUDA_TRY( cudaDeviceSynchronize() );
+	return GDF_SUCCESS;
 }
-
-
-//so we have no segmented sorting in thrust, which means that one way to accomplish our goals is to stable sort in
-//backwards order
-//this will line up all of our columns nicely
-
-
-//because our partitions are a group of columns hashing the values together makes for fewer operations later on when determining
-//partitions
-
-//so primitives we need are
-//the sorting
-//hashing